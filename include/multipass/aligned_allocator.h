@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2020 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MULTIPASS_ALIGNED_ALLOCATOR_H
+#define MULTIPASS_ALIGNED_ALLOCATOR_H
+
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include <sys/mman.h>
+
+namespace multipass
+{
+namespace utils
+{
+/* Alignment for bulk-I/O buffers: 2MiB matches the transparent-hugepage granularity, so a buffer this
+   size sits in a single huge page (advised for below), and keeps large transfers aligned to whatever
+   stripe or erase-block boundary the storage underneath cares about. Buffers smaller than one slab
+   would waste most of it, so those take the regular allocation path. */
+constexpr std::size_t large_buffer_alignment = 2u * 1024 * 1024;
+
+template <typename T>
+struct AlignedBufferAllocator
+{
+    using value_type = T;
+
+    AlignedBufferAllocator() = default;
+    template <typename U>
+    AlignedBufferAllocator(const AlignedBufferAllocator<U>&) noexcept
+    {
+    }
+
+    T* allocate(std::size_t n)
+    {
+        const auto bytes = n * sizeof(T);
+        if (bytes < large_buffer_alignment)
+            return static_cast<T*>(::operator new(bytes));
+
+        void* mem{nullptr};
+        if (::posix_memalign(&mem, large_buffer_alignment, bytes) != 0)
+            throw std::bad_alloc{};
+
+#ifdef MADV_HUGEPAGE
+        ::madvise(mem, bytes, MADV_HUGEPAGE); // best effort; plain pages serve where THP is unavailable
+#endif
+        return static_cast<T*>(mem);
+    }
+
+    void deallocate(T* mem, std::size_t n) noexcept
+    {
+        if (n * sizeof(T) < large_buffer_alignment)
+            ::operator delete(mem);
+        else
+            ::free(mem);
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const AlignedBufferAllocator<T>&, const AlignedBufferAllocator<U>&) noexcept
+{
+    return true;
+}
+
+template <typename T, typename U>
+bool operator!=(const AlignedBufferAllocator<T>&, const AlignedBufferAllocator<U>&) noexcept
+{
+    return false;
+}
+
+using IOBuffer = std::vector<unsigned char, AlignedBufferAllocator<unsigned char>>;
+} // namespace utils
+} // namespace multipass
+#endif // MULTIPASS_ALIGNED_ALLOCATOR_H
@@ -29,7 +29,7 @@ class ArgParser
     // Note: We are using camelCase here for methods since this class mimics the QCommandLineParser class
 
 public:
-    ArgParser(const QStringList& arguments, const std::vector<cmd::Command::UPtr>& commands, std::ostream& cout,
+    ArgParser(const QStringList& arguments, const std::vector<cmd::CommandEntry>& commands, std::ostream& cout,
               std::ostream& cerr);
 
     void setApplicationDescription(const QString& description);
@@ -42,7 +42,7 @@ public:
     ParseCode parse();
     cmd::Command* chosenCommand() const;
     cmd::Command* findCommand(const QString& command) const;
-    const std::vector<cmd::Command::UPtr>& getCommands() const;
+    const std::vector<cmd::CommandEntry>& getCommands() const;
 
     bool isSet(const QString& option) const;
     bool isSet(const QCommandLineOption& option) const;
@@ -68,7 +68,7 @@ private:
     QString helpText(cmd::Command* command);
 
     const QStringList& arguments;
-    const std::vector<cmd::Command::UPtr>& commands;
+    const std::vector<cmd::CommandEntry>& commands;
     cmd::Command* chosen_command;
 
     QCommandLineParser parser;
@@ -22,10 +22,12 @@
 
 #include <multipass/cert_provider.h>
 #include <multipass/cli/return_codes.h>
+#include <multipass/optional.h>
 #include <multipass/rpc/multipass.grpc.pb.h>
 #include <multipass/rpc_connection_type.h>
 #include <multipass/ssl_cert_provider.h>
 
+#include <chrono>
 #include <memory>
 #include <string>
 
@@ -54,6 +56,11 @@ void set_logger();
 void set_logger(multipass::logging::Level verbosity); // full param qualification makes sure msvc is happy
 void pre_setup();
 void post_setup();
+
+/* Best-effort cache of RPC replies under the user's cache dir, letting repeat queries answer without a
+   round trip. Loading reports the entry's age, for callers to judge against a daemon-stamped validity. */
+optional<std::chrono::seconds> load_cached_reply(const std::string& name, google::protobuf::Message& reply);
+void store_cached_reply(const std::string& name, const google::protobuf::Message& reply);
 }
 } // namespace multipass
 #endif // MULTIPASS_CLIENT_COMMON_H
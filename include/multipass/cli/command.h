@@ -30,6 +30,8 @@
 
 #include <grpc++/grpc++.h>
 
+#include <functional>
+
 namespace multipass
 {
 class ArgParser;
@@ -40,6 +42,7 @@ class Command
 {
 public:
     using UPtr = std::unique_ptr<Command>;
+    using StubFactory = std::function<Rpc::Stub&()>;
     Command(grpc::Channel& channel, Rpc::Stub& stub, std::ostream& cout, std::ostream& cerr)
         : rpc_channel{&channel}, stub{&stub}, cout{cout}, cerr{cerr}
     {
@@ -49,6 +52,13 @@ public:
         : rpc_channel{&channel}, stub{&stub}, term{term}, cout{term->cout()}, cerr{term->cerr()}
     {
     }
+
+    /* The factory form defers channel construction — and with it, certificate loading — to the first dispatch, off
+       the startup path of invocations that never reach the daemon */
+    Command(StubFactory stub_factory, Terminal* term)
+        : stub_factory{std::move(stub_factory)}, term{term}, cout{term->cout()}, cerr{term->cerr()}
+    {
+    }
     virtual ~Command() = default;
 
     virtual ReturnCode run(ArgParser* parser) = 0;
@@ -73,6 +83,9 @@ protected:
         using ReplyType = typename std::remove_reference<Arg0Type>::type;
         ReplyType reply;
 
+        if (stub == nullptr)
+            stub = &stub_factory();
+
         auto rpc_method = std::bind(rpc_func, stub, std::placeholders::_1, std::placeholders::_2);
 
         grpc::ClientContext context;
@@ -134,8 +147,9 @@ protected:
     Command(const Command&) = delete;
     Command& operator=(const Command&) = delete;
 
-    grpc::Channel* rpc_channel;
-    Rpc::Stub* stub;
+    grpc::Channel* rpc_channel{nullptr};
+    Rpc::Stub* stub{nullptr};
+    StubFactory stub_factory;
     Terminal* term;
     std::ostream& cout;
     std::ostream& cerr;
@@ -157,6 +171,26 @@ private:
         static_assert(std::is_same<FailureCallableArgType, grpc::Status&>::value, "");
     }
 };
+
+/* An entry in the client's command table: the dispatch metadata lives here, in plain data, so that
+   choosing and describing commands doesn't require instantiating any of them — only the one picked
+   to run gets constructed, on first access */
+struct CommandEntry
+{
+    Command* instance() const
+    {
+        if (!cached)
+            cached = make();
+        return cached.get();
+    }
+
+    std::string name;
+    std::vector<std::string> aliases; // includes the name itself
+    QString short_help;
+    std::function<Command::UPtr()> make;
+
+    mutable Command::UPtr cached;
+};
 } // namespace cmd
 } // namespace multipass
 #endif // MULTIPASS_COMMAND_H
@@ -26,6 +26,7 @@
 
 #include <algorithm>
 #include <string>
+#include <vector>
 
 namespace multipass
 {
@@ -37,28 +38,62 @@ std::string status_string_for(const InstanceStatus& status);
 std::string image_string_for(const multipass::FindReply_AliasInfo& alias);
 Formatter* formatter_for(const std::string& format);
 
+/*
+ * Streaming JSON emitter, for formatters to write straight into a string instead of building a
+ * QJsonObject tree and serializing it afterwards. The output matches QJsonDocument::toJson's indented
+ * format byte for byte — including keys within an object being sorted, which the caller is responsible
+ * for, since entries land in the string as they are written.
+ */
+class JsonWriter
+{
+public:
+    explicit JsonWriter(std::string& out);
+
+    void begin_object();
+    void end_object();
+    void begin_array();
+    void end_array();
+    void key(const std::string& name);
+    void value(const std::string& str);
+    void value(long long number);
+    void value(double number);
+
+private:
+    void begin_entry(); // separator and indent bookkeeping, common to keys, values and open brackets
+    void close_container(char bracket);
+    void append_escaped(const std::string& str);
+
+    std::string& out;
+    std::vector<bool> has_entries; // one per open container
+    bool after_key = false;
+};
+
 template <typename Instances>
-Instances sorted(const Instances& instances);
+std::vector<const typename Instances::value_type*> sorted(const Instances& instances);
 
 void filter_aliases(google::protobuf::RepeatedPtrField<multipass::FindReply_AliasInfo>& aliases);
 } // namespace format
 }
 
 template <typename Instances>
-Instances multipass::format::sorted(const Instances& instances)
-{
-    if (instances.empty())
-        return instances;
+std::vector<const typename Instances::value_type*> multipass::format::sorted(const Instances& instances)
+{ // sorting pointers spares copying the messages themselves, along with all the strings they hold
+    std::vector<const typename Instances::value_type*> ret;
+    ret.reserve(instances.size());
+    for (const auto& instance : instances)
+        ret.push_back(&instance);
+
+    if (ret.empty())
+        return ret;
 
-    auto ret = instances;
     const auto petenv_name = Settings::instance().get(petenv_key).toStdString();
-    std::sort(std::begin(ret), std::end(ret), [&petenv_name](const auto& a, const auto& b) {
-        if (a.name() == petenv_name)
+    std::sort(std::begin(ret), std::end(ret), [&petenv_name](const auto* a, const auto* b) {
+        if (a->name() == petenv_name)
             return true;
-        else if (b.name() == petenv_name)
+        else if (b->name() == petenv_name)
             return false;
         else
-            return a.name() < b.name();
+            return a->name() < b->name();
     });
 
     return ret;
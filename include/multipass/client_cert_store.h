@@ -21,6 +21,10 @@
 #include <multipass/cert_store.h>
 #include <multipass/path.h>
 
+#include <QDateTime>
+
+#include <unordered_set>
+
 namespace multipass
 {
 class ClientCertStore : public CertStore
@@ -32,6 +36,13 @@ public:
 
 private:
     Path cert_dir;
+
+    /* The parsed chain is cached against the file's stamp, so the store answers repeated queries without
+       touching the disk; the fingerprints let add_cert skip certificates it already holds */
+    mutable std::string cached_chain;
+    mutable std::unordered_set<std::string> cached_fingerprints;
+    mutable QDateTime cached_mtime; // invalid when nothing is cached
+    mutable qint64 cached_size{-1}; // backs up the coarse granularity of the mtime
 };
 } // namespace multipass
 #endif // MULTIPASS_CLIENT_CERT_STORE_H
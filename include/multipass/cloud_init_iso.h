@@ -33,6 +33,11 @@ public:
     void add_file(const std::string& name, const std::string& data);
     void write_to(const Path& path);
 
+    /* Patches a single entry of an ISO previously produced by write_to, rewriting only that entry's data
+       extent and the directory records carrying its size. Returns false when there is no such entry or the
+       new contents outgrow the extent reserved for it, in which case the caller should regenerate in full. */
+    static bool update_file_in(const Path& path, const std::string& name, const std::string& data);
+
 private:
     struct FileEntry
     {
@@ -42,6 +42,19 @@ constexpr auto petenv_key = "client.primary-name";     // This will eventually b
 constexpr auto driver_key = "local.driver";            // idem
 constexpr auto autostart_key = "client.gui.autostart"; // idem
 constexpr auto winterm_key = "client.apps.windows-terminal.profiles"; // idem
+constexpr auto bandwidth_key = "local.bandwidth.download"; /* idem; caps the daemon's download rate, in bytes/s
+                                                              (suffixes as in memory sizes); empty for no cap */
+constexpr auto vault_size_key = "local.vault.size"; /* idem; storage budget for cached images (suffixes as in
+                                                       memory sizes); empty for no budget */
+constexpr auto idle_suspend_key = "local.idle-suspend-timeout"; /* idem; minutes an instance may sit idle before the
+                                                                   daemon suspends it; empty to keep idle instances
+                                                                   running */
+constexpr auto mirror_key = "local.image.mirror"; /* idem; base URL of a cloud-images.ubuntu.com mirror to fetch
+                                                     images from, e.g. "https://mirror.example.net/ubuntu-cloud/";
+                                                     empty for the upstream host */
+constexpr auto log_level_key = "local.log-level"; /* idem; runtime verbosity, optionally per category, e.g. "debug"
+                                                     or "warning,sftp server=trace"; the daemon picks changes up
+                                                     without a restart; empty for the level it was started with */
 } // namespace multipass
 
 #endif // MULTIPASS_CONSTANTS_H
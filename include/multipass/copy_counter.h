@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2020 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MULTIPASS_COPY_COUNTER_H
+#define MULTIPASS_COPY_COUNTER_H
+
+#ifdef MULTIPASS_COPY_COUNTERS
+
+#include <multipass/performance_counters.h>
+
+#include <string>
+
+namespace multipass
+{
+namespace perf
+{
+/* Empty member type counting copies and moves of its enclosing type into the performance counters, so
+   accidental copies of hot types surface through the metrics RPC — and can fail a benchmark gate —
+   instead of shipping unnoticed. Declare via MP_COUNT_COPIES as the *last* member: aggregates then keep
+   accepting their existing brace-inits, with the counter value-initialized. Costs one atomic add per
+   copy/move; builds without MULTIPASS_ENABLE_COPY_COUNTERS compile the member away entirely. */
+template <typename Tag>
+struct CopyCounted
+{
+    CopyCounted() = default;
+    CopyCounted(const CopyCounted&)
+    {
+        PerformanceCounters::instance().increment(std::string{Tag::name} + "_copies_total");
+    }
+    CopyCounted(CopyCounted&&) noexcept
+    {
+        PerformanceCounters::instance().increment(std::string{Tag::name} + "_moves_total");
+    }
+    CopyCounted& operator=(const CopyCounted&)
+    {
+        PerformanceCounters::instance().increment(std::string{Tag::name} + "_copies_total");
+        return *this;
+    }
+    CopyCounted& operator=(CopyCounted&&) noexcept
+    {
+        PerformanceCounters::instance().increment(std::string{Tag::name} + "_moves_total");
+        return *this;
+    }
+};
+} // namespace perf
+} // namespace multipass
+
+#define MP_COUNT_COPIES(type)                                                                                          \
+    struct type##CopyTag                                                                                               \
+    {                                                                                                                  \
+        static constexpr auto name = #type;                                                                            \
+    };                                                                                                                 \
+    ::multipass::perf::CopyCounted<type##CopyTag> type##_copy_counter                                                  \
+    {                                                                                                                  \
+    }
+
+#else
+
+#define MP_COUNT_COPIES(type) static_assert(true, "")
+
+#endif // MULTIPASS_COPY_COUNTERS
+
+#endif // MULTIPASS_COPY_COUNTER_H
@@ -0,0 +1,40 @@
+/*
+ * Copyright (C) 2020 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MULTIPASS_DATA_SINK_H
+#define MULTIPASS_DATA_SINK_H
+
+#include <QByteArray>
+
+namespace multipass
+{
+// Receives the bytes of a transfer as they arrive, allowing work such as decompression to overlap the download
+class DataSink
+{
+public:
+    virtual ~DataSink() = default;
+
+    virtual void write(const QByteArray& data) = 0;
+    virtual void restart() = 0; // the transfer is starting over from byte zero
+
+protected:
+    DataSink() = default;
+    DataSink(const DataSink&) = delete;
+    DataSink& operator=(const DataSink&) = delete;
+};
+} // namespace multipass
+#endif // MULTIPASS_DATA_SINK_H
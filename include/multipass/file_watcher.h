@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2020 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MULTIPASS_FILE_WATCHER_H
+#define MULTIPASS_FILE_WATCHER_H
+
+#include "singleton.h"
+
+#include <QString>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+
+class QFileSystemWatcher;
+
+namespace multipass
+{
+/* The central filesystem-event service: modules subscribe to the files they care about instead of each
+   re-stat'ing them or spinning up a QFileSystemWatcher of their own. Subscriptions survive the file being
+   replaced by rename (the usual editor and atomic-writer behavior) and fire when the file first appears.
+   Callbacks run on the main thread and may be spurious — treat them as cheap invalidation hints, not as
+   precise change records. Main-thread only, like the QFileSystemWatcher underneath. */
+class FileWatcher : public Singleton<FileWatcher>
+{
+public:
+    FileWatcher(const Singleton<FileWatcher>::PrivatePass&);
+    ~FileWatcher() override; // =default in cpp, where QFileSystemWatcher is complete
+
+    // false when there is no main-thread event loop to deliver events; callers then fall back on polling
+    virtual bool watch(const QString& path, std::function<void()> callback);
+    virtual void unwatch(const QString& path); // drops every subscription on the path
+
+private:
+    void notify(const QString& path);
+
+    std::unique_ptr<QFileSystemWatcher> watcher;
+    std::map<QString, std::vector<std::function<void()>>> subscriptions; // keyed by absolute path
+};
+} // namespace multipass
+#endif // MULTIPASS_FILE_WATCHER_H
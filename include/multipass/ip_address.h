@@ -21,29 +21,98 @@
 #define MULTIPASS_IP_ADDRESS_H
 
 #include <array>
+#include <cstdint>
 #include <string>
 
 namespace multipass
 {
-struct IPAddress
+// An IPv4 address packed into a single uint32, so that comparing addresses, stepping through a range
+// and deriving subnet bounds are plain integer operations, available at compile time; only the
+// conversions from and to dotted-quad strings need runtime work
+class IPAddress
 {
-    IPAddress(std::array<uint8_t, 4> octets);
+public:
+    constexpr IPAddress(std::array<uint8_t, 4> octets)
+        : value{static_cast<uint32_t>(octets[0]) << 24u | static_cast<uint32_t>(octets[1]) << 16u |
+                static_cast<uint32_t>(octets[2]) << 8u | static_cast<uint32_t>(octets[3])}
+    {
+    }
+
     IPAddress(const std::string& ip_string);
-    explicit IPAddress(uint32_t value);
+
+    constexpr explicit IPAddress(uint32_t value) : value{value}
+    {
+    }
+
     IPAddress(const IPAddress& other) = default;
 
     std::string as_string() const;
-    uint32_t as_uint32() const;
 
-    bool operator==(const IPAddress& other) const;
-    bool operator!=(const IPAddress& other) const;
-    bool operator<(const IPAddress& other) const;
-    bool operator<=(const IPAddress& other) const;
-    bool operator>(const IPAddress& other) const;
-    bool operator>=(const IPAddress& other) const;
-    IPAddress operator+(int value) const;
+    constexpr uint32_t as_uint32() const
+    {
+        return value;
+    }
+
+    constexpr std::array<uint8_t, 4> octets() const
+    {
+        return {{static_cast<uint8_t>(value >> 24u), static_cast<uint8_t>(value >> 16u),
+                 static_cast<uint8_t>(value >> 8u), static_cast<uint8_t>(value)}};
+    }
+
+    // bounds of the assignable range within this address' subnet, skipping the network and broadcast
+    // addresses; prefix_length counts the leading network bits, as in CIDR notation
+    constexpr IPAddress first_in_subnet(int prefix_length) const
+    {
+        return IPAddress{(value & subnet_mask(prefix_length)) + 1u};
+    }
+
+    constexpr IPAddress last_in_subnet(int prefix_length) const
+    {
+        return IPAddress{(value | ~subnet_mask(prefix_length)) - 1u};
+    }
+
+    constexpr bool operator==(const IPAddress& other) const
+    {
+        return value == other.value;
+    }
+
+    constexpr bool operator!=(const IPAddress& other) const
+    {
+        return value != other.value;
+    }
+
+    constexpr bool operator<(const IPAddress& other) const
+    {
+        return value < other.value;
+    }
+
+    constexpr bool operator<=(const IPAddress& other) const
+    {
+        return value <= other.value;
+    }
+
+    constexpr bool operator>(const IPAddress& other) const
+    {
+        return value > other.value;
+    }
+
+    constexpr bool operator>=(const IPAddress& other) const
+    {
+        return value >= other.value;
+    }
+
+    constexpr IPAddress operator+(int n) const
+    {
+        return IPAddress{value + static_cast<uint32_t>(n)};
+    }
+
+private:
+    static constexpr uint32_t subnet_mask(int prefix_length)
+    {
+        return prefix_length == 0 ? 0u : ~uint32_t{0} << (32 - prefix_length);
+    }
 
-    std::array<uint8_t, 4> octets;
+    uint32_t value;
 };
 }
 
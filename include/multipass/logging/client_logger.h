@@ -55,6 +55,11 @@ public:
         }
     }
 
+    Level get_logging_level() const override
+    {
+        return logging_level;
+    }
+
 private:
     Level logging_level;
     grpc::ServerWriter<T>* server;
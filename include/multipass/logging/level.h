@@ -19,6 +19,9 @@
 #define MULTIPASS_LEVEL_H
 
 #include <multipass/logging/cstring.h>
+#include <multipass/optional.h>
+
+#include <string>
 
 namespace multipass
 {
@@ -61,6 +64,16 @@ constexpr Level level_from(std::underlying_type_t<Level> in)
     return static_cast<Level>(in);
 }
 
+// the spellings settings and CLI options use, i.e. the inverse of as_string
+inline optional<Level> level_from_name(const std::string& name)
+{
+    for (auto level : {Level::error, Level::warning, Level::info, Level::debug, Level::trace})
+        if (name == as_string(level).c_str())
+            return level;
+
+    return nullopt;
+}
+
 constexpr bool operator<(Level a, Level b) noexcept
 {
     return enum_type(a) < enum_type(b);
@@ -22,12 +22,48 @@
 #include <multipass/logging/level.h>
 #include <multipass/logging/logger.h>
 
+#include <multipass/format.h>
+
+#include <map>
+#include <string>
+#include <utility>
+
 namespace multipass
 {
 namespace logging
 {
 void log(Level level, CString category, CString message);
+Level get_logging_level();
 void set_logger(std::shared_ptr<Logger> logger);
+
+/* Runtime verbosity overrides, keyed by category; the entry with an empty key applies to categories without
+   one of their own. An empty map clears all overrides, restoring the levels the sinks were built with. With
+   no overrides in place, the check in `log` costs a single atomic load */
+void set_level_overrides(const std::map<std::string, Level>& overrides);
+
+/* The formatting variant only renders its message when some sink will actually take it, sparing call sites the fmt
+   work at filtered levels */
+template <typename Arg, typename... Args>
+void log(Level level, CString category, const char* format, Arg&& arg, Args&&... args)
+{
+    if (level <= get_logging_level())
+        log(level, category, fmt::format(format, std::forward<Arg>(arg), std::forward<Args>(args)...));
+}
 } // namespace logging
 } // namespace multipass
+
+/* Trace sites in hot loops go through the macro so that builds can drop them wholesale, argument evaluation and all —
+   define MULTIPASS_COMPILE_LOG_LEVEL below 4 (trace) to compile them away */
+#ifndef MULTIPASS_COMPILE_LOG_LEVEL
+#define MULTIPASS_COMPILE_LOG_LEVEL 4
+#endif
+
+#define MPL_TRACE_LOG(category, ...)                                                                                   \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if constexpr (MULTIPASS_COMPILE_LOG_LEVEL >=                                                                   \
+                      multipass::logging::enum_type(multipass::logging::Level::trace))                                 \
+            multipass::logging::log(multipass::logging::Level::trace, category, __VA_ARGS__);                          \
+    } while (false)
+
 #endif // MULTIPASS_LOG_H
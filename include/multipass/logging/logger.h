@@ -35,6 +35,14 @@ public:
     using UPtr = std::unique_ptr<Logger>;
     virtual ~Logger() = default;
     virtual void log(Level level, CString category, CString message) const = 0;
+    virtual Level get_logging_level() const
+    {
+        return Level::trace; // pass everything through by default, sinks filter for themselves
+    }
+    virtual void set_logging_level(Level)
+    {
+        // sinks that can retune their verbosity at runtime override this
+    }
 
 protected:
     Logger() = default;
@@ -20,6 +20,7 @@
 
 #include "logger.h"
 
+#include <atomic>
 #include <memory>
 #include <shared_mutex>
 #include <vector>
@@ -33,13 +34,18 @@ class MultiplexingLogger : public Logger
 public:
     explicit MultiplexingLogger(UPtr system_logger);
     void log(Level level, CString category, CString message) const override;
+    Level get_logging_level() const override;
+    void set_logging_level(Level level) override;
     void add_logger(const Logger* logger);
     void remove_logger(const Logger* logger);
 
 private:
+    Level compute_level_ceiling() const; // callers hold the exclusive lock
+
     UPtr system_logger;
     mutable std::shared_timed_mutex mutex;
     std::vector<const Logger*> loggers;
+    std::atomic<Level> level_ceiling;
 };
 } // namespace logging
 } // namespace multipass
@@ -20,6 +20,8 @@
 
 #include <multipass/logging/logger.h>
 
+#include <atomic>
+
 namespace multipass
 {
 namespace logging
@@ -29,9 +31,11 @@ class StandardLogger : public Logger
 public:
     StandardLogger(Level level);
     void log(Level level, CString category, CString message) const override;
+    Level get_logging_level() const override;
+    void set_logging_level(Level level) override;
 
 private:
-    Level logging_level;
+    std::atomic<Level> logging_level; // adjustable at runtime, read on every message
 };
 } // namespace logging
 } // namespace multipass
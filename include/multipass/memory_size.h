@@ -18,6 +18,8 @@
 #ifndef MULTIPASS_MEMORY_SIZE_H
 #define MULTIPASS_MEMORY_SIZE_H
 
+#include <multipass/exceptions/invalid_memory_size_exception.h>
+
 #include <string>
 
 namespace multipass
@@ -25,30 +27,120 @@ namespace multipass
 class MemorySize
 {
 public:
-    friend bool operator==(const MemorySize& a, const MemorySize& b);
-    friend bool operator!=(const MemorySize& a, const MemorySize& b);
-    friend bool operator<(const MemorySize& a, const MemorySize& b);
-    friend bool operator>(const MemorySize& a, const MemorySize& b);
-    friend bool operator<=(const MemorySize& a, const MemorySize& b);
-    friend bool operator>=(const MemorySize& a, const MemorySize& b);
-
-    MemorySize();
-    explicit MemorySize(const std::string& val);
-    long long in_bytes() const noexcept;
-    long long in_kilobytes() const noexcept;
-    long long in_megabytes() const noexcept;
-    long long in_gigabytes() const noexcept;
+    constexpr MemorySize() noexcept : bytes{0LL}
+    {
+    }
+
+    /* The constexpr form lets compile-time defaults (e.g. `min_memory_size`) be validated by the compiler: an invalid
+       literal fails constant evaluation instead of throwing at startup */
+    constexpr explicit MemorySize(const char* val) : bytes{parse(val)}
+    {
+    }
+
+    explicit MemorySize(const std::string& val) : bytes{parse(val.c_str())}
+    {
+    }
+
+    constexpr long long in_bytes() const noexcept
+    {
+        return bytes;
+    }
+
+    constexpr long long in_kilobytes() const noexcept
+    {
+        return bytes / kilo; // integer division to floor
+    }
+
+    constexpr long long in_megabytes() const noexcept
+    {
+        return bytes / mega; // integer division to floor
+    }
+
+    constexpr long long in_gigabytes() const noexcept
+    {
+        return bytes / giga; // integer division to floor
+    }
 
 private:
+    static constexpr auto kilo = 1024LL;
+    static constexpr auto mega = kilo * kilo;
+    static constexpr auto giga = mega * kilo;
+
+    // A single pass over `<digits>[KMG][B]` (case insensitive), equivalent to the old `(\d+)([KMG])?B?` regex but with
+    // no Qt types and no allocation
+    static constexpr long long parse(const char* val)
+    {
+        const char* cursor = val;
+
+        long long digits = 0LL;
+        bool seen_digit = false;
+        for (; *cursor >= '0' && *cursor <= '9'; ++cursor)
+        {
+            digits = digits * 10 + (*cursor - '0');
+            seen_digit = true;
+        }
+
+        long long multiplier = 1LL;
+        switch (*cursor)
+        {
+        case 'g':
+        case 'G':
+            multiplier = giga;
+            ++cursor;
+            break;
+        case 'm':
+        case 'M':
+            multiplier = mega;
+            ++cursor;
+            break;
+        case 'k':
+        case 'K':
+            multiplier = kilo;
+            ++cursor;
+            break;
+        }
+
+        if (*cursor == 'b' || *cursor == 'B')
+            ++cursor;
+
+        if (!seen_digit || *cursor != '\0')
+            throw InvalidMemorySizeException{val};
+
+        return digits * multiplier;
+    }
+
     long long bytes;
 };
 
-bool operator==(const MemorySize& a, const MemorySize& b);
-bool operator!=(const MemorySize& a, const MemorySize& b);
-bool operator<(const MemorySize& a, const MemorySize& b);
-bool operator>(const MemorySize& a, const MemorySize& b);
-bool operator<=(const MemorySize& a, const MemorySize& b);
-bool operator>=(const MemorySize& a, const MemorySize& b);
+constexpr bool operator==(const MemorySize& a, const MemorySize& b) noexcept
+{
+    return a.in_bytes() == b.in_bytes();
+}
+
+constexpr bool operator!=(const MemorySize& a, const MemorySize& b) noexcept
+{
+    return a.in_bytes() != b.in_bytes();
+}
+
+constexpr bool operator<(const MemorySize& a, const MemorySize& b) noexcept
+{
+    return a.in_bytes() < b.in_bytes();
+}
+
+constexpr bool operator>(const MemorySize& a, const MemorySize& b) noexcept
+{
+    return a.in_bytes() > b.in_bytes();
+}
+
+constexpr bool operator<=(const MemorySize& a, const MemorySize& b) noexcept
+{
+    return a.in_bytes() <= b.in_bytes();
+}
+
+constexpr bool operator>=(const MemorySize& a, const MemorySize& b) noexcept
+{
+    return a.in_bytes() >= b.in_bytes();
+}
 
 } // namespace multipass
 
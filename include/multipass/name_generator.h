@@ -20,7 +20,9 @@
 #ifndef MULTIPASS_NAME_GENERATOR_H
 #define MULTIPASS_NAME_GENERATOR_H
 
+#include <functional>
 #include <memory>
+#include <stdexcept>
 #include <string>
 
 namespace multipass
@@ -32,6 +34,21 @@ public:
     virtual ~NameGenerator() = default;
     virtual std::string make_name() = 0;
 
+    /// Generates a name for which is_free returns true. The predicate is the caller's reservation check over
+    /// its registry; as long as the caller claims the returned name before releasing whatever guards that
+    /// registry, the name cannot be handed out twice.
+    virtual std::string make_name(const std::function<bool(const std::string&)>& is_free)
+    {
+        constexpr auto num_retries = 100;
+        for (auto i = 0; i < num_retries; ++i)
+        {
+            auto candidate = make_name();
+            if (is_free(candidate))
+                return candidate;
+        }
+        throw std::runtime_error("unable to generate a unique name");
+    }
+
 protected:
     NameGenerator() = default;
     NameGenerator(const NameGenerator&) = delete;
@@ -0,0 +1,42 @@
+/*
+ * Copyright (C) 2020 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MULTIPASS_PAGE_CACHE_H
+#define MULTIPASS_PAGE_CACHE_H
+
+#include <fcntl.h>
+
+namespace multipass
+{
+namespace utils
+{
+// how much streamed data to let accumulate between drop_io_cache calls; frequent enough to bound the
+// cache footprint, rare enough that the writeback kicks stay batched
+constexpr long long drop_behind_window = 16 * 1024 * 1024;
+
+/* Best-effort drop-behind for bulk streaming I/O. Multi-GB image transfers are written (or read) once
+   and never touched again, yet left alone they evict the page cache that running guests depend on.
+   Dirty pages are only evictable once written back, so writeback is kicked without waiting for it —
+   pages still in flight are simply picked up by the next call. */
+inline void drop_io_cache(int fd, long long up_to)
+{
+    ::sync_file_range(fd, 0, up_to, SYNC_FILE_RANGE_WRITE);
+    ::posix_fadvise(fd, 0, up_to, POSIX_FADV_DONTNEED);
+}
+} // namespace utils
+} // namespace multipass
+#endif // MULTIPASS_PAGE_CACHE_H
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2020 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MULTIPASS_PERFORMANCE_COUNTERS_H
+#define MULTIPASS_PERFORMANCE_COUNTERS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace multipass
+{
+namespace perf
+{
+// Operational counters and latency histograms for monitoring the daemon like any other service,
+// distinct from MetricsProvider's opt-in usage pings. Entries are created on first use and then
+// only ever bumped, so updates are plain atomic adds; the mutex guards the maps themselves.
+class PerformanceCounters
+{
+public:
+    static PerformanceCounters& instance();
+
+    void increment(const std::string& name, std::uint64_t amount = 1);
+    void record_duration(const std::string& name, std::chrono::microseconds elapsed);
+
+    std::string prometheus_text() const; // the Prometheus exposition format, one metric per entry
+
+    struct DurationStats
+    {
+        static constexpr std::size_t num_buckets = 18; // exponential: 1ms doubling to ~65s, then +Inf
+
+        std::atomic<std::uint64_t> count{0};
+        std::atomic<std::uint64_t> sum_usecs{0};
+        std::array<std::atomic<std::uint64_t>, num_buckets> buckets{};
+    };
+
+private:
+    PerformanceCounters() = default;
+
+    mutable std::mutex mutex;
+    std::map<std::string, std::unique_ptr<std::atomic<std::uint64_t>>> counters;
+    std::map<std::string, std::unique_ptr<DurationStats>> durations;
+};
+} // namespace perf
+} // namespace multipass
+
+#endif // MULTIPASS_PERFORMANCE_COUNTERS_H
@@ -59,6 +59,8 @@ logging::Logger::UPtr make_logger(logging::Level level);
 UpdatePrompt::UPtr make_update_prompt();
 std::unique_ptr<Process> make_sshfs_server_process(const SSHFSServerConfig& config);
 int chown(const char* path, unsigned int uid, unsigned int gid);
+bool copy_file_sparse(const QString& source, const QString& destination); /* reflinks the file where the filesystem
+                 supports it, otherwise copies data extents only, keeping holes; false means fall back to QFile::copy */
 bool symlink(const char* target, const char* link, bool is_dir);
 bool link(const char* target, const char* link);
 int utime(const char* path, int atime, int mtime);
@@ -93,6 +93,10 @@ public:
 
     virtual bool running() const = 0;
     virtual ProcessState process_state() const = 0;
+    virtual qint64 process_id() const
+    { // only meaningful while running; 0 when unknown or not applicable
+        return 0;
+    }
 
     virtual QByteArray read_all_standard_output() = 0;
     virtual QByteArray read_all_standard_error() = 0;
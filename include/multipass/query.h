@@ -38,6 +38,7 @@ public:
     std::string remote_name;
     Type query_type;
     bool allow_unsupported{false};
+    bool full_copy{false};
 };
 }
 #endif // MULTIPASS_QUERY_H
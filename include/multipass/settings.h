@@ -18,6 +18,7 @@
 #ifndef MULTIPASS_SETTINGS_H
 #define MULTIPASS_SETTINGS_H
 
+#include "constants.h"
 #include "exceptions/settings_exceptions.h"
 #include "singleton.h"
 
@@ -25,11 +26,33 @@
 #include <QVariant>
 
 #include <map>
+#include <memory>
 #include <mutex>
 #include <set>
+#include <type_traits>
 
 namespace multipass
 {
+template <typename T>
+struct SettingSpec
+{
+    const char* key;
+};
+
+namespace settings
+{ /* Typed descriptors over the keys in constants.h. Reads through these cannot misname a key — a typo fails to
+     compile instead of throwing InvalidSettingsException mid-request — and carry the type callers expect */
+constexpr SettingSpec<QString> petenv{petenv_key};
+constexpr SettingSpec<QString> driver{driver_key};
+constexpr SettingSpec<bool> autostart{autostart_key};
+constexpr SettingSpec<QString> winterm{winterm_key};
+constexpr SettingSpec<QString> bandwidth{bandwidth_key};
+constexpr SettingSpec<QString> vault_size{vault_size_key};
+constexpr SettingSpec<QString> idle_suspend{idle_suspend_key}; // a string, since empty doubles as "disabled"
+constexpr SettingSpec<QString> mirror{mirror_key};
+constexpr SettingSpec<QString> log_level{log_level_key};
+} // namespace settings
+
 class Settings : public Singleton<Settings>
 {
 public:
@@ -42,6 +65,15 @@ public:
     template <typename T>
     T get_as(const QString& key) const;
 
+    template <typename T>
+    T get(const SettingSpec<T>& setting) const
+    {
+        if constexpr (std::is_same_v<T, QString>)
+            return get(QString{setting.key}); // no need for the QVariant round trip
+        else
+            return get_as<T>(setting.key);
+    }
+
     static QString get_daemon_settings_file_path(); // temporary
     static QString get_client_settings_file_path(); // idem
 
@@ -49,9 +81,16 @@ protected:
     const QString& get_default(const QString& key) const; // throws on unknown key
 
 private:
+    using Cache = std::map<QString, QString>;
+
     void set_aux(const QString& key, QString val);
+    void cache_value(const QString& key, const QString& val) const;
+    void invalidate_cache() const;
+    bool ensure_watching(const QString& file) const; // call with the mutex held
 
     std::map<QString, QString> defaults;
+    mutable std::shared_ptr<const Cache> cache; // swapped atomically as a whole, so `get` reads without locking
+    mutable std::set<QString> watching;         // files already subscribed with the FileWatcher
     mutable std::mutex mutex;
 };
 } // namespace multipass
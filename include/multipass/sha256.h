@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2020 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MULTIPASS_SHA256_H
+#define MULTIPASS_SHA256_H
+
+#include <QByteArray>
+
+#include <memory>
+
+class QIODevice;
+
+namespace multipass
+{
+// Streaming SHA-256, backed by the vendored crypto library so that the hardware kernels it dispatches to
+// at runtime (SHA extensions, AVX2, NEON) are used on the image hashing hot paths
+class Sha256
+{
+public:
+    Sha256();
+    ~Sha256();
+
+    void add_data(const QByteArray& data);
+    bool add_data(QIODevice* device); // returns false if reading from the device fails
+    QByteArray result();              // the hex-encoded digest; resets the hash for reuse
+    void reset();
+
+    static QByteArray hash(const QByteArray& data);
+
+private:
+    struct Context;
+    std::unique_ptr<Context> context;
+};
+} // namespace multipass
+#endif // MULTIPASS_SHA256_H
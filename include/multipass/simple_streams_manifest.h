@@ -23,10 +23,11 @@
 #include <multipass/vm_image_info.h>
 
 #include <QByteArray>
-#include <QMap>
+#include <QJsonDocument>
 #include <QString>
 
 #include <memory>
+#include <utility>
 #include <vector>
 
 namespace multipass
@@ -37,10 +38,21 @@ struct SimpleStreamsManifest
     SimpleStreamsManifest(const SimpleStreamsManifest&) = delete;
     SimpleStreamsManifest& operator=(const SimpleStreamsManifest&) = delete;
     static std::unique_ptr<SimpleStreamsManifest> fromJson(const QByteArray& json, const QString& host_url);
+    // overload for documents that were already parsed, e.g. loaded from a binary cache
+    static std::unique_ptr<SimpleStreamsManifest> fromJson(const QJsonDocument& doc, const QString& host_url);
+
+    using IndexEntry = std::pair<QString, const VMImageInfo*>;
+
+    const VMImageInfo* find_image_record(const QString& key) const; // alias/hash → record; null when absent
+    const VMImageInfo* find_product(const QString& id) const;       // idem, by id only
 
     const QString updated_at;
     const std::vector<VMImageInfo> products;
-    const QMap<QString, const VMImageInfo*> image_records;
+    /* Both indexes are sorted flat vectors over `products` instead of node-based maps: one contiguous
+       allocation each, searched by bisection, and the keys share the product strings' data. Thousands of
+       QMap/QHash nodes for release+daily showed up noticeably in the daemon's heap profile */
+    const std::vector<IndexEntry> image_records; // by alias and hash
+    const std::vector<IndexEntry> products_by_id; // sorted, so hash prefixes cover contiguous ranges
 };
 }
 #endif // MULTIPASS_SIMPLE_STREAMS_MANIFEST_H
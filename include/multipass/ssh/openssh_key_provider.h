@@ -23,6 +23,7 @@
 
 #include <QDir>
 #include <memory>
+#include <string>
 
 namespace multipass
 {
@@ -42,7 +43,10 @@ public:
 
 private:
     QDir ssh_key_dir;
+    QString priv_key_path;
     KeyUPtr priv_key;
+    std::string priv_key_contents; // the key never changes once created, so read the file only once
+    std::string pub_key_base64;    // idem for the public half, exported per launch and in identity paths
 };
 }
 #endif // MULTIPASS_OPENSSH_KEY_PROVIDER_H
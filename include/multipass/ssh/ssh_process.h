@@ -23,6 +23,7 @@
 #include <libssh/libssh.h>
 
 #include <chrono>
+#include <functional>
 #include <memory>
 #include <string>
 
@@ -32,6 +33,7 @@ class SSHProcess
 {
 public:
     using ChannelUPtr = std::unique_ptr<ssh_channel_struct, void (*)(ssh_channel)>;
+    using ChunkConsumer = std::function<void(const char* data, std::size_t size)>;
 
     SSHProcess(ssh_session ssh_session, const std::string& cmd);
 
@@ -39,6 +41,11 @@ public:
     std::string read_std_output();
     std::string read_std_error();
 
+    /* Streaming counterparts of the reads above: chunks are handed to the consumer as they come off the
+       channel, so arbitrarily large outputs flow through one fixed-size buffer instead of accumulating */
+    void consume_std_output(const ChunkConsumer& consumer);
+    void consume_std_error(const ChunkConsumer& consumer);
+
 private:
     enum class StreamType
     {
@@ -47,6 +54,7 @@ private:
     };
 
     std::string read_stream(StreamType type, int timeout = -1);
+    void consume_stream(StreamType type, const ChunkConsumer& consumer, int timeout = -1);
     ssh_channel release_channel();
 
     ssh_session session;
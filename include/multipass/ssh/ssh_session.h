@@ -35,9 +35,12 @@ public:
     SSHSession(const std::string& host, int port, const std::chrono::milliseconds timeout = std::chrono::seconds(1));
     SSHSession(const std::string& host, int port, const std::string& ssh_username, const SSHKeyProvider& key_provider,
                const std::chrono::milliseconds timeout = std::chrono::seconds(20));
+    // for clients holding a key blob (as handed out over the rpc) rather than a provider
+    SSHSession(const std::string& host, int port, const std::string& ssh_username, const std::string& priv_key_blob);
 
     SSHProcess exec(const std::string& cmd);
 
+    bool is_connected() const;
     void force_shutdown();
     operator ssh_session() const;
 
@@ -22,9 +22,13 @@
 
 #include <libssh/sftp.h>
 
+#include <chrono>
+#include <future>
 #include <memory>
+#include <string>
 #include <unordered_map>
 
+#include <QByteArray>
 #include <QFile>
 #include <QFileInfo>
 
@@ -50,6 +54,36 @@ public:
     using SSHFSProcUptr = std::unique_ptr<SSHProcess>;
 
 private:
+    // Per-handle buffering state: a read-ahead block serving sequential reads from memory, and a
+    // coalescing buffer turning runs of adjacent writes into fewer, larger writes to the filesystem
+    struct HandleIo
+    {
+        QByteArray read_buffer;
+        qint64 read_buffer_offset{0};
+        qint64 next_sequential_read{0};
+        std::future<QByteArray> read_ahead_future; // next block, fetched while the current one drains
+        qint64 read_ahead_future_offset{-1};
+        QByteArray write_buffer;
+        qint64 write_buffer_offset{-1}; // file offset of the first buffered byte; -1 when nothing is buffered
+        bool write_error{false};
+    };
+
+    // Attributes served recently, so repeated stats of the same paths (think ls -lR, or a build
+    // system scanning sources) skip the filesystem; entries expire quickly and operations going
+    // through this server that change a path drop its entry eagerly
+    struct CachedAttributes
+    {
+        sftp_attributes_struct attr;
+        bool follow;
+        std::chrono::steady_clock::time_point expiry;
+    };
+
+    bool flush_writes(QFile* file, HandleIo& io);
+    void flush_all_writes();
+
+    void cache_attributes(const std::string& path, const sftp_attributes_struct& attr, bool follow);
+    void invalidate_attributes(const std::string& path);
+
     void process_message(sftp_client_message msg);
     sftp_attributes_struct attr_from(const QFileInfo& file_info);
     int mapped_uid_for(const int uid);
@@ -80,6 +114,10 @@ private:
     const std::string target_path;
     std::unordered_map<void*, std::unique_ptr<QFileInfoList>> open_dir_handles;
     std::unordered_map<void*, std::unique_ptr<QFile>> open_file_handles;
+    std::unordered_map<QFile*, HandleIo> handle_io;
+    QByteArray random_read_buffer; // grow-only scratch for non-sequential reads; the sftp reply copies it out
+                                   // synchronously, so a single buffer can serve the whole message loop
+    std::unordered_map<std::string, CachedAttributes> attribute_cache;
     const std::unordered_map<int, int> gid_map;
     const std::unordered_map<int, int> uid_map;
     const int default_uid;
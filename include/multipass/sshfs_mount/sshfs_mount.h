@@ -19,6 +19,7 @@
 #define MULTIPASS_SSHFS_MOUNT
 
 #include <memory>
+#include <string>
 #include <thread>
 #include <unordered_map>
 
@@ -29,8 +30,11 @@ class SftpServer;
 class SshfsMount
 {
 public:
+    // A non-empty sshfs_exec_line is used as the sshfs invocation verbatim, skipping the in-guest probes;
+    // either way, the invocation in effect is announced on stdout so the daemon can cache it
     SshfsMount(SSHSession&& session, const std::string& source, const std::string& target,
-               const std::unordered_map<int, int>& gid_map, const std::unordered_map<int, int>& uid_map);
+               const std::unordered_map<int, int>& gid_map, const std::unordered_map<int, int>& uid_map,
+               std::string sshfs_exec_line = {});
     SshfsMount(SshfsMount&& other);
     ~SshfsMount();
 
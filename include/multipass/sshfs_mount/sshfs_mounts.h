@@ -45,9 +45,27 @@ public:
     bool has_instance_already_mounted(const std::string& instance, const std::string& path) const;
 
 private:
+    // What it takes to bring a mount back up if its server process dies underneath us
+    struct MountDetails
+    {
+        VirtualMachine* vm;
+        std::string source_path;
+        std::unordered_map<int, int> gid_map;
+        std::unordered_map<int, int> uid_map;
+        int restart_attempts{0};
+    };
+
+    void start_mount_process(VirtualMachine* vm, const std::string& source_path, const std::string& target_path,
+                             const std::unordered_map<int, int>& gid_map,
+                             const std::unordered_map<int, int>& uid_map);
+
     const std::string key;
     std::unordered_map<std::string, std::unordered_map<std::string, qt_delete_later_unique_ptr<Process>>>
         mount_processes;
+    std::unordered_map<std::string, std::unordered_map<std::string, MountDetails>> mount_details;
+    // sshfs invocation each instance's first mount probed for, handed to further server processes so they
+    // skip the guest execs; dropped with the instance's mounts, as the image can only change past that point
+    std::unordered_map<std::string, std::string> sshfs_exec_cache;
 };
 
 } // namespace multipass
@@ -35,6 +35,9 @@ struct SSHFSServerConfig
     std::string target_path;
     std::unordered_map<int, int> gid_map;
     std::unordered_map<int, int> uid_map;
+    // Full sshfs invocation (executable plus options) probed on an earlier mount of the same instance;
+    // when set, the server skips the in-guest detection and version execs and uses this directly
+    std::string sshfs_exec_line;
 };
 
 } // namespace multipass
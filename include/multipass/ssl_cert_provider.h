@@ -19,6 +19,7 @@
 #define MULTIPASS_SSL_CERT_PROVIDER_H
 
 #include <multipass/cert_provider.h>
+#include <multipass/optional.h>
 #include <multipass/path.h>
 
 #include <string>
@@ -40,7 +41,11 @@ public:
     std::string PEM_signing_key() const override;
 
 private:
-    KeyCertificatePair key_cert_pair;
+    KeyCertificatePair& pair() const;
+
+    const Path cert_dir;
+    const std::string server_name;
+    mutable optional<KeyCertificatePair> key_cert_pair;
 };
 } // namespace multipass
 #endif // MULTIPASS_SSL_CERT_PROVIDER_H
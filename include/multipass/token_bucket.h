@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2020 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MULTIPASS_TOKEN_BUCKET_H
+#define MULTIPASS_TOKEN_BUCKET_H
+
+#include <QtGlobal>
+
+#include <chrono>
+#include <mutex>
+
+namespace multipass
+{
+/*
+ * Byte-rate limiter. Tokens accrue at the configured rate up to a burst's worth; consumers that find
+ * the bucket short are told how long to back off. Concurrent transfers drawing from the same bucket
+ * share the cap between them.
+ */
+class TokenBucket
+{
+public:
+    void set_rate(qint64 bytes_per_second); // 0 (the initial state) lifts the limit
+    qint64 rate() const;
+    qint64 burst() const; // how many bytes the bucket holds when full
+
+    // zero means go ahead; anything else means wait that long and ask again
+    std::chrono::milliseconds consume(qint64 bytes);
+
+private:
+    mutable std::mutex mutex;
+    qint64 bytes_per_second{0};
+    double tokens{0};
+    std::chrono::steady_clock::time_point last_refill;
+};
+} // namespace multipass
+#endif // MULTIPASS_TOKEN_BUCKET_H
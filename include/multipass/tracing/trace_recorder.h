@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2020 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MULTIPASS_TRACE_RECORDER_H
+#define MULTIPASS_TRACE_RECORDER_H
+
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace multipass
+{
+namespace tracing
+{
+struct SpanEvent
+{
+    const char* name; // expected to point at a string literal
+    std::size_t thread_id;
+    std::chrono::microseconds timestamp; // relative to the recorder's epoch
+    std::chrono::microseconds duration;
+};
+
+// Keeps a bounded, in-memory record of how long the coarse stages of an operation took, so that a
+// slow launch can be diagnosed after the fact without rerunning it under external tooling
+class TraceRecorder
+{
+public:
+    static TraceRecorder& instance();
+
+    void record(const char* name, std::chrono::steady_clock::time_point begin,
+                std::chrono::steady_clock::time_point end);
+    std::string chrome_trace_json() const; // trace-event format, loadable in chrome://tracing
+    void clear();
+
+private:
+    TraceRecorder();
+
+    static constexpr std::size_t max_events = 8192; // ring: old spans give way so a dump stays bounded
+
+    const std::chrono::steady_clock::time_point epoch;
+    mutable std::mutex mutex;
+    std::vector<SpanEvent> events;
+    std::size_t next_slot{0};
+};
+
+class ScopedSpan
+{
+public:
+    explicit ScopedSpan(const char* name) : name{name}, begin{std::chrono::steady_clock::now()}
+    {
+    }
+
+    ~ScopedSpan()
+    {
+        TraceRecorder::instance().record(name, begin, std::chrono::steady_clock::now());
+    }
+
+    ScopedSpan(const ScopedSpan&) = delete;
+    ScopedSpan& operator=(const ScopedSpan&) = delete;
+
+private:
+    const char* name;
+    const std::chrono::steady_clock::time_point begin;
+};
+} // namespace tracing
+} // namespace multipass
+
+#define MULTIPASS_TRACE_CAT_(a, b) a##b
+#define MULTIPASS_TRACE_CAT(a, b) MULTIPASS_TRACE_CAT_(a, b)
+
+// The span covers the rest of the enclosing scope; name must be a string literal
+#define MP_TRACE_SPAN(name)                                                                                            \
+    multipass::tracing::ScopedSpan MULTIPASS_TRACE_CAT(multipass_trace_span_, __LINE__)                                \
+    {                                                                                                                  \
+        name                                                                                                           \
+    }
+
+#endif // MULTIPASS_TRACE_RECORDER_H
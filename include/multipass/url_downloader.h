@@ -20,17 +20,23 @@
 
 #include <multipass/path.h>
 #include <multipass/progress_monitor.h>
+#include <multipass/token_bucket.h>
 
 #include <QByteArray>
 #include <QDateTime>
+#include <QHash>
+#include <QString>
 
 #include <atomic>
 #include <chrono>
+#include <mutex>
+#include <string>
 
 class QUrl;
-class QString;
 namespace multipass
 {
+class DataSink;
+
 class URLDownloader
 {
 public:
@@ -39,9 +45,16 @@ public:
     virtual ~URLDownloader() = default;
     virtual void download_to(const QUrl& url, const QString& file_name, int64_t size, const int download_type,
                              const ProgressMonitor& monitor);
+    // as above, but each chunk is also handed to sink as it lands, ahead of the transfer completing
+    virtual void download_to(const QUrl& url, const QString& file_name, int64_t size, const int download_type,
+                             const ProgressMonitor& monitor, DataSink* sink);
     virtual QByteArray download(const QUrl& url);
     virtual QDateTime last_modified(const QUrl& url);
     virtual void abort_all_downloads();
+    // caps all of this downloader's transfers together, shared fairly between them; 0 lifts the cap
+    virtual void set_bandwidth_limit(qint64 bytes_per_second);
+    // consumes the SHA256 digest computed while file_name was downloading; empty if none was recorded
+    virtual std::string sha256_checksum(const QString& file_name);
 
 protected:
     std::atomic_bool abort_download{false};
@@ -52,6 +65,9 @@ private:
 
     const Path cache_dir_path;
     std::chrono::milliseconds timeout;
+    TokenBucket throttle;
+    QHash<QString, QByteArray> checksums;
+    std::mutex checksum_mutex;
 };
 }
 #endif // MULTIPASS_URL_DOWNLOADER_H
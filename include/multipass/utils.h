@@ -33,6 +33,8 @@
 #include <vector>
 
 #include <QDir>
+#include <QFile>
+#include <QJsonDocument>
 #include <QString>
 #include <QStringList>
 #include <QVariant>
@@ -68,6 +70,7 @@ QString backend_directory_path(const Path& path, const QString& subdirectory);
 std::string filename_for(const std::string& path);
 std::string contents_of(const multipass::Path& file_path);
 bool invalid_target_path(const QString& target_path);
+QJsonDocument load_json_document(QFile& file, QJsonParseError* parse_error); // maps the file rather than copying it
 
 // special-file helpers
 void link_autostart_file(const QDir& link_dir, const QString& autostart_subdir, const QString& autostart_filename);
@@ -85,6 +88,7 @@ bool process_log_on_error(const QString& program, const QStringList& arguments,
 
 // networking helpers
 void validate_server_address(const std::string& value);
+bool is_local_socket_address(const std::string& address);
 bool valid_hostname(const std::string& name_string);
 std::string generate_mac_address();
 
@@ -136,15 +140,18 @@ void multipass::utils::try_action_for(OnTimeoutCallable&& on_timeout, std::chron
     using namespace std::literals::chrono_literals;
 
     auto deadline = std::chrono::steady_clock::now() + timeout;
+    auto backoff = 100ms; // poll quickly at first for low latency, then back off to spare the CPU
     while (std::chrono::steady_clock::now() < deadline)
     {
         if (try_action(std::forward<Args>(args)...) == TimeoutAction::done)
             return;
 
-        if ((std::chrono::steady_clock::now() + 1s) >= deadline)
+        if ((std::chrono::steady_clock::now() + backoff) >= deadline)
             break;
 
-        std::this_thread::sleep_for(1s);
+        std::this_thread::sleep_for(backoff);
+        if (backoff < 1s)
+            backoff *= 2;
     }
     on_timeout();
 }
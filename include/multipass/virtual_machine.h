@@ -18,6 +18,9 @@
 #ifndef MULTIPASS_VIRTUAL_MACHINE_H
 #define MULTIPASS_VIRTUAL_MACHINE_H
 
+#include <multipass/memory_size.h>
+#include <multipass/optional.h>
+
 #include <chrono>
 #include <condition_variable>
 #include <memory>
@@ -61,6 +64,54 @@ public:
     virtual void wait_until_ssh_up(std::chrono::milliseconds timeout) = 0;
     virtual void ensure_vm_is_running() = 0;
     virtual void update_state() = 0;
+    virtual void update_resources(int /*num_cores*/, const MemorySize& /*mem_size*/)
+    { // backends that can apply a resize pick the new values up on the next boot; the rest ignore the request
+    }
+    virtual void update_io_limits(long long /*iops*/, long long /*bytes_per_second*/)
+    { // hypervisor-enforced disk throttles (0 lifts them); backends that can enforce them override, the rest ignore
+    }
+    virtual optional<std::string> run_in_guest(const std::string& /*cmd*/)
+    { /* output of a command run over a guest-agent channel, bypassing SSH and guest networking entirely;
+         backends without such a channel (or whose agent does not answer) return nullopt, and callers fall
+         back on SSH */
+        return nullopt;
+    }
+
+    virtual bool take_live_snapshot(const std::string& /*snapshot_name*/)
+    { /* disk snapshot of a running instance, quiescing the guest's filesystems around it when an agent
+         channel is available; backends without live snapshot support return false and callers fall back
+         on requiring the instance stopped */
+        return false;
+    }
+
+    // What the hypervisor process costs the host, as the host sees it — available even when the guest hangs
+    struct HostResourceUsage
+    {
+        double cpu_seconds;     // user + system time consumed by the process
+        long long rss_bytes;    // resident set size
+        long long io_read_bytes{-1};  // bytes fetched from the storage layer; -1 when unavailable
+        long long io_write_bytes{-1}; // bytes sent to the storage layer; idem
+        long long net_rx_bytes{-1};   // bytes the instance's network device received; idem
+        long long net_tx_bytes{-1};   // bytes the instance's network device sent; idem
+    };
+    virtual optional<HostResourceUsage> host_resource_usage()
+    { // backends that own the hypervisor process override this; the rest have nothing to report
+        return nullopt;
+    }
+
+    /* Disk compaction, in two phases so the slow one can run off the daemon thread: prepare rewrites the
+       disk into a compact copy, shedding the dead clusters a long-lived guest accrues (the original is
+       only read, so a concurrent start merely wastes the work), and commit swaps the copy in, returning
+       the bytes reclaimed — or discards it if the instance came up in between. Backends whose storage
+       cannot be compacted this way leave both as no-ops. */
+    virtual bool prepare_disk_compaction()
+    {
+        return false;
+    }
+    virtual long long commit_disk_compaction()
+    {
+        return 0;
+    }
 
     VirtualMachine::State state;
     const std::string vm_name;
@@ -30,6 +30,25 @@
 namespace multipass
 {
 class SSHKeyProvider;
+
+// Hypervisor-enforced limits on the instance's disk I/O, so one noisy instance cannot starve its
+// neighbours. Each limit covers reads and writes combined; 0 means unlimited.
+struct IoLimits
+{
+    long long iops = 0;
+    long long bytes_per_second = 0;
+};
+
+inline bool operator==(const IoLimits& a, const IoLimits& b)
+{
+    return a.iops == b.iops && a.bytes_per_second == b.bytes_per_second;
+}
+
+inline bool operator!=(const IoLimits& a, const IoLimits& b)
+{
+    return !(a == b);
+}
+
 class VirtualMachineDescription
 {
 public:
@@ -46,6 +65,7 @@ public:
     YAML::Node meta_data_config;
     YAML::Node user_data_config;
     YAML::Node vendor_data_config;
+    IoLimits io_limits;
 };
 } // namespace multipass
 
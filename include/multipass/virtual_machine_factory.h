@@ -54,6 +54,8 @@ public:
     virtual FetchType fetch_type() = 0;
     virtual VMImage prepare_source_image(const VMImage& source_image) = 0;
     virtual void prepare_instance_image(const VMImage& instance_image, const VirtualMachineDescription& desc) = 0;
+    virtual void snapshot_instance_image(const VMImage& instance_image, const std::string& snapshot_name) = 0;
+    virtual void restore_instance_image(const VMImage& instance_image, const std::string& snapshot_name) = 0;
     virtual void configure(const std::string& name, YAML::Node& meta_config, YAML::Node& user_config) = 0;
     virtual void hypervisor_health_check() = 0;
     virtual QString get_backend_directory_name() = 0;
@@ -20,6 +20,7 @@
 #ifndef MULTIPASS_VIRTUAL_MACHINE_IMAGE_H
 #define MULTIPASS_VIRTUAL_MACHINE_IMAGE_H
 
+#include <multipass/copy_counter.h>
 #include <multipass/path.h>
 
 #include <vector>
@@ -38,6 +39,8 @@ public:
     std::string current_release;
     std::string release_date;
     std::vector<std::string> aliases;
+
+    MP_COUNT_COPIES(VMImage);
 };
 }
 #endif // MULTIPASS_VIRTUAL_MACHINE_IMAGE_H
@@ -42,6 +42,12 @@ public:
     virtual void for_each_entry_do(const Action& action) = 0;
     virtual std::vector<std::string> supported_remotes() = 0;
 
+    // an opaque stamp that changes whenever this host's catalog may have; empty when the host cannot tell
+    virtual std::string catalog_version()
+    {
+        return {};
+    }
+
 protected:
     VMImageHost() = default;
     VMImageHost(const VMImageHost&) = delete;
@@ -21,8 +21,11 @@
 #include <multipass/fetch_type.h>
 #include <multipass/progress_monitor.h>
 
+#include <QtGlobal>
+
 #include <functional>
 #include <memory>
+#include <vector>
 
 namespace multipass
 {
@@ -38,11 +41,19 @@ public:
     virtual ~VMImageVault() = default;
     virtual VMImage fetch_image(const FetchType& fetch_type, const Query& query, const PrepareAction& prepare,
                                 const ProgressMonitor& monitor) = 0;
+    virtual VMImage clone_image(const std::string& source_name, const std::string& destination_name) = 0;
+    virtual VMImage rename_image(const std::string& source_name, const std::string& destination_name) = 0;
     virtual void remove(const std::string& name) = 0;
     virtual bool has_record_for(const std::string& name) = 0;
     virtual void prune_expired_images() = 0;
+    // best effort; vaults managing a local cache evict least-recently-used images on prune to stay under it
+    virtual void set_size_budget(qint64 /*bytes*/)
+    {
+    }
     virtual void update_images(const FetchType& fetch_type, const PrepareAction& prepare,
                                const ProgressMonitor& monitor) = 0;
+    virtual void prefetch_images(const std::vector<Query>& tracked_queries, const FetchType& fetch_type,
+                                 const PrepareAction& prepare, const ProgressMonitor& monitor) = 0;
 
 protected:
     VMImageVault() = default;
@@ -18,6 +18,8 @@
 #ifndef MULTIPASS_XZ_IMAGE_DECODER_H
 #define MULTIPASS_XZ_IMAGE_DECODER_H
 
+#include <multipass/aligned_allocator.h>
+#include <multipass/data_sink.h>
 #include <multipass/path.h>
 #include <multipass/progress_monitor.h>
 
@@ -42,5 +44,24 @@ private:
     QFile xz_file;
     XzDecoderUPtr xz_decoder;
 };
+
+// Push-style counterpart to XzImageDecoder: compressed bytes are fed in as they arrive (e.g. straight from
+// a download) and the decoded output is written out incrementally, sparing a separate extraction pass
+class XzStreamDecoder final : public DataSink
+{
+public:
+    explicit XzStreamDecoder(const Path& decoded_file_path);
+
+    void write(const QByteArray& data) override; // throws on decode or write errors
+    void restart() override;
+    void finish(); // throws unless a complete xz stream was consumed
+
+private:
+    QFile decoded_file;
+    XzImageDecoder::XzDecoderUPtr xz_decoder;
+    utils::IOBuffer out_buf; // aligned like the batch decoder's chunks, so decoded writes land in aligned units
+    bool stream_ended{false};
+    qint64 bytes_since_drop{0}; // decoded output streamed since the page cache was last dropped behind us
+};
 } // namespace multipass
 #endif // MULTIPASS_XZ_IMAGE_DECODER_H
@@ -23,8 +23,10 @@
 #include <openssl/pem.h>
 #include <openssl/x509.h>
 
+#include <QCryptographicHash>
 #include <QDir>
 #include <QFile>
+#include <QFileInfo>
 
 #include <stdexcept>
 
@@ -33,6 +35,30 @@ namespace mp = multipass;
 namespace
 {
 constexpr auto chain_name = "multipass_client_certs.pem";
+constexpr auto cert_end_marker = "-----END CERTIFICATE-----";
+
+std::string fingerprint_of(const std::string& pem_cert)
+{
+    return QCryptographicHash::hash(QByteArray::fromRawData(pem_cert.data(), pem_cert.size()),
+                                    QCryptographicHash::Sha256)
+        .toStdString();
+}
+
+auto fingerprints_of(const std::string& pem_chain)
+{
+    std::unordered_set<std::string> ret;
+    std::string::size_type begin = 0, end;
+    while ((end = pem_chain.find(cert_end_marker, begin)) != std::string::npos)
+    {
+        end += std::char_traits<char>::length(cert_end_marker);
+        if (end < pem_chain.size() && pem_chain[end] == '\n')
+            ++end; // hash each block as it was handed to add_cert, trailing newline included
+
+        ret.insert(fingerprint_of(pem_chain.substr(begin, end - begin)));
+        begin = end;
+    }
+    return ret;
+}
 
 void validate_certificate(const std::string& pem_cert)
 {
@@ -52,6 +78,11 @@ mp::ClientCertStore::ClientCertStore(const multipass::Path& cert_dir) : cert_dir
 void mp::ClientCertStore::add_cert(const std::string& pem_cert)
 {
     validate_certificate(pem_cert);
+
+    PEM_cert_chain(); // brings the fingerprint index up to date with the file
+    if (cached_fingerprints.find(fingerprint_of(pem_cert)) != cached_fingerprints.end())
+        return; // already stored; appending again would only grow the chain every connection verifies against
+
     QDir dir{cert_dir};
     QFile file{dir.filePath(chain_name)};
     auto opened = file.open(QIODevice::WriteOnly | QIODevice::Append);
@@ -61,13 +92,31 @@ void mp::ClientCertStore::add_cert(const std::string& pem_cert)
     size_t written = file.write(pem_cert.data(), pem_cert.size());
     if (written != pem_cert.size())
         throw std::runtime_error("failed to write certificate");
+
+    cached_mtime = QDateTime(); // the next query re-reads and re-indexes
 }
 
 std::string mp::ClientCertStore::PEM_cert_chain() const
 {
     QDir dir{cert_dir};
     auto path = dir.filePath(chain_name);
-    if (QFile::exists(path))
-        return mp::utils::contents_of(path);
-    return {};
+
+    QFileInfo info{path};
+    if (!info.exists())
+    {
+        cached_chain.clear();
+        cached_fingerprints.clear();
+        cached_mtime = QDateTime();
+        cached_size = -1;
+        return {};
+    }
+
+    if (cached_mtime.isValid() && info.lastModified() == cached_mtime && info.size() == cached_size)
+        return cached_chain;
+
+    cached_chain = mp::utils::contents_of(path);
+    cached_fingerprints = fingerprints_of(cached_chain);
+    cached_mtime = info.lastModified();
+    cached_size = info.size();
+    return cached_chain;
 }
@@ -208,7 +208,7 @@ mp::SSLCertProvider::KeyCertificatePair make_cert_key_pair(const QDir& cert_dir,
 } // namespace
 
 mp::SSLCertProvider::SSLCertProvider(const multipass::Path& cert_dir, const std::string& server_name)
-    : key_cert_pair{make_cert_key_pair(cert_dir, server_name)}
+    : cert_dir{cert_dir}, server_name{server_name}
 {
 }
 
@@ -218,10 +218,20 @@ mp::SSLCertProvider::SSLCertProvider(const multipass::Path& data_dir) : SSLCertP
 
 std::string mp::SSLCertProvider::PEM_certificate() const
 {
-    return key_cert_pair.pem_cert;
+    return pair().pem_cert;
 }
 
 std::string mp::SSLCertProvider::PEM_signing_key() const
 {
-    return key_cert_pair.pem_priv_key;
+    return pair().pem_priv_key;
+}
+
+mp::SSLCertProvider::KeyCertificatePair& mp::SSLCertProvider::pair() const
+{
+    /* Loading — or on first run, generating — the certificates waits until something actually asks for them, keeping
+       them off the startup path of invocations that never reach the wire */
+    if (!key_cert_pair)
+        key_cert_pair = make_cert_key_pair(cert_dir, server_name);
+
+    return *key_cert_pair;
 }
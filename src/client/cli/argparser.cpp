@@ -38,17 +38,17 @@ namespace cmd = multipass::cmd;
 
 namespace
 {
-auto max_command_string_length(const std::vector<cmd::Command::UPtr>& commands)
+auto max_command_string_length(const std::vector<cmd::CommandEntry>& commands)
 {
     auto ret = 0ul;
 
     if (!commands.empty())
     {
-        auto string_len_compare = [](const cmd::Command::UPtr& a, const cmd::Command::UPtr& b) {
-            return a->name().length() < b->name().length();
+        auto string_len_compare = [](const cmd::CommandEntry& a, const cmd::CommandEntry& b) {
+            return a.name.length() < b.name.length();
         };
         const auto& max_elem = *std::max_element(commands.begin(), commands.end(), string_len_compare);
-        ret = max_elem->name().length();
+        ret = max_elem.name.length();
     }
 
     return ret;
@@ -59,14 +59,14 @@ auto format_into_column(const std::string& name, std::string::size_type column_s
     return fmt::format("  {:<{}}  ", name, column_size);
 }
 
-QString format_short_help_for(const std::vector<cmd::Command::UPtr>& commands)
+QString format_short_help_for(const std::vector<cmd::CommandEntry>& commands)
 {
     const auto column_size = max_command_string_length(commands);
     QString output;
     for (const auto& c : commands)
     {
-        output += QString::fromStdString(format_into_column(c->name(), column_size));
-        output += c->short_help() + "\n";
+        output += QString::fromStdString(format_into_column(c.name, column_size));
+        output += c.short_help + "\n";
     }
     return output;
 }
@@ -88,7 +88,7 @@ auto verbosity_level_in(const QStringList& arguments)
 }
 } // namespace
 
-mp::ArgParser::ArgParser(const QStringList& arguments, const std::vector<cmd::Command::UPtr>& commands,
+mp::ArgParser::ArgParser(const QStringList& arguments, const std::vector<cmd::CommandEntry>& commands,
                          std::ostream& cout, std::ostream& cerr)
     : arguments(arguments), commands(commands), chosen_command(nullptr), help_requested(false), cout(cout), cerr(cerr)
 {
@@ -285,11 +285,11 @@ cmd::Command* mp::ArgParser::findCommand(const QString& command) const
 {
     for (const auto& c : commands)
     {
-        for (const auto& alias : c->aliases())
+        for (const auto& alias : c.aliases)
         {
             if (command.toStdString() == alias)
             {
-                return c.get();
+                return c.instance();
             }
         }
     }
@@ -297,7 +297,7 @@ cmd::Command* mp::ArgParser::findCommand(const QString& command) const
     return nullptr;
 }
 
-const std::vector<cmd::Command::UPtr>& mp::ArgParser::getCommands() const
+const std::vector<cmd::CommandEntry>& mp::ArgParser::getCommands() const
 {
     return commands;
 }
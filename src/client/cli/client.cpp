@@ -24,15 +24,20 @@
 #include "cmd/info.h"
 #include "cmd/launch.h"
 #include "cmd/list.h"
+#include "cmd/metrics.h"
+#include "cmd/modify.h"
 #include "cmd/mount.h"
 #include "cmd/purge.h"
 #include "cmd/recover.h"
 #include "cmd/restart.h"
+#include "cmd/restore.h"
 #include "cmd/set.h"
 #include "cmd/shell.h"
+#include "cmd/snapshot.h"
 #include "cmd/start.h"
 #include "cmd/stop.h"
 #include "cmd/suspend.h"
+#include "cmd/trace.h"
 #include "cmd/transfer.h"
 #include "cmd/umount.h"
 #include "cmd/version.h"
@@ -50,38 +55,55 @@ namespace mp = multipass;
 namespace mpl = multipass::logging;
 
 mp::Client::Client(ClientConfig& config)
-    : cert_provider{std::move(config.cert_provider)},
-      rpc_channel{mp::client::make_channel(config.server_address, config.conn_type, *cert_provider)},
-      stub{mp::Rpc::NewStub(rpc_channel)},
+    : server_address{config.server_address},
+      conn_type{config.conn_type},
+      cert_provider{std::move(config.cert_provider)},
       term{config.term}
 {
-    add_command<cmd::Launch>();
-    add_command<cmd::Purge>();
-    add_command<cmd::Exec>();
-    add_command<cmd::Find>();
-    add_command<cmd::Get>();
-    add_command<cmd::Help>();
-    add_command<cmd::Info>();
-    add_command<cmd::List>();
-    add_command<cmd::Mount>();
-    add_command<cmd::Recover>();
-    add_command<cmd::Set>();
-    add_command<cmd::Shell>();
-    add_command<cmd::Start>();
-    add_command<cmd::Stop>();
-    add_command<cmd::Suspend>();
-    add_command<cmd::Transfer>();
-    add_command<cmd::Restart>();
-    add_command<cmd::Delete>();
-    add_command<cmd::Umount>();
-    add_command<cmd::Version>();
+    add_command<cmd::Launch>("launch", "Create and start an Ubuntu instance");
+    add_command<cmd::Purge>("purge", "Purge all deleted instances permanently");
+    add_command<cmd::Exec>("exec", "Run a command on an instance");
+    add_command<cmd::Find>("find", "Display available images to create instances from");
+    add_command<cmd::Get>("get", "Get a configuration setting");
+    add_command<cmd::Help>("help", "Display help about a command");
+    add_command<cmd::Info>("info", "Display information about instances");
+    add_command<cmd::List>("list", "List all available instances", "ls");
+    add_command<cmd::Metrics>("metrics", "Dump the daemon's operational metrics");
+    add_command<cmd::Modify>("modify", "Modify an instance's resources");
+    add_command<cmd::Mount>("mount", "Mount a local directory in the instance");
+    add_command<cmd::Recover>("recover", "Recover deleted instances");
+    add_command<cmd::Set>("set", "Set a configuration setting");
+    add_command<cmd::Shell>("shell", "Open a shell on a running instance", "sh", "connect");
+    add_command<cmd::Snapshot>("snapshot", "Take a snapshot of an instance's disk");
+    add_command<cmd::Restore>("restore", "Restore an instance's disk from a snapshot");
+    add_command<cmd::Start>("start", "Start instances");
+    add_command<cmd::Stop>("stop", "Stop running instances");
+    add_command<cmd::Suspend>("suspend", "Suspend running instances");
+    add_command<cmd::Trace>("trace", "Dump the daemon's timing trace");
+    add_command<cmd::Transfer>("transfer", "Transfer files between the host and instances", "copy-files");
+    add_command<cmd::Restart>("restart", "Restart instances");
+    add_command<cmd::Delete>("delete", "Delete instances");
+    add_command<cmd::Umount>("umount", "Unmount a directory from an instance", "unmount");
+    add_command<cmd::Version>("version", "Show version details");
 
     sort_commands();
 }
 
+mp::Rpc::Stub& mp::Client::rpc_stub()
+{
+    if (!stub)
+    { /* The channel carries the client certificates, so creating it here defers their loading to the first actual
+         RPC; help output, parse errors and the like never pay for it */
+        rpc_channel = mp::client::make_channel(server_address, conn_type, *cert_provider);
+        stub = mp::Rpc::NewStub(rpc_channel);
+    }
+
+    return *stub;
+}
+
 void mp::Client::sort_commands()
 {
-    auto name_sort = [](cmd::Command::UPtr& a, cmd::Command::UPtr& b) { return a->name() < b->name(); };
+    auto name_sort = [](const cmd::CommandEntry& a, const cmd::CommandEntry& b) { return a.name < b.name; };
     std::sort(commands.begin(), commands.end(), name_sort);
 }
 
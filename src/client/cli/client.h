@@ -46,26 +46,35 @@ public:
     int run(const QStringList& arguments);
 
 protected:
-    template <typename T>
-    void add_command();
+    template <typename T, typename... Aliases>
+    void add_command(std::string name, QString short_help, Aliases&&... aliases);
     void sort_commands();
+    Rpc::Stub& rpc_stub();
 
 private:
+    const std::string server_address;
+    const RpcConnectionType conn_type;
     const std::unique_ptr<CertProvider> cert_provider;
     std::shared_ptr<grpc::Channel> rpc_channel;
     std::unique_ptr<multipass::Rpc::Stub> stub;
 
-    std::vector<cmd::Command::UPtr> commands;
+    std::vector<cmd::CommandEntry> commands;
 
     Terminal* term;
 };
 } // namespace multipass
 
-template <typename T>
-void multipass::Client::add_command()
+/* Commands are registered as table entries rather than instances; only the one picked to run is
+   ever constructed. The metadata here is the dispatch key — the Command virtuals remain authoritative
+   for the command's own help output. */
+template <typename T, typename... Aliases>
+void multipass::Client::add_command(std::string name, QString short_help, Aliases&&... aliases)
 {
-    auto cmd = std::make_unique<T>(*rpc_channel, *stub, term);
-    commands.push_back(std::move(cmd));
+    auto make = [this]() -> cmd::Command::UPtr {
+        return std::make_unique<T>([this]() -> Rpc::Stub& { return rpc_stub(); }, term);
+    };
+    commands.push_back(
+        cmd::CommandEntry{name, {name, std::forward<Aliases>(aliases)...}, std::move(short_help), std::move(make)});
 }
 
 #endif // MULTIPASS_CLIENT_H
@@ -20,11 +20,133 @@
 
 #include <multipass/cli/argparser.h>
 #include <multipass/ssh/ssh_client.h>
+#include <multipass/ssh/ssh_session.h>
+#include <multipass/utils.h>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
 
 namespace mp = multipass;
 namespace cmd = multipass::cmd;
 using RpcMethod = mp::Rpc::Stub;
 
+namespace
+{
+void print_tagged(std::ostream& out, const std::string& name, const std::string& text)
+{
+    for (std::size_t pos = 0; pos < text.size();)
+    {
+        auto newline = text.find('\n', pos);
+        if (newline == std::string::npos)
+            newline = text.size();
+
+        out << name << ": " << text.substr(pos, newline - pos) << "\n";
+        pos = newline + 1;
+    }
+}
+
+/* Prints a stream line by line as it arrives, tagging each with the instance name; only the current
+   partial line is buffered, so memory stays flat however much output the command produces */
+class TaggedLinePrinter
+{
+public:
+    TaggedLinePrinter(std::ostream& out, const std::string& name, std::mutex& mutex)
+        : out{out}, name{name}, mutex{mutex}
+    {
+    }
+
+    void append(const char* data, std::size_t size)
+    {
+        partial.append(data, size);
+        auto last_newline = partial.find_last_of('\n');
+        if (last_newline == std::string::npos)
+            return;
+
+        std::lock_guard<std::mutex> lock{mutex};
+        print_tagged(out, name, partial.substr(0, last_newline));
+        partial.erase(0, last_newline + 1);
+    }
+
+    void finish() // the output's last line need not be newline-terminated
+    {
+        if (partial.empty())
+            return;
+
+        std::lock_guard<std::mutex> lock{mutex};
+        print_tagged(out, name, partial);
+        partial.clear();
+    }
+
+private:
+    std::ostream& out;
+    const std::string name;
+    std::mutex& mutex;
+    std::string partial;
+};
+
+/* Fleet fan-out: the same command runs over concurrent SSH sessions, a bounded pool of workers pulling
+   instances off a shared index. Output streams through line by line as instances produce it, every line
+   tagged with its name, so the client's memory stays flat no matter how much the commands print. */
+mp::ReturnCode exec_fleet(const mp::SSHInfoReply& reply, const std::vector<std::string>& args, mp::Terminal* term)
+{
+    const auto cmd_line = mp::utils::to_cmd(args, mp::utils::QuoteType::quote_every_arg);
+
+    // the proto map's order is unspecified; fix one so repeated runs read the same
+    std::vector<std::pair<std::string, mp::SSHInfo>> targets{reply.ssh_info().begin(), reply.ssh_info().end()};
+    std::sort(targets.begin(), targets.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    constexpr auto max_fan_out = std::size_t{8}; // enough to hide SSH latency without storming the host
+    std::atomic<std::size_t> next_target{0};
+    std::atomic<bool> failed{false};
+    std::mutex output_mutex;
+
+    auto worker = [&] {
+        for (auto i = next_target++; i < targets.size(); i = next_target++)
+        {
+            const auto& name = targets[i].first;
+            const auto& ssh_info = targets[i].second;
+            try
+            {
+                mp::SSHSession session{ssh_info.host(), ssh_info.port(), ssh_info.username(),
+                                       ssh_info.priv_key_base64()};
+                auto proc = session.exec(cmd_line);
+
+                TaggedLinePrinter output{term->cout(), name, output_mutex};
+                TaggedLinePrinter errors{term->cerr(), name, output_mutex};
+                proc.consume_std_output([&output](const char* data, std::size_t size) { output.append(data, size); });
+                proc.consume_std_error([&errors](const char* data, std::size_t size) { errors.append(data, size); });
+                auto exit_code = proc.exit_code();
+                output.finish();
+                errors.finish();
+
+                if (exit_code != 0)
+                {
+                    std::lock_guard<std::mutex> lock{output_mutex};
+                    term->cerr() << name << ": command exited with status " << exit_code << "\n";
+                    failed = true;
+                }
+            }
+            catch (const std::exception& e)
+            {
+                std::lock_guard<std::mutex> lock{output_mutex};
+                term->cerr() << name << ": exec failed: " << e.what() << "\n";
+                failed = true;
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (auto i = std::size_t{0}; i < std::min(max_fan_out, targets.size()); ++i)
+        workers.emplace_back(worker);
+    for (auto& w : workers)
+        w.join();
+
+    return failed ? mp::ReturnCode::CommandFail : mp::ReturnCode::Ok;
+}
+} // namespace
+
 mp::ReturnCode cmd::Exec::run(mp::ArgParser* parser)
 {
     auto ret = parse_args(parser);
@@ -57,7 +179,8 @@ QString cmd::Exec::short_help() const
 
 QString cmd::Exec::description() const
 {
-    return QStringLiteral("Run a command on an instance");
+    return QStringLiteral("Run a command on an instance, or concurrently on several "
+                          "when given a comma-separated list of names");
 }
 
 mp::ReturnCode cmd::Exec::exec_success(const mp::SSHInfoReply& reply, const std::vector<std::string>& args,
@@ -67,6 +190,9 @@ mp::ReturnCode cmd::Exec::exec_success(const mp::SSHInfoReply& reply, const std:
     if (reply.ssh_info().empty())
         return ReturnCode::Ok;
 
+    if (reply.ssh_info().size() > 1)
+        return exec_fleet(reply, args, term);
+
     const auto& ssh_info = reply.ssh_info().begin()->second;
     const auto& host = ssh_info.host();
     const auto& port = ssh_info.port();
@@ -88,7 +214,10 @@ mp::ReturnCode cmd::Exec::exec_success(const mp::SSHInfoReply& reply, const std:
 
 mp::ParseCode cmd::Exec::parse_args(mp::ArgParser* parser)
 {
-    parser->addPositionalArgument("name", "Name of instance to execute the command on", "<name>");
+    parser->addPositionalArgument("name",
+                                  "Name of instance to execute the command on; a comma-separated list runs "
+                                  "the command on each instance concurrently, tagging output by name",
+                                  "<name>[,<name>...]");
     parser->addPositionalArgument("command", "Command to execute on the instance", "[--] <command>");
 
     auto status = parser->commandParse(this);
@@ -105,8 +234,11 @@ mp::ParseCode cmd::Exec::parse_args(mp::ArgParser* parser)
     }
     else
     {
-        auto entry = request.add_instance_name();
-        entry->append(parser->positionalArguments().first().toStdString());
+        for (const auto& name : parser->positionalArguments().first().split(',', QString::SkipEmptyParts))
+        {
+            auto entry = request.add_instance_name();
+            entry->append(name.toStdString());
+        }
     }
 
     return status;
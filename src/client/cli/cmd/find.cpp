@@ -19,8 +19,14 @@
 #include "common_cli.h"
 
 #include <multipass/cli/argparser.h>
+#include <multipass/cli/client_common.h>
+#include <multipass/cli/format_utils.h>
 #include <multipass/cli/formatter.h>
 
+#include <multipass/format.h>
+
+#include <QUrl>
+
 namespace mp = multipass;
 namespace cmd = multipass::cmd;
 using RpcMethod = mp::Rpc::Stub;
@@ -33,8 +39,57 @@ mp::ReturnCode cmd::Find::run(mp::ArgParser* parser)
         return parser->returnCodeFrom(ret);
     }
 
-    auto on_success = [this](FindReply& reply) {
-        cout << chosen_formatter->format(reply);
+    /* The cached reply from an identical previous query carries the daemon's catalog version; sending it
+       along turns the common case into a conditional lookup that the daemon answers with just "unchanged" */
+    const auto cache_name =
+        fmt::format("find-{}", QUrl::toPercentEncoding(QString::fromStdString(fmt::format(
+                                                           "{}:{}{}", request.remote_name(), request.search_string(),
+                                                           request.allow_unsupported() ? "+unsupported" : "")))
+                                   .toStdString());
+    FindReply cached;
+    if (client::load_cached_reply(cache_name, cached))
+        request.set_last_catalog_version(cached.catalog_version());
+
+    /* The daemon streams partial replies as each remote's manifest resolves. Table columns have fixed
+       widths, so those rows can render the moment they arrive — first results show while a slow remote
+       is still refreshing; structured formats need the whole document up front, so they aggregate. */
+    FindReply aggregated;
+    const auto incremental = chosen_formatter == format::formatter_for("table");
+    auto streamed = false;
+    auto unchanged = false;
+
+    auto streaming_callback = [this, &aggregated, incremental, &streamed, &unchanged](FindReply& reply) {
+        unchanged |= reply.unchanged();
+        if (!reply.catalog_version().empty())
+            aggregated.set_catalog_version(reply.catalog_version());
+
+        if (reply.images_info().empty())
+            return;
+
+        aggregated.mutable_images_info()->MergeFrom(reply.images_info()); // also feeds the cache when streaming
+
+        if (incremental)
+        {
+            auto output = chosen_formatter->format(reply);
+            if (streamed) // the header went out with the first batch
+                output.erase(0, output.find('\n') + 1);
+
+            cout << output << std::flush;
+            streamed = true;
+        }
+    };
+
+    auto on_success = [this, &aggregated, &streamed, &unchanged, &cached, &cache_name](FindReply& reply) {
+        if (unchanged) // the daemon vouched for the listing we have on disk
+        {
+            cout << chosen_formatter->format(cached);
+        }
+        else
+        {
+            if (!streamed)
+                cout << chosen_formatter->format(aggregated);
+            client::store_cached_reply(cache_name, aggregated);
+        }
 
         return ReturnCode::Ok;
     };
@@ -42,7 +97,7 @@ mp::ReturnCode cmd::Find::run(mp::ArgParser* parser)
     auto on_failure = [this](grpc::Status& status) { return standard_failure_handler_for(name(), cerr, status); };
 
     request.set_verbosity_level(parser->verbosityLevel());
-    return dispatch(&RpcMethod::find, request, on_success, on_failure);
+    return dispatch(&RpcMethod::find, request, on_success, on_failure, streaming_callback);
 }
 
 std::string cmd::Find::name() const
@@ -50,7 +50,7 @@ const std::regex show{"s|show", std::regex::icase | std::regex::optimize};
 
 mp::ReturnCode cmd::Launch::run(mp::ArgParser* parser)
 {
-    petenv_name = Settings::instance().get(petenv_key);
+    petenv_name = Settings::instance().get(settings::petenv);
     if (auto ret = parse_args(parser); ret != ParseCode::Ok)
     {
         return parser->returnCodeFrom(ret);
@@ -126,7 +126,20 @@ mp::ParseCode cmd::Launch::parse_args(mp::ArgParser* parser)
         "name");
     QCommandLineOption cloudInitOption("cloud-init", "Path to a user-data cloud-init configuration, or '-' for stdin",
                                        "file");
-    parser->addOptions({cpusOption, diskOption, memOption, nameOption, cloudInitOption});
+    QCommandLineOption fullCopyOption("full-copy",
+                                      "Give the instance a private copy of the image instead of sharing "
+                                      "a copy-on-write layer with other instances of the same image");
+    QCommandLineOption diskIopsOption("disk-iops",
+                                      "Cap on the disk operations per second the instance may issue, "
+                                      "reads and writes combined. Unlimited if omitted.",
+                                      "iops");
+    QCommandLineOption diskBandwidthOption("disk-bandwidth",
+                                           "Cap on the instance's disk throughput, reads and writes combined. "
+                                           "Positive integers, in bytes per second, or with K, M, G suffix. "
+                                           "Unlimited if omitted.",
+                                           "bandwidth");
+    parser->addOptions({cpusOption, diskOption, memOption, nameOption, cloudInitOption, fullCopyOption, diskIopsOption,
+                        diskBandwidthOption});
 
     auto status = parser->commandParse(this);
 
@@ -191,6 +204,24 @@ mp::ParseCode cmd::Launch::parse_args(mp::ArgParser* parser)
         request.set_disk_space(parser->value(diskOption).toStdString());
     }
 
+    if (parser->isSet(diskIopsOption))
+    {
+        bool ok{false};
+        const auto iops = parser->value(diskIopsOption).toLongLong(&ok);
+        if (!ok || iops < 1)
+        {
+            cerr << "Invalid disk IOPS limit\n";
+            return ParseCode::CommandLineError;
+        }
+
+        request.set_disk_iops(iops);
+    }
+
+    if (parser->isSet(diskBandwidthOption))
+    {
+        request.set_disk_bandwidth(parser->value(diskBandwidthOption).toStdString());
+    }
+
     if (parser->isSet(cloudInitOption))
     {
         try
@@ -222,6 +253,8 @@ mp::ParseCode cmd::Launch::parse_args(mp::ArgParser* parser)
         }
     }
 
+    request.set_full_copy(parser->isSet(fullCopyOption));
+
     request.set_verbosity_level(parser->verbosityLevel());
 
     return status;
@@ -316,6 +349,10 @@ mp::ReturnCode cmd::Launch::request_launch()
             {
                 error_details = fmt::format("Invalid instance name supplied: {}", request.instance_name());
             }
+            else if (error == LaunchError::INVALID_DISK_BANDWIDTH)
+            {
+                error_details = fmt::format("Invalid disk bandwidth value supplied: {}.", request.disk_bandwidth());
+            }
         }
 
         return standard_failure_handler_for(name(), cerr, status, error_details);
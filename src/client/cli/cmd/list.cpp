@@ -20,11 +20,43 @@
 
 #include <multipass/cli/argparser.h>
 #include <multipass/cli/formatter.h>
+#include <multipass/utils.h>
+
+#include <algorithm>
 
 namespace mp = multipass;
 namespace cmd = multipass::cmd;
 using RpcMethod = mp::Rpc::Stub;
 
+namespace
+{
+/* Repaints a live terminal in place: the cursor walks back up over the previous snapshot and only the
+   lines that differ get erased and rewritten — the table's fixed column widths keep unchanged rows
+   byte-identical, so a large watch display costs a handful of line writes per update rather than a full
+   re-print. Rows that disappeared leave the remainder of the screen erased below. */
+void repaint_in_place(std::ostream& out, const std::string& previous, const std::string& current)
+{
+    const auto previous_height = std::count(previous.cbegin(), previous.cend(), '\n');
+    if (previous_height > 0)
+        out << "\x1b[" << previous_height << "A"; // the cursor sits in column 0, just below the last line
+
+    const auto old_lines = mp::utils::split(previous, "\n");
+    const auto new_lines = mp::utils::split(current, "\n");
+    const auto new_height = std::count(current.cbegin(), current.cend(), '\n');
+
+    for (std::ptrdiff_t i = 0; i < new_height; ++i)
+    {
+        if (i < previous_height && old_lines[i] == new_lines[i])
+            out << "\x1b[1B"; // unchanged — step over it without redrawing
+        else
+            out << "\x1b[2K" << new_lines[i] << "\n";
+    }
+
+    if (previous_height > new_height)
+        out << "\x1b[0J";
+}
+} // namespace
+
 mp::ReturnCode cmd::List::run(mp::ArgParser* parser)
 {
     auto ret = parse_args(parser);
@@ -34,6 +66,9 @@ mp::ReturnCode cmd::List::run(mp::ArgParser* parser)
     }
 
     auto on_success = [this](ListReply& reply) {
+        if (request.watch())
+            return ReturnCode::Ok; // everything was printed as it streamed in
+
         cout << chosen_formatter->format(reply);
 
         if (term->is_live() && update_available(reply.update_info()))
@@ -44,9 +79,26 @@ mp::ReturnCode cmd::List::run(mp::ArgParser* parser)
 
     auto on_failure = [this](grpc::Status& status) { return standard_failure_handler_for(name(), cerr, status); };
 
-    ListRequest request;
+    std::string last_output;
+    auto streaming_callback = [this, &last_output](ListReply& reply) {
+        if (!request.watch())
+            return;
+
+        auto output = chosen_formatter->format(reply);
+        if (output == last_output) // liveness probes repeat the previous snapshot
+            return;
+
+        if (term->cout_is_live() && !last_output.empty())
+            repaint_in_place(cout, last_output, output);
+        else // redirected output (or the first snapshot) appends, keeping logs complete
+            cout << output;
+
+        cout << std::flush;
+        last_output = std::move(output);
+    };
+
     request.set_verbosity_level(parser->verbosityLevel());
-    return dispatch(&RpcMethod::list, request, on_success, on_failure);
+    return dispatch(&RpcMethod::list, request, on_success, on_failure, streaming_callback);
 }
 
 std::string cmd::List::name() const
@@ -75,7 +127,15 @@ mp::ParseCode cmd::List::parse_args(mp::ArgParser* parser)
         "format", "Output list in the requested format.\nValid formats are: table (default), json, csv and yaml",
         "format", "table");
 
+    QCommandLineOption noIpv4Option("no-ipv4", "Do not query the instances' IP addresses, which can be slow on "
+                                               "hosts with many instances");
+
+    QCommandLineOption watchOption("watch", "Keep the list coming: stay connected and print a fresh listing "
+                                            "whenever it changes, instead of polling with repeated invocations");
+
     parser->addOption(formatOption);
+    parser->addOption(noIpv4Option);
+    parser->addOption(watchOption);
 
     auto status = parser->commandParse(this);
 
@@ -84,6 +144,9 @@ mp::ParseCode cmd::List::parse_args(mp::ArgParser* parser)
         return status;
     }
 
+    request.set_no_ipv4(parser->isSet(noIpv4Option));
+    request.set_watch(parser->isSet(watchOption));
+
     if (parser->positionalArguments().count() > 0)
     {
         cerr << "This command takes no arguments\n";
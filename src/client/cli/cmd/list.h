@@ -43,6 +43,7 @@ private:
     ParseCode parse_args(ArgParser *parser) override;
 
     Formatter* chosen_formatter;
+    ListRequest request;
 };
 }
 }
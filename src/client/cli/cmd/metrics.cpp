@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2020 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "metrics.h"
+#include "common_cli.h"
+
+#include <multipass/cli/argparser.h>
+
+namespace mp = multipass;
+namespace cmd = multipass::cmd;
+using RpcMethod = mp::Rpc::Stub;
+
+mp::ReturnCode cmd::Metrics::run(mp::ArgParser* parser)
+{
+    auto ret = parse_args(parser);
+    if (ret != ParseCode::Ok)
+    {
+        return parser->returnCodeFrom(ret);
+    }
+
+    auto on_success = [this](mp::MetricsReply& reply) {
+        cout << reply.metrics();
+        return ReturnCode::Ok;
+    };
+
+    auto on_failure = [this](grpc::Status& status) { return standard_failure_handler_for(name(), cerr, status); };
+
+    mp::MetricsRequest request;
+    request.set_verbosity_level(parser->verbosityLevel());
+    return dispatch(&RpcMethod::get_metrics, request, on_success, on_failure);
+}
+
+std::string cmd::Metrics::name() const
+{
+    return "metrics";
+}
+
+QString cmd::Metrics::short_help() const
+{
+    return QStringLiteral("Dump the daemon's operational metrics");
+}
+
+QString cmd::Metrics::description() const
+{
+    return QStringLiteral("Fetch the daemon's operational counters and latency histograms in\n"
+                          "the Prometheus text exposition format, suitable for the node\n"
+                          "exporter's textfile collector or any other scraper.");
+}
+
+mp::ParseCode cmd::Metrics::parse_args(mp::ArgParser* parser)
+{
+    auto status = parser->commandParse(this);
+
+    if (status != ParseCode::Ok)
+    {
+        return status;
+    }
+
+    if (parser->positionalArguments().count() > 0)
+    {
+        cerr << "This command takes no arguments\n";
+        return ParseCode::CommandLineError;
+    }
+
+    return status;
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2020 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "modify.h"
+#include "common_cli.h"
+
+#include <multipass/cli/argparser.h>
+
+namespace mp = multipass;
+namespace cmd = multipass::cmd;
+using RpcMethod = mp::Rpc::Stub;
+
+mp::ReturnCode cmd::Modify::run(mp::ArgParser* parser)
+{
+    auto ret = parse_args(parser);
+    if (ret != ParseCode::Ok)
+    {
+        return parser->returnCodeFrom(ret);
+    }
+
+    auto on_success = [this](mp::ModifyReply& reply) {
+        if (!reply.reply_message().empty())
+            cout << reply.reply_message() << "\n";
+        return ReturnCode::Ok;
+    };
+
+    auto on_failure = [this](grpc::Status& status) { return standard_failure_handler_for(name(), cerr, status); };
+
+    request.set_verbosity_level(parser->verbosityLevel());
+    return dispatch(&RpcMethod::modify, request, on_success, on_failure);
+}
+
+std::string cmd::Modify::name() const
+{
+    return "modify";
+}
+
+QString cmd::Modify::short_help() const
+{
+    return QStringLiteral("Modify an instance's resources");
+}
+
+QString cmd::Modify::description() const
+{
+    return QStringLiteral("Change the number of CPU cores, the amount of memory and/or the\n"
+                          "disk I/O limits of an instance. Changes to a running instance's\n"
+                          "cores or memory take effect on its next start; I/O limits apply\n"
+                          "immediately where the backend supports it.");
+}
+
+mp::ParseCode cmd::Modify::parse_args(mp::ArgParser* parser)
+{
+    parser->addPositionalArgument("name", "Name of the instance to modify", "<name>");
+
+    QCommandLineOption cpusOption({"c", "cpus"}, "Number of CPUs to allocate", "cpus");
+    QCommandLineOption memOption({"m", "mem"}, "Amount of memory to allocate", "mem");
+    QCommandLineOption diskIopsOption("disk-iops",
+                                      "Cap on the disk operations per second the instance may issue, reads "
+                                      "and writes combined; 0 removes the limit",
+                                      "iops");
+    QCommandLineOption diskBandwidthOption("disk-bandwidth",
+                                           "Cap on the instance's disk throughput, reads and writes combined, "
+                                           "in bytes per second or with K, M, G suffix; 0 removes the limit",
+                                           "bandwidth");
+
+    parser->addOptions({cpusOption, memOption, diskIopsOption, diskBandwidthOption});
+
+    auto status = parser->commandParse(this);
+    if (status != ParseCode::Ok)
+    {
+        return status;
+    }
+
+    const auto args = parser->positionalArguments();
+    if (args.count() != 1)
+    {
+        cerr << "Need the name of an instance to modify.\n";
+        return ParseCode::CommandLineError;
+    }
+
+    if (!parser->isSet(cpusOption) && !parser->isSet(memOption) && !parser->isSet(diskIopsOption) &&
+        !parser->isSet(diskBandwidthOption))
+    {
+        cerr << "Need at least one of --cpus, --mem, --disk-iops and --disk-bandwidth.\n";
+        return ParseCode::CommandLineError;
+    }
+
+    request.set_instance_name(args.at(0).toStdString());
+
+    if (parser->isSet(cpusOption))
+    {
+        bool ok{false};
+        const auto cpus = parser->value(cpusOption).toInt(&ok);
+        if (!ok || cpus < 1)
+        {
+            cerr << "Invalid number of CPUs\n";
+            return ParseCode::CommandLineError;
+        }
+
+        request.set_num_cores(cpus);
+    }
+
+    if (parser->isSet(memOption))
+        request.set_mem_size(parser->value(memOption).toStdString());
+
+    if (parser->isSet(diskIopsOption))
+    {
+        bool ok{false};
+        const auto iops = parser->value(diskIopsOption).toLongLong(&ok);
+        if (!ok || iops < 0)
+        {
+            cerr << "Invalid disk IOPS limit\n";
+            return ParseCode::CommandLineError;
+        }
+
+        request.set_disk_iops(iops == 0 ? -1 : iops); // in the wire format, 0 means "leave unchanged"
+    }
+
+    if (parser->isSet(diskBandwidthOption))
+        request.set_disk_bandwidth(parser->value(diskBandwidthOption).toStdString());
+
+    return ParseCode::Ok;
+}
@@ -66,7 +66,7 @@ QString cmd::Restart::description() const
 
 mp::ParseCode cmd::Restart::parse_args(mp::ArgParser* parser)
 {
-    const auto petenv_name = Settings::instance().get(petenv_key);
+    const auto petenv_name = Settings::instance().get(settings::petenv);
     parser->addPositionalArgument(
         "name",
         QString{"Names of instances to restart. If omitted, and without the --all option, '%1' will be assumed."}.arg(
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2020 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "restore.h"
+#include "common_cli.h"
+
+#include "animated_spinner.h"
+
+#include <multipass/cli/argparser.h>
+#include <multipass/format.h>
+
+namespace mp = multipass;
+namespace cmd = multipass::cmd;
+using RpcMethod = mp::Rpc::Stub;
+
+mp::ReturnCode cmd::Restore::run(mp::ArgParser* parser)
+{
+    auto ret = parse_args(parser);
+    if (ret != ParseCode::Ok)
+    {
+        return parser->returnCodeFrom(ret);
+    }
+
+    AnimatedSpinner spinner{cout};
+    auto on_success = [&spinner](mp::RestoreReply& reply) {
+        spinner.stop();
+        return ReturnCode::Ok;
+    };
+
+    auto on_failure = [this, &spinner](grpc::Status& status) {
+        spinner.stop();
+        return standard_failure_handler_for(name(), cerr, status);
+    };
+
+    spinner.start(fmt::format("Restoring snapshot of {}", request.instance_name()));
+    request.set_verbosity_level(parser->verbosityLevel());
+    return dispatch(&RpcMethod::restore, request, on_success, on_failure);
+}
+
+std::string cmd::Restore::name() const
+{
+    return "restore";
+}
+
+QString cmd::Restore::short_help() const
+{
+    return QStringLiteral("Restore an instance's disk from a snapshot");
+}
+
+QString cmd::Restore::description() const
+{
+    return QStringLiteral("Restore the disk of a stopped instance to a snapshot previously\n"
+                          "taken with the snapshot command.");
+}
+
+mp::ParseCode cmd::Restore::parse_args(mp::ArgParser* parser)
+{
+    parser->addPositionalArgument("name", "Name of the instance to restore", "<name>");
+    parser->addPositionalArgument("snapshot", "Name of the snapshot to restore", "<snapshot>");
+
+    auto status = parser->commandParse(this);
+    if (status == ParseCode::Ok)
+    {
+        const auto args = parser->positionalArguments();
+        if (args.count() == 2)
+        {
+            request.set_instance_name(args.at(0).toStdString());
+            request.set_snapshot_name(args.at(1).toStdString());
+        }
+        else
+        {
+            cerr << "Need the instance name and a snapshot name.\n";
+            status = ParseCode::CommandLineError;
+        }
+    }
+
+    return status;
+}
@@ -30,7 +30,7 @@ using RpcMethod = mp::Rpc::Stub;
 
 mp::ReturnCode cmd::Shell::run(mp::ArgParser* parser)
 {
-    petenv_name = Settings::instance().get(petenv_key);
+    petenv_name = Settings::instance().get(settings::petenv);
     auto ret = parse_args(parser);
     if (ret != ParseCode::Ok)
     {
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2020 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "snapshot.h"
+#include "common_cli.h"
+
+#include "animated_spinner.h"
+
+#include <multipass/cli/argparser.h>
+#include <multipass/format.h>
+
+namespace mp = multipass;
+namespace cmd = multipass::cmd;
+using RpcMethod = mp::Rpc::Stub;
+
+mp::ReturnCode cmd::Snapshot::run(mp::ArgParser* parser)
+{
+    auto ret = parse_args(parser);
+    if (ret != ParseCode::Ok)
+    {
+        return parser->returnCodeFrom(ret);
+    }
+
+    AnimatedSpinner spinner{cout};
+    auto on_success = [&spinner](mp::SnapshotReply& reply) {
+        spinner.stop();
+        return ReturnCode::Ok;
+    };
+
+    auto on_failure = [this, &spinner](grpc::Status& status) {
+        spinner.stop();
+        return standard_failure_handler_for(name(), cerr, status);
+    };
+
+    spinner.start(fmt::format("Taking snapshot of {}", request.instance_name()));
+    request.set_verbosity_level(parser->verbosityLevel());
+    return dispatch(&RpcMethod::snapshot, request, on_success, on_failure);
+}
+
+std::string cmd::Snapshot::name() const
+{
+    return "snapshot";
+}
+
+QString cmd::Snapshot::short_help() const
+{
+    return QStringLiteral("Take a snapshot of an instance's disk");
+}
+
+QString cmd::Snapshot::description() const
+{
+    return QStringLiteral("Take a named snapshot of the disk of a stopped instance. The\n"
+                          "snapshot can later be restored with the restore command.");
+}
+
+mp::ParseCode cmd::Snapshot::parse_args(mp::ArgParser* parser)
+{
+    parser->addPositionalArgument("name", "Name of the instance to snapshot", "<name>");
+    parser->addPositionalArgument("snapshot", "Name to give the snapshot", "<snapshot>");
+
+    auto status = parser->commandParse(this);
+    if (status == ParseCode::Ok)
+    {
+        const auto args = parser->positionalArguments();
+        if (args.count() == 2)
+        {
+            request.set_instance_name(args.at(0).toStdString());
+            request.set_snapshot_name(args.at(1).toStdString());
+        }
+        else
+        {
+            cerr << "Need the instance name and a snapshot name.\n";
+            status = ParseCode::CommandLineError;
+        }
+    }
+
+    return status;
+}
@@ -43,7 +43,7 @@ constexpr auto unknown_error_fmt = "Instance '{}' failed in an unexpected way, c
 
 mp::ReturnCode cmd::Start::run(mp::ArgParser* parser)
 {
-    petenv_name = Settings::instance().get(petenv_key);
+    petenv_name = Settings::instance().get(settings::petenv);
     auto ret = parse_args(parser);
     if (ret != ParseCode::Ok)
     {
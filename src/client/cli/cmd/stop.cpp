@@ -67,7 +67,7 @@ QString cmd::Stop::description() const
 
 mp::ParseCode cmd::Stop::parse_args(mp::ArgParser* parser)
 {
-    const auto petenv_name = Settings::instance().get(petenv_key);
+    const auto petenv_name = Settings::instance().get(settings::petenv);
     parser->addPositionalArgument(
         "name",
         QString{"Names of instances to stop. If omitted, and without the --all option, '%1' will be assumed"}.arg(
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2020 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "trace.h"
+#include "common_cli.h"
+
+#include <multipass/cli/argparser.h>
+
+namespace mp = multipass;
+namespace cmd = multipass::cmd;
+using RpcMethod = mp::Rpc::Stub;
+
+mp::ReturnCode cmd::Trace::run(mp::ArgParser* parser)
+{
+    auto ret = parse_args(parser);
+    if (ret != ParseCode::Ok)
+    {
+        return parser->returnCodeFrom(ret);
+    }
+
+    auto on_success = [this](mp::TraceReply& reply) {
+        cout << reply.chrome_trace() << "\n";
+        return ReturnCode::Ok;
+    };
+
+    auto on_failure = [this](grpc::Status& status) { return standard_failure_handler_for(name(), cerr, status); };
+
+    request.set_verbosity_level(parser->verbosityLevel());
+    return dispatch(&RpcMethod::trace, request, on_success, on_failure);
+}
+
+std::string cmd::Trace::name() const
+{
+    return "trace";
+}
+
+QString cmd::Trace::short_help() const
+{
+    return QStringLiteral("Dump the daemon's timing trace");
+}
+
+QString cmd::Trace::description() const
+{
+    return QStringLiteral("Fetch the daemon's in-memory record of how long recent operations\n"
+                          "took, in Chrome trace-event JSON (load it via chrome://tracing or a\n"
+                          "compatible viewer to see the waterfall).");
+}
+
+mp::ParseCode cmd::Trace::parse_args(mp::ArgParser* parser)
+{
+    QCommandLineOption clearOption("clear", "Clear the trace buffer after dumping it, so the next dump "
+                                            "starts from a clean slate");
+
+    parser->addOption(clearOption);
+
+    auto status = parser->commandParse(this);
+
+    if (status != ParseCode::Ok)
+    {
+        return status;
+    }
+
+    request.set_clear(parser->isSet(clearOption));
+
+    if (parser->positionalArguments().count() > 0)
+    {
+        cerr << "This command takes no arguments\n";
+        return ParseCode::CommandLineError;
+    }
+
+    return status;
+}
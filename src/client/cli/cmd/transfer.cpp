@@ -25,6 +25,10 @@
 #include <QDir>
 #include <QFileInfo>
 
+#include <atomic>
+#include <mutex>
+#include <thread>
+
 namespace mp = multipass;
 namespace cmd = multipass::cmd;
 namespace mcp = multipass::cli::platform;
@@ -33,6 +37,7 @@ using RpcMethod = mp::Rpc::Stub;
 namespace
 {
 const char streaming_symbol{'-'};
+constexpr auto max_concurrent_transfers = 4u; // enough to hide per-file latency without flooding the instance
 } // namespace
 
 mp::ReturnCode cmd::Transfer::run(mp::ArgParser* parser)
@@ -49,49 +54,78 @@ mp::ReturnCode cmd::Transfer::run(mp::ArgParser* parser)
         if (reply.ssh_info().empty())
             return ReturnCode::Ok;
 
-        for (const auto& source : sources)
-        {
-            mp::SSHInfo ssh_info;
+        auto ssh_info_for = [this, &reply](const std::pair<std::string, std::string>& source) {
             if (!source.first.empty())
+                return reply.ssh_info().find(source.first)->second;
+            else if (!destination.first.empty())
+                return reply.ssh_info().find(destination.first)->second;
+
+            return mp::SSHInfo{};
+        };
+
+        if (streaming_enabled)
+        {
+            const auto& source = sources.front();
+            const auto ssh_info = ssh_info_for(source);
+
+            try
             {
-                ssh_info = reply.ssh_info().find(source.first)->second;
+                mp::SFTPClient sftp_client{ssh_info.host(), ssh_info.port(), ssh_info.username(),
+                                           ssh_info.priv_key_base64()};
+
+                if (destination.first.empty())
+                    sftp_client.stream_file(source.second, term->cout());
+                else
+                    sftp_client.stream_file(destination.second, term->cin());
             }
-            else if (!destination.first.empty())
+            catch (const std::exception& e)
             {
-                ssh_info = reply.ssh_info().find(destination.first)->second;
+                cerr << "transfer failed: " << e.what() << "\n";
+                return ReturnCode::CommandFail;
             }
 
-            auto host = ssh_info.host();
-            auto port = ssh_info.port();
-            auto username = ssh_info.username();
-            auto priv_key_blob = ssh_info.priv_key_base64();
+            return ReturnCode::Ok;
+        }
 
-            try
+        // Each source gets its own SFTP session, so several files move in parallel over separate SSH
+        // connections instead of paying the per-file open/transfer/close latency one file at a time
+        std::atomic<std::size_t> next_source{0};
+        std::atomic<bool> failed{false};
+        std::mutex cerr_mutex;
+
+        auto worker = [&] {
+            for (auto i = next_source++; i < sources.size(); i = next_source++)
             {
-                mp::SFTPClient sftp_client{host, port, username, priv_key_blob};
+                const auto& source = sources[i];
+                const auto ssh_info = ssh_info_for(source);
 
-                if (streaming_enabled)
-                {
-                    if (destination.first.empty())
-                        sftp_client.stream_file(source.second, term->cout());
-                    else
-                        sftp_client.stream_file(destination.second, term->cin());
-                }
-                else
+                try
                 {
+                    mp::SFTPClient sftp_client{ssh_info.host(), ssh_info.port(), ssh_info.username(),
+                                               ssh_info.priv_key_base64()};
+
                     if (!destination.first.empty())
                         sftp_client.push_file(source.second, destination.second);
                     else
                         sftp_client.pull_file(source.second, destination.second);
                 }
+                catch (const std::exception& e)
+                {
+                    std::lock_guard<std::mutex> lock{cerr_mutex};
+                    cerr << "transfer failed: " << e.what() << "\n";
+                    failed = true;
+                }
             }
-            catch (const std::exception& e)
-            {
-                cerr << "transfer failed: " << e.what() << "\n";
-                return ReturnCode::CommandFail;
-            }
-        }
-        return ReturnCode::Ok;
+        };
+
+        std::vector<std::thread> workers;
+        for (auto i = 0u; i < std::min<std::size_t>(sources.size(), max_concurrent_transfers); ++i)
+            workers.emplace_back(worker);
+
+        for (auto& thread : workers)
+            thread.join();
+
+        return failed ? ReturnCode::CommandFail : ReturnCode::Ok;
     };
 
     auto on_failure = [this](grpc::Status& status) { return standard_failure_handler_for(name(), cerr, status); };
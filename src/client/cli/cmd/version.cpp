@@ -18,12 +18,20 @@
 #include "version.h"
 #include "common_cli.h"
 #include <multipass/cli/argparser.h>
+#include <multipass/cli/client_common.h>
 #include <multipass/version.h>
 
+#include <chrono>
+
 namespace mp = multipass;
 namespace cmd = multipass::cmd;
 using RpcMethod = mp::Rpc::Stub;
 
+namespace
+{
+constexpr auto version_cache_name = "version";
+} // namespace
+
 mp::ReturnCode cmd::Version::run(mp::ArgParser* parser)
 {
     auto ret = parse_args(parser);
@@ -34,14 +42,30 @@ mp::ReturnCode cmd::Version::run(mp::ArgParser* parser)
 
     cout << "multipass  " << multipass::version_string << "\n";
 
-    auto on_success = [this](mp::VersionReply& reply) {
+    auto print_reply = [this](const mp::VersionReply& reply) {
         cout << "multipassd " << reply.version() << "\n";
         if (term->is_live() && update_available(reply.update_info()))
             cout << update_notice(reply.update_info());
         return ReturnCode::Ok;
     };
 
-    auto on_failure = [](grpc::Status& status) { return ReturnCode::Ok; };
+    mp::VersionReply cached;
+    const auto cache_age = client::load_cached_reply(version_cache_name, cached);
+
+    // shell prompt integrations run this on every prompt — answer from cache while the daemon's stamp allows
+    if (cache_age && *cache_age < std::chrono::seconds{cached.cache_ttl()})
+        return print_reply(cached);
+
+    auto on_success = [&print_reply](mp::VersionReply& reply) {
+        client::store_cached_reply(version_cache_name, reply);
+        return print_reply(reply);
+    };
+
+    auto on_failure = [&print_reply, &cache_age, &cached](grpc::Status& status) {
+        if (cache_age) // a stale daemon version beats none while the daemon is unreachable
+            return print_reply(cached);
+        return ReturnCode::Ok;
+    };
 
     mp::VersionRequest request;
     request.set_verbosity_level(parser->verbosityLevel());
@@ -30,8 +30,9 @@ std::string mp::CSVFormatter::format(const InfoReply& reply) const
         buf, "Name,State,Ipv4,Ipv6,Release,Image hash,Image release,Load,Disk usage,Disk total,Memory usage,Memory "
              "total,Mounts\n");
 
-    for (const auto& info : format::sorted(reply.info()))
+    for (const auto* info_ptr : format::sorted(reply.info()))
     {
+        const auto& info = *info_ptr;
         fmt::format_to(buf, "{},{},{},{},{},{},{},{},{},{},{},{},", info.name(),
                        mp::format::status_string_for(info.instance_status()), info.ipv4(), info.ipv6(),
                        info.current_release(), info.id(), info.image_release(), info.load(), info.disk_usage(),
@@ -54,8 +55,9 @@ std::string mp::CSVFormatter::format(const ListReply& reply) const
 
     fmt::format_to(buf, "Name,State,IPv4,IPv6,Release\n");
 
-    for (const auto& instance : format::sorted(reply.instances()))
+    for (const auto* instance_ptr : format::sorted(reply.instances()))
     {
+        const auto& instance = *instance_ptr;
         fmt::format_to(buf, "{},{},{},{},{}\n", instance.name(),
                        mp::format::status_string_for(instance.instance_status()), instance.ipv4(), instance.ipv6(),
                        instance.current_release());
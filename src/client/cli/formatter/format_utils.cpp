@@ -23,6 +23,9 @@
 #include <multipass/cli/table_formatter.h>
 #include <multipass/cli/yaml_formatter.h>
 
+#include <QByteArray>
+#include <QLocale>
+
 namespace mp = multipass;
 
 namespace
@@ -110,3 +113,130 @@ void mp::format::filter_aliases(google::protobuf::RepeatedPtrField<multipass::Fi
             aliases.DeleteSubrange(i, 1);
     }
 }
+
+mp::format::JsonWriter::JsonWriter(std::string& out) : out{out}
+{
+}
+
+void mp::format::JsonWriter::begin_entry()
+{
+    if (after_key)
+    { // the key already wrote this entry's separator and indent
+        after_key = false;
+        return;
+    }
+
+    if (!has_entries.empty())
+    {
+        if (has_entries.back())
+            out += ",\n";
+        has_entries.back() = true;
+        out.append(4 * has_entries.size(), ' ');
+    }
+}
+
+void mp::format::JsonWriter::close_container(char bracket)
+{
+    const auto had_entries = has_entries.back();
+    has_entries.pop_back();
+    if (had_entries) // otherwise the opening bracket's newline already ended the line
+        out += '\n';
+    out.append(4 * has_entries.size(), ' ');
+    out += bracket;
+    if (has_entries.empty())
+        out += '\n'; // QJsonDocument::toJson ends documents with a newline
+}
+
+void mp::format::JsonWriter::begin_object()
+{
+    begin_entry();
+    out += "{\n";
+    has_entries.push_back(false);
+}
+
+void mp::format::JsonWriter::end_object()
+{
+    close_container('}');
+}
+
+void mp::format::JsonWriter::begin_array()
+{
+    begin_entry();
+    out += "[\n";
+    has_entries.push_back(false);
+}
+
+void mp::format::JsonWriter::end_array()
+{
+    close_container(']');
+}
+
+void mp::format::JsonWriter::key(const std::string& name)
+{
+    begin_entry();
+    append_escaped(name);
+    out += ": ";
+    after_key = true;
+}
+
+void mp::format::JsonWriter::value(const std::string& str)
+{
+    begin_entry();
+    append_escaped(str);
+}
+
+void mp::format::JsonWriter::value(long long number)
+{
+    begin_entry();
+    out += std::to_string(number);
+}
+
+void mp::format::JsonWriter::value(double number)
+{
+    begin_entry();
+
+    const auto as_integer = static_cast<long long>(number);
+    if (number >= -9007199254740992.0 && number <= 9007199254740992.0 &&
+        static_cast<double>(as_integer) == number) // whole numbers print without a decimal point, as in Qt
+        out += std::to_string(as_integer);
+    else
+        out += QByteArray::number(number, 'g', QLocale::FloatingPointShortest).toStdString();
+}
+
+void mp::format::JsonWriter::append_escaped(const std::string& str)
+{
+    out += '"';
+    for (const unsigned char c : str)
+    {
+        switch (c)
+        {
+        case '"':
+            out += "\\\"";
+            break;
+        case '\\':
+            out += "\\\\";
+            break;
+        case '\b':
+            out += "\\b";
+            break;
+        case '\f':
+            out += "\\f";
+            break;
+        case '\n':
+            out += "\\n";
+            break;
+        case '\r':
+            out += "\\r";
+            break;
+        case '\t':
+            out += "\\t";
+            break;
+        default:
+            if (c < 0x20)
+                out += fmt::format("\\u{:04x}", c);
+            else // UTF-8 passes through unescaped
+                out += c;
+        }
+    }
+    out += '"';
+}
@@ -20,152 +20,258 @@
 #include <multipass/cli/format_utils.h>
 #include <multipass/utils.h>
 
-#include <QJsonArray>
-#include <QJsonDocument>
-#include <QJsonObject>
+#include <algorithm>
+#include <vector>
 
 namespace mp = multipass;
 
+namespace
+{
+std::string id_mapping_for(int host_id, int instance_id)
+{
+    return fmt::format("{}:{}", host_id,
+                       instance_id == mp::default_id ? "default" : std::to_string(instance_id));
+}
+} // namespace
+
 std::string mp::JsonFormatter::format(const InfoReply& reply) const
 {
-    QJsonObject info_json;
-    QJsonObject info_obj;
+    std::string json;
+    json.reserve(64 + reply.info_size() * 768); // a rough per-instance footprint, to avoid regrowing
+
+    mp::format::JsonWriter writer{json};
+    writer.begin_object();
+
+    writer.key("errors");
+    writer.begin_array();
+    writer.end_array();
 
-    info_json.insert("errors", QJsonArray());
+    writer.key("info");
+    writer.begin_object();
 
+    // entries stream out in the order they are written, so sort by name up front to keep the
+    // output identical to what QJsonObject's sorted keys used to produce
+    std::vector<const InfoReply::Info*> infos;
+    infos.reserve(reply.info_size());
     for (const auto& info : reply.info())
-    {
-        QJsonObject instance_info;
-        instance_info.insert("state", QString::fromStdString(mp::format::status_string_for(info.instance_status())));
-        instance_info.insert("image_hash", QString::fromStdString(info.id()));
-        instance_info.insert("image_release", QString::fromStdString(info.image_release()));
-        instance_info.insert("release", QString::fromStdString(info.current_release()));
-
-        QJsonArray load;
-        if (!info.load().empty())
-        {
-            auto loads = mp::utils::split(info.load(), " ");
-            for (const auto& entry : loads)
-                load.append(std::stod(entry));
-        }
-        instance_info.insert("load", load);
+        infos.push_back(&info);
+    std::sort(infos.begin(), infos.end(), [](const auto* a, const auto* b) { return a->name() < b->name(); });
 
-        QJsonObject disks;
-        QJsonObject disk;
-        if (!info.disk_usage().empty())
-            disk.insert("used", QString::fromStdString(info.disk_usage()));
-        if (!info.disk_total().empty())
-            disk.insert("total", QString::fromStdString(info.disk_total()));
+    for (const auto* info : infos)
+    {
+        writer.key(info->name());
+        writer.begin_object();
 
+        writer.key("disks");
+        writer.begin_object();
         // TODO: disk name should come from daemon
-        disks.insert("sda1", disk);
-        instance_info.insert("disks", disks);
-
-        QJsonObject memory;
-        if (!info.memory_usage().empty())
-            memory.insert("used", std::stoll(info.memory_usage()));
-        if (!info.memory_total().empty())
-            memory.insert("total", std::stoll(info.memory_total()));
-        instance_info.insert("memory", memory);
-
-        QJsonArray ipv4_addrs;
-        if (!info.ipv4().empty())
-            ipv4_addrs.append(QString::fromStdString(info.ipv4()));
-        instance_info.insert("ipv4", ipv4_addrs);
-
-        QJsonObject mounts;
-        for (const auto& mount : info.mount_info().mount_paths())
+        writer.key("sda1");
+        writer.begin_object();
+        if (!info->disk_total().empty())
         {
-            QJsonObject entry;
-            QJsonArray mount_uids;
-            QJsonArray mount_gids;
-
-            for (const auto uid_map : mount.mount_maps().uid_map())
+            writer.key("total");
+            writer.value(info->disk_total());
+        }
+        if (!info->disk_usage().empty())
+        {
+            writer.key("used");
+            writer.value(info->disk_usage());
+        }
+        writer.end_object();
+        writer.end_object();
+
+        if (!info->host_cpu_time().empty())
+        { // host-side accounting of the hypervisor process; only reported while the instance runs
+            writer.key("host");
+            writer.begin_object();
+            writer.key("cpu_time");
+            writer.value(info->host_cpu_time());
+            if (!info->host_disk_read().empty())
             {
-                mount_uids.append(
-                    QString("%1:%2")
-                        .arg(QString::number(uid_map.first))
-                        .arg((uid_map.second == mp::default_id) ? "default" : QString::number(uid_map.second)));
+                writer.key("disk_read");
+                writer.value(info->host_disk_read());
             }
-            for (const auto gid_map : mount.mount_maps().gid_map())
+            if (!info->host_disk_write().empty())
             {
-                mount_gids.append(
-                    QString("%1:%2")
-                        .arg(QString::number(gid_map.first))
-                        .arg((gid_map.second == mp::default_id) ? "default" : QString::number(gid_map.second)));
+                writer.key("disk_write");
+                writer.value(info->host_disk_write());
             }
+            writer.key("memory_usage");
+            writer.value(info->host_memory_usage());
+            writer.end_object();
+        }
+
+        writer.key("image_hash");
+        writer.value(info->id());
+        writer.key("image_release");
+        writer.value(info->image_release());
+
+        writer.key("ipv4");
+        writer.begin_array();
+        if (!info->ipv4().empty())
+            writer.value(info->ipv4());
+        writer.end_array();
+
+        writer.key("load");
+        writer.begin_array();
+        if (!info->load().empty())
+            for (const auto& entry : mp::utils::split(info->load(), " "))
+                writer.value(std::stod(entry));
+        writer.end_array();
+
+        writer.key("memory");
+        writer.begin_object();
+        if (!info->memory_total().empty())
+        {
+            writer.key("total");
+            writer.value(std::stoll(info->memory_total()));
+        }
+        if (!info->memory_usage().empty())
+        {
+            writer.key("used");
+            writer.value(std::stoll(info->memory_usage()));
+        }
+        writer.end_object();
+
+        writer.key("mounts");
+        writer.begin_object();
 
-            entry.insert("uid_mappings", mount_uids);
-            entry.insert("gid_mappings", mount_gids);
-            entry.insert("source_path", QString::fromStdString(mount.source_path()));
+        std::vector<const MountInfo::MountPaths*> mounts;
+        mounts.reserve(info->mount_info().mount_paths_size());
+        for (const auto& mount : info->mount_info().mount_paths())
+            mounts.push_back(&mount);
+        std::sort(mounts.begin(), mounts.end(),
+                  [](const auto* a, const auto* b) { return a->target_path() < b->target_path(); });
 
-            mounts.insert(QString::fromStdString(mount.target_path()), entry);
+        for (const auto* mount : mounts)
+        {
+            writer.key(mount->target_path());
+            writer.begin_object();
+
+            writer.key("gid_mappings");
+            writer.begin_array();
+            for (const auto& gid_map : mount->mount_maps().gid_map())
+                writer.value(id_mapping_for(gid_map.first, gid_map.second));
+            writer.end_array();
+
+            writer.key("source_path");
+            writer.value(mount->source_path());
+
+            writer.key("uid_mappings");
+            writer.begin_array();
+            for (const auto& uid_map : mount->mount_maps().uid_map())
+                writer.value(id_mapping_for(uid_map.first, uid_map.second));
+            writer.end_array();
+
+            writer.end_object();
         }
-        instance_info.insert("mounts", mounts);
+        writer.end_object();
+
+        writer.key("release");
+        writer.value(info->current_release());
+        writer.key("state");
+        writer.value(mp::format::status_string_for(info->instance_status()));
 
-        info_obj.insert(QString::fromStdString(info.name()), instance_info);
+        writer.end_object();
     }
-    info_json.insert("info", info_obj);
+    writer.end_object();
 
-    return QString(QJsonDocument(info_json).toJson()).toStdString();
+    writer.end_object();
+    return json;
 }
 
 std::string mp::JsonFormatter::format(const ListReply& reply) const
 {
-    QJsonObject list_json;
-    QJsonArray instances;
+    std::string json;
+    json.reserve(64 + reply.instances_size() * 192);
+
+    mp::format::JsonWriter writer{json};
+    writer.begin_object();
+
+    writer.key("list");
+    writer.begin_array();
 
     for (const auto& instance : reply.instances())
     {
-        QJsonObject instance_obj;
-        instance_obj.insert("name", QString::fromStdString(instance.name()));
-        instance_obj.insert("state", QString::fromStdString(mp::format::status_string_for(instance.instance_status())));
+        writer.begin_object();
 
-        QJsonArray ipv4_addrs;
+        writer.key("ipv4");
+        writer.begin_array();
         if (!instance.ipv4().empty())
-            ipv4_addrs.append(QString::fromStdString(instance.ipv4()));
-        instance_obj.insert("ipv4", ipv4_addrs);
+            writer.value(instance.ipv4());
+        writer.end_array();
 
-        instance_obj.insert("release", QString::fromStdString(instance.current_release()));
+        writer.key("name");
+        writer.value(instance.name());
+        writer.key("release");
+        writer.value(instance.current_release());
+        writer.key("state");
+        writer.value(mp::format::status_string_for(instance.instance_status()));
 
-        instances.append(instance_obj);
+        writer.end_object();
     }
+    writer.end_array();
 
-    list_json.insert("list", instances);
-
-    return QString(QJsonDocument(list_json).toJson()).toStdString();
+    writer.end_object();
+    return json;
 }
 
 std::string mp::JsonFormatter::format(const FindReply& reply) const
 {
-    QJsonObject find_json;
-    QJsonObject images;
+    std::string json;
+    json.reserve(64 + reply.images_info_size() * 256);
 
-    find_json.insert("errors", QJsonArray());
+    mp::format::JsonWriter writer{json};
+    writer.begin_object();
 
-    for (const auto& image : reply.images_info())
+    writer.key("errors");
+    writer.begin_array();
+    writer.end_array();
+
+    writer.key("images");
+    writer.begin_object();
+
+    struct ImageEntry
     {
-        QJsonObject image_obj;
-        image_obj.insert("os", QString::fromStdString(image.os()));
-        image_obj.insert("release", QString::fromStdString(image.release()));
-        image_obj.insert("version", QString::fromStdString(image.version()));
+        std::string key;
+        const FindReply::ImageInfo* image;
+        google::protobuf::RepeatedPtrField<FindReply::AliasInfo> aliases;
+    };
 
-        QJsonArray aliases_arr;
+    std::vector<ImageEntry> images;
+    images.reserve(reply.images_info_size());
+    for (const auto& image : reply.images_info())
+    {
         auto aliases = image.aliases_info();
         mp::format::filter_aliases(aliases);
-
-        for (auto alias = aliases.cbegin() + 1; alias != aliases.cend(); alias++)
-        {
-            aliases_arr.append(QString::fromStdString(alias->alias()));
-        }
-        image_obj.insert("aliases", aliases_arr);
-
-        image_obj.insert("remote", QString::fromStdString(aliases[0].remote_name()));
-
-        images.insert(QString::fromStdString(mp::format::image_string_for(aliases[0])), image_obj);
+        images.push_back({mp::format::image_string_for(aliases[0]), &image, std::move(aliases)});
     }
+    std::sort(images.begin(), images.end(), [](const auto& a, const auto& b) { return a.key < b.key; });
 
-    find_json.insert("images", images);
+    for (const auto& entry : images)
+    {
+        writer.key(entry.key);
+        writer.begin_object();
+
+        writer.key("aliases");
+        writer.begin_array();
+        for (auto alias = entry.aliases.cbegin() + 1; alias != entry.aliases.cend(); alias++)
+            writer.value(alias->alias());
+        writer.end_array();
+
+        writer.key("os");
+        writer.value(entry.image->os());
+        writer.key("release");
+        writer.value(entry.image->release());
+        writer.key("remote");
+        writer.value(entry.aliases[0].remote_name());
+        writer.key("version");
+        writer.value(entry.image->version());
+
+        writer.end_object();
+    }
+    writer.end_object();
 
-    return QString(QJsonDocument(find_json).toJson()).toStdString();
+    writer.end_object();
+    return json;
 }
@@ -54,8 +54,9 @@ std::string mp::TableFormatter::format(const InfoReply& reply) const
 {
     fmt::memory_buffer buf;
 
-    for (const auto& info : format::sorted(reply.info()))
+    for (const auto* info_ptr : format::sorted(reply.info()))
     {
+        const auto& info = *info_ptr;
         fmt::format_to(buf, "{:<16}{}\n", "Name:", info.name());
         fmt::format_to(buf, "{:<16}{}\n", "State:", mp::format::status_string_for(info.instance_status()));
         fmt::format_to(buf, "{:<16}{}\n", "IPv4:", info.ipv4().empty() ? "--" : info.ipv4());
@@ -120,7 +121,7 @@ std::string mp::TableFormatter::format(const ListReply& reply) const
 {
     fmt::memory_buffer buf;
 
-    auto instances = reply.instances();
+    const auto instances = format::sorted(reply.instances()); // sorted once, reused for layout and rows
 
     if (instances.empty())
         return "No instances found.\n";
@@ -128,10 +129,10 @@ std::string mp::TableFormatter::format(const ListReply& reply) const
     const std::string::size_type minimal_name_column_width = 24;
     const std::string::size_type state_column_width = 18;
     const std::string::size_type ip_column_width = 17;
-    const auto get_name_length = [](const auto& instance) { return instance.name().length(); };
+    const auto get_name_length = [](const auto* instance) { return instance->name().length(); };
 
     auto largest_name_it =
-        std::max_element(instances.begin(), instances.end(), [&get_name_length](auto& lhs, auto& rhs) {
+        std::max_element(instances.begin(), instances.end(), [&get_name_length](const auto* lhs, const auto* rhs) {
             return get_name_length(lhs) < get_name_length(rhs);
         });
 
@@ -141,8 +142,9 @@ std::string mp::TableFormatter::format(const ListReply& reply) const
     fmt::format_to(buf, row_format, "Name", name_column_width, "State", state_column_width, "IPv4", ip_column_width,
                    "Image");
 
-    for (const auto& instance : format::sorted(reply.instances()))
+    for (const auto* instance_ptr : instances)
     {
+        const auto& instance = *instance_ptr;
         fmt::format_to(buf, row_format, instance.name(), name_column_width,
                        mp::format::status_string_for(instance.instance_status()), state_column_width,
                        instance.ipv4().empty() ? "--" : instance.ipv4(), ip_column_width,
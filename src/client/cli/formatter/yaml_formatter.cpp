@@ -34,8 +34,9 @@ std::string mp::YamlFormatter::format(const InfoReply& reply) const
 
     info_node["errors"].push_back(YAML::Null);
 
-    for (const auto& info : format::sorted(reply.info()))
+    for (const auto* info_ptr : format::sorted(reply.info()))
     {
+        const auto& info = *info_ptr;
         YAML::Node instance_node;
 
         instance_node["state"] = mp::format::status_string_for(info.instance_status());
@@ -115,8 +116,9 @@ std::string mp::YamlFormatter::format(const ListReply& reply) const
 {
     YAML::Node list;
 
-    for (const auto& instance : format::sorted(reply.instances()))
+    for (const auto* instance_ptr : format::sorted(reply.instances()))
     {
+        const auto& instance = *instance_ptr;
         YAML::Node instance_node;
         instance_node["state"] = mp::format::status_string_for(instance.instance_status());
 
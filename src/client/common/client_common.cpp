@@ -25,6 +25,10 @@
 #include <multipass/logging/log.h>
 #include <multipass/logging/standard_logger.h>
 
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+
 namespace mp = multipass;
 namespace mpl = multipass::logging;
 
@@ -34,6 +38,12 @@ mp::ReturnCode return_code_for(const grpc::StatusCode& code)
 {
     return code == grpc::StatusCode::UNAVAILABLE ? mp::ReturnCode::DaemonFail : mp::ReturnCode::CommandFail;
 }
+
+QString cached_reply_path(const std::string& name)
+{
+    const auto cache_dir = mp::StandardPaths::instance().writableLocation(mp::StandardPaths::CacheLocation);
+    return QString{"%1/%2.bin"}.arg(mp::utils::make_dir(cache_dir, "replies"), QString::fromStdString(name));
+}
 } // namespace
 
 mp::ReturnCode mp::cmd::standard_failure_handler_for(const std::string& command, std::ostream& cerr,
@@ -56,6 +66,10 @@ std::shared_ptr<grpc::Channel> mp::client::make_channel(const std::string& serve
                                                         mp::RpcConnectionType conn_type,
                                                         mp::CertProvider& cert_provider)
 {
+    if (conn_type == mp::RpcConnectionType::ssl && mp::utils::is_local_socket_address(server_address))
+        conn_type = mp::RpcConnectionType::insecure; // matches the daemon, which serves local sockets in plaintext and
+                                                     // relies on the socket's own permissions for authentication
+
     std::shared_ptr<grpc::ChannelCredentials> creds;
     if (conn_type == mp::RpcConnectionType::ssl)
     {
@@ -73,7 +87,14 @@ std::shared_ptr<grpc::Channel> mp::client::make_channel(const std::string& serve
     {
         throw std::runtime_error("Unknown connection type");
     }
-    return grpc::CreateChannel(server_address, creds);
+
+    grpc::ChannelArguments channel_args;
+    if (mp::utils::is_local_socket_address(server_address))
+    { /* grpc consults the proxy environment when setting up each channel; a proxy makes no sense on
+         the way to a local socket, so spare every CLI invocation that lookup */
+        channel_args.SetInt(GRPC_ARG_ENABLE_HTTP_PROXY, 0);
+    }
+    return grpc::CreateCustomChannel(server_address, creds, channel_args);
 }
 
 std::string mp::client::get_server_address()
@@ -105,6 +126,27 @@ void mp::client::set_logger(mpl::Level verbosity)
     mpl::set_logger(std::make_shared<mpl::StandardLogger>(verbosity));
 }
 
+auto mp::client::load_cached_reply(const std::string& name, google::protobuf::Message& reply)
+    -> optional<std::chrono::seconds>
+{
+    QFile file{cached_reply_path(name)};
+    if (!file.open(QIODevice::ReadOnly))
+        return nullopt;
+
+    const auto data = file.readAll();
+    if (!reply.ParseFromArray(data.constData(), data.size()))
+        return nullopt; // e.g. written by a client with a different proto; treat as absent
+
+    return std::chrono::seconds{QFileInfo{file}.lastModified().secsTo(QDateTime::currentDateTime())};
+}
+
+void mp::client::store_cached_reply(const std::string& name, const google::protobuf::Message& reply)
+{
+    QFile file{cached_reply_path(name)};
+    if (file.open(QIODevice::WriteOnly)) // best effort; a failed write only costs the next call a round trip
+        file.write(QByteArray::fromStdString(reply.SerializeAsString()));
+}
+
 void mp::client::pre_setup()
 {
     try
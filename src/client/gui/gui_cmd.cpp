@@ -139,7 +139,7 @@ void cmd::GuiCmd::create_actions()
     mp::utils::check_and_create_config_file(client_config_path);
     config_watcher.addPath(client_config_path);
     QObject::connect(&config_watcher, &QFileSystemWatcher::fileChanged, this, [this](const QString& path) {
-        autostart_option.setChecked(Settings::instance().get_as<bool>(autostart_key));
+        autostart_option.setChecked(Settings::instance().get(settings::autostart));
         // Needed since the original watched file may be removed and opened as a new file
         if (!config_watcher.files().contains(path) && QFile::exists(path))
         {
@@ -285,7 +285,7 @@ void cmd::GuiCmd::create_menu()
     about_menu.setTitle("About");
 
     autostart_option.setCheckable(true);
-    autostart_option.setChecked(Settings::instance().get_as<bool>(autostart_key));
+    autostart_option.setChecked(Settings::instance().get(settings::autostart));
     QObject::connect(&autostart_option, &QAction::toggled, this,
                      [](bool checked) { Settings::instance().set(autostart_key, QVariant(checked).toString()); });
 
@@ -378,7 +378,7 @@ void cmd::GuiCmd::create_menu_actions_for(const std::string& instance_name, cons
 
 void cmd::GuiCmd::handle_petenv_instance(const google::protobuf::RepeatedPtrField<mp::ListVMInstance>& instances)
 {
-    auto petenv_name = Settings::instance().get(petenv_key).toStdString();
+    auto petenv_name = Settings::instance().get(settings::petenv).toStdString();
     auto petenv_instance =
         std::find_if(instances.cbegin(), instances.cend(),
                      [&petenv_name](const ListVMInstance& instance) { return petenv_name == instance.name(); });
@@ -25,7 +25,11 @@ constexpr auto base_cloud_init_config = "growpart:\n"
                                         "    ignore_growroot_disabled: false\n"
                                         "users:\n"
                                         "    - default\n"
-                                        "manage_etc_hosts: true\n";
+                                        "manage_etc_hosts: true\n"
+                                        // guest side of the qemu backend's telemetry channel; small and inert
+                                        // on backends without a virtio-serial port for it to attach to
+                                        "packages:\n"
+                                        "    - qemu-guest-agent\n";
 }
 
 #endif // MULTIPASS_BASE_CLOUD_INIT_CONFIG_H
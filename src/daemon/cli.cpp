@@ -62,10 +62,13 @@ mp::DaemonConfigBuilder mp::cli::parse(const QCoreApplication& app)
                                       "specifies which address to use for the multipassd service;"
                                       " a socket can be specified using unix:<socket_file>",
                                       "server_name:port"};
+    QCommandLineOption profile_startup_option{
+        "profile-startup", "writes a chrome-trace report of the daemon's initialization timings once ready"};
 
     parser.addOption(logger_option);
     parser.addOption(verbosity_option);
     parser.addOption(address_option);
+    parser.addOption(profile_startup_option);
 
     parser.process(app);
 
@@ -92,5 +95,7 @@ mp::DaemonConfigBuilder mp::cli::parse(const QCoreApplication& app)
         builder.server_address = address;
     }
 
+    builder.profile_startup = parser.isSet(profile_startup_option);
+
     return builder;
 }
@@ -21,16 +21,20 @@
 
 #include <multipass/format.h>
 
+#include <algorithm>
+#include <random>
+
 namespace mp = multipass;
 namespace mpl = multipass::logging;
 
 namespace
 {
 constexpr auto category = "VMImageHost";
+constexpr auto max_ttl_stretch = 8;
 }
 
 mp::CommonVMImageHost::CommonVMImageHost(std::chrono::seconds manifest_time_to_live)
-  : manifest_time_to_live{manifest_time_to_live}, last_update{}
+  : manifest_time_to_live{manifest_time_to_live}, current_ttl{manifest_time_to_live}, last_update{}
 {
     // careful: the functor below relies on polymorphic behavior, which is not available in constructors
     // fine here as the call is deferred to after the constructor is done (independently of connection type)
@@ -63,17 +67,37 @@ auto mp::CommonVMImageHost::info_for_full_hash(const std::string& full_hash) ->
     return info_for_full_hash_impl(full_hash);
 }
 
+auto mp::CommonVMImageHost::catalog_version() -> std::string
+{
+    update_manifests();
+
+    return catalog_version_impl();
+}
+
 void mp::CommonVMImageHost::update_manifests()
 {
     const auto now = std::chrono::steady_clock::now();
-    if ((now - last_update) > manifest_time_to_live || need_extra_update)
+    if ((now - last_update) > current_ttl || need_extra_update)
     {
         need_extra_update = false;
 
+        const auto previous_version = catalog_version_impl();
         clear();
         fetch_manifests();
 
         last_update = now;
+
+        /* Images are published far less often than the base TTL, so the refresh interval stretches (up to
+           8x) while consecutive fetches come back identical, snapping back once something new lands. The
+           jitter spreads revalidation over time, keeping periodic tasks from hitting the mirrors in
+           lockstep with everyone else's */
+        auto ttl = manifest_time_to_live;
+        if (!previous_version.empty() && catalog_version_impl() == previous_version)
+            ttl = std::min(current_ttl * 2, manifest_time_to_live * max_ttl_stretch);
+
+        static std::default_random_engine gen{std::random_device{}()};
+        std::uniform_int_distribution<std::chrono::seconds::rep> jitter{-ttl.count() / 8, ttl.count() / 8};
+        current_ttl = ttl + std::chrono::seconds{jitter(gen)};
     }
 }
 
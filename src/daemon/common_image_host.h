@@ -33,6 +33,7 @@ public:
     CommonVMImageHost(std::chrono::seconds manifest_time_to_live);
     void for_each_entry_do(const Action& action) final;
     VMImageInfo info_for_full_hash(const std::string& full_hash) final;
+    std::string catalog_version() final;
 
 protected:
     void update_manifests();
@@ -43,9 +44,11 @@ protected:
     virtual VMImageInfo info_for_full_hash_impl(const std::string& full_hash) = 0;
     virtual void clear() = 0;
     virtual void fetch_manifests() = 0;
+    virtual std::string catalog_version_impl() const = 0;
 
 private:
     std::chrono::seconds manifest_time_to_live;
+    std::chrono::seconds current_ttl; // stretches while refreshes find nothing new; see update_manifests
     std::chrono::steady_clock::time_point last_update;
     bool need_extra_update = true;
     QTimer manifest_single_shot;
@@ -263,6 +263,22 @@ void mp::CustomVMImageHost::clear()
     custom_image_info.clear();
 }
 
+auto mp::CustomVMImageHost::catalog_version_impl() const -> std::string
+{
+    fmt::memory_buffer version; // iteration follows `remotes` to keep the stamp stable across refreshes
+    for (const auto& remote : remotes)
+    {
+        auto it = custom_image_info.find(remote);
+        if (it == custom_image_info.end())
+            continue;
+
+        for (const auto& product : it->second->products)
+            fmt::format_to(version, "{}@{};", product.id, product.version);
+    }
+
+    return fmt::to_string(version);
+}
+
 mp::CustomManifest* mp::CustomVMImageHost::manifest_from(const std::string& remote_name)
 {
     update_manifests();
@@ -54,6 +54,7 @@ protected:
     VMImageInfo info_for_full_hash_impl(const std::string& full_hash) override;
     void fetch_manifests() override;
     void clear() override;
+    std::string catalog_version_impl() const override;
 
 private:
     CustomManifest* manifest_from(const std::string& remote_name);
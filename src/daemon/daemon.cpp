@@ -26,12 +26,16 @@
 #include <multipass/exceptions/invalid_memory_size_exception.h>
 #include <multipass/exceptions/sshfs_missing_error.h>
 #include <multipass/exceptions/start_exception.h>
+#include <multipass/file_watcher.h>
 #include <multipass/logging/client_logger.h>
 #include <multipass/logging/log.h>
 #include <multipass/name_generator.h>
+#include <multipass/performance_counters.h>
 #include <multipass/platform.h>
 #include <multipass/query.h>
+#include <multipass/settings.h>
 #include <multipass/ssh/ssh_session.h>
+#include <multipass/tracing/trace_recorder.h>
 #include <multipass/utils.h>
 #include <multipass/version.h>
 #include <multipass/virtual_machine.h>
@@ -52,13 +56,21 @@
 #include <QJsonObject>
 #include <QJsonParseError>
 #include <QSysInfo>
+#include <QThread>
 #include <QtConcurrent/QtConcurrent>
 
+#include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <functional>
+#include <limits>
+#include <map>
 #include <stdexcept>
+#include <thread>
 #include <utility>
 
+#include <unistd.h>
+
 namespace mp = multipass;
 namespace mpl = multipass::logging;
 namespace mpu = multipass::utils;
@@ -72,12 +84,24 @@ using error_string = std::string;
 
 constexpr auto category = "daemon";
 constexpr auto instance_db_name = "multipassd-vm-instances.json";
+constexpr auto instance_db_journal_name = "multipassd-vm-instances.journal";
+constexpr auto max_journal_entries = 128; // journal is folded back into the main DB when it grows past this
 constexpr auto uuid_file_name = "multipass-unique-id";
 constexpr auto metrics_opt_in_file = "multipassd-send-metrics.yaml";
 constexpr auto reboot_cmd = "sudo reboot";
 constexpr auto up_timeout = 2min; // This may be tweaked as appropriate and used in places that wait for ssh to be up
+constexpr auto instance_stats_ttl = 10s; // how long cached instance stats are considered fresh
+constexpr auto idle_check_interval = 1min;     // how often running instances are sampled for activity
+constexpr auto idle_cpu_threshold = 1.2;       /* hypervisor CPU seconds per check interval above which an instance
+                                                  counts as busy (2% of one core) */
+constexpr auto idle_net_threshold = 16 * 1024; /* bytes on the instance's network device per check interval above
+                                                  which it counts as busy; background chatter stays below this */
 constexpr auto cloud_init_timeout = 5min;
 constexpr auto stop_ssh_cmd = "sudo systemctl stop ssh";
+constexpr auto max_concurrent_ops_env_var = "MULTIPASS_MAX_CONCURRENT_OPS";
+constexpr auto prefetch_images_env_var = "MULTIPASS_PREFETCH_IMAGES"; // comma-separated, e.g. "lts,daily:devel"
+constexpr auto standby_image_env_var = "MULTIPASS_STANDBY_IMAGE";     // e.g. "bionic" or "daily:devel"
+constexpr auto standby_count_env_var = "MULTIPASS_STANDBY_COUNT";     // instances to keep prepared ahead; default 1
 const std::string sshfs_error_template = "Error enabling mount support in '{}'"
                                          "\n\nPlease install the 'multipass-sshfs' snap manually inside the instance.";
 
@@ -96,12 +120,27 @@ mp::Query query_from(const mp::LaunchRequest* request, const std::string& name)
     else if (QString::fromStdString(image).startsWith("http"))
         query_type = mp::Query::Type::HttpDownload;
 
-    return {name, image, false, request->remote_name(), query_type, true};
+    return {name, image, false, request->remote_name(), query_type, true, request->full_copy()};
 }
 
 auto make_cloud_init_vendor_config(const mp::SSHKeyProvider& key_provider, const std::string& time_zone,
                                    const std::string& username, const std::string& backend_version_string)
 {
+    /* Within a daemon run the result only varies with the inputs below (the key provider is fixed), so the
+       parsed-and-populated document is built once per combination seen and copies are handed out — yaml-cpp
+       parsing of the base config was a measurable slice of the launch path. Launches run concurrently on the
+       instance-operations pool, hence the lock */
+    static std::mutex cache_mutex;
+    static std::unordered_map<std::string, YAML::Node> cache;
+    const auto cache_key = fmt::format("{}|{}|{}", time_zone, username, backend_version_string);
+
+    {
+        std::lock_guard<std::mutex> lock{cache_mutex};
+        auto cached = cache.find(cache_key);
+        if (cached != cache.end())
+            return YAML::Clone(cached->second); // a copy, so callers remain free to tweak theirs
+    }
+
     auto ssh_key_line = fmt::format("ssh-rsa {} {}@localhost", key_provider.public_key_as_base64(), username);
 
     auto config = YAML::Load(mp::base_cloud_init_config);
@@ -121,7 +160,9 @@ auto make_cloud_init_vendor_config(const mp::SSHKeyProvider& key_provider, const
 
     config["write_files"].push_back(pollinate_user_agent_node);
 
-    return config;
+    std::lock_guard<std::mutex> lock{cache_mutex};
+    cache.emplace(cache_key, config);
+    return YAML::Clone(config);
 }
 
 auto make_cloud_init_meta_config(const std::string& name)
@@ -163,9 +204,10 @@ void prepare_user_data(YAML::Node& user_data_config, YAML::Node& vendor_config)
 
 mp::VirtualMachineDescription to_machine_desc(const mp::LaunchRequest* request, const std::string& name,
                                               const mp::MemorySize& mem_size, const mp::MemorySize& disk_space,
-                                              const std::string& mac_addr, const std::string& ssh_username,
-                                              const mp::VMImage& image, YAML::Node& meta_data_config,
-                                              YAML::Node& user_data_config, YAML::Node& vendor_data_config)
+                                              const mp::IoLimits& io_limits, const std::string& mac_addr,
+                                              const std::string& ssh_username, const mp::VMImage& image,
+                                              YAML::Node& meta_data_config, YAML::Node& user_data_config,
+                                              YAML::Node& vendor_data_config)
 {
     const auto num_cores = request->num_cores() < std::stoi(mp::min_cpu_cores)
                                ? std::stoi(mp::default_cpu_cores)
@@ -173,29 +215,138 @@ mp::VirtualMachineDescription to_machine_desc(const mp::LaunchRequest* request,
     const auto instance_dir = mp::utils::base_dir(image.image_path);
     const auto cloud_init_iso =
         make_cloud_init_image(name, instance_dir, meta_data_config, user_data_config, vendor_data_config);
-    return {num_cores,        mem_size,         disk_space,        name, mac_addr, ssh_username, image, cloud_init_iso,
-            meta_data_config, user_data_config, vendor_data_config};
+    return {num_cores,     mem_size,         disk_space,       name,
+            mac_addr,      ssh_username,     image,            cloud_init_iso,
+            meta_data_config, user_data_config, vendor_data_config, io_limits};
 }
 
 template <typename T>
-auto name_from(const std::string& requested_name, mp::NameGenerator& name_gen, const T& currently_used_names)
+auto name_from(const std::string& requested_name, mp::NameGenerator& name_gen, const T& instances,
+               const T& deleted_instances)
 {
     if (requested_name.empty())
+        return name_gen.make_name([&instances, &deleted_instances](const std::string& name) {
+            return instances.find(name) == instances.end() &&
+                   deleted_instances.find(name) == deleted_instances.end();
+        }); // the reservation predicate runs and the name is claimed without yielding to other requests in between
+
+    return requested_name;
+}
+
+mp::VMSpecs spec_from_json(const QJsonObject& record)
+{
+    auto num_cores = record["num_cores"].toInt();
+    auto mem_size = record["mem_size"].toString().toStdString();
+    auto disk_iops = record["disk_iops"].toString().toLongLong(); // missing keys parse to 0, i.e. unlimited
+    auto disk_bandwidth = record["disk_bandwidth"].toString().toLongLong();
+    auto disk_space = record["disk_space"].toString().toStdString();
+    auto mac_addr = record["mac_addr"].toString().toStdString();
+    auto ssh_username = record["ssh_username"].toString().toStdString();
+    auto state = record["state"].toInt();
+    auto deleted = record["deleted"].toBool();
+    auto metadata = record["metadata"].toObject();
+
+    if (ssh_username.empty())
+        ssh_username = "ubuntu";
+
+    std::unordered_map<std::string, mp::VMMount> mounts;
+    std::unordered_map<int, int> uid_map;
+    std::unordered_map<int, int> gid_map;
+
+    for (const auto& entry : record["mounts"].toArray())
     {
-        auto name = name_gen.make_name();
-        constexpr int num_retries = 100;
-        for (int i = 0; i < num_retries; i++)
+        auto target_path = entry.toObject()["target_path"].toString().toStdString();
+        auto source_path = entry.toObject()["source_path"].toString().toStdString();
+
+        for (const auto& uid_entry : entry.toObject()["uid_mappings"].toArray())
         {
-            if (currently_used_names.find(name) != currently_used_names.end())
-                continue;
-            return name;
+            uid_map[uid_entry.toObject()["host_uid"].toInt()] = uid_entry.toObject()["instance_uid"].toInt();
+        }
+
+        for (const auto& gid_entry : entry.toObject()["gid_mappings"].toArray())
+        {
+            gid_map[gid_entry.toObject()["host_gid"].toInt()] = gid_entry.toObject()["instance_gid"].toInt();
         }
-        throw std::runtime_error("unable to generate a unique name");
+
+        mp::VMMount mount{source_path, gid_map, uid_map};
+        mounts[target_path] = mount;
     }
-    return requested_name;
+
+    std::vector<std::string> boot_dependencies;
+    for (const auto& dependency : record["boot_dependencies"].toArray())
+        boot_dependencies.push_back(dependency.toString().toStdString());
+
+    return {num_cores,
+            mp::MemorySize{mem_size.empty() ? mp::default_memory_size : mem_size},
+            mp::MemorySize{disk_space.empty() ? mp::default_disk_size : disk_space},
+            mac_addr,
+            ssh_username,
+            static_cast<mp::VirtualMachine::State>(state),
+            mounts,
+            deleted,
+            metadata,
+            mp::IoLimits{disk_iops, disk_bandwidth},
+            boot_dependencies};
+}
+
+QJsonObject vm_spec_to_json(const mp::VMSpecs& specs)
+{
+    QJsonObject json;
+    json.insert("num_cores", specs.num_cores);
+    json.insert("mem_size", QString::number(specs.mem_size.in_bytes()));
+    json.insert("disk_space", QString::number(specs.disk_space.in_bytes()));
+    json.insert("mac_addr", QString::fromStdString(specs.mac_addr));
+    json.insert("ssh_username", QString::fromStdString(specs.ssh_username));
+    json.insert("state", static_cast<int>(specs.state));
+    json.insert("deleted", specs.deleted);
+    json.insert("metadata", specs.metadata);
+    json.insert("disk_iops", QString::number(specs.io_limits.iops));
+    json.insert("disk_bandwidth", QString::number(specs.io_limits.bytes_per_second));
+
+    QJsonArray mounts;
+    for (const auto& mount : specs.mounts)
+    {
+        QJsonObject entry;
+        entry.insert("source_path", QString::fromStdString(mount.second.source_path));
+        entry.insert("target_path", QString::fromStdString(mount.first));
+
+        QJsonArray uid_map;
+        for (const auto& map : mount.second.uid_map)
+        {
+            QJsonObject map_entry;
+            map_entry.insert("host_uid", map.first);
+            map_entry.insert("instance_uid", map.second);
+
+            uid_map.append(map_entry);
+        }
+
+        entry.insert("uid_mappings", uid_map);
+
+        QJsonArray gid_map;
+        for (const auto& map : mount.second.gid_map)
+        {
+            QJsonObject map_entry;
+            map_entry.insert("host_gid", map.first);
+            map_entry.insert("instance_gid", map.second);
+
+            gid_map.append(map_entry);
+        }
+
+        entry.insert("gid_mappings", gid_map);
+        mounts.append(entry);
+    }
+
+    json.insert("mounts", mounts);
+
+    QJsonArray boot_dependencies;
+    for (const auto& dependency : specs.boot_dependencies)
+        boot_dependencies.append(QString::fromStdString(dependency));
+    json.insert("boot_dependencies", boot_dependencies);
+
+    return json;
 }
 
-std::unordered_map<std::string, mp::VMSpecs> load_db(const mp::Path& data_path, const mp::Path& cache_path)
+std::unordered_map<std::string, mp::VMSpecs> load_base_db(const mp::Path& data_path, const mp::Path& cache_path)
 {
     QDir data_dir{data_path};
     QDir cache_dir{cache_path};
@@ -212,7 +363,7 @@ std::unordered_map<std::string, mp::VMSpecs> load_db(const mp::Path& data_path,
     }
 
     QJsonParseError parse_error;
-    auto doc = QJsonDocument::fromJson(db_file.readAll(), &parse_error);
+    auto doc = mp::utils::load_json_document(db_file, &parse_error);
     if (doc.isNull())
         return {};
 
@@ -228,52 +379,38 @@ std::unordered_map<std::string, mp::VMSpecs> load_db(const mp::Path& data_path,
         if (record.isEmpty())
             return {};
 
-        auto num_cores = record["num_cores"].toInt();
-        auto mem_size = record["mem_size"].toString().toStdString();
-        auto disk_space = record["disk_space"].toString().toStdString();
-        auto mac_addr = record["mac_addr"].toString().toStdString();
-        auto ssh_username = record["ssh_username"].toString().toStdString();
-        auto state = record["state"].toInt();
-        auto deleted = record["deleted"].toBool();
-        auto metadata = record["metadata"].toObject();
-
-        if (ssh_username.empty())
-            ssh_username = "ubuntu";
-
-        std::unordered_map<std::string, mp::VMMount> mounts;
-        std::unordered_map<int, int> uid_map;
-        std::unordered_map<int, int> gid_map;
+        reconstructed_records[key] = spec_from_json(record);
+    }
+    return reconstructed_records;
+}
 
-        for (const auto& entry : record["mounts"].toArray())
-        {
-            auto target_path = entry.toObject()["target_path"].toString().toStdString();
-            auto source_path = entry.toObject()["source_path"].toString().toStdString();
+std::unordered_map<std::string, mp::VMSpecs> load_db(const mp::Path& data_path, const mp::Path& cache_path)
+{ // The journal holds individual record updates appended since the main DB was last rewritten
+    MP_TRACE_SPAN("load_db");
+    auto records = load_base_db(data_path, cache_path);
 
-            for (const auto& uid_entry : entry.toObject()["uid_mappings"].toArray())
-            {
-                uid_map[uid_entry.toObject()["host_uid"].toInt()] = uid_entry.toObject()["instance_uid"].toInt();
-            }
+    QFile journal_file{QDir{data_path}.filePath(instance_db_journal_name)};
+    if (!journal_file.open(QIODevice::ReadOnly))
+        return records;
 
-            for (const auto& gid_entry : entry.toObject()["gid_mappings"].toArray())
-            {
-                gid_map[gid_entry.toObject()["host_gid"].toInt()] = gid_entry.toObject()["instance_gid"].toInt();
-            }
+    while (!journal_file.atEnd())
+    {
+        auto doc = QJsonDocument::fromJson(journal_file.readLine());
+        if (doc.isNull())
+            continue;
 
-            mp::VMMount mount{source_path, gid_map, uid_map};
-            mounts[target_path] = mount;
-        }
+        auto entry = doc.object();
+        auto name = entry["name"].toString().toStdString();
+        if (name.empty())
+            continue;
 
-        reconstructed_records[key] = {num_cores,
-                                      mp::MemorySize{mem_size.empty() ? mp::default_memory_size : mem_size},
-                                      mp::MemorySize{disk_space.empty() ? mp::default_disk_size : disk_space},
-                                      mac_addr,
-                                      ssh_username,
-                                      static_cast<mp::VirtualMachine::State>(state),
-                                      mounts,
-                                      deleted,
-                                      metadata};
+        if (entry["removed"].toBool())
+            records.erase(name);
+        else
+            records[name] = spec_from_json(entry["record"].toObject());
     }
-    return reconstructed_records;
+
+    return records;
 }
 
 auto fetch_image_for(const std::string& name, const mp::FetchType& fetch_type, mp::VMImageVault& vault)
@@ -300,9 +437,8 @@ auto try_mem_size(const std::string& val) -> mp::optional<mp::MemorySize>
 
 auto validate_create_arguments(const mp::LaunchRequest* request)
 {
-    static const auto min_mem = try_mem_size(mp::min_memory_size);
-    static const auto min_disk = try_mem_size(mp::min_disk_size);
-    assert(min_mem && min_disk);
+    constexpr auto min_mem = mp::MemorySize{mp::min_memory_size}; // the constexpr parse validates
+    constexpr auto min_disk = mp::MemorySize{mp::min_disk_size};  // these defaults at compile time
 
     auto mem_size_str = request->mem_size();
     auto disk_space_str = request->disk_space();
@@ -326,13 +462,25 @@ auto validate_create_arguments(const mp::LaunchRequest* request)
     if (!request->instance_name().empty() && !mp::utils::valid_hostname(request->instance_name()))
         option_errors.add_error_codes(mp::LaunchError::INVALID_HOSTNAME);
 
+    mp::IoLimits io_limits{};
+    if (request->disk_iops() > 0)
+        io_limits.iops = request->disk_iops();
+
+    const auto disk_bandwidth_str = request->disk_bandwidth();
+    const auto opt_disk_bandwidth = try_mem_size(disk_bandwidth_str.empty() ? "0" : disk_bandwidth_str);
+    if (opt_disk_bandwidth)
+        io_limits.bytes_per_second = opt_disk_bandwidth->in_bytes();
+    else
+        option_errors.add_error_codes(mp::LaunchError::INVALID_DISK_BANDWIDTH);
+
     struct CheckedArguments
     {
         mp::MemorySize mem_size;
         mp::MemorySize disk_space;
+        mp::IoLimits io_limits;
         std::string instance_name;
         mp::LaunchError option_errors;
-    } ret{mem_size, disk_space, instance_name, option_errors};
+    } ret{mem_size, disk_space, io_limits, instance_name, option_errors};
     return ret;
 }
 
@@ -424,6 +572,7 @@ auto connect_rpc(mp::DaemonRpc& rpc, mp::Daemon& daemon)
 {
     QObject::connect(&rpc, &mp::DaemonRpc::on_create, &daemon, &mp::Daemon::create);
     QObject::connect(&rpc, &mp::DaemonRpc::on_launch, &daemon, &mp::Daemon::launch);
+    QObject::connect(&rpc, &mp::DaemonRpc::on_clone, &daemon, &mp::Daemon::clone);
     QObject::connect(&rpc, &mp::DaemonRpc::on_purge, &daemon, &mp::Daemon::purge);
     QObject::connect(&rpc, &mp::DaemonRpc::on_find, &daemon, &mp::Daemon::find);
     QObject::connect(&rpc, &mp::DaemonRpc::on_info, &daemon, &mp::Daemon::info);
@@ -435,9 +584,21 @@ auto connect_rpc(mp::DaemonRpc& rpc, mp::Daemon& daemon)
     QObject::connect(&rpc, &mp::DaemonRpc::on_stop, &daemon, &mp::Daemon::stop);
     QObject::connect(&rpc, &mp::DaemonRpc::on_suspend, &daemon, &mp::Daemon::suspend);
     QObject::connect(&rpc, &mp::DaemonRpc::on_restart, &daemon, &mp::Daemon::restart);
+    QObject::connect(&rpc, &mp::DaemonRpc::on_snapshot, &daemon, &mp::Daemon::snapshot);
+    QObject::connect(&rpc, &mp::DaemonRpc::on_restore, &daemon, &mp::Daemon::restore);
+    QObject::connect(&rpc, &mp::DaemonRpc::on_modify, &daemon, &mp::Daemon::modify);
     QObject::connect(&rpc, &mp::DaemonRpc::on_delete, &daemon, &mp::Daemon::delet);
+    QObject::connect(&rpc, &mp::DaemonRpc::on_apply, &daemon, &mp::Daemon::apply);
     QObject::connect(&rpc, &mp::DaemonRpc::on_umount, &daemon, &mp::Daemon::umount);
-    QObject::connect(&rpc, &mp::DaemonRpc::on_version, &daemon, &mp::Daemon::version);
+
+    /* version doesn't touch the instance maps, so it runs directly on the gRPC worker thread rather than queueing
+       behind slower handlers on the daemon thread */
+    QObject::connect(&rpc, &mp::DaemonRpc::on_version, &daemon, &mp::Daemon::version, Qt::DirectConnection);
+
+    // same deal for trace and metrics: both stores are internally synchronized, so no need to involve the
+    // daemon thread
+    QObject::connect(&rpc, &mp::DaemonRpc::on_trace, &daemon, &mp::Daemon::trace, Qt::DirectConnection);
+    QObject::connect(&rpc, &mp::DaemonRpc::on_get_metrics, &daemon, &mp::Daemon::get_metrics, Qt::DirectConnection);
 }
 
 template <typename Instances, typename InstanceMap, typename InstanceCheck>
@@ -501,6 +662,61 @@ auto find_instances_to_delete(const Instances& instances, const InstanceMap& ope
     return std::make_tuple(operational_instances_to_delete, trashed_instances_to_delete, status);
 }
 
+int max_concurrent_instance_ops()
+{
+    bool ok{false};
+    auto cap = qEnvironmentVariableIntValue(max_concurrent_ops_env_var, &ok);
+    return ok && cap > 0 ? cap : QThread::idealThreadCount();
+}
+
+std::vector<mp::Query> tracked_image_queries()
+{
+    std::vector<mp::Query> queries;
+    for (const auto& entry : QString{qgetenv(prefetch_images_env_var)}.split(',', QString::SkipEmptyParts))
+    {
+        const auto image = entry.trimmed();
+        if (image.isEmpty())
+            continue;
+
+        if (image.contains(':'))
+            queries.push_back({"", image.section(':', 1).toStdString(), false, image.section(':', 0, 0).toStdString(),
+                               mp::Query::Type::Alias, false});
+        else
+            queries.push_back({"", image.toStdString(), false, "", mp::Query::Type::Alias, false});
+    }
+
+    return queries;
+}
+
+mp::Query standby_pool_query()
+{
+    mp::Query query{"", "", false, "", mp::Query::Type::Alias, true};
+
+    const auto image = QString{qgetenv(standby_image_env_var)}.trimmed();
+    if (image.contains(':'))
+    {
+        query.remote_name = image.section(':', 0, 0).toStdString();
+        query.release = image.section(':', 1).toStdString();
+    }
+    else
+        query.release = image.toStdString();
+
+    return query;
+}
+
+auto standby_name_for(int slot)
+{
+    // The leading dot keeps the names out of reach of clients — it is not a valid hostname character
+    return fmt::format(".standby-{}", slot);
+}
+
+bool vm_needs_stopping(const mp::VirtualMachine::State& state)
+{
+    using St = mp::VirtualMachine::State;
+    const auto skip_states = {St::off, St::stopped, St::suspended};
+    return std::none_of(cbegin(skip_states), cend(skip_states), [&state](const auto& st) { return state == st; });
+}
+
 template <typename Instances>
 auto instances_running(const Instances& instances)
 {
@@ -530,11 +746,8 @@ grpc::Status stop_accepting_ssh_connections(mp::SSHSession& session)
                                      proc.read_std_error()};
 }
 
-grpc::Status ssh_reboot(const std::string& hostname, int port, const std::string& username,
-                        const mp::SSHKeyProvider& key_provider)
+grpc::Status ssh_reboot(mp::SSHSession& session)
 {
-    mp::SSHSession session{hostname, port, username, key_provider};
-
     // This allows us to later detect when the machine has finished restarting by waiting for SSH to be back up.
     // Otherwise, there would be a race condition, and we would be unable to distinguish whether it had ever been down.
     stop_accepting_ssh_connections(session);
@@ -607,8 +820,11 @@ mp::Daemon::Daemon(std::unique_ptr<const DaemonConfig> the_config)
       metrics_opt_in{get_metrics_opt_in(config->data_directory)},
       instance_mounts{*config->ssh_key_provider}
 {
+    MP_TRACE_SPAN("Daemon::Daemon");
     connect_rpc(daemon_rpc, *this);
+    instance_ops_pool.setMaxThreadCount(max_concurrent_instance_ops());
     std::vector<std::string> invalid_specs;
+    std::map<std::string, QFuture<VirtualMachine::ShPtr>> pending_constructions;
     bool mac_addr_missing{false};
     for (auto& entry : vm_instance_specs)
     {
@@ -643,48 +859,75 @@ mp::Daemon::Daemon(std::unique_ptr<const DaemonConfig> the_config)
                                               cloud_init_iso,
                                               {},
                                               {},
-                                              {}};
+                                              {},
+                                              spec.io_limits};
+
+        // FIXME: somehow we're writing contradictory state to disk.
+        if (spec.deleted && spec.state != VirtualMachine::State::stopped)
+        {
+            mpl::log(mpl::Level::warning, category,
+                     fmt::format("{} is deleted but has incompatible state {}, reseting state to 0 (stopped)", name,
+                                 static_cast<int>(spec.state)));
+            spec.state = VirtualMachine::State::stopped;
+        }
+
+        if (spec.deleted)
+        { // Deleted instances materialize lazily, on recovery; a null entry marks membership
+            std::unique_lock<std::shared_mutex> lock{instance_map_mutex};
+            deleted_instances[name];
+            deferred_instance_descs[name] = vm_desc;
+        }
+        else
+        {
+            pending_constructions[name] =
+                QtConcurrent::run(&instance_ops_pool, [this, vm_desc] { // copy the desc, the loop moves on
+                    MP_TRACE_SPAN("create_virtual_machine");
+                    return VirtualMachine::ShPtr{config->factory->create_virtual_machine(vm_desc, *this)};
+                });
+        }
+    }
 
+    // The backends may dial connections or define domains per instance, so constructions run concurrently above
+    for (auto& pending : pending_constructions)
+    {
+        const auto& name = pending.first;
         try
         {
-            auto& instance_record = spec.deleted ? deleted_instances : vm_instances;
-            instance_record[name] = config->factory->create_virtual_machine(vm_desc, *this);
+            auto constructed = pending.second.result(); // waits outside the lock, constructions can be slow
+            std::unique_lock<std::shared_mutex> lock{instance_map_mutex};
+            vm_instances[name] = std::move(constructed);
         }
         catch (const std::exception& e)
         {
             mpl::log(mpl::Level::error, category, fmt::format("Removing instance {}: {}", name, e.what()));
             invalid_specs.push_back(name);
             config->vault->remove(name);
+            continue;
         }
 
-        // FIXME: somehow we're writing contradictory state to disk.
-        if (spec.deleted && spec.state != VirtualMachine::State::stopped)
-        {
-            mpl::log(mpl::Level::warning, category,
-                     fmt::format("{} is deleted but has incompatible state {}, reseting state to 0 (stopped)", name,
-                                 static_cast<int>(spec.state)));
-            spec.state = VirtualMachine::State::stopped;
-        }
-
+        const auto& spec = vm_instance_specs[name];
         if (spec.state == VirtualMachine::State::running && vm_instances[name]->state != VirtualMachine::State::running)
         {
             assert(!spec.deleted);
             mpl::log(mpl::Level::info, category, fmt::format("{} needs starting. Starting now...", name));
 
-            QTimer::singleShot(0, [this, &name] {
+            QTimer::singleShot(0, [this, name] {
                 vm_instances[name]->start();
                 on_restart(name);
             });
         }
     }
+    pending_constructions.clear();
 
     for (const auto& bad_spec : invalid_specs)
     {
         vm_instance_specs.erase(bad_spec);
     }
 
-    if (!invalid_specs.empty() || mac_addr_missing)
-        persist_instances();
+    const QDir data_dir{
+        mp::utils::backend_directory_path(config->data_directory, config->factory->get_backend_directory_name())};
+    if (!invalid_specs.empty() || mac_addr_missing || QFile::exists(data_dir.filePath(instance_db_journal_name)))
+        persist_instances(); // folds any journal left over from the previous run back into the main DB
 
     for (const auto& image_host : config->image_hosts)
     {
@@ -696,6 +939,9 @@ mp::Daemon::Daemon(std::unique_ptr<const DaemonConfig> the_config)
 
     config->vault->prune_expired_images();
 
+    // Standby instances, when configured, get prepared in the background, ahead of the launches claiming them
+    replenish_standby_pool();
+
     // Fire timer every six hours to perform maintenance on source images such as
     // pruning expired images and updating to newly released images.
     connect(&source_images_maintenance_task, &QTimer::timeout, [this]() {
@@ -729,6 +975,10 @@ mp::Daemon::Daemon(std::unique_ptr<const DaemonConfig> the_config)
                 try
                 {
                     config->vault->update_images(config->factory->fetch_type(), prepare_action, download_monitor);
+
+                    // Keep any tracked images warm, so the first launch after a refresh skips the download
+                    config->vault->prefetch_images(tracked_image_queries(), config->factory->fetch_type(),
+                                                   prepare_action, download_monitor);
                 }
                 catch (const std::exception& e)
                 {
@@ -736,8 +986,111 @@ mp::Daemon::Daemon(std::unique_ptr<const DaemonConfig> the_config)
                 }
             });
         }
+
+        /* Instance disks get compacted in the same maintenance window: long-lived guests accrue dead
+           clusters that degrade I/O, and rewriting the image while the instance is down sheds them. The
+           slow rewrite runs on the ops pool and only reads the original; the swap happens back on this
+           thread, where commit_disk_compaction() re-checks that the instance stayed down. */
+        for (const auto& pair : vm_instances)
+        {
+            const auto state = pair.second->current_state();
+            if ((state != VirtualMachine::State::off && state != VirtualMachine::State::stopped) ||
+                compacting_instances.find(pair.first) != compacting_instances.end())
+                continue;
+
+            compacting_instances.insert(pair.first);
+
+            auto watcher = new QFutureWatcher<bool>{this};
+            connect(watcher, &QFutureWatcher<bool>::finished, this, [this, name = pair.first, watcher] {
+                watcher->deleteLater();
+                compacting_instances.erase(name);
+
+                auto it = vm_instances.find(name);
+                if (watcher->future().result() && it != vm_instances.end())
+                {
+                    const auto reclaimed = it->second->commit_disk_compaction();
+                    if (reclaimed > 0)
+                    {
+                        mpl::log(mpl::Level::info, category,
+                                 fmt::format("Compacted the disk of \"{}\", reclaiming {} bytes", name, reclaimed));
+                        mp::perf::PerformanceCounters::instance().increment("disk_compaction_reclaimed_bytes",
+                                                                            reclaimed);
+                    }
+                }
+            });
+
+            watcher->setFuture(QtConcurrent::run(&instance_ops_pool, [name = pair.first, vm = pair.second] {
+                try
+                {
+                    return vm->prepare_disk_compaction();
+                }
+                catch (const std::exception& e)
+                {
+                    mpl::log(mpl::Level::warning, category,
+                             fmt::format("Could not compact the disk of \"{}\": {}", name, e.what()));
+                    return false;
+                }
+            }));
+        }
     });
     source_images_maintenance_task.start(config->image_refresh_timer);
+
+    // Keep the stats of running instances warm in the background, so info/list answer from memory
+    connect(&instance_stats_refresh_task, &QTimer::timeout, [this]() {
+        std::vector<std::string> running;
+        for (const auto& pair : vm_instances)
+            if (mp::utils::is_running(pair.second->current_state()))
+                running.push_back(pair.first);
+
+        for (const auto& name : running)
+            QtConcurrent::run(&instance_ops_pool, [this, name] {
+                try
+                {
+                    VirtualMachine::ShPtr vm;
+                    std::string ssh_username;
+                    {
+                        std::shared_lock<std::shared_mutex> lock{instance_map_mutex};
+                        auto it = vm_instances.find(name);
+                        auto spec_it = vm_instance_specs.find(name);
+                        if (it == vm_instances.end() || spec_it == vm_instance_specs.end())
+                            return; // deleted since the tick started; nothing to refresh
+                        vm = it->second;
+                        ssh_username = spec_it->second.ssh_username;
+                    }
+                    if (mp::utils::is_running(vm->current_state()))
+                        stats_for(name, *vm, ssh_username);
+                }
+                catch (const std::exception& e)
+                {
+                    mpl::log(mpl::Level::debug, category,
+                             fmt::format("Could not refresh stats for \"{}\": {}", name, e.what()));
+                }
+            });
+    });
+    instance_stats_refresh_task.start(instance_stats_ttl);
+
+    connect(&idle_detection_task, &QTimer::timeout, [this]() { check_idle_instances(); });
+    idle_detection_task.start(idle_check_interval);
+
+    default_log_level = config->logger->get_logging_level();
+    apply_log_settings();
+    FileWatcher::instance().watch(Settings::get_daemon_settings_file_path(), [this] { apply_log_settings(); });
+}
+
+mp::Daemon::~Daemon()
+{
+    if (instance_persist_pending)
+        write_instance_records(); // an acked change may still be queued behind the group-commit window
+
+    /* Tear instances down concurrently: a running VM suspends to disk in its destructor and resumes on the
+       next daemon start, so a daemon upgrade waits for the slowest memory snapshot instead of their sum */
+    delayed_shutdown_instances.clear(); // their timers hold bare pointers into the instances below
+    QFutureSynchronizer<void> synchronizer;
+    for (auto& pair : vm_instances)
+        synchronizer.addFuture(
+            QtConcurrent::run(&instance_ops_pool, [vm = std::move(pair.second)]() mutable { vm.reset(); }));
+    vm_instances.clear();
+    synchronizer.waitForFinished();
 }
 
 void mp::Daemon::create(const CreateRequest* request, grpc::ServerWriter<CreateReply>* server,
@@ -794,8 +1147,11 @@ catch (const mp::StartException& e)
 {
     auto name = e.name();
 
-    release_resources(name);
-    vm_instances.erase(name);
+    {
+        std::unique_lock<std::shared_mutex> lock{instance_map_mutex}; // release_resources drops the specs too
+        release_resources(name);
+        vm_instances.erase(name);
+    }
     persist_instances();
 
     status_promise->set_value(grpc::Status(grpc::StatusCode::ABORTED, e.what(), ""));
@@ -805,14 +1161,138 @@ catch (const std::exception& e)
     status_promise->set_value(grpc::Status(grpc::StatusCode::FAILED_PRECONDITION, e.what(), ""));
 }
 
+void mp::Daemon::clone(const CloneRequest* request, grpc::ServerWriter<CloneReply>* server,
+                       std::promise<grpc::Status>* status_promise) // clang-format off
+try // clang-format on
+{
+    mpl::ClientLogger<CloneReply> logger{mpl::level_from(request->verbosity_level()), *config->logger, server};
+
+    const auto& source_name = request->source_name();
+    auto option_errors = check_instance_operational(source_name);
+    if (!option_errors.empty())
+        return status_promise->set_value(grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, option_errors, ""));
+
+    auto& source_vm = vm_instances[source_name];
+    const auto source_state = source_vm->current_state();
+    if (source_state != VirtualMachine::State::off && source_state != VirtualMachine::State::stopped)
+        return status_promise->set_value(
+            grpc::Status(grpc::StatusCode::FAILED_PRECONDITION,
+                         fmt::format("instance \"{}\" has to be stopped before it can be cloned", source_name), ""));
+
+    if (!request->destination_name().empty() && !mp::utils::valid_hostname(request->destination_name()))
+        return status_promise->set_value(
+            grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                         fmt::format("Invalid instance name supplied: {}", request->destination_name()), ""));
+
+    auto name = name_from(request->destination_name(), *config->name_generator, vm_instances, deleted_instances);
+
+    if (vm_instances.find(name) != vm_instances.end() || deleted_instances.find(name) != deleted_instances.end())
+        return status_promise->set_value(grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                                                      fmt::format("instance \"{}\" already exists", name), ""));
+
+    try
+    {
+        CloneReply reply;
+        reply.set_reply_message(fmt::format("Cloning {} into {}", source_name, name));
+        server->Write(reply);
+
+        auto vm_image = config->vault->clone_image(source_name, name);
+
+        /* A fresh instance-id makes cloud-init treat the copied disk as a new machine on first boot, regenerating
+           the SSH host keys and applying the new hostname; a fresh MAC takes care of the rest of the identity */
+        auto vendor_data_cloud_init_config =
+            make_cloud_init_vendor_config(*config->ssh_key_provider, request->time_zone(), config->ssh_username,
+                                          config->factory->get_backend_version_string().toStdString());
+        auto meta_data_cloud_init_config = make_cloud_init_meta_config(name);
+        auto user_data_cloud_init_config = YAML::Load("");
+
+        std::string mac_addr;
+        while (true)
+        {
+            mac_addr = mp::utils::generate_mac_address();
+
+            auto it = allocated_mac_addrs.find(mac_addr);
+            if (it == allocated_mac_addrs.end())
+            {
+                allocated_mac_addrs.insert(mac_addr);
+                break;
+            }
+        }
+
+        const auto& source_spec = vm_instance_specs[source_name];
+        const auto instance_dir = mp::utils::base_dir(vm_image.image_path);
+        const auto cloud_init_iso = make_cloud_init_image(name, instance_dir, meta_data_cloud_init_config,
+                                                          user_data_cloud_init_config, vendor_data_cloud_init_config);
+
+        VirtualMachineDescription vm_desc{source_spec.num_cores,
+                                          source_spec.mem_size,
+                                          source_spec.disk_space,
+                                          name,
+                                          mac_addr,
+                                          config->ssh_username,
+                                          vm_image,
+                                          cloud_init_iso,
+                                          meta_data_cloud_init_config,
+                                          user_data_cloud_init_config,
+                                          vendor_data_cloud_init_config,
+                                          source_spec.io_limits};
+
+        auto cloned_vm = config->factory->create_virtual_machine(vm_desc, *this);
+        {
+            std::unique_lock<std::shared_mutex> lock{instance_map_mutex};
+            vm_instances[name] = std::move(cloned_vm);
+            vm_instance_specs[name] = {vm_desc.num_cores,
+                                       vm_desc.mem_size,
+                                       vm_desc.disk_space,
+                                       mac_addr,
+                                       config->ssh_username,
+                                       VirtualMachine::State::off,
+                                       {},
+                                       false,
+                                       QJsonObject(),
+                                       vm_desc.io_limits};
+        }
+
+        persist_instances();
+
+        CloneReply reply_done;
+        reply_done.set_cloned_instance_name(name);
+        server->Write(reply_done);
+
+        status_promise->set_value(grpc::Status::OK);
+    }
+    catch (const std::exception&)
+    {
+        {
+            std::unique_lock<std::shared_mutex> lock{instance_map_mutex}; // release_resources drops the specs too
+            release_resources(name);
+            vm_instances.erase(name);
+        }
+        persist_instances();
+        throw;
+    }
+}
+catch (const std::exception& e)
+{
+    status_promise->set_value(grpc::Status(grpc::StatusCode::FAILED_PRECONDITION, e.what(), ""));
+}
+
 void mp::Daemon::purge(const PurgeRequest* request, grpc::ServerWriter<PurgeReply>* server,
                        std::promise<grpc::Status>* status_promise) // clang-format off
 try // clang-format on
 {
-    for (const auto& del : deleted_instances)
-        release_resources(del.first);
+    mpl::ClientLogger<PurgeReply> logger{mpl::level_from(request->verbosity_level()), *config->logger, server};
+
+    {
+        std::unique_lock<std::shared_mutex> lock{instance_map_mutex}; // release_resources drops the specs too
+        for (const auto& del : deleted_instances)
+        {
+            release_resources(del.first);
+            mpl::log(mpl::Level::debug, category, fmt::format("Purged \"{}\"", del.first));
+        }
 
-    deleted_instances.clear();
+        deleted_instances.clear();
+    }
     persist_instances();
 
     status_promise->set_value(grpc::Status::OK);
@@ -829,6 +1309,40 @@ try // clang-format on
     mpl::ClientLogger<FindReply> logger{mpl::level_from(request->verbosity_level()), *config->logger, server};
     FindReply response;
 
+    /* A single stamp over all the hosts' catalogs; computing it refreshes manifests at most once per TTL, so
+       a client that polls with the stamp from its previous reply usually learns "unchanged" without us (or it)
+       serializing the whole catalog again */
+    fmt::memory_buffer catalog;
+    for (const auto& image_host : config->image_hosts)
+        fmt::format_to(catalog, "{}", image_host->catalog_version());
+    const auto catalog_version = fmt::to_string(catalog);
+
+    response.set_catalog_version(catalog_version);
+    if (!request->last_catalog_version().empty() && request->last_catalog_version() == catalog_version)
+    {
+        response.set_unchanged(true);
+        server->Write(response);
+        return status_promise->set_value(grpc::Status::OK);
+    }
+
+    /* Tooling tends to fire identical find queries in bursts (e.g. several dashboards starting together);
+       the first execution's replies are kept and replayed to the rest, so the catalog is only walked and
+       serialized once per distinct query while its stamp holds */
+    const auto query_key =
+        fmt::format("{}|{}|{}", request->search_string(), request->remote_name(), request->allow_unsupported());
+    if (find_reply_cache_stamp != catalog_version)
+    { // earlier replies described a catalog that is gone
+        find_reply_cache.clear();
+        find_reply_cache_stamp = catalog_version;
+    }
+    else if (auto cached = find_reply_cache.find(query_key); cached != find_reply_cache.end())
+    {
+        for (const auto& reply : cached->second)
+            server->Write(reply);
+        return status_promise->set_value(grpc::Status::OK);
+    }
+    std::vector<FindReply> replies;
+
     if (!request->search_string().empty())
     {
         std::vector<VMImageInfo> vm_images_info;
@@ -975,9 +1489,19 @@ try // clang-format on
             };
 
             image_host->for_each_entry_do(action);
+
+            if (!response.images_info().empty()) // this host's rows go out while the next may still be refreshing
+            {
+                replies.push_back(response);
+                server->Write(response);
+                response.Clear();
+            }
         }
     }
+    response.set_catalog_version(catalog_version); // the per-host writes above may have cleared it
+    replies.push_back(response);
     server->Write(response);
+    find_reply_cache[query_key] = std::move(replies); // only successful executions are worth replaying
     status_promise->set_value(grpc::Status::OK);
 }
 catch (const std::exception& e)
@@ -1006,6 +1530,40 @@ try // clang-format on
             instances_for_info.push_back(name);
     }
 
+    { // Warm the stats of the targeted running instances concurrently, so the reply loop below hits the cache
+        QFutureSynchronizer<void> stats_synchronizer;
+        for (const auto& name : instances_for_info)
+        {
+            auto it = vm_instances.find(name);
+            if (it == vm_instances.end() || !mp::utils::is_running(it->second->current_state()))
+                continue;
+
+            stats_synchronizer.addFuture(QtConcurrent::run(&instance_ops_pool, [this, name, vm = it->second] {
+                try
+                {
+                    std::string ssh_username;
+                    {
+                        std::shared_lock<std::shared_mutex> lock{instance_map_mutex};
+                        auto spec_it = vm_instance_specs.find(name);
+                        if (spec_it == vm_instance_specs.end())
+                            return; // deleted while the warm-up was queued
+                        ssh_username = spec_it->second.ssh_username;
+                    }
+                    stats_for(name, *vm, ssh_username);
+                }
+                catch (const std::exception& e)
+                {
+                    mpl::log(mpl::Level::debug, category,
+                             fmt::format("Could not collect stats for \"{}\": {}", name, e.what()));
+                }
+            }));
+        }
+        stats_synchronizer.waitForFinished();
+    }
+
+    std::unordered_map<std::string, std::string> release_title_cache; /* one manifest lookup per distinct image
+        rather than per instance -- with --all, most instances share a handful of common images */
+
     for (const auto& name : instances_for_info)
     {
         auto it = vm_instances.find(name);
@@ -1022,15 +1580,16 @@ try // clang-format on
         }
 
         auto info = response.add_info();
-        auto& vm = it->second;
-        auto present_state = vm->current_state();
         info->set_name(name);
+
+        auto present_state = VirtualMachine::State::stopped;
         if (deleted)
-        {
+        { // no need to materialize a deleted instance just to report it as such
             info->mutable_instance_status()->set_status(mp::InstanceStatus::DELETED);
         }
         else
         {
+            present_state = it->second->current_state();
             info->mutable_instance_status()->set_status(grpc_instance_status_for(present_state));
         }
 
@@ -1039,21 +1598,31 @@ try // clang-format on
 
         if (!vm_image.id.empty() && original_release.empty())
         {
-            try
+            auto cached = release_title_cache.find(vm_image.id);
+            if (cached != release_title_cache.end())
             {
-                auto vm_image_info = config->image_hosts.back()->info_for_full_hash(vm_image.id);
-                original_release = vm_image_info.release_title.toStdString();
+                original_release = cached->second;
             }
-            catch (const std::exception& e)
+            else
             {
-                mpl::log(mpl::Level::warning, category, fmt::format("Cannot fetch image information: {}", e.what()));
+                try
+                {
+                    auto vm_image_info = config->image_hosts.back()->info_for_full_hash(vm_image.id);
+                    original_release = vm_image_info.release_title.toStdString();
+                }
+                catch (const std::exception& e)
+                {
+                    mpl::log(mpl::Level::warning, category,
+                             fmt::format("Cannot fetch image information: {}", e.what()));
+                }
+                release_title_cache[vm_image.id] = original_release; // unresolvable ids are remembered too
             }
         }
 
         info->set_image_release(original_release);
         info->set_id(vm_image.id);
 
-        auto vm_specs = vm_instance_specs[name];
+        const auto& vm_specs = vm_instance_specs[name]; // a copy would drag the whole mount map along
 
         auto mount_info = info->mutable_mount_info();
 
@@ -1082,41 +1651,28 @@ try // clang-format on
 
         if (mp::utils::is_running(present_state))
         {
-            mp::SSHSession session{vm->ssh_hostname(), vm->ssh_port(), vm_specs.ssh_username,
-                                   *config->ssh_key_provider};
-
-            auto run_in_vm = [&session](const std::string& cmd) {
-                auto proc = session.exec(cmd);
-                if (proc.exit_code() != 0)
-                {
-                    auto error_msg = proc.read_std_error();
-                    mpl::log(
-                        mpl::Level::warning, category,
-                        fmt::format("failed to run '{}', error message: '{}'", cmd, mp::utils::trim_end(error_msg)));
-                    return std::string{};
-                }
+            auto& vm = it->second;
+            const auto stats = stats_for(name, *vm, vm_specs.ssh_username);
+
+            info->set_load(stats.load);
+            info->set_memory_usage(stats.memory_usage);
+            info->set_memory_total(stats.memory_total);
+            info->set_disk_usage(stats.disk_usage);
+            info->set_disk_total(stats.disk_total);
+            info->set_ipv4(vm->ipv4());
+            info->set_current_release(!stats.current_release.empty() ? stats.current_release : original_release);
 
-                auto output = proc.read_std_output();
-                if (output.empty())
-                {
-                    mpl::log(mpl::Level::warning, category, fmt::format("no output after running '{}'", cmd));
-                    return std::string{};
-                }
-
-                return mp::utils::trim_end(output);
-            };
-
-            info->set_load(run_in_vm("cat /proc/loadavg | cut -d ' ' -f1-3"));
-            info->set_memory_usage(run_in_vm("free -b | sed '1d;3d' | awk '{printf $3}'"));
-            info->set_memory_total(run_in_vm("free -b | sed '1d;3d' | awk '{printf $2}'"));
-            info->set_disk_usage(
-                run_in_vm("df --output=used `awk '$2 == \"/\" { print $1 }' /proc/mounts` -B1 | sed 1d"));
-            info->set_disk_total(
-                run_in_vm("df --output=size `awk '$2 == \"/\" { print $1 }' /proc/mounts` -B1 | sed 1d"));
-            info->set_ipv4(vm->ipv4());
-
-            auto current_release = run_in_vm("lsb_release -ds");
-            info->set_current_release(!current_release.empty() ? current_release : original_release);
+            // Host-side truth about the hypervisor process; unlike the SSH-gathered stats above, this costs a
+            // couple of /proc reads and still answers when the guest is hung
+            if (const auto usage = vm->host_resource_usage())
+            {
+                info->set_host_cpu_time(fmt::format("{:.2f}", usage->cpu_seconds));
+                info->set_host_memory_usage(std::to_string(usage->rss_bytes));
+                if (usage->io_read_bytes >= 0)
+                    info->set_host_disk_read(std::to_string(usage->io_read_bytes));
+                if (usage->io_write_bytes >= 0)
+                    info->set_host_disk_write(std::to_string(usage->io_write_bytes));
+            }
         }
     }
 
@@ -1131,15 +1687,53 @@ catch (const std::exception& e)
     status_promise->set_value(grpc::Status(grpc::StatusCode::FAILED_PRECONDITION, e.what(), ""));
 }
 
-void mp::Daemon::list(const ListRequest* request, grpc::ServerWriter<ListReply>* server,
-                      std::promise<grpc::Status>* status_promise) // clang-format off
-try // clang-format on
+void mp::Daemon::list_reply_for(const ListRequest* request, ListReply& response)
 {
-    mpl::ClientLogger<ListReply> logger{mpl::level_from(request->verbosity_level()), *config->logger, server};
-    ListReply response;
-    config->update_prompt->populate_if_time_to_show(response.mutable_update_info());
+    response.Clear(); // keeps the repeated fields' storage around, so a reused reply stops allocating once warm
+
+    /* A stable snapshot to iterate over: watchers call this from worker threads while handlers on the daemon
+       thread may be inserting or erasing; the copied ShPtrs also keep instances alive past a concurrent purge */
+    std::vector<std::pair<std::string, VirtualMachine::ShPtr>> instances_snapshot;
+    std::vector<std::string> deleted_names;
+    {
+        std::shared_lock<std::shared_mutex> lock{instance_map_mutex};
+        instances_snapshot.assign(vm_instances.cbegin(), vm_instances.cend());
+        deleted_names.reserve(deleted_instances.size());
+        for (const auto& del : deleted_instances)
+            deleted_names.push_back(del.first);
+    }
 
-    for (const auto& instance : vm_instances)
+    std::unordered_map<std::string, std::string> resolved_ipv4;
+    if (!request->no_ipv4())
+    { // Resolve IP addresses concurrently up front; lease lookups can dominate latency on large fleets
+        for (const auto& instance : instances_snapshot)
+            if (mp::utils::is_running(instance.second->current_state()))
+                resolved_ipv4[instance.first]; // create the slot, each worker only touches its own
+
+        QFutureSynchronizer<void> ipv4_synchronizer;
+        for (const auto& instance : instances_snapshot)
+        {
+            auto slot = resolved_ipv4.find(instance.first);
+            if (slot == resolved_ipv4.end())
+                continue;
+
+            ipv4_synchronizer.addFuture(
+                QtConcurrent::run(&instance_ops_pool, [&ipv4 = slot->second, vm = instance.second] {
+                    try
+                    {
+                        ipv4 = vm->ipv4();
+                    }
+                    catch (const std::exception& e)
+                    {
+                        mpl::log(mpl::Level::debug, category,
+                                 fmt::format("Cannot resolve IP address for \"{}\": {}", vm->vm_name, e.what()));
+                    }
+                }));
+        }
+        ipv4_synchronizer.waitForFinished();
+    }
+
+    for (const auto& instance : instances_snapshot)
     {
         const auto& name = instance.first;
         const auto& vm = instance.second;
@@ -1167,20 +1761,100 @@ try // clang-format on
 
         entry->set_current_release(current_release);
 
-        if (mp::utils::is_running(present_state))
-            entry->set_ipv4(vm->ipv4());
+        auto resolved = resolved_ipv4.find(name);
+        if (resolved != resolved_ipv4.end())
+            entry->set_ipv4(resolved->second);
     }
 
-    for (const auto& instance : deleted_instances)
+    for (const auto& name : deleted_names)
     {
-        const auto& name = instance.first;
         auto entry = response.add_instances();
         entry->set_name(name);
         entry->mutable_instance_status()->set_status(mp::InstanceStatus::DELETED);
     }
+}
+
+void mp::Daemon::list(const ListRequest* request, grpc::ServerWriter<ListReply>* server,
+                      std::promise<grpc::Status>* status_promise) // clang-format off
+try // clang-format on
+{
+    mpl::ClientLogger<ListReply> logger{mpl::level_from(request->verbosity_level()), *config->logger, server};
 
+    ListReply response;
+    list_reply_for(request, response);
+    auto serialized = response.SerializeAsString(); // before the update prompt, snapshots are compared without it
+    config->update_prompt->populate_if_time_to_show(response.mutable_update_info());
     server->Write(response);
-    status_promise->set_value(grpc::Status::OK);
+
+    if (!request->watch())
+        return status_promise->set_value(grpc::Status::OK);
+
+    /* Watch mode keeps the stream open, pushing a fresh snapshot whenever the list changes. Rather than polling,
+       the loop blocks on the instance-event counter, which every persisted state change bumps — N watchers cost
+       nothing while nothing happens, and all wake on the same event. Some of what the list shows trails the state
+       transition that announces it (addresses resolve after an instance reports running), so a written change is
+       followed by a few short settling polls. An occasional unchanged snapshot doubles as a liveness probe — a
+       hung-up client only surfaces on the next write. Each watcher gets a thread of its own: parked in a wait
+       for as long as the client stays connected, it would otherwise hold a slot in a bounded pool — and both
+       the global pool and the instance-operations pool run launches, so enough watchers would wedge those.
+       Detached, since the loop's lifetime is the client connection's and the daemon's is the process's. */
+    std::thread{[this, request, server, status_promise, last = std::move(serialized)]() mutable {
+        constexpr auto settle_interval = 1s;
+        constexpr auto settle_cycles_after_change = 10;
+        constexpr auto keep_alive_interval = 30s;
+
+        uint64_t seen;
+        {
+            std::lock_guard<std::mutex> lock{instance_event_mutex};
+            seen = instance_event_count;
+        }
+
+        ListReply update; // reused across cycles; after the first, refills mostly land in already-owned storage
+        for (auto settle_cycles = settle_cycles_after_change;;)
+        {
+            auto timed_out = false;
+            if (settle_cycles > 0)
+            {
+                --settle_cycles;
+                std::this_thread::sleep_for(settle_interval);
+            }
+            else
+            {
+                std::unique_lock<std::mutex> lock{instance_event_mutex};
+                timed_out = !instance_event_cv.wait_for(lock, keep_alive_interval,
+                                                        [this, seen] { return instance_event_count != seen; });
+            }
+
+            {
+                std::lock_guard<std::mutex> lock{instance_event_mutex};
+                seen = instance_event_count;
+            }
+
+            try
+            {
+                list_reply_for(request, update);
+            }
+            catch (const std::exception& e)
+            {
+                return status_promise->set_value(grpc::Status(grpc::StatusCode::FAILED_PRECONDITION, e.what(), ""));
+            }
+
+            auto serialized = update.SerializeAsString();
+            if (serialized != last)
+            {
+                if (!server->Write(update)) // the client hung up
+                    return status_promise->set_value(grpc::Status::OK);
+
+                last = std::move(serialized);
+                settle_cycles = settle_cycles_after_change;
+            }
+            else if (timed_out)
+            {
+                if (!server->Write(update)) // the liveness probe
+                    return status_promise->set_value(grpc::Status::OK);
+            }
+        }
+    }}.detach();
 }
 catch (const std::exception& e)
 {
@@ -1265,9 +1939,9 @@ try // clang-format on
                     mount_reply.set_mount_message("Enabling support for mounting");
                     server->Write(mount_reply);
 
-                    mp::SSHSession session{vm->ssh_hostname(), vm->ssh_port(), vm_specs.ssh_username,
-                                           *config->ssh_key_provider};
-                    mp::utils::install_sshfs_for(name, session);
+                    auto session = checkout_ssh_session(name, *vm, vm_specs.ssh_username);
+                    mp::utils::install_sshfs_for(name, *session);
+                    return_ssh_session(name, std::move(session));
                     instance_mounts.start_mount(vm.get(), request->source_path(), target_path, gid_map, uid_map);
                 }
                 catch (const mp::SSHFSMissingError&)
@@ -1289,7 +1963,10 @@ try // clang-format on
         }
 
         VMMount mount{request->source_path(), gid_map, uid_map};
-        vm_specs.mounts[target_path] = mount;
+        {
+            std::unique_lock<std::shared_mutex> lock{instance_map_mutex}; // pooled workers copy mounts out
+            vm_specs.mounts[target_path] = mount;
+        }
     }
 
     persist_instances();
@@ -1318,10 +1995,15 @@ try // clang-format on
             auto it = deleted_instances.find(name);
             if (it != std::end(deleted_instances))
             {
-                assert(vm_instance_specs[name].deleted);
-                vm_instance_specs[name].deleted = false;
-                vm_instances[name] = std::move(it->second);
-                deleted_instances.erase(it);
+                auto& spec = vm_instance_specs[name];
+                assert(spec.deleted);
+                spec.deleted = false;
+                auto materialized = materialized_deleted_vm(name); // constructs a VM, so keep it outside the lock
+                {
+                    std::unique_lock<std::shared_mutex> lock{instance_map_mutex};
+                    vm_instances[name] = std::move(materialized);
+                    deleted_instances.erase(it);
+                }
             }
             else
             {
@@ -1364,6 +2046,30 @@ try // clang-format on
         if (vm->current_state() == VirtualMachine::State::unknown)
             throw std::runtime_error("Cannot retrieve credentials in unknown state");
 
+        if (vm->current_state() == VirtualMachine::State::suspended &&
+            suspended_on_idle.find(name) != suspended_on_idle.end())
+        { // the daemon parked this instance itself, so bring it back rather than bouncing the connection
+            mpl::log(mpl::Level::info, category, fmt::format("Resuming \"{}\" on connection", name));
+            vm->start();
+            suspended_on_idle.erase(name);
+            vm->wait_until_ssh_up(up_timeout);
+
+            for (const auto& mount_entry : vm_instance_specs[name].mounts)
+            { // best effort; a plain `start` remains the way to diagnose mount problems
+                try
+                {
+                    instance_mounts.start_mount(vm.get(), mount_entry.second.source_path, mount_entry.first,
+                                                mount_entry.second.gid_map, mount_entry.second.uid_map);
+                }
+                catch (const std::exception& e)
+                {
+                    mpl::log(mpl::Level::warning, category,
+                             fmt::format("Could not restore mount \"{}\" in \"{}\": {}", mount_entry.first, name,
+                                         e.what()));
+                }
+            }
+        }
+
         if (!mp::utils::is_running(vm->current_state()))
         {
             return status_promise->set_value(
@@ -1383,12 +2089,11 @@ try // clang-format on
             }
         }
 
-        mp::SSHInfo ssh_info;
+        auto& ssh_info = (*response.mutable_ssh_info())[name]; // build the entry in place, instead of copying it in
         ssh_info.set_host(vm->ssh_hostname());
         ssh_info.set_port(vm->ssh_port());
-        ssh_info.set_priv_key_base64(config->ssh_key_provider->private_key_as_base64());
+        *ssh_info.mutable_priv_key_base64() = config->ssh_key_provider->private_key_as_base64();
         ssh_info.set_username(vm->ssh_username());
-        (*response.mutable_ssh_info())[name] = ssh_info;
     }
 
     server->Write(response);
@@ -1439,17 +2144,27 @@ try // clang-format on
         }
     }
 
-    for (const auto& name : vms)
+    auto layers = boot_layers_for(vms);
+    auto future_watcher = create_future_watcher();
+
+    if (layers.size() <= 1)
+    { // no boot dependencies among these; kick everything off at once and wait in parallel, as ever
+        for (const auto& name : vms)
+        {
+            auto it = vm_instances.find(name);
+            auto state = it->second->current_state();
+            if (state != VirtualMachine::State::starting && state != VirtualMachine::State::restarting)
+                it->second->start();
+        }
+
+        future_watcher->setFuture(
+            QtConcurrent::run(this, &Daemon::async_wait_for_ready_all<StartReply>, server, vms, status_promise));
+    }
+    else
     {
-        auto it = vm_instances.find(name);
-        auto state = it->second->current_state();
-        if (state != VirtualMachine::State::starting && state != VirtualMachine::State::restarting)
-            it->second->start();
+        future_watcher->setFuture(QtConcurrent::run(this, &Daemon::async_start_in_dependency_order<StartReply>, server,
+                                                    layers, status_promise));
     }
-
-    auto future_watcher = create_future_watcher();
-    future_watcher->setFuture(
-        QtConcurrent::run(this, &Daemon::async_wait_for_ready_all<StartReply>, server, vms, status_promise));
 }
 catch (const std::exception& e)
 {
@@ -1468,14 +2183,10 @@ try // clang-format on
 
     if (status.ok())
     {
-        std::function<grpc::Status(VirtualMachine&)> operation;
         if (request->cancel_shutdown())
-            operation = std::bind(&Daemon::cancel_vm_shutdown, this, std::placeholders::_1);
+            status = cmd_vms(instances, std::bind(&Daemon::cancel_vm_shutdown, this, std::placeholders::_1));
         else
-            operation = std::bind(&Daemon::shutdown_vm, this, std::placeholders::_1,
-                                  std::chrono::minutes(request->time_minutes()));
-
-        status = cmd_vms(instances, operation);
+            status = shutdown_vms(instances, std::chrono::minutes(request->time_minutes()));
     }
 
     status_promise->set_value(status);
@@ -1517,11 +2228,17 @@ try // clang-format on
                 instances_to_suspend.push_back(pair.first);
         }
 
-        status = cmd_vms(instances_to_suspend, [this](auto& vm) {
+        status = cmd_vms_concurrently(instances_to_suspend, [](auto& vm) {
             vm.suspend();
-            instance_mounts.stop_all_mounts_for_instance(vm.vm_name);
             return grpc::Status::OK;
         });
+
+        for (const auto& name : instances_to_suspend)
+        {
+            instance_mounts.stop_all_mounts_for_instance(name);
+            drop_ssh_sessions_for(name);
+            suspended_on_idle.erase(name); // an explicit suspension is not to be undone by a mere connection
+        }
     }
 
     status_promise->set_value(status);
@@ -1546,8 +2263,8 @@ try // clang-format on
         return status_promise->set_value(status);
     }
 
-    status = cmd_vms(instances,
-                     std::bind(&Daemon::reboot_vm, this, std::placeholders::_1)); // 1st pass to reboot all targets
+    status = cmd_vms_concurrently(
+        instances, std::bind(&Daemon::reboot_vm, this, std::placeholders::_1)); // 1st pass to reboot all targets
 
     if (!status.ok())
     {
@@ -1563,6 +2280,161 @@ catch (const std::exception& e)
     status_promise->set_value(grpc::Status(grpc::StatusCode::FAILED_PRECONDITION, e.what(), ""));
 }
 
+void mp::Daemon::snapshot(const SnapshotRequest* request, grpc::ServerWriter<SnapshotReply>* server,
+                          std::promise<grpc::Status>* status_promise) // clang-format off
+try // clang-format on
+{
+    mpl::ClientLogger<SnapshotReply> logger{mpl::level_from(request->verbosity_level()), *config->logger, server};
+
+    const auto& name = request->instance_name();
+    auto errors = check_instance_operational(name);
+    if (!errors.empty())
+        return status_promise->set_value(grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, errors, ""));
+
+    if (request->snapshot_name().empty())
+        return status_promise->set_value(
+            grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "a snapshot name is required", ""));
+
+    const auto state = vm_instances[name]->current_state();
+    if (state != VirtualMachine::State::off && state != VirtualMachine::State::stopped)
+    {
+        // backends that can take a live, guest-quiesced snapshot spare the stop/snapshot/start cycle
+        if (!vm_instances[name]->take_live_snapshot(request->snapshot_name()))
+            return status_promise->set_value(
+                grpc::Status(grpc::StatusCode::FAILED_PRECONDITION,
+                             fmt::format("instance \"{}\" has to be stopped before taking a snapshot", name), ""));
+    }
+    else
+    {
+        auto vm_image = fetch_image_for(name, config->factory->fetch_type(), *config->vault);
+        config->factory->snapshot_instance_image(vm_image, request->snapshot_name());
+    }
+
+    SnapshotReply reply;
+    reply.set_reply_message(fmt::format("Snapshot \"{}\" taken of {}", request->snapshot_name(), name));
+    server->Write(reply);
+
+    status_promise->set_value(grpc::Status::OK);
+}
+catch (const std::exception& e)
+{
+    status_promise->set_value(grpc::Status(grpc::StatusCode::FAILED_PRECONDITION, e.what(), ""));
+}
+
+void mp::Daemon::restore(const RestoreRequest* request, grpc::ServerWriter<RestoreReply>* server,
+                         std::promise<grpc::Status>* status_promise) // clang-format off
+try // clang-format on
+{
+    mpl::ClientLogger<RestoreReply> logger{mpl::level_from(request->verbosity_level()), *config->logger, server};
+
+    const auto& name = request->instance_name();
+    auto errors = check_instance_operational(name);
+    if (!errors.empty())
+        return status_promise->set_value(grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, errors, ""));
+
+    if (request->snapshot_name().empty())
+        return status_promise->set_value(
+            grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "a snapshot name is required", ""));
+
+    const auto state = vm_instances[name]->current_state();
+    if (state != VirtualMachine::State::off && state != VirtualMachine::State::stopped)
+        return status_promise->set_value(
+            grpc::Status(grpc::StatusCode::FAILED_PRECONDITION,
+                         fmt::format("instance \"{}\" has to be stopped before restoring a snapshot", name), ""));
+
+    auto vm_image = fetch_image_for(name, config->factory->fetch_type(), *config->vault);
+    config->factory->restore_instance_image(vm_image, request->snapshot_name());
+
+    RestoreReply reply;
+    reply.set_reply_message(fmt::format("Snapshot \"{}\" restored to {}", request->snapshot_name(), name));
+    server->Write(reply);
+
+    status_promise->set_value(grpc::Status::OK);
+}
+catch (const std::exception& e)
+{
+    status_promise->set_value(grpc::Status(grpc::StatusCode::FAILED_PRECONDITION, e.what(), ""));
+}
+
+void mp::Daemon::modify(const ModifyRequest* request, grpc::ServerWriter<ModifyReply>* server,
+                        std::promise<grpc::Status>* status_promise) // clang-format off
+try // clang-format on
+{
+    mpl::ClientLogger<ModifyReply> logger{mpl::level_from(request->verbosity_level()), *config->logger, server};
+
+    const auto& name = request->instance_name();
+    auto errors = check_instance_operational(name);
+    if (!errors.empty())
+        return status_promise->set_value(grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, errors, ""));
+
+    auto& vm_specs = vm_instance_specs[name];
+    auto num_cores = vm_specs.num_cores;
+    auto mem_size = vm_specs.mem_size;
+
+    if (request->num_cores() != 0)
+    {
+        if (request->num_cores() < std::stoi(mp::min_cpu_cores))
+            return status_promise->set_value(grpc::Status(
+                grpc::StatusCode::INVALID_ARGUMENT,
+                fmt::format("invalid number of cores: {}", request->num_cores()), ""));
+
+        num_cores = request->num_cores();
+    }
+
+    if (!request->mem_size().empty())
+    {
+        constexpr auto min_mem = mp::MemorySize{mp::min_memory_size};
+        const auto opt_mem_size = try_mem_size(request->mem_size());
+        if (!opt_mem_size || *opt_mem_size < min_mem)
+            return status_promise->set_value(grpc::Status(
+                grpc::StatusCode::INVALID_ARGUMENT,
+                fmt::format("invalid memory size \"{}\" (minimum is {})", request->mem_size(), mp::min_memory_size),
+                ""));
+
+        mem_size = *opt_mem_size;
+    }
+
+    auto io_limits = vm_specs.io_limits;
+    if (request->disk_iops() != 0)
+        io_limits.iops = std::max<long long>(request->disk_iops(), 0); // a negative value lifts the limit
+
+    if (!request->disk_bandwidth().empty())
+    {
+        const auto opt_disk_bandwidth = try_mem_size(request->disk_bandwidth());
+        if (!opt_disk_bandwidth)
+            return status_promise->set_value(grpc::Status(
+                grpc::StatusCode::INVALID_ARGUMENT,
+                fmt::format("invalid disk bandwidth \"{}\"", request->disk_bandwidth()), ""));
+
+        io_limits.bytes_per_second = opt_disk_bandwidth->in_bytes(); // "0" lifts the limit
+    }
+
+    const auto compute_changed = num_cores != vm_specs.num_cores || mem_size != vm_specs.mem_size;
+    ModifyReply reply;
+    if (compute_changed || io_limits != vm_specs.io_limits)
+    {
+        vm_specs.num_cores = num_cores;
+        vm_specs.mem_size = mem_size;
+        vm_specs.io_limits = io_limits;
+
+        auto& vm = vm_instances[name];
+        vm->update_resources(num_cores, mem_size);
+        vm->update_io_limits(io_limits.iops, io_limits.bytes_per_second); // backends that can, apply this live
+        persist_instances();
+
+        if (compute_changed && vm->current_state() != VirtualMachine::State::off &&
+            vm->current_state() != VirtualMachine::State::stopped)
+            reply.set_reply_message(fmt::format("Changes to {} will take effect on its next start", name));
+    }
+    server->Write(reply);
+
+    status_promise->set_value(grpc::Status::OK);
+}
+catch (const std::exception& e)
+{
+    status_promise->set_value(grpc::Status(grpc::StatusCode::FAILED_PRECONDITION, e.what(), ""));
+}
+
 void mp::Daemon::delet(const DeleteRequest* request, grpc::ServerWriter<DeleteReply>* server,
                        std::promise<grpc::Status>* status_promise) // clang-format off
 try // clang-format on
@@ -1586,8 +2458,10 @@ try // clang-format on
                 delayed_shutdown_instances.erase(name);
 
             instance_mounts.stop_all_mounts_for_instance(name);
+            drop_ssh_sessions_for(name);
             instance->shutdown();
 
+            std::unique_lock<std::shared_mutex> lock{instance_map_mutex};
             if (purge)
                 release_resources(name);
             else
@@ -1601,6 +2475,7 @@ try // clang-format on
 
         if (purge)
         {
+            std::unique_lock<std::shared_mutex> lock{instance_map_mutex};
             for (const auto& name : trashed_instances_to_delete)
             {
                 assert(vm_instance_specs[name].deleted);
@@ -1619,6 +2494,101 @@ catch (const std::exception& e)
     status_promise->set_value(grpc::Status(grpc::StatusCode::FAILED_PRECONDITION, e.what(), ""));
 }
 
+void mp::Daemon::apply(const ApplyRequest* request, grpc::ServerWriter<ApplyReply>* server,
+                       std::promise<grpc::Status>* status_promise) // clang-format off
+try // clang-format on
+{
+    mpl::ClientLogger<ApplyReply> logger{mpl::level_from(request->verbosity_level()), *config->logger, server};
+
+    fmt::memory_buffer errors;
+    for (const auto& op : request->operations())
+    {
+        const auto& name = op.instance_name();
+        auto it = vm_instances.find(name);
+        if (it == vm_instances.end())
+            fmt::format_to(errors, check_instance_operational(name));
+        else if (op.operation() == InstanceOperation::START &&
+                 it->second->current_state() == VirtualMachine::State::delayed_shutdown)
+            delayed_shutdown_instances.erase(name);
+    }
+
+    auto status = grpc_status_for(errors);
+    if (!status.ok())
+        return status_promise->set_value(status);
+
+    /* All operations are dispatched on the instance-operations pool; completion events stream back per instance, in
+       request order, as the respective operations finish */
+    std::vector<QFuture<error_string>> results;
+    for (const auto& op : request->operations())
+    {
+        results.push_back(QtConcurrent::run(&instance_ops_pool, [this, &op]() -> error_string {
+            try
+            {
+                const auto& name = op.instance_name();
+                VirtualMachine::ShPtr vm_ptr;
+                {
+                    std::shared_lock<std::shared_mutex> lock{instance_map_mutex};
+                    vm_ptr = vm_instances.at(name);
+                }
+                auto& vm = *vm_ptr;
+                switch (op.operation())
+                {
+                case InstanceOperation::START:
+                    if (!mp::utils::is_running(vm.current_state()))
+                        vm.start();
+                    return async_wait_for_ssh_and_start_mounts_for<StartReply>(name, nullptr);
+                case InstanceOperation::STOP:
+                    if (vm_needs_stopping(vm.current_state()))
+                    {
+                        instance_mounts.stop_all_mounts_for_instance(name);
+                        drop_ssh_sessions_for(name);
+                        vm.shutdown();
+                    }
+                    return {};
+                case InstanceOperation::SUSPEND:
+                    if (mp::utils::is_running(vm.current_state()))
+                    {
+                        vm.suspend();
+                        instance_mounts.stop_all_mounts_for_instance(name);
+                        drop_ssh_sessions_for(name);
+                    }
+                    return {};
+                default:
+                    return fmt::format("unsupported operation on \"{}\"", name);
+                }
+            }
+            catch (const std::exception& e)
+            {
+                return e.what();
+            }
+        }));
+    }
+
+    fmt::memory_buffer op_errors;
+    for (int i = 0; i < request->operations().size(); ++i)
+    {
+        results[i].waitForFinished();
+        auto error = results[i].result();
+
+        ApplyReply reply;
+        reply.set_instance_name(request->operations(i).instance_name());
+        reply.set_success(error.empty());
+        reply.set_error(error);
+        server->Write(reply);
+
+        if (!error.empty())
+            fmt::format_to(op_errors, "{}: {}\n", request->operations(i).instance_name(), error);
+    }
+
+    persist_instances();
+
+    status_promise->set_value(grpc_status_for(op_errors));
+}
+catch (const std::exception& e)
+{
+    status_promise->set_value(grpc::Status(grpc::StatusCode::FAILED_PRECONDITION, e.what(), ""));
+}
+
 void mp::Daemon::umount(const UmountRequest* request, grpc::ServerWriter<UmountReply>* server,
                         std::promise<grpc::Status>* status_promise) // clang-format off
 try // clang-format on
@@ -1644,6 +2614,7 @@ try // clang-format on
         if (target_path.empty())
         {
             instance_mounts.stop_all_mounts_for_instance(name);
+            std::unique_lock<std::shared_mutex> lock{instance_map_mutex}; // pooled workers copy mounts out
             mounts.clear();
         }
         else
@@ -1656,7 +2627,11 @@ try // clang-format on
                 }
             }
 
-            auto erased = mounts.erase(target_path);
+            std::size_t erased;
+            {
+                std::unique_lock<std::shared_mutex> lock{instance_map_mutex}; // pooled workers copy mounts out
+                erased = mounts.erase(target_path);
+            }
             if (!erased)
             {
                 fmt::format_to(errors, "\"{}\" not found in database\n", target_path);
@@ -1680,11 +2655,38 @@ void mp::Daemon::version(const VersionRequest* request, grpc::ServerWriter<Versi
 
     VersionReply reply;
     reply.set_version(multipass::version_string);
+    // an hour: our version only changes with a package upgrade, and update checks are throttled anyway
+    reply.set_cache_ttl(3600);
     config->update_prompt->populate(reply.mutable_update_info());
     server->Write(reply);
     status_promise->set_value(grpc::Status::OK);
 }
 
+void mp::Daemon::trace(const TraceRequest* request, grpc::ServerWriter<TraceReply>* server,
+                       std::promise<grpc::Status>* status_promise)
+{
+    mpl::ClientLogger<TraceReply> logger{mpl::level_from(request->verbosity_level()), *config->logger, server};
+
+    TraceReply reply;
+    // assigning through mutable_ moves the (potentially large) string rather than copying it
+    *reply.mutable_chrome_trace() = tracing::TraceRecorder::instance().chrome_trace_json();
+    if (request->clear())
+        tracing::TraceRecorder::instance().clear();
+    server->Write(reply);
+    status_promise->set_value(grpc::Status::OK);
+}
+
+void mp::Daemon::get_metrics(const MetricsRequest* request, grpc::ServerWriter<MetricsReply>* server,
+                             std::promise<grpc::Status>* status_promise)
+{
+    mpl::ClientLogger<MetricsReply> logger{mpl::level_from(request->verbosity_level()), *config->logger, server};
+
+    MetricsReply reply;
+    *reply.mutable_metrics() = perf::PerformanceCounters::instance().prometheus_text();
+    server->Write(reply);
+    status_promise->set_value(grpc::Status::OK);
+}
+
 void mp::Daemon::on_shutdown()
 {
 }
@@ -1711,14 +2713,14 @@ void mp::Daemon::on_restart(const std::string& name)
 void mp::Daemon::persist_state_for(const std::string& name, const VirtualMachine::State& state)
 {
     vm_instance_specs[name].state = state;
-    persist_instances();
+    persist_instance(name);
 }
 
 void mp::Daemon::update_metadata_for(const std::string& name, const QJsonObject& metadata)
 {
     vm_instance_specs[name].metadata = metadata;
 
-    persist_instances();
+    persist_instance(name);
 }
 
 QJsonObject mp::Daemon::retrieve_metadata_for(const std::string& name)
@@ -1726,71 +2728,298 @@ QJsonObject mp::Daemon::retrieve_metadata_for(const std::string& name)
     return vm_instance_specs[name].metadata;
 }
 
-void mp::Daemon::persist_instances()
-{
-    auto vm_spec_to_json = [](const mp::VMSpecs& specs) -> QJsonObject {
-        QJsonObject json;
-        json.insert("num_cores", specs.num_cores);
-        json.insert("mem_size", QString::number(specs.mem_size.in_bytes()));
-        json.insert("disk_space", QString::number(specs.disk_space.in_bytes()));
-        json.insert("mac_addr", QString::fromStdString(specs.mac_addr));
-        json.insert("ssh_username", QString::fromStdString(specs.ssh_username));
-        json.insert("state", static_cast<int>(specs.state));
-        json.insert("deleted", specs.deleted);
-        json.insert("metadata", specs.metadata);
-
-        QJsonArray mounts;
-        for (const auto& mount : specs.mounts)
-        {
-            QJsonObject entry;
-            entry.insert("source_path", QString::fromStdString(mount.second.source_path));
-            entry.insert("target_path", QString::fromStdString(mount.first));
-
-            QJsonArray uid_map;
-            for (const auto& map : mount.second.uid_map)
-            {
-                QJsonObject map_entry;
-                map_entry.insert("host_uid", map.first);
-                map_entry.insert("instance_uid", map.second);
-
-                uid_map.append(map_entry);
-            }
+std::shared_ptr<mp::SSHSession> mp::Daemon::checkout_ssh_session(const std::string& name, VirtualMachine& vm,
+                                                                 const std::string& ssh_username)
+{ /* Hands out a pooled session when a live one is available, sparing the full key exchange. Sessions are checked out
+     exclusively — libssh sessions cannot be shared between threads — and given back with return_ssh_session */
+    {
+        std::lock_guard<decltype(ssh_pool_mutex)> lock{ssh_pool_mutex};
+        auto it = ssh_session_pool.find(name);
+        if (it != ssh_session_pool.end())
+        {
+            auto session = std::move(it->second);
+            ssh_session_pool.erase(it);
+            if (session->is_connected())
+                return session;
+        }
+    }
 
-            entry.insert("uid_mappings", uid_map);
+    return std::make_shared<mp::SSHSession>(vm.ssh_hostname(), vm.ssh_port(), ssh_username,
+                                            *config->ssh_key_provider);
+}
 
-            QJsonArray gid_map;
-            for (const auto& map : mount.second.gid_map)
-            {
-                QJsonObject map_entry;
-                map_entry.insert("host_gid", map.first);
-                map_entry.insert("instance_gid", map.second);
+void mp::Daemon::return_ssh_session(const std::string& name, std::shared_ptr<SSHSession> session)
+{
+    if (!session->is_connected())
+        return;
 
-                gid_map.append(map_entry);
-            }
+    std::lock_guard<decltype(ssh_pool_mutex)> lock{ssh_pool_mutex};
+    ssh_session_pool[name] = std::move(session);
+}
 
-            entry.insert("gid_mappings", gid_map);
-            mounts.append(entry);
-        }
+void mp::Daemon::drop_ssh_sessions_for(const std::string& name)
+{ // a pooled session is of no use once the instance is going down
+    std::lock_guard<decltype(ssh_pool_mutex)> lock{ssh_pool_mutex};
+    ssh_session_pool.erase(name);
+}
 
-        json.insert("mounts", mounts);
-        return json;
-    };
-    QJsonObject instance_records_json;
-    for (const auto& record : vm_instance_specs)
+mp::Daemon::InstanceStats mp::Daemon::stats_for(const std::string& name, VirtualMachine& vm,
+                                                const std::string& ssh_username)
+{ // Returns cached stats while they are fresh, only falling back on live SSH when the TTL expired
     {
-        auto key = QString::fromStdString(record.first);
-        instance_records_json.insert(key, vm_spec_to_json(record.second));
+        std::lock_guard<decltype(stats_cache_mutex)> lock{stats_cache_mutex};
+        auto it = instance_stats_cache.find(name);
+        if (it != instance_stats_cache.end() &&
+            std::chrono::steady_clock::now() - it->second.collected < instance_stats_ttl)
+            return it->second;
+    }
+
+    std::shared_ptr<SSHSession> session; // only dialed when the guest-agent channel can't answer
+
+    auto run_in_vm = [&](const std::string& cmd) {
+        if (auto output = vm.run_in_guest(cmd)) // guest-agent channel: no SSH, works with broken guest networking
+            return mp::utils::trim_end(*output);
+
+        if (!session)
+            session = checkout_ssh_session(name, vm, ssh_username);
+
+        auto proc = session->exec(cmd);
+        if (proc.exit_code() != 0)
+        {
+            auto error_msg = proc.read_std_error();
+            mpl::log(mpl::Level::warning, category,
+                     fmt::format("failed to run '{}', error message: '{}'", cmd, mp::utils::trim_end(error_msg)));
+            return std::string{};
+        }
+
+        auto output = proc.read_std_output();
+        if (output.empty())
+        {
+            mpl::log(mpl::Level::warning, category, fmt::format("no output after running '{}'", cmd));
+            return std::string{};
+        }
+
+        return mp::utils::trim_end(output);
+    };
+
+    InstanceStats stats;
+    stats.load = run_in_vm("cat /proc/loadavg | cut -d ' ' -f1-3");
+    stats.memory_usage = run_in_vm("free -b | sed '1d;3d' | awk '{printf $3}'");
+    stats.memory_total = run_in_vm("free -b | sed '1d;3d' | awk '{printf $2}'");
+    stats.disk_usage = run_in_vm("df --output=used `awk '$2 == \"/\" { print $1 }' /proc/mounts` -B1 | sed 1d");
+    stats.disk_total = run_in_vm("df --output=size `awk '$2 == \"/\" { print $1 }' /proc/mounts` -B1 | sed 1d");
+    stats.current_release = run_in_vm("lsb_release -ds");
+    stats.collected = std::chrono::steady_clock::now();
+
+    if (session)
+        return_ssh_session(name, std::move(session));
+
+    {
+        std::lock_guard<decltype(stats_cache_mutex)> lock{stats_cache_mutex};
+        instance_stats_cache[name] = stats;
+    }
+
+    return stats;
+}
+
+void mp::Daemon::apply_log_settings()
+{
+    const auto spec = Settings::instance().get(settings::log_level);
+
+    std::map<std::string, mpl::Level> overrides;
+    auto ceiling = default_log_level;
+    for (const auto& token : spec.split(',', QString::SkipEmptyParts))
+    {
+        const auto parts = token.split('=');
+        const auto level = mpl::level_from_name(parts.last().trimmed().toStdString());
+        if (parts.size() > 2 || !level)
+        { // a hand-edited settings file should not take logging down with it
+            mpl::log(mpl::Level::warning, category,
+                     fmt::format("Ignoring invalid {} setting \"{}\"", log_level_key, spec));
+            return;
+        }
+
+        overrides[parts.size() == 2 ? parts.first().trimmed().toStdString() : std::string{}] = *level;
+        ceiling = std::max(ceiling, *level);
+    }
+
+    if (!overrides.empty()) // categories without an override of their own stay at the startup verbosity
+        overrides.emplace(std::string{}, default_log_level);
+
+    mpl::set_level_overrides(overrides);
+    config->logger->set_logging_level(ceiling); /* the sinks must pass everything some override admits; the
+        per-category filter drops the rest before it reaches them */
+}
+
+void mp::Daemon::check_idle_instances()
+{
+    const auto timeout_setting = Settings::instance().get(settings::idle_suspend);
+    if (timeout_setting.isEmpty())
+    {
+        idle_samples.clear();
+        return;
+    }
+
+    const auto idle_timeout = std::chrono::minutes{timeout_setting.toInt()};
+    const auto now = std::chrono::steady_clock::now();
+
+    for (const auto& pair : vm_instances)
+    {
+        const auto& name = pair.first;
+
+        if (pair.second->current_state() != VirtualMachine::State::running)
+        { // only plain running instances are candidates; a delayed shutdown is already on its way out
+            idle_samples.erase(name);
+            continue;
+        }
+        suspended_on_idle.erase(name); // it is running again, so a future suspension would be the user's own
+
+        const auto usage = pair.second->host_resource_usage();
+        if (!usage) // backends that cannot report host-side activity are left alone
+            continue;
+
+        const auto net_bytes = std::max(usage->net_rx_bytes, 0LL) + std::max(usage->net_tx_bytes, 0LL);
+        auto it = idle_samples.find(name);
+        if (it == idle_samples.end())
+        {
+            idle_samples[name] = {usage->cpu_seconds, net_bytes, now};
+            continue;
+        }
+
+        auto& sample = it->second;
+        const auto busy = usage->cpu_seconds - sample.cpu_seconds > idle_cpu_threshold ||
+                          net_bytes - sample.net_bytes > idle_net_threshold;
+        sample.cpu_seconds = usage->cpu_seconds;
+        sample.net_bytes = net_bytes;
+
+        if (busy)
+            sample.idle_since = now;
+        else if (now - sample.idle_since >= idle_timeout)
+        {
+            mpl::log(mpl::Level::info, category,
+                     fmt::format("Suspending \"{}\" after {} minutes without activity", name, timeout_setting));
+            idle_samples.erase(name);
+            suspended_on_idle.insert(name);
+            instance_mounts.stop_all_mounts_for_instance(name);
+            drop_ssh_sessions_for(name);
+            QtConcurrent::run(&instance_ops_pool, [name, vm = pair.second] {
+                try
+                {
+                    vm->suspend();
+                }
+                catch (const std::exception& e)
+                {
+                    mpl::log(mpl::Level::warning, category,
+                             fmt::format("Could not suspend idle instance \"{}\": {}", name, e.what()));
+                }
+            });
+        }
+    }
+}
+
+void mp::Daemon::persist_instances()
+{ /* Group commit: bulk operations call this once per touched instance, so the actual write is deferred to
+     the next event-loop pass and every call in between collapses into a single fsync'd DB replacement */
+    notify_instance_event(); // watchers read the in-memory maps, so they need not wait for the disk
+
+    if (instance_persist_pending)
+        return;
+
+    instance_persist_pending = true;
+    QTimer::singleShot(0, this, [this] {
+        instance_persist_pending = false;
+        write_instance_records();
+    });
+}
+
+void mp::Daemon::write_instance_records()
+{
+    QJsonObject instance_records_json;
+    {
+        std::shared_lock<std::shared_mutex> lock{instance_map_mutex}; // pooled workers read specs concurrently
+        for (const auto& record : vm_instance_specs)
+        {
+            auto key = QString::fromStdString(record.first);
+            instance_records_json.insert(key, vm_spec_to_json(record.second));
+        }
     }
     QDir data_dir{
         mp::utils::backend_directory_path(config->data_directory, config->factory->get_backend_directory_name())};
     mp::write_json(instance_records_json, data_dir.filePath(instance_db_name));
+
+    // The journal is now folded into the main DB
+    QFile::remove(data_dir.filePath(instance_db_journal_name));
+    journal_entry_count = 0;
+}
+
+void mp::Daemon::notify_instance_event()
+{
+    {
+        std::lock_guard<std::mutex> lock{instance_event_mutex};
+        ++instance_event_count;
+    }
+    instance_event_cv.notify_all();
+}
+
+void mp::Daemon::persist_instance(const std::string& name)
+{ /* Appends the single affected record to the instance-DB journal, so that individual state changes cost O(1) I/O
+     rather than a rewrite of every record */
+    if (journal_entry_count >= max_journal_entries)
+        return persist_instances(); // compact instead
+
+    QJsonObject entry;
+    entry.insert("name", QString::fromStdString(name));
+
+    auto spec_it = vm_instance_specs.find(name);
+    if (spec_it != vm_instance_specs.end())
+        entry.insert("record", vm_spec_to_json(spec_it->second));
+    else
+        entry.insert("removed", true);
+
+    QDir data_dir{
+        mp::utils::backend_directory_path(config->data_directory, config->factory->get_backend_directory_name())};
+    QFile journal_file{data_dir.filePath(instance_db_journal_name)};
+    if (!journal_file.open(QIODevice::WriteOnly | QIODevice::Append))
+        return persist_instances(); // fall back on the full rewrite
+
+    journal_file.write(QJsonDocument{entry}.toJson(QJsonDocument::Compact));
+    journal_file.write("\n");
+    journal_file.flush();
+    ::fsync(journal_file.handle()); // the append must survive a crash, or replay would miss the newest state
+    ++journal_entry_count;
+
+    notify_instance_event();
+}
+
+mp::VirtualMachine::ShPtr mp::Daemon::materialized_deleted_vm(const std::string& name)
+{ // Deleted instances are registered with a null VM at startup; the object is only constructed when actually needed
+    auto& vm = deleted_instances.at(name);
+    if (!vm)
+    {
+        vm = config->factory->create_virtual_machine(deferred_instance_descs.at(name), *this);
+        deferred_instance_descs.erase(name);
+    }
+
+    return vm;
 }
 
 void mp::Daemon::release_resources(const std::string& instance)
 {
+    deferred_instance_descs.erase(instance);
     config->factory->remove_resources_for(instance);
     config->vault->remove(instance);
     vm_instance_specs.erase(instance);
+
+    {
+        std::lock_guard<decltype(ssh_pool_mutex)> lock{ssh_pool_mutex};
+        ssh_session_pool.erase(instance);
+    }
+
+    idle_samples.erase(instance);
+    suspended_on_idle.erase(instance);
+
+    std::lock_guard<decltype(stats_cache_mutex)> lock{stats_cache_mutex};
+    instance_stats_cache.erase(instance);
 }
 
 std::string mp::Daemon::check_instance_operational(const std::string& instance_name) const
@@ -1826,7 +3055,7 @@ void mp::Daemon::create_vm(const CreateRequest* request, grpc::ServerWriter<Crea
                                                       checked_args.option_errors.SerializeAsString()));
     }
 
-    auto name = name_from(checked_args.instance_name, *config->name_generator, vm_instances);
+    auto name = name_from(checked_args.instance_name, *config->name_generator, vm_instances, deleted_instances);
 
     if (vm_instances.find(name) != vm_instances.end() || deleted_instances.find(name) != deleted_instances.end())
     {
@@ -1848,9 +3077,6 @@ void mp::Daemon::create_vm(const CreateRequest* request, grpc::ServerWriter<Crea
                                                       create_error.SerializeAsString()));
     }
 
-    if (!instances_running(vm_instances))
-        config->factory->hypervisor_health_check();
-
     preparing_instances.insert(name);
 
     auto prepare_future_watcher = new QFutureWatcher<VirtualMachineDescription>();
@@ -1862,16 +3088,21 @@ void mp::Daemon::create_vm(const CreateRequest* request, grpc::ServerWriter<Crea
             {
                 auto vm_desc = prepare_future_watcher->future().result();
 
-                vm_instances[name] = config->factory->create_virtual_machine(vm_desc, *this);
-                vm_instance_specs[name] = {vm_desc.num_cores,
-                                           vm_desc.mem_size,
-                                           vm_desc.disk_space,
-                                           vm_desc.mac_addr,
-                                           config->ssh_username,
-                                           VirtualMachine::State::off,
-                                           {},
-                                           false,
-                                           QJsonObject()};
+                auto new_vm = config->factory->create_virtual_machine(vm_desc, *this);
+                {
+                    std::unique_lock<std::shared_mutex> lock{instance_map_mutex};
+                    vm_instances[name] = std::move(new_vm);
+                    vm_instance_specs[name] = {vm_desc.num_cores,
+                                               vm_desc.mem_size,
+                                               vm_desc.disk_space,
+                                               vm_desc.mac_addr,
+                                               config->ssh_username,
+                                               VirtualMachine::State::off,
+                                               {},
+                                               false,
+                                               QJsonObject(),
+                                               vm_desc.io_limits};
+                }
                 preparing_instances.erase(name);
 
                 persist_instances();
@@ -1904,7 +3135,10 @@ void mp::Daemon::create_vm(const CreateRequest* request, grpc::ServerWriter<Crea
             {
                 preparing_instances.erase(name);
                 release_resources(name);
-                vm_instances.erase(name);
+                {
+                    std::unique_lock<std::shared_mutex> lock{instance_map_mutex};
+                    vm_instances.erase(name);
+                }
                 persist_instances();
                 status_promise->set_value(grpc::Status(grpc::StatusCode::FAILED_PRECONDITION, e.what(), ""));
             }
@@ -1912,13 +3146,110 @@ void mp::Daemon::create_vm(const CreateRequest* request, grpc::ServerWriter<Crea
             delete prepare_future_watcher;
         });
 
-    prepare_future_watcher->setFuture(
-        QtConcurrent::run([this, server, request, name, checked_args]() -> VirtualMachineDescription {
+    /* A standby instance, when one matches, skips the pipeline below: the prepared image just needs moving into place
+       and giving its identity. The instance never booted, so rewriting the cloud-init data is enough — nothing has
+       baked the standby name into the disk yet. */
+    if (request->cloud_init_user_data().empty())
+    {
+        const auto num_cores = request->num_cores() < std::stoi(mp::min_cpu_cores) ? std::stoi(mp::default_cpu_cores)
+                                                                                   : request->num_cores();
+        if (auto standby = claim_standby_instance(query_from(request, name), num_cores, checked_args.mem_size,
+                                                  checked_args.disk_space))
+        {
+            prepare_future_watcher->setFuture(QtConcurrent::run(
+                &instance_ops_pool,
+                [this, server, request, name, vm_desc = *standby]() mutable -> VirtualMachineDescription {
+                    try
+                    {
+                        bool any_running;
+                        {
+                            std::shared_lock<std::shared_mutex> lock{instance_map_mutex};
+                            any_running = instances_running(vm_instances);
+                        }
+                        if (!any_running)
+                            config->factory->hypervisor_health_check();
+
+                        CreateReply reply;
+                        reply.set_create_message("Configuring " + name);
+                        server->Write(reply);
+
+                        auto vm_image = config->vault->rename_image(vm_desc.vm_name, name);
+
+                        auto vendor_data_cloud_init_config = make_cloud_init_vendor_config(
+                            *config->ssh_key_provider, request->time_zone(), config->ssh_username,
+                            config->factory->get_backend_version_string().toStdString());
+                        auto meta_data_cloud_init_config = make_cloud_init_meta_config(name);
+                        auto user_data_cloud_init_config = YAML::Load(request->cloud_init_user_data());
+                        prepare_user_data(user_data_cloud_init_config, vendor_data_cloud_init_config);
+                        config->factory->configure(name, meta_data_cloud_init_config, vendor_data_cloud_init_config);
+
+                        std::string mac_addr;
+                        while (true)
+                        {
+                            mac_addr = mp::utils::generate_mac_address();
+
+                            auto it = allocated_mac_addrs.find(mac_addr);
+                            if (it == allocated_mac_addrs.end())
+                            {
+                                allocated_mac_addrs.insert(mac_addr);
+                                break;
+                            }
+                        }
+
+                        vm_desc.vm_name = name;
+                        vm_desc.mac_addr = mac_addr;
+                        vm_desc.image = vm_image;
+                        vm_desc.meta_data_config = meta_data_cloud_init_config;
+                        vm_desc.user_data_config = user_data_cloud_init_config;
+                        vm_desc.vendor_data_config = vendor_data_cloud_init_config;
+                        vm_desc.cloud_init_iso = make_cloud_init_image(
+                            name, mp::utils::base_dir(vm_image.image_path), meta_data_cloud_init_config,
+                            user_data_cloud_init_config, vendor_data_cloud_init_config);
+
+                        replenish_standby_pool(); // refill the claimed slot in the background
+
+                        return vm_desc;
+                    }
+                    catch (const std::exception& e)
+                    {
+                        throw CreateImageException(e.what());
+                    }
+                }));
+            return;
+        }
+    }
+
+    /* The whole pipeline below — health check, image fetch, preparation, and cloud-init ISO writing — runs on the
+       instance-operations pool, so that concurrent launches overlap and the RPC thread only registers the result */
+    prepare_future_watcher->setFuture(QtConcurrent::run(
+        &instance_ops_pool, [this, server, request, name, checked_args]() -> VirtualMachineDescription {
             try
             {
+                bool any_running;
+                {
+                    std::shared_lock<std::shared_mutex> lock{instance_map_mutex};
+                    any_running = instances_running(vm_instances);
+                }
+                if (!any_running)
+                    config->factory->hypervisor_health_check();
+
                 auto query = query_from(request, name);
 
-                auto progress_monitor = [server](int progress_type, int percentage) {
+                auto progress_monitor = [server, last_percentage = std::numeric_limits<int>::min(),
+                                         last_write = std::chrono::steady_clock::time_point{}](
+                                            int progress_type, int percentage) mutable {
+                    /* The download callback fires per network chunk; only changes go down the stream, a few
+                       times a second at most, instead of hundreds of identical tiny messages. A skipped step
+                       is covered by a later one — the endpoints always go through */
+                    constexpr auto min_progress_interval = std::chrono::milliseconds{100};
+                    const auto now = std::chrono::steady_clock::now();
+                    if (percentage == last_percentage ||
+                        (percentage > 0 && percentage < 100 && now - last_write < min_progress_interval))
+                        return true; // a dropped write cannot detect a hung-up client, but the next one will
+
+                    last_percentage = percentage;
+                    last_write = now;
+
                     CreateReply create_reply;
                     create_reply.mutable_launch_progress()->set_percent_complete(std::to_string(percentage));
                     create_reply.mutable_launch_progress()->set_type((CreateProgress::ProgressTypes)progress_type);
@@ -1962,9 +3293,10 @@ void mp::Daemon::create_vm(const CreateRequest* request, grpc::ServerWriter<Crea
                         break;
                     }
                 }
-                auto vm_desc = to_machine_desc(request, name, checked_args.mem_size, checked_args.disk_space, mac_addr,
-                                               config->ssh_username, vm_image, meta_data_cloud_init_config,
-                                               user_data_cloud_init_config, vendor_data_cloud_init_config);
+                auto vm_desc = to_machine_desc(request, name, checked_args.mem_size, checked_args.disk_space,
+                                               checked_args.io_limits, mac_addr, config->ssh_username, vm_image,
+                                               meta_data_cloud_init_config, user_data_cloud_init_config,
+                                               vendor_data_cloud_init_config);
 
                 config->factory->prepare_instance_image(vm_image, vm_desc);
 
@@ -1977,6 +3309,119 @@ void mp::Daemon::create_vm(const CreateRequest* request, grpc::ServerWriter<Crea
         }));
 }
 
+void mp::Daemon::replenish_standby_pool()
+{
+    auto query = standby_pool_query();
+    if (query.release.empty())
+    { // reclaim leftovers in case a previously configured pool got disabled
+        for (int i = 0; config->vault->has_record_for(standby_name_for(i)); ++i)
+            config->vault->remove(standby_name_for(i));
+        return;
+    }
+
+    bool ok{false};
+    auto count = qEnvironmentVariableIntValue(standby_count_env_var, &ok);
+    if (!ok || count < 1)
+        count = 1;
+
+    for (int i = 0; i < count; ++i)
+    {
+        const auto standby_name = standby_name_for(i);
+        {
+            std::lock_guard<decltype(standby_mutex)> lock{standby_mutex};
+            if (standby_instances.find(standby_name) != standby_instances.end() ||
+                preparing_standby_instances.find(standby_name) != preparing_standby_instances.end())
+                continue;
+
+            preparing_standby_instances.insert(standby_name);
+        }
+
+        query.name = standby_name;
+        QtConcurrent::run(&instance_ops_pool, [this, standby_name, query] {
+            try
+            {
+                auto prepare_action = [this](const VMImage& source_image) -> VMImage {
+                    return config->factory->prepare_source_image(source_image);
+                };
+
+                /* Leftover standby images from a previous run are picked up again here: the vault still has their
+                   records, so the fetch below costs nothing for them */
+                auto vm_image = config->vault->fetch_image(config->factory->fetch_type(), query, prepare_action,
+                                                           [](int, int) { return true; });
+
+                VirtualMachineDescription vm_desc{std::stoi(default_cpu_cores),
+                                                  MemorySize{default_memory_size},
+                                                  MemorySize{default_disk_size},
+                                                  standby_name,
+                                                  "",
+                                                  config->ssh_username,
+                                                  vm_image,
+                                                  "",
+                                                  {},
+                                                  {},
+                                                  {}};
+                config->factory->prepare_instance_image(vm_image, vm_desc);
+
+                {
+                    std::lock_guard<decltype(standby_mutex)> lock{standby_mutex};
+                    standby_instances.emplace(standby_name, vm_desc);
+                    preparing_standby_instances.erase(standby_name);
+                }
+
+                mpl::log(mpl::Level::info, category, fmt::format("Standby instance {} is ready", standby_name));
+            }
+            catch (const std::exception& e)
+            {
+                {
+                    std::lock_guard<decltype(standby_mutex)> lock{standby_mutex};
+                    preparing_standby_instances.erase(standby_name);
+                }
+
+                mpl::log(mpl::Level::warning, category,
+                         fmt::format("Could not prepare standby instance {}: {}", standby_name, e.what()));
+            }
+        });
+    }
+
+    // Drop slots beyond the configured count, e.g. after the pool was shrunk
+    for (int i = count; config->vault->has_record_for(standby_name_for(i)); ++i)
+    {
+        const auto standby_name = standby_name_for(i);
+        {
+            std::lock_guard<decltype(standby_mutex)> lock{standby_mutex};
+            if (preparing_standby_instances.find(standby_name) != preparing_standby_instances.end())
+                continue; // still being prepared by an earlier round, leave it alone
+
+            standby_instances.erase(standby_name);
+        }
+        config->vault->remove(standby_name);
+    }
+}
+
+mp::optional<mp::VirtualMachineDescription> mp::Daemon::claim_standby_instance(const Query& query, int num_cores,
+                                                                              const MemorySize& mem_size,
+                                                                              const MemorySize& disk_space)
+{
+    const auto pool_query = standby_pool_query();
+    if (pool_query.release.empty() || query.release != pool_query.release ||
+        query.remote_name != pool_query.remote_name || query.query_type != Query::Type::Alias)
+        return nullopt;
+
+    std::lock_guard<decltype(standby_mutex)> lock{standby_mutex};
+    for (auto it = standby_instances.begin(); it != standby_instances.end(); ++it)
+    {
+        const auto& desc = it->second;
+        if (num_cores == desc.num_cores && mem_size == desc.mem_size && disk_space == desc.disk_space)
+        {
+            auto claimed = std::move(it->second);
+            standby_instances.erase(it);
+            return claimed;
+        }
+    }
+
+    return nullopt;
+}
+
 grpc::Status mp::Daemon::reboot_vm(VirtualMachine& vm)
 {
     if (vm.state == VirtualMachine::State::delayed_shutdown)
@@ -1987,35 +3432,26 @@ grpc::Status mp::Daemon::reboot_vm(VirtualMachine& vm)
                             fmt::format("instance \"{}\" is not running", vm.vm_name), ""};
 
     mpl::log(mpl::Level::debug, category, fmt::format("Rebooting {}", vm.vm_name));
-    return ssh_reboot(vm.ssh_hostname(), vm.ssh_port(), vm.ssh_username(), *config->ssh_key_provider);
+
+    // the session dies with the reboot, so it is not given back to the pool afterwards
+    auto session = checkout_ssh_session(vm.vm_name, vm, vm.ssh_username());
+    return ssh_reboot(*session);
 }
 
-grpc::Status mp::Daemon::shutdown_vm(VirtualMachine& vm, const std::chrono::milliseconds delay)
+grpc::Status mp::Daemon::shutdown_vm(VirtualMachine& vm, const std::chrono::milliseconds delay,
+                                     mp::optional<SSHSession> session)
 {
     const auto& name = vm.vm_name;
-    const auto& state = vm.current_state();
-
-    using St = VirtualMachine::State;
-    const auto skip_states = {St::off, St::stopped, St::suspended};
 
-    if (std::none_of(cbegin(skip_states), cend(skip_states), [&state](const auto& st) { return state == st; }))
+    if (vm_needs_stopping(vm.current_state()))
     {
         delayed_shutdown_instances.erase(name);
 
-        mp::optional<mp::SSHSession> session;
-        try
-        {
-            session = mp::SSHSession{vm.ssh_hostname(), vm.ssh_port(), vm.ssh_username(), *config->ssh_key_provider};
-        }
-        catch (const std::exception& e)
-        {
-            mpl::log(mpl::Level::info, category,
-                     fmt::format("Cannot open ssh session on \"{}\" shutdown: {}", name, e.what()));
-        }
-
         auto& shutdown_timer = delayed_shutdown_instances[name] = std::make_unique<DelayedShutdownTimer>(
-            &vm, std::move(session),
-            std::bind(&SSHFSMounts::stop_all_mounts_for_instance, &instance_mounts, std::placeholders::_1));
+            &vm, std::move(session), [this](const std::string& instance) {
+                instance_mounts.stop_all_mounts_for_instance(instance);
+                drop_ssh_sessions_for(instance);
+            });
 
         QObject::connect(shutdown_timer.get(), &DelayedShutdownTimer::finished,
                          [this, name]() { delayed_shutdown_instances.erase(name); });
@@ -2028,6 +3464,50 @@ grpc::Status mp::Daemon::shutdown_vm(VirtualMachine& vm, const std::chrono::mill
     return grpc::Status::OK;
 }
 
+grpc::Status mp::Daemon::shutdown_vms(const std::vector<std::string>& tgts, const std::chrono::milliseconds delay)
+{ /* The delayed-shutdown timers have to live on the daemon thread, but dialing SSH dominates the cost of a shutdown
+     request, so the sessions are opened concurrently up front. */
+    std::vector<mp::optional<mp::SSHSession>> sessions(tgts.size());
+
+    std::vector<mp::VirtualMachine*> vms;
+    vms.reserve(tgts.size());
+    for (const auto& tgt : tgts)
+        vms.push_back(vm_instances.at(tgt).get()); // resolve each name once, rather than re-hashing it per pass
+
+    QFutureSynchronizer<void> dial_synchronizer;
+    for (std::vector<std::string>::size_type i = 0; i < tgts.size(); ++i)
+    {
+        auto& vm = *vms[i];
+        if (!vm_needs_stopping(vm.current_state()))
+            continue;
+
+        dial_synchronizer.addFuture(QtConcurrent::run(&instance_ops_pool, [this, &sessions, i, &vm] {
+            try
+            {
+                sessions[i] =
+                    mp::SSHSession{vm.ssh_hostname(), vm.ssh_port(), vm.ssh_username(), *config->ssh_key_provider};
+            }
+            catch (const std::exception& e)
+            {
+                mpl::log(mpl::Level::info, category,
+                         fmt::format("Cannot open ssh session on \"{}\" shutdown: {}", vm.vm_name, e.what()));
+            }
+        }));
+    }
+
+    dial_synchronizer.waitForFinished();
+
+    fmt::memory_buffer errors;
+    for (std::vector<std::string>::size_type i = 0; i < tgts.size(); ++i)
+    {
+        auto status = shutdown_vm(*vms[i], delay, std::move(sessions[i]));
+        if (!status.ok())
+            fmt::format_to(errors, "{}\n", status.error_message());
+    }
+
+    return grpc_status_for(errors);
+}
+
 grpc::Status mp::Daemon::cancel_vm_shutdown(const VirtualMachine& vm)
 {
     auto it = delayed_shutdown_instances.find(vm.vm_name);
@@ -2054,6 +3534,43 @@ grpc::Status mp::Daemon::cmd_vms(const std::vector<std::string>& tgts, std::func
     return grpc::Status::OK;
 }
 
+grpc::Status mp::Daemon::cmd_vms_concurrently(const std::vector<std::string>& tgts,
+                                              std::function<grpc::Status(VirtualMachine&)> cmd)
+{ /* Fans the command out on the instance-operations pool, whose size caps the parallelism. The command must be safe
+     to run against distinct instances from different threads. Unlike cmd_vms, all targets are attempted and the
+     per-instance errors aggregated, as failing early would leave the remaining instances in unknown stages. */
+    QFutureSynchronizer<grpc::Status> synchronizer;
+    for (const auto& tgt : tgts)
+        synchronizer.addFuture(QtConcurrent::run(&instance_ops_pool, [this, &cmd, &tgt]() -> grpc::Status {
+            try
+            {
+                VirtualMachine::ShPtr vm;
+                {
+                    std::shared_lock<std::shared_mutex> lock{instance_map_mutex};
+                    vm = vm_instances.at(tgt);
+                }
+                return cmd(*vm);
+            }
+            catch (const std::exception& e)
+            {
+                return grpc::Status{grpc::StatusCode::FAILED_PRECONDITION, fmt::format("\"{}\": {}", tgt, e.what()),
+                                    ""};
+            }
+        }));
+
+    synchronizer.waitForFinished();
+
+    fmt::memory_buffer errors;
+    for (const auto& future : synchronizer.futures())
+    {
+        auto status = future.result();
+        if (!status.ok())
+            fmt::format_to(errors, "{}\n", status.error_message());
+    }
+
+    return grpc_status_for(errors);
+}
+
 QFutureWatcher<mp::Daemon::AsyncOperationStatus>*
 mp::Daemon::create_future_watcher(std::function<void()> const& finished_op)
 {
@@ -2076,8 +3593,14 @@ error_string mp::Daemon::async_wait_for_ssh_and_start_mounts_for(const std::stri
     fmt::memory_buffer errors;
     try
     {
-        auto it = vm_instances.find(name);
-        auto vm = it->second;
+        VirtualMachine::ShPtr vm;
+        {
+            std::shared_lock<std::shared_mutex> lock{instance_map_mutex};
+            auto it = vm_instances.find(name);
+            if (it == vm_instances.end())
+                return {}; // the instance went away while this was queued; nothing to wait for
+            vm = it->second;
+        }
         vm->wait_until_ssh_up(up_timeout);
 
         if (std::is_same<Reply, LaunchReply>::value)
@@ -2093,8 +3616,17 @@ error_string mp::Daemon::async_wait_for_ssh_and_start_mounts_for(const std::stri
         }
 
         std::vector<std::string> invalid_mounts;
-        auto& mounts = vm_instance_specs[name].mounts;
-        auto& vm_specs = vm_instance_specs[name];
+        std::string ssh_username;
+        decltype(VMSpecs::mounts) mounts;
+        {
+            std::shared_lock<std::shared_mutex> lock{instance_map_mutex};
+            auto spec_it = vm_instance_specs.find(name);
+            if (spec_it == vm_instance_specs.end())
+                return {}; // deleted under us, taking its mounts along
+            ssh_username = spec_it->second.ssh_username;
+            mounts = spec_it->second.mounts; /* a copy: mount setup takes seconds and the daemon thread stays
+                                                free to reshape the specs map meanwhile */
+        }
         for (const auto& mount_entry : mounts)
         {
             auto& target_path = mount_entry.first;
@@ -2117,9 +3649,9 @@ error_string mp::Daemon::async_wait_for_ssh_and_start_mounts_for(const std::stri
                         server->Write(reply);
                     }
 
-                    mp::SSHSession session{vm->ssh_hostname(), vm->ssh_port(), vm_specs.ssh_username,
-                                           *config->ssh_key_provider};
-                    mp::utils::install_sshfs_for(name, session);
+                    auto session = checkout_ssh_session(name, *vm, ssh_username);
+                    mp::utils::install_sshfs_for(name, *session);
+                    return_ssh_session(name, std::move(session));
                     instance_mounts.start_mount(vm.get(), source_path, target_path, gid_map, uid_map);
                 }
                 catch (const mp::SSHFSMissingError&)
@@ -2160,8 +3692,8 @@ mp::Daemon::AsyncOperationStatus mp::Daemon::async_wait_for_ready_all(grpc::Serv
             }
             else
             {
-                auto future =
-                    QtConcurrent::run(this, &Daemon::async_wait_for_ssh_and_start_mounts_for<Reply>, name, server);
+                auto future = QtConcurrent::run(&instance_ops_pool, this,
+                                                &Daemon::async_wait_for_ssh_and_start_mounts_for<Reply>, name, server);
                 async_running_futures[name] = future;
                 start_synchronizer.addFuture(future);
             }
@@ -2201,6 +3733,92 @@ mp::Daemon::AsyncOperationStatus mp::Daemon::async_wait_for_ready_all(grpc::Serv
     return {grpc_status_for(errors), status_promise};
 }
 
+std::vector<std::vector<std::string>> mp::Daemon::boot_layers_for(std::vector<std::string> vms)
+{
+    std::unordered_set<std::string> pending{vms.begin(), vms.end()};
+    for (auto i = 0u; i < vms.size(); ++i) // vms grows as transitive dependencies are discovered
+    {
+        for (const auto& dependency : vm_instance_specs[vms[i]].boot_dependencies)
+        {
+            auto it = vm_instances.find(dependency);
+            if (it == vm_instances.end())
+                mpl::log(mpl::Level::warning, category,
+                         fmt::format("Ignoring unknown boot dependency \"{}\" of \"{}\"", dependency, vms[i]));
+            else if (it->second->current_state() != VirtualMachine::State::running &&
+                     pending.insert(dependency).second)
+                vms.push_back(dependency);
+        }
+    }
+
+    std::vector<std::vector<std::string>> layers;
+    while (!pending.empty())
+    {
+        std::vector<std::string> layer;
+        for (const auto& name : pending)
+        { // a dependency outside `pending` is either up already or placed in an earlier layer
+            const auto& dependencies = vm_instance_specs[name].boot_dependencies;
+            if (std::all_of(dependencies.cbegin(), dependencies.cend(),
+                            [&pending](const auto& dependency) { return pending.count(dependency) == 0; }))
+                layer.push_back(name);
+        }
+
+        if (layer.empty())
+        { // dependency cycle; refusing to start would be worse than ignoring the declared order
+            mpl::log(mpl::Level::warning, category,
+                     "Circular boot dependencies; starting the remaining instances together");
+            layer.assign(pending.cbegin(), pending.cend());
+        }
+
+        for (const auto& name : layer)
+            pending.erase(name);
+        layers.push_back(std::move(layer));
+    }
+
+    return layers;
+}
+
+template <typename Reply>
+mp::Daemon::AsyncOperationStatus mp::Daemon::async_start_in_dependency_order(
+    grpc::ServerWriter<Reply>* server, const std::vector<std::vector<std::string>>& layers,
+    std::promise<grpc::Status>* status_promise)
+{
+    fmt::memory_buffer errors;
+    for (const auto& layer : layers)
+    {
+        if (errors.size())
+        { // a dependency did not come up; leave its dependents down rather than starting a broken stack
+            for (const auto& name : layer)
+                fmt::format_to(errors, "\"{}\": not started, a boot dependency failed\n", name);
+            continue;
+        }
+
+        std::vector<VirtualMachine::ShPtr> to_start;
+        {
+            std::shared_lock<std::shared_mutex> lock{instance_map_mutex};
+            for (const auto& name : layer)
+            {
+                auto it = vm_instances.find(name);
+                if (it != vm_instances.end())
+                    to_start.push_back(it->second);
+            }
+        }
+
+        for (const auto& vm : to_start)
+        {
+            auto state = vm->current_state();
+            if (state != VirtualMachine::State::running && state != VirtualMachine::State::starting &&
+                state != VirtualMachine::State::restarting)
+                vm->start();
+        }
+
+        auto status = async_wait_for_ready_all<Reply>(server, layer, nullptr).status; // readiness gate for the layer
+        if (!status.ok())
+            fmt::format_to(errors, "{}\n", status.error_message());
+    }
+
+    return {grpc_status_for(errors), status_promise};
+}
+
 void mp::Daemon::finish_async_operation(QFuture<AsyncOperationStatus> async_future)
 {
     auto it = std::find_if(async_future_watchers.begin(), async_future_watchers.end(),
@@ -21,21 +21,28 @@
 #include "daemon_config.h"
 #include "daemon_rpc.h"
 
+#include <multipass/copy_counter.h>
 #include <multipass/delayed_shutdown_timer.h>
 #include <multipass/memory_size.h>
+#include <multipass/optional.h>
 #include <multipass/metrics_provider.h>
 #include <multipass/sshfs_mount/sshfs_mounts.h>
 #include <multipass/virtual_machine.h>
+#include <multipass/virtual_machine_description.h>
 #include <multipass/vm_status_monitor.h>
 
+#include <atomic>
 #include <future>
 #include <memory>
+#include <condition_variable>
 #include <mutex>
+#include <shared_mutex>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
 #include <QFutureWatcher>
+#include <QThreadPool>
 
 namespace multipass
 {
@@ -57,6 +64,10 @@ struct VMSpecs
     std::unordered_map<std::string, VMMount> mounts;
     bool deleted;
     QJsonObject metadata;
+    IoLimits io_limits;
+    std::vector<std::string> boot_dependencies; // instances to bring up (to SSH) first on `start`; usually empty
+
+    MP_COUNT_COPIES(VMSpecs);
 };
 
 struct MetricsOptInData
@@ -66,11 +77,13 @@ struct MetricsOptInData
 };
 
 struct DaemonConfig;
+class Query;
 class Daemon : public QObject, public multipass::VMStatusMonitor
 {
     Q_OBJECT
 public:
     explicit Daemon(std::unique_ptr<const DaemonConfig> config);
+    ~Daemon();
     Daemon(const Daemon&) = delete;
     Daemon& operator=(const Daemon&) = delete;
 
@@ -91,6 +104,9 @@ public slots:
     virtual void launch(const LaunchRequest* request, grpc::ServerWriter<LaunchReply>* reply,
                         std::promise<grpc::Status>* status_promise);
 
+    virtual void clone(const CloneRequest* request, grpc::ServerWriter<CloneReply>* response,
+                       std::promise<grpc::Status>* status_promise);
+
     virtual void purge(const PurgeRequest* request, grpc::ServerWriter<PurgeReply>* response,
                        std::promise<grpc::Status>* status_promise);
 
@@ -124,26 +140,57 @@ public slots:
     virtual void restart(const RestartRequest* request, grpc::ServerWriter<RestartReply>* response,
                          std::promise<grpc::Status>* status_promise);
 
+    virtual void snapshot(const SnapshotRequest* request, grpc::ServerWriter<SnapshotReply>* response,
+                          std::promise<grpc::Status>* status_promise);
+
+    virtual void restore(const RestoreRequest* request, grpc::ServerWriter<RestoreReply>* response,
+                         std::promise<grpc::Status>* status_promise);
+
+    virtual void modify(const ModifyRequest* request, grpc::ServerWriter<ModifyReply>* response,
+                        std::promise<grpc::Status>* status_promise);
+
     virtual void delet(const DeleteRequest* request, grpc::ServerWriter<DeleteReply>* response,
                        std::promise<grpc::Status>* status_promise);
 
+    virtual void apply(const ApplyRequest* request, grpc::ServerWriter<ApplyReply>* response,
+                       std::promise<grpc::Status>* status_promise);
+
     virtual void umount(const UmountRequest* request, grpc::ServerWriter<UmountReply>* response,
                         std::promise<grpc::Status>* status_promise);
 
     virtual void version(const VersionRequest* request, grpc::ServerWriter<VersionReply>* response,
                          std::promise<grpc::Status>* status_promise);
 
+    virtual void trace(const TraceRequest* request, grpc::ServerWriter<TraceReply>* response,
+                       std::promise<grpc::Status>* status_promise);
+
+    virtual void get_metrics(const MetricsRequest* request, grpc::ServerWriter<MetricsReply>* response,
+                             std::promise<grpc::Status>* status_promise);
+
 private:
     void persist_instances();
+    void persist_instance(const std::string& name);
+    void write_instance_records();
+    void notify_instance_event();
+    VirtualMachine::ShPtr materialized_deleted_vm(const std::string& name);
     void release_resources(const std::string& instance);
     std::string check_instance_operational(const std::string& instance_name) const;
     std::string check_instance_exists(const std::string& instance_name) const;
     void create_vm(const CreateRequest* request, grpc::ServerWriter<CreateReply>* server,
                    std::promise<grpc::Status>* status_promise, bool start);
+    void replenish_standby_pool();
+    optional<VirtualMachineDescription> claim_standby_instance(const Query& query, int num_cores,
+                                                               const MemorySize& mem_size,
+                                                               const MemorySize& disk_space);
+    void list_reply_for(const ListRequest* request, ListReply& response);
     grpc::Status reboot_vm(VirtualMachine& vm);
-    grpc::Status shutdown_vm(VirtualMachine& vm, const std::chrono::milliseconds delay);
+    grpc::Status shutdown_vm(VirtualMachine& vm, const std::chrono::milliseconds delay,
+                             optional<SSHSession> session);
+    grpc::Status shutdown_vms(const std::vector<std::string>& tgts, const std::chrono::milliseconds delay);
     grpc::Status cancel_vm_shutdown(const VirtualMachine& vm);
     grpc::Status cmd_vms(const std::vector<std::string>& tgts, std::function<grpc::Status(VirtualMachine&)> cmd);
+    grpc::Status cmd_vms_concurrently(const std::vector<std::string>& tgts,
+                                      std::function<grpc::Status(VirtualMachine&)> cmd);
     void install_sshfs(VirtualMachine* vm, const std::string& name);
 
     struct AsyncOperationStatus
@@ -152,12 +199,43 @@ private:
         std::promise<grpc::Status>* status_promise;
     };
 
+    struct InstanceStats
+    {
+        std::string load;
+        std::string memory_usage;
+        std::string memory_total;
+        std::string disk_usage;
+        std::string disk_total;
+        std::string current_release;
+        std::chrono::steady_clock::time_point collected;
+    };
+
+    struct IdleSample
+    {
+        double cpu_seconds;   // cumulative hypervisor CPU time at the last check
+        long long net_bytes;  // cumulative rx + tx on the instance's network device, idem
+        std::chrono::steady_clock::time_point idle_since; // start of the current idle streak
+    };
+
+    InstanceStats stats_for(const std::string& name, VirtualMachine& vm, const std::string& ssh_username);
+    void check_idle_instances();
+    void apply_log_settings(); // reapplies the log-level setting; hooked to changes of the settings file
+    std::shared_ptr<SSHSession> checkout_ssh_session(const std::string& name, VirtualMachine& vm,
+                                                     const std::string& ssh_username);
+    void return_ssh_session(const std::string& name, std::shared_ptr<SSHSession> session);
+    void drop_ssh_sessions_for(const std::string& name);
+
     template <typename Reply>
     std::string async_wait_for_ssh_and_start_mounts_for(const std::string& name, grpc::ServerWriter<Reply>* server);
     template <typename Reply>
     AsyncOperationStatus async_wait_for_ready_all(grpc::ServerWriter<Reply>* server,
                                                   const std::vector<std::string>& vms,
                                                   std::promise<grpc::Status>* status_promise);
+    std::vector<std::vector<std::string>> boot_layers_for(std::vector<std::string> vms);
+    template <typename Reply>
+    AsyncOperationStatus async_start_in_dependency_order(grpc::ServerWriter<Reply>* server,
+                                                         const std::vector<std::vector<std::string>>& layers,
+                                                         std::promise<grpc::Status>* status_promise);
     void finish_async_operation(QFuture<AsyncOperationStatus> async_future);
     QFutureWatcher<AsyncOperationStatus>* create_future_watcher(std::function<void()> const& finished_op = []() {});
 
@@ -165,19 +243,49 @@ private:
     std::unordered_map<std::string, VMSpecs> vm_instance_specs;
     std::unordered_map<std::string, VirtualMachine::ShPtr> vm_instances;
     std::unordered_map<std::string, VirtualMachine::ShPtr> deleted_instances;
+    mutable std::shared_mutex instance_map_mutex; /* guards the structure of the three maps above, specs included.
+        Only the daemon thread mutates them (under an exclusive lock), but watchers and pooled workers look
+        instances and specs up from other threads, taking shared locks — so read-mostly traffic never queues
+        behind itself. Lookups copy what they need out rather than holding the lock across instance operations */
+    std::unordered_map<std::string, VirtualMachineDescription> deferred_instance_descs;
     std::unordered_map<std::string, std::unique_ptr<DelayedShutdownTimer>> delayed_shutdown_instances;
     std::unordered_set<std::string> allocated_mac_addrs;
     std::unordered_map<std::string, VMImageHost*> remote_image_host_map;
     DaemonRpc daemon_rpc;
     QTimer source_images_maintenance_task;
+    QTimer instance_stats_refresh_task;
+    std::unordered_map<std::string, InstanceStats> instance_stats_cache;
+    std::mutex stats_cache_mutex;
+    std::unordered_map<std::string, std::vector<FindReply>> find_reply_cache; /* replies per distinct query,
+        shared by the identical find requests tooling fires in bursts; daemon-thread only, and valid exactly
+        as long as the catalog stamp below is, so served replies are never staler than the manifest TTL */
+    std::string find_reply_cache_stamp;
+    QTimer idle_detection_task;
+    std::unordered_map<std::string, IdleSample> idle_samples; // daemon-thread only
+    std::unordered_set<std::string> suspended_on_idle; /* instances the daemon parked itself; these resume
+                                                          transparently when a client asks for their credentials */
+    logging::Level default_log_level{logging::Level::info}; // the verbosity the daemon was started with
+    std::unordered_map<std::string, std::shared_ptr<SSHSession>> ssh_session_pool;
+    std::mutex ssh_pool_mutex;
     MetricsProvider metrics_provider;
     MetricsOptInData metrics_opt_in;
     SSHFSMounts instance_mounts;
     std::vector<std::unique_ptr<QFutureWatcher<AsyncOperationStatus>>> async_future_watchers;
     std::unordered_map<std::string, QFuture<std::string>> async_running_futures;
     std::mutex start_mutex;
+    QThreadPool instance_ops_pool;
+    int journal_entry_count{0};
+    std::atomic<bool> instance_persist_pending{false}; /* a full DB write is queued on the event loop; pooled
+        mount workers persist too, so the flag must be safe to test-and-set off the daemon thread */
+    std::mutex instance_event_mutex;
+    std::condition_variable instance_event_cv;
+    uint64_t instance_event_count{0}; // bumped on every persisted instance change, to wake watching list streams
     std::unordered_set<std::string> preparing_instances;
+    std::unordered_map<std::string, VirtualMachineDescription> standby_instances;
+    std::unordered_set<std::string> preparing_standby_instances;
+    std::mutex standby_mutex;
     QFuture<void> image_update_future;
+    std::unordered_set<std::string> compacting_instances; // daemon-thread only, like the maps above
 };
 } // namespace multipass
 #endif // MULTIPASS_DAEMON_H
@@ -21,19 +21,25 @@
 #include "ubuntu_image_host.h"
 
 #include <multipass/client_cert_store.h>
+#include <multipass/constants.h>
+#include <multipass/format.h>
 #include <multipass/logging/log.h>
 #include <multipass/logging/standard_logger.h>
+#include <multipass/memory_size.h>
 #include <multipass/name_generator.h>
 #include <multipass/platform.h>
+#include <multipass/settings.h>
 #include <multipass/ssh/openssh_key_provider.h>
 #include <multipass/ssl_cert_provider.h>
 #include <multipass/standard_paths.h>
+#include <multipass/tracing/trace_recorder.h>
 #include <multipass/utils.h>
 
 #include <QString>
 #include <QUrl>
 
 #include <chrono>
+#include <future>
 #include <memory>
 
 namespace mp = multipass;
@@ -94,6 +100,7 @@ mp::DaemonConfig::~DaemonConfig()
 
 std::unique_ptr<const mp::DaemonConfig> mp::DaemonConfigBuilder::build()
 {
+    MP_TRACE_SPAN("DaemonConfigBuilder::build");
     // Install logger as early as possible
     if (logger == nullptr)
         logger = platform::make_logger(verbosity_level);
@@ -110,22 +117,76 @@ std::unique_ptr<const mp::DaemonConfig> mp::DaemonConfigBuilder::build()
         data_directory = StandardPaths::instance().writableLocation(StandardPaths::AppDataLocation);
     if (url_downloader == nullptr)
         url_downloader = std::make_unique<URLDownloader>(cache_directory, std::chrono::seconds{10});
+
+    const auto bandwidth = Settings::instance().get(settings::bandwidth);
+    if (!bandwidth.isEmpty())
+    {
+        try
+        {
+            url_downloader->set_bandwidth_limit(MemorySize{bandwidth.toStdString()}.in_bytes());
+        }
+        catch (const std::exception& e)
+        { // a hand-edited settings file should not keep the daemon from starting
+            mpl::log(mpl::Level::warning, "daemon config",
+                     fmt::format("Ignoring invalid {} setting \"{}\": {}", bandwidth_key, bandwidth, e.what()));
+        }
+    }
+    if (server_address.empty())
+        server_address = platform::default_server_address();
+    if (connection_type == RpcConnectionType::ssl && mp::utils::is_local_socket_address(server_address))
+        connection_type = RpcConnectionType::insecure; /* filesystem permissions on the socket already authenticate
+            local peers, so TLS on top only adds a handshake per invocation; TCP addresses keep SSL */
+
+    /* The slow pieces of startup are independent of one another: backend probing and the vault record load on one
+       side, SSH key and TLS certificate generation (expensive on a first run) on the other. Generate keys and certs
+       on the side while this thread walks the backend chain; everything else here is microseconds of wiring, so a
+       fuller dependency graph would buy nothing more. */
+    std::future<std::unique_ptr<SSHKeyProvider>> ssh_key_future;
+    if (ssh_key_provider == nullptr)
+        ssh_key_future = std::async(std::launch::async, [this]() -> std::unique_ptr<SSHKeyProvider> {
+            return std::make_unique<OpenSSHKeyProvider>(data_directory);
+        });
+
+    std::future<std::unique_ptr<CertProvider>> cert_future;
+    if (cert_provider == nullptr)
+        cert_future = std::async(std::launch::async, [this]() -> std::unique_ptr<CertProvider> {
+            return std::make_unique<mp::SSLCertProvider>(mp::utils::make_dir(data_directory, "certificates"),
+                                                         server_name_from(server_address));
+        });
+
     if (factory == nullptr)
+    {
+        MP_TRACE_SPAN("vm_backend"); // backend probing, network bridge and firewall setup
         factory = platform::vm_backend(data_directory);
+    }
     if (update_prompt == nullptr)
         update_prompt = platform::make_update_prompt();
     if (image_hosts.empty())
     {
+        const auto upstream_release = std::string{"https://cloud-images.ubuntu.com/releases/"};
+        const auto upstream_daily = std::string{"https://cloud-images.ubuntu.com/daily/"};
+        const auto mirror = Settings::instance().get(settings::mirror).toStdString();
+
         image_hosts.push_back(std::make_unique<mp::CustomVMImageHost>(url_downloader.get(), manifest_ttl));
-        image_hosts.push_back(std::make_unique<mp::UbuntuVMImageHost>(
+        auto ubuntu_host = std::make_unique<mp::UbuntuVMImageHost>(
             std::vector<std::pair<std::string, std::string>>{
-                {mp::release_remote, "https://cloud-images.ubuntu.com/releases/"},
-                {mp::daily_remote, "https://cloud-images.ubuntu.com/daily/"},
+                {mp::release_remote, mirror.empty() ? upstream_release : mirror + "releases/"},
+                {mp::daily_remote, mirror.empty() ? upstream_daily : mirror + "daily/"},
                 {mp::appliance_remote, "http://cdimage.ubuntu.com/ubuntu-core/appliances/"}},
-            url_downloader.get(), manifest_ttl));
+            url_downloader.get(), manifest_ttl);
+
+        if (!mirror.empty())
+        { // the upstream host remains as a fallback, so a stale mirror config cannot cut images off entirely
+            mpl::log(mpl::Level::info, "daemon config", fmt::format("Fetching images via mirror \"{}\"", mirror));
+            ubuntu_host->set_fallback_url(mp::release_remote, upstream_release);
+            ubuntu_host->set_fallback_url(mp::daily_remote, upstream_daily);
+        }
+
+        image_hosts.push_back(std::move(ubuntu_host));
     }
     if (vault == nullptr)
     {
+        MP_TRACE_SPAN("create_image_vault"); // includes loading the vault records from disk
         std::vector<VMImageHost*> hosts;
         for (const auto& image : image_hosts)
         {
@@ -137,15 +198,26 @@ std::unique_ptr<const mp::DaemonConfig> mp::DaemonConfigBuilder::build()
             mp::utils::backend_directory_path(cache_directory, factory->get_backend_directory_name()),
             mp::utils::backend_directory_path(data_directory, factory->get_backend_directory_name()), days_to_expire);
     }
+
+    const auto vault_size = Settings::instance().get(settings::vault_size);
+    if (!vault_size.isEmpty())
+    {
+        try
+        {
+            vault->set_size_budget(MemorySize{vault_size.toStdString()}.in_bytes());
+        }
+        catch (const std::exception& e)
+        { // as with the bandwidth cap, a hand-edited settings file should not keep the daemon from starting
+            mpl::log(mpl::Level::warning, "daemon config",
+                     fmt::format("Ignoring invalid {} setting \"{}\": {}", vault_size_key, vault_size, e.what()));
+        }
+    }
     if (name_generator == nullptr)
         name_generator = mp::make_default_name_generator();
-    if (server_address.empty())
-        server_address = platform::default_server_address();
-    if (ssh_key_provider == nullptr)
-        ssh_key_provider = std::make_unique<OpenSSHKeyProvider>(data_directory);
-    if (cert_provider == nullptr)
-        cert_provider = std::make_unique<mp::SSLCertProvider>(mp::utils::make_dir(data_directory, "certificates"),
-                                                              server_name_from(server_address));
+    if (ssh_key_future.valid())
+        ssh_key_provider = ssh_key_future.get();
+    if (cert_future.valid())
+        cert_provider = cert_future.get();
     if (client_cert_store == nullptr)
         client_cert_store =
             std::make_unique<mp::ClientCertStore>(mp::utils::make_dir(data_directory, "registered-certs"));
@@ -84,6 +84,7 @@ struct DaemonConfigBuilder
     std::chrono::hours image_refresh_timer{6};
     multipass::logging::Level verbosity_level{multipass::logging::Level::info};
     RpcConnectionType connection_type{RpcConnectionType::ssl};
+    bool profile_startup{false}; // read by main before build(); the config itself does not carry it
 
     std::unique_ptr<const DaemonConfig> build();
 };
@@ -28,6 +28,7 @@
 #include <multipass/platform.h>
 #include <multipass/platform_unix.h>
 #include <multipass/top_catch_all.h>
+#include <multipass/tracing/trace_recorder.h>
 #include <multipass/utils.h>
 #include <multipass/version.h>
 #include <multipass/virtual_machine_factory.h>
@@ -37,6 +38,8 @@
 #include <multipass/format.h>
 
 #include <QCoreApplication>
+#include <QDir>
+#include <QFile>
 
 #include <csignal>
 #include <cstring>
@@ -78,6 +81,24 @@ void set_server_permissions(const std::string& server_address)
         throw std::runtime_error("Could not set permissions for the multipass socket.");
 }
 
+void dump_startup_profile(const mp::Path& data_directory)
+{
+    const auto trace_path = QDir{data_directory}.filePath("startup-trace.json");
+    const auto json = mp::tracing::TraceRecorder::instance().chrome_trace_json();
+
+    QFile file{trace_path};
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) ||
+        file.write(json.data(), json.size()) != static_cast<qint64>(json.size()))
+    {
+        mpl::log(mpl::Level::warning, "daemon",
+                 fmt::format("Could not write startup profile to {}: {}", trace_path, file.errorString()));
+        return;
+    }
+
+    mpl::log(mpl::Level::info, "daemon",
+             fmt::format("Startup profile written to {}; load it in chrome://tracing", trace_path));
+}
+
 class UnixSignalHandler
 {
 public:
@@ -114,14 +135,19 @@ int main_impl(int argc, char* argv[])
     UnixSignalHandler handler;
 
     auto builder = mp::cli::parse(app);
+    const auto profile_startup = builder.profile_startup;
     auto config = builder.build();
     auto server_address = config->server_address;
+    auto data_directory = config->data_directory;
 
     mp::monitor_and_quit_on_settings_change(); // temporary
     mp::Daemon daemon(std::move(config));
 
     set_server_permissions(server_address);
 
+    if (profile_startup) // construction is done, so the spans recorded up to here are the startup story
+        dump_startup_profile(data_directory);
+
     mpl::log(mpl::Level::info, "daemon", fmt::format("Starting Multipass {}", mp::version_string));
     mpl::log(mpl::Level::info, "daemon", fmt::format("Daemon arguments: {}", app.arguments().join(" ")));
     auto ret = QCoreApplication::exec();
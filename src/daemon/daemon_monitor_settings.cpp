@@ -17,12 +17,11 @@
 
 #include "daemon_monitor_settings.h"
 
+#include <multipass/file_watcher.h>
 #include <multipass/settings.h>
 #include <multipass/utils.h>
 
 #include <QCoreApplication>
-#include <QFileSystemWatcher>
-#include <QObject>
 
 namespace mp = multipass;
 
@@ -33,9 +32,8 @@ constexpr const int settings_changed_code = 42;
 
 void multipass::monitor_and_quit_on_settings_change() // temporary
 {
-    static const auto filename = mp::Settings::get_daemon_settings_file_path();
+    const auto filename = mp::Settings::get_daemon_settings_file_path();
     mp::utils::check_and_create_config_file(filename); // create if not there
 
-    static QFileSystemWatcher monitor{{filename}};
-    QObject::connect(&monitor, &QFileSystemWatcher::fileChanged, [] { QCoreApplication::exit(settings_changed_code); });
+    mp::FileWatcher::instance().watch(filename, [] { QCoreApplication::exit(settings_changed_code); });
 }
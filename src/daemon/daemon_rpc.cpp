@@ -19,11 +19,14 @@
 #include "daemon_config.h"
 
 #include <multipass/logging/log.h>
+#include <multipass/performance_counters.h>
 #include <multipass/virtual_machine_factory.h>
 #include <multipass/vm_image_host.h>
 
 #include <multipass/format.h>
 
+#include <grpcpp/health_check_service_interface.h>
+
 #include <chrono>
 #include <stdexcept>
 
@@ -33,6 +36,7 @@ namespace mpl = multipass::logging;
 namespace
 {
 constexpr auto category = "rpc";
+constexpr auto rpc_workers_env_var = "MULTIPASS_RPC_WORKERS";
 
 void throw_if_server_exists(const std::string& address)
 {
@@ -56,6 +60,11 @@ auto make_server(const std::string& server_address, mp::RpcConnectionType conn_t
                  mp::Rpc::Service* service)
 {
     throw_if_server_exists(server_address);
+
+    /* Serve the standard grpc.health.v1 service as well, so liveness probes (grpc-health-probe and
+       friends) get answered inside the gRPC library itself — no daemon code runs, no instance state
+       is touched, and a 1s-interval health check adds no observable load */
+    grpc::EnableDefaultHealthCheckService(true);
     grpc::ServerBuilder builder;
 
     std::shared_ptr<grpc::ServerCredentials> creds;
@@ -78,21 +87,55 @@ auto make_server(const std::string& server_address, mp::RpcConnectionType conn_t
     builder.AddListeningPort(server_address, creds);
     builder.RegisterService(service);
 
+    /* By default gRPC sizes its sync-server pollers on its own; allow pinning the worker model down so a burst of
+       slow calls cannot occupy every poller and head-of-line-block cheap ones like ping */
+    bool ok{false};
+    auto workers = qEnvironmentVariableIntValue(rpc_workers_env_var, &ok);
+    if (ok && workers > 0)
+    {
+        builder.SetSyncServerOption(grpc::ServerBuilder::SyncServerOption::NUM_CQS, workers);
+        builder.SetSyncServerOption(grpc::ServerBuilder::SyncServerOption::MIN_POLLERS, 1);
+        builder.SetSyncServerOption(grpc::ServerBuilder::SyncServerOption::MAX_POLLERS, workers);
+    }
+
     std::unique_ptr<grpc::Server> server{builder.BuildAndStart()};
     if (server == nullptr)
         throw std::runtime_error(fmt::format("Failed to start multipass gRPC service at {}", server_address));
 
+    if (auto* health = server->GetHealthCheckService())
+        health->SetServingStatus(true);
+
     return server;
 }
 
 template <typename OperationSignal>
-grpc::Status emit_signal_and_wait_for_result(OperationSignal operation_signal)
+grpc::Status emit_signal_and_wait_for_result(grpc::ServerContext* context, const char* method,
+                                             std::atomic<int>& in_flight, OperationSignal operation_signal)
 {
+    /* Operations queue behind whatever the daemon thread is busy with, so a deadline may well expire
+       before this one would even start; drop it here, while it is still free to retry. Once emitted we
+       are committed to waiting — the promise lives on this stack and the daemon will fulfil it. */
+    const auto queued_behind = in_flight.load(std::memory_order_relaxed);
+    if (context->deadline() <= std::chrono::system_clock::now())
+        return grpc::Status{grpc::StatusCode::DEADLINE_EXCEEDED,
+                            fmt::format("\"{}\" dropped before starting: deadline expired with {} operation(s) in "
+                                        "flight; back off and retry",
+                                        method, queued_behind)};
+
     std::promise<grpc::Status> status_promise;
     auto status_future = status_promise.get_future();
+
+    ++in_flight;
+    auto begin = std::chrono::steady_clock::now();
     emit operation_signal(&status_promise);
+    auto status = status_future.get();
+    --in_flight;
 
-    return status_future.get();
+    mp::perf::PerformanceCounters::instance().record_duration(
+        fmt::format("rpc_{}", method),
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin));
+
+    return status;
 }
 } // namespace
 
@@ -108,6 +151,7 @@ grpc::Status mp::DaemonRpc::create(grpc::ServerContext* context, const CreateReq
                                    grpc::ServerWriter<CreateReply>* reply)
 {
     return emit_signal_and_wait_for_result(
+        context, "create", operations_in_flight,
         std::bind(&DaemonRpc::on_create, this, request, reply, std::placeholders::_1));
 }
 
@@ -115,13 +159,23 @@ grpc::Status mp::DaemonRpc::launch(grpc::ServerContext* context, const LaunchReq
                                    grpc::ServerWriter<LaunchReply>* reply)
 {
     return emit_signal_and_wait_for_result(
+        context, "launch", operations_in_flight,
         std::bind(&DaemonRpc::on_launch, this, request, reply, std::placeholders::_1));
 }
 
+grpc::Status mp::DaemonRpc::clone(grpc::ServerContext* context, const CloneRequest* request,
+                                  grpc::ServerWriter<CloneReply>* response)
+{
+    return emit_signal_and_wait_for_result(
+        context, "clone", operations_in_flight,
+        std::bind(&DaemonRpc::on_clone, this, request, response, std::placeholders::_1));
+}
+
 grpc::Status mp::DaemonRpc::purge(grpc::ServerContext* context, const PurgeRequest* request,
                                   grpc::ServerWriter<PurgeReply>* response)
 {
     return emit_signal_and_wait_for_result(
+        context, "purge", operations_in_flight,
         std::bind(&DaemonRpc::on_purge, this, request, response, std::placeholders::_1));
 }
 
@@ -129,6 +183,7 @@ grpc::Status mp::DaemonRpc::find(grpc::ServerContext* context, const FindRequest
                                  grpc::ServerWriter<FindReply>* response)
 {
     return emit_signal_and_wait_for_result(
+        context, "find", operations_in_flight,
         std::bind(&DaemonRpc::on_find, this, request, response, std::placeholders::_1));
 }
 
@@ -136,6 +191,7 @@ grpc::Status mp::DaemonRpc::info(grpc::ServerContext* context, const InfoRequest
                                  grpc::ServerWriter<InfoReply>* response)
 {
     return emit_signal_and_wait_for_result(
+        context, "info", operations_in_flight,
         std::bind(&DaemonRpc::on_info, this, request, response, std::placeholders::_1));
 }
 
@@ -143,6 +199,7 @@ grpc::Status mp::DaemonRpc::list(grpc::ServerContext* context, const ListRequest
                                  grpc::ServerWriter<ListReply>* response)
 {
     return emit_signal_and_wait_for_result(
+        context, "list", operations_in_flight,
         std::bind(&DaemonRpc::on_list, this, request, response, std::placeholders::_1));
 }
 
@@ -150,6 +207,7 @@ grpc::Status mp::DaemonRpc::mount(grpc::ServerContext* context, const MountReque
                                   grpc::ServerWriter<MountReply>* response)
 {
     return emit_signal_and_wait_for_result(
+        context, "mount", operations_in_flight,
         std::bind(&DaemonRpc::on_mount, this, request, response, std::placeholders::_1));
 }
 
@@ -157,6 +215,7 @@ grpc::Status mp::DaemonRpc::recover(grpc::ServerContext* context, const RecoverR
                                     grpc::ServerWriter<RecoverReply>* response)
 {
     return emit_signal_and_wait_for_result(
+        context, "recover", operations_in_flight,
         std::bind(&DaemonRpc::on_recover, this, request, response, std::placeholders::_1));
 }
 
@@ -164,6 +223,7 @@ grpc::Status mp::DaemonRpc::ssh_info(grpc::ServerContext* context, const SSHInfo
                                      grpc::ServerWriter<SSHInfoReply>* response)
 {
     return emit_signal_and_wait_for_result(
+        context, "ssh_info", operations_in_flight,
         std::bind(&DaemonRpc::on_ssh_info, this, request, response, std::placeholders::_1));
 }
 
@@ -171,6 +231,7 @@ grpc::Status mp::DaemonRpc::start(grpc::ServerContext* context, const StartReque
                                   grpc::ServerWriter<StartReply>* response)
 {
     return emit_signal_and_wait_for_result(
+        context, "start", operations_in_flight,
         std::bind(&DaemonRpc::on_start, this, request, response, std::placeholders::_1));
 }
 
@@ -178,6 +239,7 @@ grpc::Status mp::DaemonRpc::stop(grpc::ServerContext* context, const StopRequest
                                  grpc::ServerWriter<StopReply>* response)
 {
     return emit_signal_and_wait_for_result(
+        context, "stop", operations_in_flight,
         std::bind(&DaemonRpc::on_stop, this, request, response, std::placeholders::_1));
 }
 
@@ -185,6 +247,7 @@ grpc::Status mp::DaemonRpc::suspend(grpc::ServerContext* context, const SuspendR
                                     grpc::ServerWriter<SuspendReply>* response)
 {
     return emit_signal_and_wait_for_result(
+        context, "suspend", operations_in_flight,
         std::bind(&DaemonRpc::on_suspend, this, request, response, std::placeholders::_1));
 }
 
@@ -192,20 +255,55 @@ grpc::Status mp::DaemonRpc::restart(grpc::ServerContext* context, const RestartR
                                     grpc::ServerWriter<RestartReply>* response)
 {
     return emit_signal_and_wait_for_result(
+        context, "restart", operations_in_flight,
         std::bind(&DaemonRpc::on_restart, this, request, response, std::placeholders::_1));
 }
 
+grpc::Status mp::DaemonRpc::snapshot(grpc::ServerContext* context, const SnapshotRequest* request,
+                                     grpc::ServerWriter<SnapshotReply>* response)
+{
+    return emit_signal_and_wait_for_result(
+        context, "snapshot", operations_in_flight,
+        std::bind(&DaemonRpc::on_snapshot, this, request, response, std::placeholders::_1));
+}
+
+grpc::Status mp::DaemonRpc::restore(grpc::ServerContext* context, const RestoreRequest* request,
+                                    grpc::ServerWriter<RestoreReply>* response)
+{
+    return emit_signal_and_wait_for_result(
+        context, "restore", operations_in_flight,
+        std::bind(&DaemonRpc::on_restore, this, request, response, std::placeholders::_1));
+}
+
+grpc::Status mp::DaemonRpc::modify(grpc::ServerContext* context, const ModifyRequest* request,
+                                   grpc::ServerWriter<ModifyReply>* response)
+{
+    return emit_signal_and_wait_for_result(
+        context, "modify", operations_in_flight,
+        std::bind(&DaemonRpc::on_modify, this, request, response, std::placeholders::_1));
+}
+
 grpc::Status mp::DaemonRpc::delet(grpc::ServerContext* context, const DeleteRequest* request,
                                   grpc::ServerWriter<DeleteReply>* response)
 {
     return emit_signal_and_wait_for_result(
+        context, "delete", operations_in_flight,
         std::bind(&DaemonRpc::on_delete, this, request, response, std::placeholders::_1));
 }
 
+grpc::Status mp::DaemonRpc::apply(grpc::ServerContext* context, const ApplyRequest* request,
+                                  grpc::ServerWriter<ApplyReply>* response)
+{
+    return emit_signal_and_wait_for_result(
+        context, "apply", operations_in_flight,
+        std::bind(&DaemonRpc::on_apply, this, request, response, std::placeholders::_1));
+}
+
 grpc::Status mp::DaemonRpc::umount(grpc::ServerContext* context, const UmountRequest* request,
                                    grpc::ServerWriter<UmountReply>* response)
 {
     return emit_signal_and_wait_for_result(
+        context, "umount", operations_in_flight,
         std::bind(&DaemonRpc::on_umount, this, request, response, std::placeholders::_1));
 }
 
@@ -213,10 +311,33 @@ grpc::Status mp::DaemonRpc::version(grpc::ServerContext* context, const VersionR
                                     grpc::ServerWriter<VersionReply>* response)
 {
     return emit_signal_and_wait_for_result(
+        context, "version", operations_in_flight,
         std::bind(&DaemonRpc::on_version, this, request, response, std::placeholders::_1));
 }
 
+grpc::Status mp::DaemonRpc::trace(grpc::ServerContext* context, const TraceRequest* request,
+                                  grpc::ServerWriter<TraceReply>* response)
+{
+    return emit_signal_and_wait_for_result(
+        context, "trace", operations_in_flight,
+        std::bind(&DaemonRpc::on_trace, this, request, response, std::placeholders::_1));
+}
+
+grpc::Status mp::DaemonRpc::get_metrics(grpc::ServerContext* context, const MetricsRequest* request,
+                                        grpc::ServerWriter<MetricsReply>* response)
+{
+    // not routed through the timing helper: scrapes shouldn't show up in the numbers they collect
+    std::promise<grpc::Status> status_promise;
+    auto status_future = status_promise.get_future();
+    emit on_get_metrics(request, response, &status_promise);
+
+    return status_future.get();
+}
+
 grpc::Status mp::DaemonRpc::ping(grpc::ServerContext* context, const PingRequest* request, PingReply* response)
 {
+    // answered right here on the gRPC worker, so it stays cheap even while the daemon thread is busy;
+    // the in-flight count lets callers back off before committing to an operation that would just queue
+    response->set_operations_in_flight(operations_in_flight.load(std::memory_order_relaxed));
     return grpc::Status::OK;
 }
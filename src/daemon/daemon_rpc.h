@@ -28,6 +28,7 @@
 
 #include <QObject>
 
+#include <atomic>
 #include <future>
 #include <memory>
 
@@ -53,6 +54,8 @@ signals:
                    std::promise<grpc::Status>* status_promise);
     void on_launch(const LaunchRequest* request, grpc::ServerWriter<LaunchReply>* reply,
                    std::promise<grpc::Status>* status_promise);
+    void on_clone(const CloneRequest* request, grpc::ServerWriter<CloneReply>* response,
+                  std::promise<grpc::Status>* status_promise);
     void on_purge(const PurgeRequest* request, grpc::ServerWriter<PurgeReply>* response,
                   std::promise<grpc::Status>* status_promise);
     void on_find(const FindRequest* request, grpc::ServerWriter<FindReply>* response,
@@ -75,22 +78,37 @@ signals:
                     std::promise<grpc::Status>* status_promise);
     void on_restart(const RestartRequest* request, grpc::ServerWriter<RestartReply>* response,
                     std::promise<grpc::Status>* status_promise);
+    void on_snapshot(const SnapshotRequest* request, grpc::ServerWriter<SnapshotReply>* response,
+                     std::promise<grpc::Status>* status_promise);
+    void on_restore(const RestoreRequest* request, grpc::ServerWriter<RestoreReply>* response,
+                    std::promise<grpc::Status>* status_promise);
+    void on_modify(const ModifyRequest* request, grpc::ServerWriter<ModifyReply>* response,
+                   std::promise<grpc::Status>* status_promise);
     void on_delete(const DeleteRequest* request, grpc::ServerWriter<DeleteReply>* response,
                    std::promise<grpc::Status>* status_promise);
+    void on_apply(const ApplyRequest* request, grpc::ServerWriter<ApplyReply>* response,
+                  std::promise<grpc::Status>* status_promise);
     void on_umount(const UmountRequest* request, grpc::ServerWriter<UmountReply>* response,
                    std::promise<grpc::Status>* status_promise);
     void on_version(const VersionRequest* request, grpc::ServerWriter<VersionReply>* response,
                     std::promise<grpc::Status>* status_promise);
+    void on_trace(const TraceRequest* request, grpc::ServerWriter<TraceReply>* response,
+                  std::promise<grpc::Status>* status_promise);
+    void on_get_metrics(const MetricsRequest* request, grpc::ServerWriter<MetricsReply>* response,
+                        std::promise<grpc::Status>* status_promise);
 
 private:
     const std::string server_address;
     const std::unique_ptr<grpc::Server> server;
+    std::atomic<int> operations_in_flight{0}; // operations queued on or running in the daemon thread
 
 protected:
     grpc::Status create(grpc::ServerContext* context, const CreateRequest* request,
                         grpc::ServerWriter<CreateReply>* reply) override;
     grpc::Status launch(grpc::ServerContext* context, const LaunchRequest* request,
                         grpc::ServerWriter<LaunchReply>* reply) override;
+    grpc::Status clone(grpc::ServerContext* context, const CloneRequest* request,
+                       grpc::ServerWriter<CloneReply>* response) override;
     grpc::Status purge(grpc::ServerContext* context, const PurgeRequest* request,
                        grpc::ServerWriter<PurgeReply>* response) override;
     grpc::Status find(grpc::ServerContext* context, const FindRequest* request,
@@ -113,12 +131,24 @@ protected:
                          grpc::ServerWriter<SuspendReply>* response) override;
     grpc::Status restart(grpc::ServerContext* context, const RestartRequest* request,
                          grpc::ServerWriter<RestartReply>* response) override;
+    grpc::Status snapshot(grpc::ServerContext* context, const SnapshotRequest* request,
+                          grpc::ServerWriter<SnapshotReply>* response) override;
+    grpc::Status restore(grpc::ServerContext* context, const RestoreRequest* request,
+                         grpc::ServerWriter<RestoreReply>* response) override;
+    grpc::Status modify(grpc::ServerContext* context, const ModifyRequest* request,
+                        grpc::ServerWriter<ModifyReply>* response) override;
     grpc::Status delet(grpc::ServerContext* context, const DeleteRequest* request,
                        grpc::ServerWriter<DeleteReply>* response) override;
+    grpc::Status apply(grpc::ServerContext* context, const ApplyRequest* request,
+                       grpc::ServerWriter<ApplyReply>* response) override;
     grpc::Status umount(grpc::ServerContext* context, const UmountRequest* request,
                         grpc::ServerWriter<UmountReply>* response) override;
     grpc::Status version(grpc::ServerContext* context, const VersionRequest* request,
                          grpc::ServerWriter<VersionReply>* response) override;
+    grpc::Status trace(grpc::ServerContext* context, const TraceRequest* request,
+                       grpc::ServerWriter<TraceReply>* response) override;
+    grpc::Status get_metrics(grpc::ServerContext* context, const MetricsRequest* request,
+                             grpc::ServerWriter<MetricsReply>* response) override;
     grpc::Status ping(grpc::ServerContext* context, const PingRequest* request, PingReply* response) override;
 };
 } // namespace multipass
@@ -25,6 +25,8 @@
 #include <multipass/platform.h>
 #include <multipass/query.h>
 #include <multipass/rpc/multipass.grpc.pb.h>
+#include <multipass/sha256.h>
+#include <multipass/tracing/trace_recorder.h>
 #include <multipass/url_downloader.h>
 #include <multipass/utils.h>
 #include <multipass/vm_image.h>
@@ -32,13 +34,13 @@
 
 #include <multipass/format.h>
 
-#include <QCryptographicHash>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QUrl>
 #include <QtConcurrent/QtConcurrent>
 
+#include <algorithm>
 #include <exception>
 
 namespace mp = multipass;
@@ -49,6 +51,7 @@ namespace
 constexpr auto category = "image vault";
 constexpr auto instance_db_name = "multipassd-instance-image-records.json";
 constexpr auto image_db_name = "multipassd-image-records.json";
+constexpr auto trash_dir_name = ".trash"; // removed instances are staged here pending background reclamation
 
 auto filename_for(const QString& path)
 {
@@ -107,7 +110,7 @@ std::unordered_map<std::string, mp::VaultRecord> load_db(const QString& db_name)
         return {};
 
     QJsonParseError parse_error;
-    auto doc = QJsonDocument::fromJson(db_file.readAll(), &parse_error);
+    auto doc = mp::utils::load_json_document(db_file, &parse_error);
     if (doc.isNull())
         return {};
 
@@ -189,16 +192,59 @@ QString copy(const QString& file_name, const QDir& output_dir)
     QFileInfo info{file_name};
     const auto source_name = info.fileName();
     auto new_path = output_dir.filePath(source_name);
-    QFile::copy(file_name, new_path);
+    if (!mp::platform::copy_file_sparse(file_name, new_path)) // QFile::copy would expand every hole in the image
+        QFile::copy(file_name, new_path);
     return new_path;
 }
 
+QString link_or_copy(const QString& file_name, const QDir& output_dir)
+{
+    if (file_name.isEmpty())
+        return {};
+
+    if (!QFileInfo::exists(file_name))
+        throw std::runtime_error(fmt::format("{} missing", file_name));
+
+    /* Kernels and initrds are immutable once prepared, so every instance can share the vault's inode; the
+       link also keeps the bits alive should the cached image get pruned. Linking across filesystems (or on
+       filesystems without hard links) fails, in which case we fall back to a copy */
+    const auto new_path = output_dir.filePath(QFileInfo{file_name}.fileName());
+    if (mp::platform::link(file_name.toStdString().c_str(), new_path.toStdString().c_str()))
+        return new_path;
+
+    return copy(file_name, output_dir);
+}
+
 void delete_file(const QString& path)
 {
     QFile file{path};
     file.remove();
 }
 
+bool is_qcow2_image(const QString& image_path)
+{
+    QFile image_file{image_path};
+    if (!image_file.open(QIODevice::ReadOnly))
+        return false;
+
+    return image_file.read(4) == QByteArrayLiteral("QFI\xfb");
+}
+
+QString layer_onto_base(const QString& base_path, const QDir& output_dir)
+{
+    // Lay a qcow2 copy-on-write image over the shared base instead of duplicating it — writes land in the
+    // overlay while untouched clusters keep being served from the base, so creation is metadata-only
+    const auto overlay_path = output_dir.filePath(filename_for(base_path));
+    if (mp::utils::process_log_on_error("qemu-img",
+                                        QStringList{"create", "-q", "-f", "qcow2", "-b", base_path, overlay_path},
+                                        "Cannot create copy-on-write layer, falling back to a full copy: {}", category,
+                                        mpl::Level::warning))
+        return overlay_path;
+
+    delete_file(overlay_path); // qemu-img may leave a partial file behind
+    return {};
+}
+
 void remove_source_images(const mp::VMImage& source_image, const mp::VMImage& prepared_image)
 {
     // The prepare phase may have been a no-op, check and only remove source images
@@ -210,21 +256,31 @@ void remove_source_images(const mp::VMImage& source_image, const mp::VMImage& pr
         delete_file(source_image.initrd_path);
 }
 
-void verify_image_download(const mp::Path& image_path, const std::string& image_hash)
+void verify_image_download(const mp::Path& image_path, const std::string& image_hash,
+                           const std::string& streamed_hash)
 {
+    // The downloader hashes the stream as it lands on disk; only re-read the image when that is unavailable
+    if (!streamed_hash.empty())
+    {
+        if (streamed_hash != image_hash)
+            throw std::runtime_error("Downloaded image hash does not match");
+
+        return;
+    }
+
     QFile image_file(image_path);
     if (!image_file.open(QFile::ReadOnly))
     {
         throw std::runtime_error("Cannot open image file for computing hash");
     }
 
-    QCryptographicHash hash(QCryptographicHash::Sha256);
-    if (!hash.addData(&image_file))
+    mp::Sha256 hash;
+    if (!hash.add_data(&image_file))
     {
         throw std::runtime_error("Cannot read image file to compute hash");
     }
 
-    if (hash.result().toHex().toStdString() != image_hash)
+    if (hash.result().toStdString() != image_hash)
     {
         throw std::runtime_error("Downloaded image hash does not match");
     }
@@ -262,6 +318,52 @@ private:
 };
 } // namespace
 
+mp::FetchObservers::FetchObservers(const ProgressMonitor& monitor) : monitors{monitor}
+{
+}
+
+void mp::FetchObservers::add(const ProgressMonitor& monitor)
+{
+    std::lock_guard<decltype(mutex)> lock{mutex};
+    monitors.push_back(monitor);
+}
+
+bool mp::FetchObservers::notify(const int download_type, const int progress)
+{
+    /* Called per network chunk, from the download thread. Fanning out to the attached reply streams
+       means a lock and gRPC writes, so that only happens when the percentage changes and a sampling
+       interval has passed — in between, the thread gets the cached verdict and goes straight back to
+       the socket. The endpoints (<= 0 and 100) always go through, so no client misses the extremes */
+    constexpr auto sampling_interval = std::chrono::milliseconds{100};
+
+    if (progress > 0 && progress < 100)
+    {
+        if (progress == last_progress.load(std::memory_order_relaxed))
+            return carry_on.load(std::memory_order_relaxed);
+
+        const auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+        auto prev = last_flush.load(std::memory_order_relaxed);
+        if (now - prev < std::chrono::steady_clock::duration{sampling_interval}.count() ||
+            !last_flush.compare_exchange_strong(prev, now)) // another thread took this sample
+            return carry_on.load(std::memory_order_relaxed);
+    }
+
+    return flush(download_type, progress);
+}
+
+bool mp::FetchObservers::flush(const int download_type, const int progress)
+{
+    // The transfer carries on for as long as at least one of the attached requests still wants it
+    std::lock_guard<decltype(mutex)> lock{mutex};
+    auto result = false;
+    for (const auto& monitor : monitors)
+        result = monitor(download_type, progress) || result;
+
+    last_progress.store(progress, std::memory_order_relaxed);
+    carry_on.store(result, std::memory_order_relaxed);
+    return result;
+}
+
 mp::DefaultVMImageVault::DefaultVMImageVault(std::vector<VMImageHost*> image_hosts, URLDownloader* downloader,
                                              mp::Path cache_dir_path, mp::Path data_dir_path, mp::days days_to_expire)
     : image_hosts{image_hosts},
@@ -281,16 +383,25 @@ mp::DefaultVMImageVault::DefaultVMImageVault(std::vector<VMImageHost*> image_hos
             remote_image_host_map[remote] = image_host;
         }
     }
+
+    // Sweep any staged removals left over from a previous run
+    QDir staging_dir{instances_dir.filePath(trash_dir_name)};
+    if (staging_dir.exists())
+        reclamation_synchronizer.addFuture(
+            QtConcurrent::run([path = staging_dir.absolutePath()] { QDir{path}.removeRecursively(); }));
 }
 
 mp::DefaultVMImageVault::~DefaultVMImageVault()
 {
     url_downloader->abort_all_downloads();
+    reclamation_synchronizer.waitForFinished();
 }
 
 mp::VMImage mp::DefaultVMImageVault::fetch_image(const FetchType& fetch_type, const Query& query,
                                                  const PrepareAction& prepare, const ProgressMonitor& monitor)
 {
+    MP_TRACE_SPAN("DefaultVMImageVault::fetch_image");
+
     {
         std::lock_guard<decltype(fetch_mutex)> lock{fetch_mutex};
         auto name_entry = instance_image_records.find(query.name);
@@ -321,7 +432,8 @@ mp::VMImage mp::DefaultVMImageVault::fetch_image(const FetchType& fetch_type, co
         }
         else
         {
-            source_image = image_instance_from(query.name, source_image);
+            // Local files are not owned by the vault, so they cannot serve as a backing layer
+            source_image = image_instance_from(query.name, source_image, true);
         }
 
         if (fetch_type == FetchType::ImageKernelAndInitrd)
@@ -354,7 +466,7 @@ mp::VMImage mp::DefaultVMImageVault::fetch_image(const FetchType& fetch_type, co
             QUrl image_url(QString::fromStdString(query.release));
 
             // Generate a sha256 hash based on the URL and use that for the id
-            id = QCryptographicHash::hash(query.release.c_str(), QCryptographicHash::Sha256).toHex().toStdString();
+            id = mp::Sha256::hash(query.release.c_str()).toStdString();
             auto last_modified = url_downloader->last_modified(image_url);
 
             std::lock_guard<decltype(fetch_mutex)> lock{fetch_mutex};
@@ -373,6 +485,7 @@ mp::VMImage mp::DefaultVMImageVault::fetch_image(const FetchType& fetch_type, co
             if (running_future)
             {
                 monitor(LaunchProgress::WAITING, -1);
+                fetch_observers[id]->add(monitor);
                 future = *running_future;
             }
             else
@@ -400,12 +513,7 @@ mp::VMImage mp::DefaultVMImageVault::fetch_image(const FetchType& fetch_type, co
                         .arg(last_modified.toString("yyyyMMdd"));
                 const auto image_dir = mp::utils::make_dir(images_dir, image_dir_name);
 
-                // Had to use std::bind here to workaround the 5 allowable function arguments constraint of
-                // QtConcurrent::run()
-                future = QtConcurrent::run(std::bind(&DefaultVMImageVault::download_and_prepare_source_image, this,
-                                                     info, source_image, image_dir, fetch_type, prepare, monitor));
-
-                in_progress_image_fetches[id] = future;
+                future = launch_image_fetch(id, info, source_image, image_dir, fetch_type, prepare, monitor);
             }
         }
         else
@@ -456,6 +564,7 @@ mp::VMImage mp::DefaultVMImageVault::fetch_image(const FetchType& fetch_type, co
             if (running_future)
             {
                 monitor(LaunchProgress::WAITING, -1);
+                fetch_observers[id]->add(monitor);
                 future = *running_future;
             }
             else
@@ -463,12 +572,7 @@ mp::VMImage mp::DefaultVMImageVault::fetch_image(const FetchType& fetch_type, co
                 const auto image_dir =
                     mp::utils::make_dir(images_dir, QString("%1-%2").arg(info.release).arg(info.version));
 
-                // Had to use std::bind here to workaround the 5 allowable function arguments constraint of
-                // QtConcurrent::run()
-                future = QtConcurrent::run(std::bind(&DefaultVMImageVault::download_and_prepare_source_image, this,
-                                                     info, source_image, image_dir, fetch_type, prepare, monitor));
-
-                in_progress_image_fetches[id] = future;
+                future = launch_image_fetch(id, info, source_image, image_dir, fetch_type, prepare, monitor);
             }
         }
 
@@ -477,6 +581,7 @@ mp::VMImage mp::DefaultVMImageVault::fetch_image(const FetchType& fetch_type, co
             auto prepared_image = future.result();
             std::lock_guard<decltype(fetch_mutex)> lock{fetch_mutex};
             in_progress_image_fetches.erase(id);
+            fetch_observers.erase(id);
             return finalize_image_records(query, prepared_image, id);
         }
         catch (const AbortedDownloadException&)
@@ -487,6 +592,7 @@ mp::VMImage mp::DefaultVMImageVault::fetch_image(const FetchType& fetch_type, co
         {
             std::lock_guard<decltype(fetch_mutex)> lock{fetch_mutex};
             in_progress_image_fetches.erase(id);
+            fetch_observers.erase(id);
             throw;
         }
     }
@@ -494,16 +600,35 @@ mp::VMImage mp::DefaultVMImageVault::fetch_image(const FetchType& fetch_type, co
 
 void mp::DefaultVMImageVault::remove(const std::string& name)
 {
-    const auto& name_entry = instance_image_records.find(name);
-    if (name_entry == instance_image_records.end())
-        return;
+    {
+        std::lock_guard<decltype(fetch_mutex)> lock{fetch_mutex};
+        const auto& name_entry = instance_image_records.find(name);
+        if (name_entry == instance_image_records.end())
+            return;
+
+        instance_image_records.erase(name);
+        persist_instance_records();
+    }
 
+    /* Stage the instance directory away with a cheap rename, then reclaim the disk in the background — recursive
+       removal of a large image would otherwise block the caller for the duration */
     QDir instance_dir{instances_dir};
-    if (instance_dir.cd(QString::fromStdString(name)))
+    if (!instance_dir.exists(QString::fromStdString(name)))
+        return;
+
+    QDir staging_dir{instances_dir.filePath(trash_dir_name)};
+    staging_dir.mkpath(".");
+
+    const auto staged_name = QString("%1-%2").arg(QString::fromStdString(name), mp::utils::make_uuid());
+    if (!instance_dir.rename(QString::fromStdString(name), staging_dir.filePath(staged_name)))
+    { // fall back on removing in place
+        instance_dir.cd(QString::fromStdString(name));
         instance_dir.removeRecursively();
+        return;
+    }
 
-    instance_image_records.erase(name);
-    persist_instance_records();
+    reclamation_synchronizer.addFuture(QtConcurrent::run(
+        [path = staging_dir.filePath(staged_name)] { QDir{path}.removeRecursively(); }));
 }
 
 bool mp::DefaultVMImageVault::has_record_for(const std::string& name)
@@ -511,6 +636,16 @@ bool mp::DefaultVMImageVault::has_record_for(const std::string& name)
     return instance_image_records.find(name) != instance_image_records.end();
 }
 
+bool mp::DefaultVMImageVault::has_instance_layered_on(const std::string& id) const
+{
+    // Instance images may be copy-on-write layers over the prepared image, so the latter needs to be
+    // retained for as long as any instance may be reading from it
+    return std::any_of(instance_image_records.cbegin(), instance_image_records.cend(),
+                       [&id](const std::pair<const std::string, VaultRecord>& record) {
+                           return record.second.image.id == id;
+                       });
+}
+
 void mp::DefaultVMImageVault::prune_expired_images()
 {
     std::vector<decltype(prepared_image_records)::key_type> expired_keys;
@@ -518,8 +653,10 @@ void mp::DefaultVMImageVault::prune_expired_images()
 
     for (const auto& record : prepared_image_records)
     {
-        // Expire source images if they aren't persistent and haven't been accessed in 14 days
+        // Expire source images if they aren't persistent, haven't been accessed in 14 days and no instance
+        // image may still be layered on them
         if (record.second.query.query_type == Query::Type::Alias && !record.second.query.persistent &&
+            !has_instance_layered_on(record.first) &&
             record.second.last_accessed + days_to_expire <= std::chrono::system_clock::now())
         {
             mpl::log(
@@ -548,12 +685,58 @@ void mp::DefaultVMImageVault::prune_expired_images()
     for (const auto& key : expired_keys)
         prepared_image_records.erase(key);
 
+    /* With a size budget set, the TTL pass above is followed by evicting least-recently-used images until
+       the vault fits. The same pinning rules apply: persistent images, explicit (non-alias) fetches and
+       anything an instance may still be layered on stay put, whatever the budget says */
+    if (size_budget > 0)
+    {
+        struct Candidate
+        {
+            std::string key;
+            qint64 size;
+            std::chrono::system_clock::time_point last_accessed;
+        };
+
+        std::vector<Candidate> candidates;
+        qint64 total{0};
+        for (const auto& record : prepared_image_records)
+        {
+            const auto size = QFileInfo{record.second.image.image_path}.size();
+            total += size;
+            if (record.second.query.query_type == Query::Type::Alias && !record.second.query.persistent &&
+                !has_instance_layered_on(record.first))
+                candidates.push_back({record.first, size, record.second.last_accessed});
+        }
+
+        std::sort(candidates.begin(), candidates.end(),
+                  [](const Candidate& a, const Candidate& b) { return a.last_accessed < b.last_accessed; });
+
+        for (auto candidate = candidates.cbegin(); total > size_budget && candidate != candidates.cend(); ++candidate)
+        {
+            const auto& record = prepared_image_records.at(candidate->key);
+            mpl::log(mpl::Level::info, category,
+                     fmt::format("Vault is over its size budget. Evicting image {}.", record.query.release));
+            delete_image_dir(record.image.image_path);
+            prepared_image_records.erase(candidate->key);
+            total -= candidate->size;
+        }
+    }
+
     persist_image_records();
 }
 
+void mp::DefaultVMImageVault::set_size_budget(qint64 bytes)
+{
+    size_budget = bytes;
+}
+
 void mp::DefaultVMImageVault::update_images(const FetchType& fetch_type, const PrepareAction& prepare,
                                             const ProgressMonitor& monitor)
 {
+    /* Updates re-download the image whole. Delta transfer (zsync/casync style) was considered and dropped:
+       simplestreams publishes only whole-file sha256 sums and the image servers expose no block index to
+       diff the cached revision against, so there are no "changed ranges" to request. Revisit if the
+       stream ever grows one. */
     mpl::log(mpl::Level::debug, category, "Checking for images to update…");
 
     std::vector<decltype(prepared_image_records)::key_type> keys_to_update;
@@ -567,6 +750,13 @@ void mp::DefaultVMImageVault::update_images(const FetchType& fetch_type, const P
                 auto info = info_for(record.second.query);
                 if (info.id.toStdString() != record.first)
                 {
+                    if (has_instance_layered_on(record.first))
+                    { // the old revision has to stay around until the instances backed by it are gone
+                        mpl::log(mpl::Level::debug, category,
+                                 fmt::format("Source image {} is still backing instances. Deferring its update.",
+                                             record.second.query.release));
+                        continue;
+                    }
                     keys_to_update.push_back(record.first);
                 }
             }
@@ -577,24 +767,109 @@ void mp::DefaultVMImageVault::update_images(const FetchType& fetch_type, const P
         }
     }
 
+    /* Each image fetches through its own pipeline on the vault's bounded pool, so the sweep takes about
+       as long as the slowest transfer instead of the sum of all. Launch first, then collect: the futures
+       come from launch_image_fetch, the same machinery fetch_image uses, so a launch arriving mid-update
+       simply attaches to the transfer already in flight. Verification adds nothing to the sweep — the
+       downloader hashes each stream as it lands on disk. */
+    struct UpdateFetch
+    {
+        std::string old_key;
+        Query query;
+        Path old_image_path;
+        std::string new_id;
+        QFuture<VMImage> future;
+    };
+    std::vector<UpdateFetch> fetches;
+
     for (const auto& key : keys_to_update)
     {
         const auto& record = prepared_image_records[key];
         mpl::log(mpl::Level::info, category, fmt::format("Updating {} source image to latest", record.query.release));
         try
         {
-            fetch_image(fetch_type, record.query, prepare, monitor);
+            const auto info = info_for(record.query);
+            const auto id = info.id.toStdString();
+            optional<VMImage> source_image{nullopt};
 
-            // Remove old image
             std::lock_guard<decltype(fetch_mutex)> lock{fetch_mutex};
-            delete_image_dir(record.image.image_path);
-            prepared_image_records.erase(key);
+            QFuture<VMImage> future;
+            if (auto running_future = get_image_future(id))
+            {
+                future = *running_future;
+            }
+            else
+            {
+                const auto image_dir =
+                    mp::utils::make_dir(images_dir, QString("%1-%2").arg(info.release).arg(info.version));
+                future = launch_image_fetch(id, info, source_image, image_dir, fetch_type, prepare, monitor);
+            }
+            fetches.push_back({key, record.query, record.image.image_path, id, future});
+        }
+        catch (const std::exception& e)
+        {
+            mpl::log(mpl::Level::warning, category,
+                     fmt::format("Cannot update source image {}: {}", record.query.release, e.what()));
+        }
+    }
+
+    for (auto& fetch : fetches)
+    {
+        try
+        {
+            auto prepared_image = fetch.future.result();
+            std::lock_guard<decltype(fetch_mutex)> lock{fetch_mutex};
+            in_progress_image_fetches.erase(fetch.new_id);
+            fetch_observers.erase(fetch.new_id);
+
+            Query prepared_query{fetch.query};
+            prepared_query.name = "";
+            prepared_image_records[fetch.new_id] = {prepared_image, prepared_query, std::chrono::system_clock::now()};
+
+            // Remove old image
+            delete_image_dir(fetch.old_image_path);
+            prepared_image_records.erase(fetch.old_key);
             persist_image_records();
         }
         catch (const CreateImageException& e)
         {
+            std::lock_guard<decltype(fetch_mutex)> lock{fetch_mutex};
+            in_progress_image_fetches.erase(fetch.new_id);
+            fetch_observers.erase(fetch.new_id);
             mpl::log(mpl::Level::warning, category,
-                     fmt::format("Cannot update source image {}: {}", record.query.release, e.what()));
+                     fmt::format("Cannot update source image {}: {}", fetch.query.release, e.what()));
+        }
+    }
+}
+
+void mp::DefaultVMImageVault::prefetch_images(const std::vector<Query>& tracked_queries, const FetchType& fetch_type,
+                                              const PrepareAction& prepare, const ProgressMonitor& monitor)
+{
+    for (const auto& query : tracked_queries)
+    {
+        try
+        {
+            const auto info = info_for(query);
+
+            {
+                std::lock_guard<decltype(fetch_mutex)> lock{fetch_mutex};
+                auto entry = prepared_image_records.find(info.id.toStdString());
+                if (entry != prepared_image_records.end())
+                {
+                    // Tracked images are kept warm — bump the access time, so they don't expire between launches
+                    entry->second.last_accessed = std::chrono::system_clock::now();
+                    persist_image_records();
+                    continue;
+                }
+            }
+
+            mpl::log(mpl::Level::info, category, fmt::format("Pre-fetching image for \"{}\"", query.release));
+            fetch_image(fetch_type, query, prepare, monitor);
+        }
+        catch (const std::exception& e)
+        {
+            mpl::log(mpl::Level::warning, category,
+                     fmt::format("Cannot pre-fetch image for \"{}\": {}", query.release, e.what()));
         }
     }
 }
@@ -624,27 +899,47 @@ mp::VMImage mp::DefaultVMImageVault::download_and_prepare_source_image(
         }
     }
 
+    QString decoded_image_path;
+    if (source_image.image_path.endsWith(".xz"))
+    {
+        decoded_image_path = source_image.image_path;
+        decoded_image_path.remove(".xz");
+    }
+
     DeleteOnException image_file{source_image.image_path};
+    DeleteOnException decoded_image_file{decoded_image_path.isEmpty() ? source_image.image_path : decoded_image_path};
 
     try
     {
-        url_downloader->download_to(info.image_location, source_image.image_path, info.size, LaunchProgress::IMAGE,
-                                    monitor);
+        if (!decoded_image_path.isEmpty())
+        { // decode while the bits arrive, so the decompressed image lands on disk in the same pass as the download
+            XzStreamDecoder decoder{decoded_image_path};
+            url_downloader->download_to(info.image_location, source_image.image_path, info.size, LaunchProgress::IMAGE,
+                                        monitor, &decoder);
+            decoder.finish();
+        }
+        else
+        {
+            url_downloader->download_to(info.image_location, source_image.image_path, info.size, LaunchProgress::IMAGE,
+                                        monitor);
+        }
 
         if (info.verify)
         {
             monitor(LaunchProgress::VERIFY, -1);
-            verify_image_download(source_image.image_path, id);
+            verify_image_download(source_image.image_path, id,
+                                  url_downloader->sha256_checksum(source_image.image_path));
         }
 
-        if (fetch_type == FetchType::ImageKernelAndInitrd)
+        if (!decoded_image_path.isEmpty())
         {
-            source_image = fetch_kernel_and_initrd(info, source_image, image_dir, monitor);
+            delete_file(source_image.image_path);
+            source_image.image_path = decoded_image_path;
         }
 
-        if (source_image.image_path.endsWith(".xz"))
+        if (fetch_type == FetchType::ImageKernelAndInitrd)
         {
-            source_image = extract_downloaded_image(source_image, monitor);
+            source_image = fetch_kernel_and_initrd(info, source_image, image_dir, monitor);
         }
 
         auto prepared_image = prepare(source_image);
@@ -662,6 +957,71 @@ mp::VMImage mp::DefaultVMImageVault::download_and_prepare_source_image(
     }
 }
 
+mp::VMImage mp::DefaultVMImageVault::clone_image(const std::string& source_name, const std::string& destination_name)
+{
+    std::lock_guard<decltype(fetch_mutex)> lock{fetch_mutex};
+
+    const auto source_entry = instance_image_records.find(source_name);
+    if (source_entry == instance_image_records.end())
+        throw std::runtime_error(fmt::format("No image found for \"{}\"", source_name));
+
+    if (instance_image_records.find(destination_name) != instance_image_records.end())
+        throw std::runtime_error(fmt::format("An image for \"{}\" already exists", destination_name));
+
+    const auto& source_image = source_entry->second.image;
+    const QDir output_dir{mp::utils::make_dir(instances_dir, QString::fromStdString(destination_name))};
+
+    /* The source disk cannot serve as a qcow2 backing layer: backing files have to stay immutable and the source
+       instance keeps writing to its disk. A qcow2 image only holds allocated clusters though, so a plain copy of it is
+       still cheap relative to provisioning from scratch. */
+    VMImage image{source_image};
+    image.image_path = copy(source_image.image_path, output_dir);
+    image.kernel_path = link_or_copy(source_image.kernel_path, output_dir);
+    image.initrd_path = link_or_copy(source_image.initrd_path, output_dir);
+
+    auto query = source_entry->second.query;
+    query.name = destination_name;
+
+    instance_image_records[destination_name] = {image, query, std::chrono::system_clock::now()};
+    persist_instance_records();
+
+    return image;
+}
+
+mp::VMImage mp::DefaultVMImageVault::rename_image(const std::string& source_name, const std::string& destination_name)
+{
+    std::lock_guard<decltype(fetch_mutex)> lock{fetch_mutex};
+
+    const auto source_entry = instance_image_records.find(source_name);
+    if (source_entry == instance_image_records.end())
+        throw std::runtime_error(fmt::format("No image found for \"{}\"", source_name));
+
+    if (instance_image_records.find(destination_name) != instance_image_records.end())
+        throw std::runtime_error(fmt::format("An image for \"{}\" already exists", destination_name));
+
+    QDir instance_dir{instances_dir};
+    if (!instance_dir.rename(QString::fromStdString(source_name), QString::fromStdString(destination_name)))
+        throw std::runtime_error(
+            fmt::format("Failed to move the image for \"{}\" over to \"{}\"", source_name, destination_name));
+
+    const QDir output_dir{instances_dir.filePath(QString::fromStdString(destination_name))};
+    const auto rebase = [&output_dir](const Path& path) -> Path {
+        return path.isEmpty() ? path : output_dir.filePath(QFileInfo{path}.fileName());
+    };
+
+    auto record = source_entry->second;
+    record.image.image_path = rebase(record.image.image_path);
+    record.image.kernel_path = rebase(record.image.kernel_path);
+    record.image.initrd_path = rebase(record.image.initrd_path);
+    record.query.name = destination_name;
+
+    instance_image_records.erase(source_entry);
+    instance_image_records[destination_name] = record;
+    persist_instance_records();
+
+    return record.image;
+}
+
 mp::VMImage mp::DefaultVMImageVault::extract_image_from(const std::string& instance_name, const VMImage& source_image,
                                                         const ProgressMonitor& monitor)
 {
@@ -680,29 +1040,21 @@ mp::VMImage mp::DefaultVMImageVault::extract_image_from(const std::string& insta
     return image;
 }
 
-mp::VMImage mp::DefaultVMImageVault::extract_downloaded_image(const VMImage& source_image,
-                                                              const ProgressMonitor& monitor)
-{
-    VMImage image{source_image};
-    XzImageDecoder xz_decoder(image.image_path);
-    auto image_path = image.image_path.remove(".xz");
-
-    xz_decoder.decode_to(image_path, monitor);
-    delete_file(source_image.image_path);
-    image.image_path = image_path;
-
-    return image;
-}
-
 mp::VMImage mp::DefaultVMImageVault::image_instance_from(const std::string& instance_name,
-                                                         const VMImage& prepared_image)
+                                                         const VMImage& prepared_image, const bool full_copy)
 {
     auto name = QString::fromStdString(instance_name);
     auto output_dir = mp::utils::make_dir(instances_dir, name);
 
-    return {copy(prepared_image.image_path, output_dir),
-            copy(prepared_image.kernel_path, output_dir),
-            copy(prepared_image.initrd_path, output_dir),
+    QString image_path;
+    if (!full_copy && is_qcow2_image(prepared_image.image_path))
+        image_path = layer_onto_base(prepared_image.image_path, output_dir);
+    if (image_path.isEmpty())
+        image_path = copy(prepared_image.image_path, output_dir);
+
+    return {image_path,
+            link_or_copy(prepared_image.kernel_path, output_dir),
+            link_or_copy(prepared_image.initrd_path, output_dir),
             prepared_image.id,
             prepared_image.stream_location,
             prepared_image.original_release,
@@ -726,6 +1078,30 @@ mp::VMImage mp::DefaultVMImageVault::fetch_kernel_and_initrd(const VMImageInfo&
     return image;
 }
 
+QFuture<mp::VMImage> mp::DefaultVMImageVault::launch_image_fetch(const std::string& id, const VMImageInfo& info,
+                                                                 optional<VMImage>& source_image, const QDir& image_dir,
+                                                                 const FetchType& fetch_type,
+                                                                 const PrepareAction& prepare,
+                                                                 const ProgressMonitor& monitor)
+{
+    auto observers = std::make_shared<FetchObservers>(monitor);
+    ProgressMonitor broadcast_monitor = [observers](int download_type, int progress) {
+        return observers->notify(download_type, progress);
+    };
+
+    /* Run the fetch on the vault's own pool, so that distinct images transfer in parallel without queuing
+       behind unrelated work on the global pool. Had to use std::bind here to workaround the 5 allowable
+       function arguments constraint of QtConcurrent::run() */
+    auto future = QtConcurrent::run(&image_fetch_pool,
+                                    std::bind(&DefaultVMImageVault::download_and_prepare_source_image, this, info,
+                                              source_image, image_dir, fetch_type, prepare, broadcast_monitor));
+
+    in_progress_image_fetches[id] = future;
+    fetch_observers[id] = observers;
+
+    return future;
+}
+
 mp::optional<QFuture<mp::VMImage>> mp::DefaultVMImageVault::get_image_future(const std::string& id)
 {
     auto it = in_progress_image_fetches.find(id);
@@ -744,7 +1120,7 @@ mp::VMImage mp::DefaultVMImageVault::finalize_image_records(const Query& query,
 
     if (!query.name.empty())
     {
-        vm_image = image_instance_from(query.name, prepared_image);
+        vm_image = image_instance_from(query.name, prepared_image, query.full_copy);
         instance_image_records[query.name] = {vm_image, query, std::chrono::system_clock::now()};
     }
 
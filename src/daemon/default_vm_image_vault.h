@@ -28,10 +28,16 @@
 
 #include <QDir>
 #include <QFuture>
+#include <QFutureSynchronizer>
+#include <QThreadPool>
 
+#include <atomic>
+#include <chrono>
+#include <limits>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
+#include <vector>
 
 namespace multipass
 {
@@ -44,6 +50,23 @@ public:
     multipass::Query query;
     std::chrono::system_clock::time_point last_accessed;
 };
+class FetchObservers
+// fans download progress out to every request attached to an in-flight image fetch
+{
+public:
+    explicit FetchObservers(const ProgressMonitor& monitor);
+    void add(const ProgressMonitor& monitor);
+    bool notify(int download_type, int progress);
+
+private:
+    bool flush(int download_type, int progress);
+
+    std::mutex mutex; // guards monitors; the chunk-rate path in notify() stays on the atomics below
+    std::vector<ProgressMonitor> monitors;
+    std::atomic<int> last_progress{std::numeric_limits<int>::min()};
+    std::atomic<std::chrono::steady_clock::duration::rep> last_flush{0};
+    std::atomic<bool> carry_on{true};
+};
 class DefaultVMImageVault final : public VMImageVault
 {
 public:
@@ -53,23 +76,32 @@ public:
 
     VMImage fetch_image(const FetchType& fetch_type, const Query& query, const PrepareAction& prepare,
                         const ProgressMonitor& monitor) override;
+    VMImage clone_image(const std::string& source_name, const std::string& destination_name) override;
+    VMImage rename_image(const std::string& source_name, const std::string& destination_name) override;
     void remove(const std::string& name) override;
     bool has_record_for(const std::string& name) override;
     void prune_expired_images() override;
+    void set_size_budget(qint64 bytes) override;
     void update_images(const FetchType& fetch_type, const PrepareAction& prepare,
                        const ProgressMonitor& monitor) override;
+    void prefetch_images(const std::vector<Query>& tracked_queries, const FetchType& fetch_type,
+                         const PrepareAction& prepare, const ProgressMonitor& monitor) override;
 
 private:
-    VMImage image_instance_from(const std::string& name, const VMImage& prepared_image);
+    VMImage image_instance_from(const std::string& name, const VMImage& prepared_image, bool full_copy);
+    bool has_instance_layered_on(const std::string& id) const;
     VMImage download_and_prepare_source_image(const VMImageInfo& info, optional<VMImage>& existing_source_image,
                                               const QDir& image_dir, const FetchType& fetch_type,
                                               const PrepareAction& prepare, const ProgressMonitor& monitor);
     VMImage extract_image_from(const std::string& instance_name, const VMImage& source_image,
                                const ProgressMonitor& monitor);
-    VMImage extract_downloaded_image(const VMImage& source_image, const ProgressMonitor& monitor);
     VMImage fetch_kernel_and_initrd(const VMImageInfo& info, const VMImage& source_image, const QDir& image_dir,
                                     const ProgressMonitor& monitor);
     optional<QFuture<VMImage>> get_image_future(const std::string& id);
+    QFuture<VMImage> launch_image_fetch(const std::string& id, const VMImageInfo& info,
+                                        optional<VMImage>& source_image, const QDir& image_dir,
+                                        const FetchType& fetch_type, const PrepareAction& prepare,
+                                        const ProgressMonitor& monitor);
     VMImage finalize_image_records(const Query& query, const VMImage& prepared_image, const std::string& id);
     VMImageInfo info_for(const Query& query);
     VMImageInfo get_kernel_query_info(const std::string& name);
@@ -83,12 +115,16 @@ private:
     const QDir instances_dir;
     const QDir images_dir;
     const days days_to_expire;
+    qint64 size_budget{0}; // bytes; 0 means unbounded
     std::mutex fetch_mutex;
 
     std::unordered_map<std::string, VaultRecord> prepared_image_records;
     std::unordered_map<std::string, VaultRecord> instance_image_records;
     std::unordered_map<std::string, VMImageHost*> remote_image_host_map;
+    QFutureSynchronizer<void> reclamation_synchronizer;
+    QThreadPool image_fetch_pool;
     std::unordered_map<std::string, QFuture<VMImage>> in_progress_image_fetches;
+    std::unordered_map<std::string, std::shared_ptr<FetchObservers>> fetch_observers;
 };
 }
 #endif // MULTIPASS_DEFAULT_VM_IMAGE_VAULT_H
@@ -19,16 +19,131 @@
 
 #include "json_writer.h"
 
-#include <QFile>
-#include <QJsonDocument>
+#include <QJsonArray>
+#include <QJsonValue>
+#include <QSaveFile>
+
+#include <unistd.h>
 
 namespace mp = multipass;
 
+namespace
+{
+/* Streams the tree straight into a byte buffer, compact — the persist paths call this on every instance
+   change, and building a pretty-printed QJsonDocument first costs a full intermediate DOM and a second
+   copy of the text for databases that can run to megabytes */
+
+void append_value(const QJsonValue& value, QByteArray& out);
+
+void append_string(const QString& str, QByteArray& out)
+{
+    out += '"';
+    for (const char byte : str.toUtf8())
+    {
+        if (byte == '"' || byte == '\\')
+        {
+            out += '\\';
+            out += byte;
+        }
+        else if (static_cast<unsigned char>(byte) < 0x20)
+        { // control characters may not appear raw; multi-byte UTF-8 is untouched, its bytes are all >= 0x80
+            switch (byte)
+            {
+            case '\b':
+                out += "\\b";
+                break;
+            case '\f':
+                out += "\\f";
+                break;
+            case '\n':
+                out += "\\n";
+                break;
+            case '\r':
+                out += "\\r";
+                break;
+            case '\t':
+                out += "\\t";
+                break;
+            default:
+                out += "\\u00";
+                out += QByteArray::number(byte, 16).rightJustified(2, '0');
+            }
+        }
+        else
+        {
+            out += byte;
+        }
+    }
+    out += '"';
+}
+
+void append_object(const QJsonObject& object, QByteArray& out)
+{
+    out += '{';
+    for (auto it = object.constBegin(); it != object.constEnd(); ++it)
+    {
+        if (it != object.constBegin())
+            out += ',';
+        append_string(it.key(), out);
+        out += ':';
+        append_value(it.value(), out);
+    }
+    out += '}';
+}
+
+void append_array(const QJsonArray& array, QByteArray& out)
+{
+    out += '[';
+    for (auto it = array.constBegin(); it != array.constEnd(); ++it)
+    {
+        if (it != array.constBegin())
+            out += ',';
+        append_value(*it, out);
+    }
+    out += ']';
+}
+
+void append_value(const QJsonValue& value, QByteArray& out)
+{
+    switch (value.type())
+    {
+    case QJsonValue::Bool:
+        out += value.toBool() ? "true" : "false";
+        break;
+    case QJsonValue::Double:
+    {
+        const auto number = value.toDouble();
+        if (number == static_cast<qint64>(number))
+            out += QByteArray::number(static_cast<qint64>(number));
+        else
+            out += QByteArray::number(number, 'g', 17); // enough digits to round-trip any double
+        break;
+    }
+    case QJsonValue::String:
+        append_string(value.toString(), out);
+        break;
+    case QJsonValue::Array:
+        append_array(value.toArray(), out);
+        break;
+    case QJsonValue::Object:
+        append_object(value.toObject(), out);
+        break;
+    default:
+        out += "null";
+    }
+}
+} // namespace
+
 void mp::write_json(const QJsonObject& root, QString file_name)
 {
-    QJsonDocument doc{root};
-    auto raw_json = doc.toJson();
-    QFile db_file{file_name};
-    db_file.open(QIODevice::ReadWrite | QIODevice::Truncate);
+    QByteArray raw_json;
+    raw_json.reserve(4096); // most records fit a page; larger databases double up from here, amortized
+    append_object(root, raw_json);
+
+    QSaveFile db_file{file_name}; // fills a sibling temp file, then renames it over the target, atomically —
+    db_file.open(QIODevice::WriteOnly); // a crash mid-write can no longer truncate the database
     db_file.write(raw_json);
+    db_file.flush();
+    ::fsync(db_file.handle()); // the data has to be durable before the rename may supersede the old file
+    db_file.commit();
 }
@@ -17,8 +17,10 @@
 
 #include "ubuntu_image_host.h"
 
+#include <multipass/logging/log.h>
 #include <multipass/query.h>
 #include <multipass/simple_streams_index.h>
+#include <multipass/standard_paths.h>
 #include <multipass/url_downloader.h>
 
 #include <multipass/exceptions/download_exception.h>
@@ -27,24 +29,101 @@
 
 #include <multipass/format.h>
 
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QUrl>
 
 #include <algorithm>
-#include <unordered_set>
+#include <future>
 
 namespace mp = multipass;
+namespace mpl = multipass::logging;
 
 namespace
 {
+constexpr auto category = "image host";
 constexpr auto index_path = "streams/v1/index.json";
+constexpr auto index_updated_key = "index_updated";
+
+QString manifest_cache_file_for(const QString& host_url)
+{
+    const auto cache_location = mp::StandardPaths::instance().writableLocation(mp::StandardPaths::CacheLocation);
+    if (cache_location.isEmpty())
+        return {};
+
+    const auto key = QCryptographicHash::hash(host_url.toUtf8(), QCryptographicHash::Sha256).toHex();
+    return QDir{cache_location}.filePath(QStringLiteral("simplestreams-cache/%1.qbjs").arg(QString{key}));
+}
+
+std::unique_ptr<mp::SimpleStreamsManifest> manifest_from_cache(const QString& cache_file, const QString& index_updated,
+                                                               const QString& host_url)
+{
+    if (cache_file.isEmpty() || index_updated.isEmpty())
+        return nullptr;
+
+    QFile file{cache_file};
+    if (!file.open(QIODevice::ReadOnly))
+        return nullptr;
+
+    const auto mapped = file.map(0, file.size());
+    if (mapped == nullptr)
+        return nullptr;
+
+    const auto doc = QJsonDocument::fromRawData(reinterpret_cast<const char*>(mapped), file.size(),
+                                                QJsonDocument::Validate);
+    if (doc.isNull() || !doc.isObject() || doc.object()[index_updated_key].toString() != index_updated)
+        return nullptr;
+
+    try
+    {
+        return mp::SimpleStreamsManifest::fromJson(doc, host_url);
+    }
+    catch (const std::exception&)
+    {
+        return nullptr; // corrupt or outdated cache entry; fall through to a fresh download
+    }
+}
+
+void cache_manifest(const QString& cache_file, QJsonDocument doc, const QString& index_updated)
+{
+    if (cache_file.isEmpty() || index_updated.isEmpty())
+        return;
+
+    auto object = doc.object();
+    object.insert(index_updated_key, index_updated); // validity key, checked against the index on the next load
+    doc.setObject(object);
+
+    QDir{}.mkpath(QFileInfo{cache_file}.path());
+    QFile file{cache_file};
+    if (file.open(QIODevice::WriteOnly)) // best effort; a failed write just means a re-parse on the next start
+        file.write(doc.toBinaryData());
+}
 
 auto download_manifest(const QString& host_url, mp::URLDownloader* url_downloader)
 {
     auto json_index = url_downloader->download({host_url + index_path});
     auto index = mp::SimpleStreamsIndex::fromJson(json_index);
 
+    // The binary cache spares the expensive text parse of the (much larger) manifest whenever the index
+    // reports no change, notably on every daemon restart
+    const auto cache_file = manifest_cache_file_for(host_url);
+    if (auto manifest = manifest_from_cache(cache_file, index.updated_at, host_url))
+        return manifest;
+
     auto json_manifest = url_downloader->download({host_url + index.manifest_path});
-    return mp::SimpleStreamsManifest::fromJson(json_manifest, host_url);
+
+    QJsonParseError parse_error;
+    const auto doc = QJsonDocument::fromJson(json_manifest, &parse_error);
+    if (doc.isNull())
+        throw mp::GenericManifestException(parse_error.errorString().toStdString());
+
+    auto manifest = mp::SimpleStreamsManifest::fromJson(doc, host_url);
+    cache_manifest(cache_file, doc, index.updated_at);
+    return manifest;
 }
 
 mp::VMImageInfo with_location_fully_resolved(const QString& host_url, const mp::VMImageInfo& info)
@@ -71,6 +150,23 @@ auto key_from(const std::string& search_string)
         key = "default";
     return key;
 }
+
+auto images_with_hash_prefix(const mp::SimpleStreamsManifest& manifest, const QString& key)
+{
+    // ids are indexed in sorted order, so all the entries sharing a prefix sit in a contiguous range
+    std::vector<const mp::VMImageInfo*> matches;
+    auto it = std::lower_bound(manifest.products_by_id.cbegin(), manifest.products_by_id.cend(), key,
+                               [](const auto& entry, const QString& k) { return entry.first < k; });
+    for (; it != manifest.products_by_id.cend(); ++it)
+    {
+        if (!it->first.startsWith(key))
+            break;
+
+        matches.push_back(it->second);
+    }
+
+    return matches;
+}
 } // namespace
 
 mp::UbuntuVMImageHost::UbuntuVMImageHost(std::vector<std::pair<std::string, std::string>> remotes,
@@ -92,20 +188,12 @@ mp::optional<mp::VMImageInfo> mp::UbuntuVMImageHost::info_for(const Query& query
 
     if (!info)
     {
-        int num_matches = 0;
-
-        auto predicate = [&](const VMImageInfo& entry) {
-            auto partial_match = false;
-            if (entry.id.startsWith(key))
-            {
-                info = &entry;
-                partial_match = true;
-            }
-            return partial_match;
-        };
-        num_matches += std::count_if(manifest->products.begin(), manifest->products.end(), predicate);
-        if (num_matches > 1)
+        const auto matches = images_with_hash_prefix(*manifest, key);
+        if (matches.size() > 1)
             throw std::runtime_error(fmt::format("Too many images matching \"{}\"", query.release));
+
+        if (!matches.empty())
+            info = matches.front();
     }
 
     if (info)
@@ -141,16 +229,12 @@ std::vector<mp::VMImageInfo> mp::UbuntuVMImageHost::all_info_for(const Query& qu
     }
     else
     {
-        std::unordered_set<std::string> found_hashes;
-
-        for (const auto& entry : manifest->products)
+        for (const auto* entry : images_with_hash_prefix(*manifest, key))
         {
-            if (entry.id.startsWith(key) && (entry.supported || query.allow_unsupported) &&
-                found_hashes.find(entry.id.toStdString()) == found_hashes.end())
+            if (entry->supported || query.allow_unsupported)
             {
                 images.push_back(
-                    with_location_fully_resolved(QString::fromStdString(remote_url_from(remote_name)), entry));
-                found_hashes.insert(entry.id.toStdString());
+                    with_location_fully_resolved(QString::fromStdString(remote_url_from(remote_name)), *entry));
             }
         }
     }
@@ -165,12 +249,9 @@ mp::VMImageInfo mp::UbuntuVMImageHost::info_for_full_hash_impl(const std::string
 {
     for (const auto& manifest : manifests)
     {
-        for (const auto& product : manifest.second->products)
+        if (auto record = manifest.second->find_product(QString::fromStdString(full_hash)))
         {
-            if (product.id.toStdString() == full_hash)
-            {
-                return with_location_fully_resolved(QString::fromStdString(remote_url_from(manifest.first)), product);
-            }
+            return with_location_fully_resolved(QString::fromStdString(remote_url_from(manifest.first)), *record);
         }
     }
 
@@ -223,16 +304,42 @@ std::vector<std::string> mp::UbuntuVMImageHost::supported_remotes()
 
 void mp::UbuntuVMImageHost::fetch_manifests()
 {
+    /* Fetch all remotes concurrently — each download runs its own network manager and event loop — so the
+       refresh window stays one round-trip wide instead of growing with every configured remote */
+    using ManifestAndUrl = std::pair<std::unique_ptr<SimpleStreamsManifest>, std::string>;
+    std::vector<std::pair<std::string, std::future<ManifestAndUrl>>> fetches;
     for (const auto& remote : remotes)
+        fetches.emplace_back(
+            remote.first, std::async(std::launch::async, [this, name = remote.first, url = remote.second] {
+                try
+                {
+                    return ManifestAndUrl{download_manifest(QString::fromStdString(url), url_downloader), url};
+                }
+                catch (const mp::DownloadException& e)
+                {
+                    auto fallback = fallback_urls.find(name);
+                    if (fallback == fallback_urls.end())
+                        throw;
+
+                    mpl::log(mpl::Level::warning, category,
+                             fmt::format("Could not reach \"{}\" for the {} remote ({}); falling back to \"{}\"", url,
+                                         name, e.what(), fallback->second));
+                    return ManifestAndUrl{download_manifest(QString::fromStdString(fallback->second), url_downloader),
+                                          fallback->second};
+                }
+            }));
+
+    for (auto& fetch : fetches)
     {
         try
         {
-            manifests.emplace_back(
-                std::make_pair(remote.first, download_manifest(QString::fromStdString(remote.second), url_downloader)));
+            auto [manifest, url] = fetch.second.get();
+            active_urls[fetch.first] = url;
+            manifests.emplace_back(std::make_pair(fetch.first, std::move(manifest)));
         }
         catch (mp::EmptyManifestException& /* e */)
         {
-            on_manifest_empty(fmt::format("Did not find any supported products in \"{}\"", remote.first));
+            on_manifest_empty(fmt::format("Did not find any supported products in \"{}\"", fetch.first));
         }
         catch (mp::GenericManifestException& e)
         {
@@ -250,6 +357,15 @@ void mp::UbuntuVMImageHost::clear()
     manifests.clear();
 }
 
+auto mp::UbuntuVMImageHost::catalog_version_impl() const -> std::string
+{
+    fmt::memory_buffer version;
+    for (const auto& manifest : manifests)
+        fmt::format_to(version, "{}@{};", manifest.first, manifest.second->updated_at);
+
+    return fmt::to_string(version);
+}
+
 mp::SimpleStreamsManifest* mp::UbuntuVMImageHost::manifest_from(const std::string& remote)
 {
     update_manifests();
@@ -268,15 +384,18 @@ mp::SimpleStreamsManifest* mp::UbuntuVMImageHost::manifest_from(const std::strin
 void mp::UbuntuVMImageHost::match_alias(const QString& key, const VMImageInfo** info,
                                         const mp::SimpleStreamsManifest& manifest)
 {
-    auto it = manifest.image_records.find(key);
-    if (it != manifest.image_records.end())
+    if (auto record = manifest.find_image_record(key))
     {
-        *info = it.value();
+        *info = record;
     }
 }
 
 std::string mp::UbuntuVMImageHost::remote_url_from(const std::string& remote_name)
 {
+    auto active = active_urls.find(remote_name);
+    if (active != active_urls.end()) // image locations must resolve against wherever the manifest came from
+        return active->second;
+
     std::string url;
 
     auto it = std::find_if(
@@ -288,3 +407,8 @@ std::string mp::UbuntuVMImageHost::remote_url_from(const std::string& remote_nam
 
     return url;
 }
+
+void mp::UbuntuVMImageHost::set_fallback_url(const std::string& remote_name, const std::string& url)
+{
+    fallback_urls[remote_name] = url;
+}
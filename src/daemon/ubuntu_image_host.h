@@ -24,6 +24,7 @@
 #include <QString>
 
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace multipass
@@ -44,11 +45,15 @@ public:
     std::vector<VMImageInfo> all_images_for(const std::string& remote_name, const bool allow_unsupported) override;
     std::vector<std::string> supported_remotes() override;
 
+    // registers a URL to fall back to when a remote's (e.g. mirrored) primary is unreachable
+    void set_fallback_url(const std::string& remote_name, const std::string& url);
+
 protected:
     void for_each_entry_do_impl(const Action& action) override;
     VMImageInfo info_for_full_hash_impl(const std::string& full_hash) override;
     void fetch_manifests() override;
     void clear() override;
+    std::string catalog_version_impl() const override;
 
 private:
     SimpleStreamsManifest* manifest_from(const std::string& remote);
@@ -56,6 +61,8 @@ private:
     std::vector<std::pair<std::string, std::unique_ptr<SimpleStreamsManifest>>> manifests;
     URLDownloader* const url_downloader;
     std::vector<std::pair<std::string, std::string>> remotes;
+    std::unordered_map<std::string, std::string> fallback_urls;
+    std::unordered_map<std::string, std::string> active_urls; // which URL each remote's manifest actually came from
     std::string remote_url_from(const std::string& remote_name);
     QString index_path;
 };
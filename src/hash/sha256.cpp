@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2020 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <multipass/sha256.h>
+
+#include <openssl/sha.h>
+
+#include <QIODevice>
+
+namespace mp = multipass;
+
+struct mp::Sha256::Context
+{
+    SHA256_CTX ctx;
+};
+
+mp::Sha256::Sha256() : context{std::make_unique<Context>()}
+{
+    SHA256_Init(&context->ctx);
+}
+
+mp::Sha256::~Sha256() = default;
+
+void mp::Sha256::add_data(const QByteArray& data)
+{
+    SHA256_Update(&context->ctx, data.constData(), data.size());
+}
+
+bool mp::Sha256::add_data(QIODevice* device)
+{
+    char buffer[65536];
+
+    while (true)
+    {
+        auto bytes_read = device->read(buffer, sizeof(buffer));
+        if (bytes_read < 0)
+            return false;
+        if (bytes_read == 0)
+            return true;
+
+        SHA256_Update(&context->ctx, buffer, bytes_read);
+    }
+}
+
+QByteArray mp::Sha256::result()
+{
+    unsigned char digest[SHA256_DIGEST_LENGTH];
+    SHA256_Final(digest, &context->ctx);
+    SHA256_Init(&context->ctx);
+
+    return QByteArray{reinterpret_cast<const char*>(digest), SHA256_DIGEST_LENGTH}.toHex();
+}
+
+void mp::Sha256::reset()
+{
+    SHA256_Init(&context->ctx);
+}
+
+QByteArray mp::Sha256::hash(const QByteArray& data)
+{
+    Sha256 sha256;
+    sha256.add_data(data);
+    return sha256.result();
+}
@@ -18,9 +18,11 @@
  */
 
 #include <multipass/cloud_init_iso.h>
+#include <multipass/tracing/trace_recorder.h>
 
 #include <QFile>
 
+#include <algorithm>
 #include <array>
 #include <cctype>
 
@@ -97,9 +99,10 @@ void set_at(T& t, SizeType offset, const V& value)
 }
 
 template <typename T>
-void write(const T& t, QFile& f)
+void write(const T& t, std::vector<uint8_t>& image, size_t& pos)
 {
-    f.write(reinterpret_cast<const char*>(t.data.data()), t.data.size());
+    std::copy(std::begin(t.data), std::end(t.data), image.begin() + pos);
+    pos += t.data.size();
 }
 
 template <size_t size>
@@ -365,18 +368,24 @@ Size num_blocks(Size num_bytes)
     return ((num_bytes + logical_block_size - 1) / logical_block_size);
 }
 
-void seek_to_next_block(QFile& f)
+/* Every entry gets at least this many blocks, so typical config edits can be patched into the reserved
+   extent without shifting the sections behind it (see update_file_in) */
+constexpr auto min_extent_blocks = 8u;
+
+uint32_t allocated_blocks(const std::string& data)
+{
+    return std::max(min_extent_blocks, num_blocks(static_cast<uint32_t>(data.size())));
+}
+
+uint32_t read_lsb(const QByteArray& bytes, int offset)
 {
-    const auto next_block_pos = num_blocks(f.pos()) * logical_block_size;
-    f.seek(next_block_pos);
+    return static_cast<uchar>(bytes[offset]) | static_cast<uchar>(bytes[offset + 1]) << 8u |
+           static_cast<uchar>(bytes[offset + 2]) << 16u | static_cast<uchar>(bytes[offset + 3]) << 24u;
 }
 
-void pad_to_end(QFile& f)
+void seek_to_next_block(size_t& pos)
 {
-    seek_to_next_block(f);
-    f.seek(f.pos() - 1);
-    char end = 0;
-    f.write(&end, 1);
+    pos = num_blocks(pos) * logical_block_size;
 }
 } // namespace
 
@@ -387,13 +396,14 @@ void mp::CloudInitIso::add_file(const std::string& name, const std::string& data
 
 void mp::CloudInitIso::write_to(const Path& path)
 {
+    MP_TRACE_SPAN("CloudInitIso::write_to");
+
     QFile f{path};
     if (!f.open(QIODevice::WriteOnly))
         throw std::runtime_error{"failed to open file for writing during cloud-init generation"};
 
     const uint32_t num_reserved_bytes = 32768u;
     const uint32_t num_reserved_blocks = num_blocks(num_reserved_bytes);
-    f.seek(num_reserved_bytes);
 
     PrimaryVolumeDescriptor prim_desc;
     JolietVolumeDescriptor joliet_desc;
@@ -406,7 +416,7 @@ void mp::CloudInitIso::write_to(const Path& path)
         num_reserved_blocks + num_blocks_for_descriptors + num_blocks_for_path_table + num_blocks_for_dir_records;
     for (const auto& entry : files)
     {
-        volume_size += num_blocks(entry.data.size());
+        volume_size += allocated_blocks(entry.data);
     }
 
     prim_desc.set_volume_size(volume_size);
@@ -440,38 +450,108 @@ void mp::CloudInitIso::write_to(const Path& path)
     {
         iso_file_records.emplace_back(entry.name, current_block_index, entry.data.size());
         joliet_file_records.emplace_back(entry.name, current_block_index, entry.data.size());
-        current_block_index += num_blocks(entry.data.size());
+        current_block_index += allocated_blocks(entry.data);
     }
 
-    write(prim_desc, f);
-    write(joliet_desc, f);
-    write(VolumeDescriptorSetTerminator(), f);
+    // The whole image is assembled in memory and written out in one go, rather
+    // than drip-feeding the file a few bytes at a time; the zero-initialized
+    // buffer also provides the inter-block and end padding for free
+    std::vector<uint8_t> image(volume_size * logical_block_size, 0u);
+    size_t pos = num_reserved_bytes;
+
+    write(prim_desc, image, pos);
+    write(joliet_desc, image, pos);
+    write(VolumeDescriptorSetTerminator(), image, pos);
 
-    write(root_path, f);
-    seek_to_next_block(f);
-    write(joliet_root_path, f);
-    seek_to_next_block(f);
+    write(root_path, image, pos);
+    seek_to_next_block(pos);
+    write(joliet_root_path, image, pos);
+    seek_to_next_block(pos);
 
-    write(root_record, f);
-    write(root_parent_record, f);
+    write(root_record, image, pos);
+    write(root_parent_record, image, pos);
     for (const auto& iso_record : iso_file_records)
     {
-        write(iso_record, f);
+        write(iso_record, image, pos);
     }
-    seek_to_next_block(f);
+    seek_to_next_block(pos);
 
-    write(joliet_root_record, f);
-    write(joliet_root_parent_record, f);
+    write(joliet_root_record, image, pos);
+    write(joliet_root_parent_record, image, pos);
     for (const auto& joliet_record : joliet_file_records)
     {
-        write(joliet_record, f);
+        write(joliet_record, image, pos);
     }
-    seek_to_next_block(f);
+    seek_to_next_block(pos);
 
     for (const auto& entry : files)
     {
-        f.write(entry.data.data(), entry.data.size());
-        seek_to_next_block(f);
+        std::copy(entry.data.begin(), entry.data.end(), image.begin() + pos);
+        pos += allocated_blocks(entry.data) * logical_block_size; // on to the next reserved extent
     }
-    pad_to_end(f);
+
+    f.write(reinterpret_cast<const char*>(image.data()), image.size());
+}
+
+bool mp::CloudInitIso::update_file_in(const Path& path, const std::string& name, const std::string& data)
+{
+    MP_TRACE_SPAN("CloudInitIso::update_file_in");
+
+    QFile f{path};
+    if (!f.open(QIODevice::ReadWrite))
+        throw std::runtime_error{"failed to open file for patching during cloud-init update"};
+
+    // the blocks ahead of the file extents have fixed sizes, so the directory records are where write_to put them
+    const uint32_t num_reserved_blocks = num_blocks(32768u);
+    const uint32_t num_blocks_for_descriptors = 3u;
+    const uint32_t num_blocks_for_path_table = 2u;
+    const auto iso_dir_block = num_reserved_blocks + num_blocks_for_descriptors + num_blocks_for_path_table;
+    const auto joliet_dir_block = iso_dir_block + 1u;
+
+    f.seek(static_cast<qint64>(iso_dir_block) * logical_block_size);
+    const auto iso_dir = f.read(logical_block_size);
+    f.seek(static_cast<qint64>(joliet_dir_block) * logical_block_size);
+    const auto joliet_dir = f.read(logical_block_size);
+
+    const auto find_record = [](const QByteArray& dir, const std::string& record_name) -> std::pair<int, uint32_t> {
+        for (int pos = 2 * 34; pos < dir.size() && dir[pos] != 0; pos += static_cast<uchar>(dir[pos]))
+        { // the two root records lead the block, then the file records follow back to back
+            const auto id_len = static_cast<uchar>(dir[pos + 32]);
+            if (dir.mid(pos + 33, id_len).toStdString() == record_name)
+                return {pos, read_lsb(dir, pos + 2)};
+        }
+        return {-1, 0};
+    };
+
+    const auto [iso_pos, extent_location] = find_record(iso_dir, make_iso_name(name));
+    const auto [joliet_pos, joliet_location] = find_record(joliet_dir, make_u16_name(name));
+    if (iso_pos < 0 || joliet_pos < 0 || extent_location != joliet_location)
+        return false;
+
+    // the extent runs up to the next one, or to the end of the volume when it is the last
+    f.seek(static_cast<qint64>(num_reserved_blocks) * logical_block_size + 80);
+    auto extent_end = read_lsb(f.read(4), 0);
+    for (int pos = 2 * 34; pos < iso_dir.size() && iso_dir[pos] != 0; pos += static_cast<uchar>(iso_dir[pos]))
+    {
+        const auto location = read_lsb(iso_dir, pos + 2);
+        if (location > extent_location && location < extent_end)
+            extent_end = location;
+    }
+
+    if (num_blocks(static_cast<uint32_t>(data.size())) > extent_end - extent_location)
+        return false; // the new contents outgrew the reserved extent
+
+    const auto size_field = to_lsb_msb(static_cast<uint32_t>(data.size()));
+    f.seek(static_cast<qint64>(iso_dir_block) * logical_block_size + iso_pos + 10);
+    f.write(reinterpret_cast<const char*>(size_field.data()), size_field.size());
+    f.seek(static_cast<qint64>(joliet_dir_block) * logical_block_size + joliet_pos + 10);
+    f.write(reinterpret_cast<const char*>(size_field.data()), size_field.size());
+
+    // rewrite the whole extent, so no stale tail survives past the new contents
+    std::string extent(static_cast<size_t>(extent_end - extent_location) * logical_block_size, '\0');
+    extent.replace(0, data.size(), data);
+    f.seek(static_cast<qint64>(extent_location) * logical_block_size);
+    f.write(extent.data(), extent.size());
+
+    return true;
 }
@@ -23,15 +23,16 @@
 #include <QString>
 #include <QtGlobal>
 
-#include <shared_mutex>
+#include <algorithm>
+#include <atomic>
 #include <stdexcept>
 
 namespace mpl = multipass::logging;
 
 namespace
 {
-std::shared_timed_mutex mutex;
 std::shared_ptr<multipass::logging::Logger> global_logger;
+std::shared_ptr<const std::map<std::string, mpl::Level>> level_overrides; // null while no overrides are set
 
 mpl::Level to_level(QtMsgType type)
 {
@@ -59,16 +60,45 @@ void qt_message_handler(QtMsgType type, const QMessageLogContext&, const QString
 
 void mpl::log(Level level, CString category, CString message)
 {
-    std::shared_lock<decltype(mutex)> lock{mutex};
-    if (global_logger)
-        global_logger->log(level, category, message);
+    if (auto overrides = std::atomic_load_explicit(&level_overrides, std::memory_order_acquire))
+    {
+        auto it = overrides->find(category.c_str());
+        if (it == overrides->end())
+            it = overrides->find("");
+        if (it != overrides->end() && level > it->second)
+            return;
+    }
+
+    /* A plain pointer snapshot instead of a reader-writer lock: log gets called from every thread in the daemon and
+       the shared-lock handshake was a point of contention under debug verbosity */
+    auto logger = std::atomic_load_explicit(&global_logger, std::memory_order_acquire);
+    if (logger)
+        logger->log(level, category, message);
     else
         fmt::print(stderr, "[{}] [{}] {}\n", as_string(level).c_str(), category.c_str(), message.c_str());
 }
 
+mpl::Level mpl::get_logging_level()
+{
+    auto logger = std::atomic_load_explicit(&global_logger, std::memory_order_acquire);
+    auto level = logger ? logger->get_logging_level() : Level::trace;
+
+    if (auto overrides = std::atomic_load_explicit(&level_overrides, std::memory_order_acquire))
+        for (const auto& entry : *overrides) // a raised category must make it past callers' formatting gates
+            level = std::max(level, entry.second);
+
+    return level;
+}
+
+void mpl::set_level_overrides(const std::map<std::string, Level>& overrides)
+{
+    std::atomic_store(&level_overrides, overrides.empty()
+                                            ? decltype(level_overrides){}
+                                            : std::make_shared<const std::map<std::string, Level>>(overrides));
+}
+
 void mpl::set_logger(std::shared_ptr<Logger> logger)
 {
-    std::lock_guard<decltype(mutex)> lock{mutex};
-    global_logger = std::move(logger);
+    std::atomic_store(&global_logger, std::move(logger));
     qInstallMessageHandler(qt_message_handler);
 }
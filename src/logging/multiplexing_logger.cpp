@@ -22,26 +22,52 @@
 namespace mpl = multipass::logging;
 
 multipass::logging::MultiplexingLogger::MultiplexingLogger(UPtr system_logger)
-    : system_logger{std::move(system_logger)}
+    : system_logger{std::move(system_logger)}, level_ceiling{this->system_logger->get_logging_level()}
 {
 }
 
 void mpl::MultiplexingLogger::log(mpl::Level level, CString category, CString message) const
 {
+    // No sink wants this level, so don't even take the lock
+    if (level > level_ceiling.load(std::memory_order_relaxed))
+        return;
+
     std::shared_lock<decltype(mutex)> lock{mutex};
     system_logger->log(level, category, message);
     for (auto logger : loggers)
         logger->log(level, category, message);
 }
 
+mpl::Level mpl::MultiplexingLogger::get_logging_level() const
+{
+    return level_ceiling.load(std::memory_order_relaxed);
+}
+
+void mpl::MultiplexingLogger::set_logging_level(mpl::Level level)
+{
+    std::lock_guard<decltype(mutex)> lock{mutex};
+    system_logger->set_logging_level(level);
+    level_ceiling.store(compute_level_ceiling());
+}
+
 void mpl::MultiplexingLogger::add_logger(const Logger* logger)
 {
     std::lock_guard<decltype(mutex)> lock{mutex};
     loggers.push_back(logger);
+    level_ceiling.store(compute_level_ceiling());
 }
 
 void mpl::MultiplexingLogger::remove_logger(const Logger* logger)
 {
     std::lock_guard<decltype(mutex)> lock{mutex};
     loggers.erase(std::remove(loggers.begin(), loggers.end(), logger), loggers.end());
+    level_ceiling.store(compute_level_ceiling());
+}
+
+mpl::Level mpl::MultiplexingLogger::compute_level_ceiling() const
+{
+    auto ceiling = system_logger->get_logging_level();
+    for (auto logger : loggers)
+        ceiling = std::max(ceiling, logger->get_logging_level());
+    return ceiling;
 }
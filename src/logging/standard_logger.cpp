@@ -28,9 +28,19 @@ mpl::StandardLogger::StandardLogger(mpl::Level level) : logging_level{level}
 {
 }
 
+mpl::Level mpl::StandardLogger::get_logging_level() const
+{
+    return logging_level.load(std::memory_order_relaxed);
+}
+
+void mpl::StandardLogger::set_logging_level(mpl::Level level)
+{
+    logging_level.store(level, std::memory_order_relaxed);
+}
+
 void mpl::StandardLogger::log(mpl::Level level, CString category, CString message) const
 {
-    if (level <= logging_level)
+    if (level <= logging_level.load(std::memory_order_relaxed))
     {
         fmt::print(stderr, "[{}] [{}] [{}] {}\n", mp::utils::timestamp(), as_string(level).c_str(), category.c_str(),
                    message.c_str());
@@ -38,6 +38,7 @@ namespace
 {
 constexpr auto category = "metrics";
 constexpr auto saved_metrics_file = "saved_metrics.json";
+constexpr auto max_saved_batches = 128; // bounds memory and disk while the endpoint is unreachable
 
 void post_request(const QUrl& metrics_url, const QByteArray& body)
 {
@@ -80,6 +81,9 @@ auto load_saved_metrics(const mp::Path& data_path)
     metrics_file.open(QIODevice::ReadOnly);
     auto metrics = QJsonDocument::fromJson(metrics_file.readAll()).array();
 
+    while (metrics.size() > max_saved_batches) // a file saved by an older, unbounded build may exceed the cap
+        metrics.removeFirst();
+
     return metrics;
 }
 
@@ -112,10 +116,11 @@ mp::MetricsProvider::MetricsProvider(const QUrl& url, const QString& unique_id,
               if (!metrics_available && !metrics_failed)
                   continue;
 
-              auto saved_metrics(metric_batches);
-              auto body = QJsonDocument(metric_batches).toJson(QJsonDocument::Compact);
+              auto saved_metrics(metric_batches); // shallow copy; the serialization below runs unlocked
               lock.unlock();
 
+              auto body = QJsonDocument(saved_metrics).toJson(QJsonDocument::Compact);
+
               try
               {
                   post_request(metrics_url, body);
@@ -145,7 +150,10 @@ mp::MetricsProvider::MetricsProvider(const QUrl& url, const QString& unique_id,
                       timeout = std::chrono::seconds::zero();
                   }
 
-                  persist_metrics(QJsonDocument(metric_batches).toJson(QJsonDocument::Compact), data_path);
+                  auto remaining(metric_batches);
+                  lock.unlock(); // the rewrite of the saved file need not block new metrics coming in
+                  persist_metrics(QJsonDocument(remaining).toJson(QJsonDocument::Compact), data_path);
+                  lock.lock();
               }
               catch (const std::exception& e)
               {
@@ -220,11 +228,18 @@ void mp::MetricsProvider::send_denied()
 
 void mp::MetricsProvider::update_and_notify_sender(const QJsonObject& metric)
 {
+    QJsonArray snapshot;
     {
         std::lock_guard<std::mutex> lck(metrics_mutex);
         metric_batches.push_back(metric);
-        persist_metrics(QJsonDocument(metric_batches).toJson(QJsonDocument::Compact), data_path);
+        while (metric_batches.size() > max_saved_batches)
+            metric_batches.removeFirst(); // oldest batches give way; telemetry is not worth unbounded growth
+
         metrics_available = true;
+        snapshot = metric_batches;
     }
     metrics_cv.notify_one();
+
+    // the JSON serialization and file rewrite happen off the lock, so callers on RPC threads never wait on disk
+    persist_metrics(QJsonDocument(snapshot).toJson(QJsonDocument::Compact), data_path);
 }
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2020 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <multipass/performance_counters.h>
+
+#include <multipass/format.h>
+
+namespace mp = multipass;
+
+namespace
+{
+std::size_t bucket_for(std::chrono::microseconds elapsed)
+{
+    auto msecs = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+
+    std::size_t bucket = 0;
+    for (std::int64_t bound = 1; bucket < mp::perf::PerformanceCounters::DurationStats::num_buckets - 1;
+         ++bucket, bound *= 2)
+        if (msecs <= bound)
+            break;
+
+    return bucket;
+}
+
+double bucket_bound_seconds(std::size_t bucket)
+{
+    return (1LL << bucket) / 1e3; // bucket i holds samples up to 2^i ms
+}
+} // namespace
+
+mp::perf::PerformanceCounters& mp::perf::PerformanceCounters::instance()
+{
+    static PerformanceCounters counters;
+    return counters;
+}
+
+void mp::perf::PerformanceCounters::increment(const std::string& name, std::uint64_t amount)
+{
+    std::unique_lock<decltype(mutex)> lock{mutex};
+    auto& counter = counters[name];
+    if (!counter)
+        counter = std::make_unique<std::atomic<std::uint64_t>>(0);
+    lock.unlock();
+
+    counter->fetch_add(amount, std::memory_order_relaxed);
+}
+
+void mp::perf::PerformanceCounters::record_duration(const std::string& name, std::chrono::microseconds elapsed)
+{
+    std::unique_lock<decltype(mutex)> lock{mutex};
+    auto& stats = durations[name];
+    if (!stats)
+        stats = std::make_unique<DurationStats>();
+    lock.unlock();
+
+    stats->count.fetch_add(1, std::memory_order_relaxed);
+    stats->sum_usecs.fetch_add(elapsed.count(), std::memory_order_relaxed);
+    stats->buckets[bucket_for(elapsed)].fetch_add(1, std::memory_order_relaxed);
+}
+
+std::string mp::perf::PerformanceCounters::prometheus_text() const
+{
+    fmt::memory_buffer buffer;
+
+    std::lock_guard<decltype(mutex)> lock{mutex};
+    for (const auto& entry : counters)
+    {
+        fmt::format_to(buffer, "# TYPE multipass_{}_total counter\n", entry.first);
+        fmt::format_to(buffer, "multipass_{}_total {}\n", entry.first,
+                       entry.second->load(std::memory_order_relaxed));
+    }
+
+    for (const auto& entry : durations)
+    {
+        const auto& stats = *entry.second;
+        fmt::format_to(buffer, "# TYPE multipass_{}_seconds histogram\n", entry.first);
+
+        std::uint64_t cumulative = 0;
+        for (std::size_t bucket = 0; bucket < DurationStats::num_buckets - 1; ++bucket)
+        {
+            cumulative += stats.buckets[bucket].load(std::memory_order_relaxed);
+            fmt::format_to(buffer, "multipass_{}_seconds_bucket{{le=\"{}\"}} {}\n", entry.first,
+                           bucket_bound_seconds(bucket), cumulative);
+        }
+        cumulative += stats.buckets[DurationStats::num_buckets - 1].load(std::memory_order_relaxed);
+        fmt::format_to(buffer, "multipass_{}_seconds_bucket{{le=\"+Inf\"}} {}\n", entry.first, cumulative);
+
+        fmt::format_to(buffer, "multipass_{}_seconds_sum {}\n", entry.first,
+                       stats.sum_usecs.load(std::memory_order_relaxed) / 1e6);
+        fmt::format_to(buffer, "multipass_{}_seconds_count {}\n", entry.first,
+                       stats.count.load(std::memory_order_relaxed));
+    }
+
+    return fmt::to_string(buffer);
+}
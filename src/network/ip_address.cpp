@@ -51,73 +51,17 @@ std::array<uint8_t, 4> parse(const std::string& ip)
 
     return {{as_octect(a), as_octect(b), as_octect(c), as_octect(d)}};
 }
-
-std::array<uint8_t, 4> to_octets(uint32_t value)
-{
-    return {{as_octect(value >> 24u), as_octect(value >> 16u), as_octect(value >> 8u), as_octect(value)}};
-}
-}
-
-mp::IPAddress::IPAddress(std::array<uint8_t, 4> octets) : octets{octets}
-{
 }
 
 mp::IPAddress::IPAddress(const std::string& ip) : IPAddress(parse(ip))
 {
 }
 
-mp::IPAddress::IPAddress(uint32_t value) : IPAddress(to_octets(value))
-{
-}
-
 std::string mp::IPAddress::as_string() const
 {
+    const auto bytes = octets();
     std::stringstream ip;
-    ip << static_cast<int>(octets[0]) << "." << static_cast<int>(octets[1]) << "." << static_cast<int>(octets[2]) << "."
-       << static_cast<int>(octets[3]);
+    ip << static_cast<int>(bytes[0]) << "." << static_cast<int>(bytes[1]) << "." << static_cast<int>(bytes[2]) << "."
+       << static_cast<int>(bytes[3]);
     return ip.str();
 }
-
-uint32_t mp::IPAddress::as_uint32() const
-{
-    uint32_t value = octets[0] << 24u;
-    value |= octets[1] << 16u;
-    value |= octets[2] << 8u;
-    value |= octets[3];
-    return value;
-}
-
-bool mp::IPAddress::operator==(const IPAddress& other) const
-{
-    return octets == other.octets;
-}
-
-bool mp::IPAddress::operator!=(const IPAddress& other) const
-{
-    return octets != other.octets;
-}
-
-bool mp::IPAddress::operator<(const IPAddress& other) const
-{
-    return as_uint32() < other.as_uint32();
-}
-
-bool mp::IPAddress::operator<=(const IPAddress& other) const
-{
-    return as_uint32() <= other.as_uint32();
-}
-
-bool mp::IPAddress::operator>(const IPAddress& other) const
-{
-    return as_uint32() > other.as_uint32();
-}
-
-bool mp::IPAddress::operator>=(const IPAddress& other) const
-{
-    return as_uint32() >= other.as_uint32();
-}
-
-mp::IPAddress mp::IPAddress::operator+(int value) const
-{
-    return mp::IPAddress(as_uint32() + value);
-}
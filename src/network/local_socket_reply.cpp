@@ -22,6 +22,9 @@
 #include <QRegularExpression>
 #include <QRegularExpressionMatch>
 
+#include <algorithm>
+#include <cctype>
+
 namespace mp = multipass;
 
 namespace
@@ -177,16 +180,21 @@ void mp::LocalSocketReply::send_request(const QNetworkRequest& request, QIODevic
 
 void mp::LocalSocketReply::read_reply()
 {
-    auto data_ptr = reply_data.data();
-    int bytes_read{0};
+    qint64 bytes_read{0};
 
     do
     {
-        bytes_read = local_socket->read(reply_data.data(), len);
+        if (bytes_received == reply_data.size())
+            reply_data.resize(reply_data.size() * 2); // a reply can be bigger than the initial buffer
+
+        bytes_read = local_socket->read(reply_data.data() + bytes_received, reply_data.size() - bytes_received);
 
-        data_ptr += bytes_read;
+        if (bytes_read > 0)
+            bytes_received += bytes_read;
     } while (bytes_read > 0);
 
+    reply_data.truncate(static_cast<int>(bytes_received)); // drop the unwritten tail so parsing sees just the reply
+
     parse_reply();
 
     setFinished(true);
@@ -195,33 +203,92 @@ void mp::LocalSocketReply::read_reply()
 
 void mp::LocalSocketReply::parse_reply()
 {
-    auto reply_lines = reply_data.split('\n');
-    auto it = reply_lines.constBegin();
+    // Headers are scanned through views into the receive buffer — splitting into lines up front would copy
+    // the entire (possibly multi-MB) body along with them
+    constexpr auto npos = std::string_view::npos;
+    const std::string_view reply{reply_data.constData(), static_cast<std::size_t>(reply_data.size())};
+
+    std::size_t pos = 0;
+    const auto take_line = [&reply, &pos]() -> std::string_view {
+        if (pos >= reply.size())
+            return {};
+
+        const auto eol = reply.find('\n', pos);
+        auto line = reply.substr(pos, eol == npos ? npos : eol - pos);
+        pos = eol == npos ? reply.size() : eol + 1;
 
-    parse_status(*it);
+        if (!line.empty() && line.back() == '\r')
+            line.remove_suffix(1);
 
-    for (++it; it != reply_lines.constEnd(); ++it)
+        return line;
+    };
+
+    const auto status_line = take_line();
+    parse_status(QByteArray::fromRawData(status_line.data(), static_cast<int>(status_line.size())));
+
+    for (auto line = take_line(); !line.empty(); line = take_line())
     {
-        if ((*it).contains("Transfer-Encoding") && (*it).contains("chunked"))
+        if (line.find("Transfer-Encoding") != npos && line.find("chunked") != npos)
             chunked_transfer_encoding = true;
+    }
 
-        if ((*it).isEmpty() || (*it).startsWith('\r'))
-        {
-            // Advance to the body
-            // Chunked transfer encoding also includes a line with the amount of
-            // bytes (in hex) in the chunk. We just skip it for now.
-            it = chunked_transfer_encoding ? it + 2 : it + 1;
+    auto body = reply.substr(std::min(pos, reply.size()));
+
+    if (chunked_transfer_encoding)
+        decode_chunked_body(body);
+    else
+    { // mirror the old trimmed() semantics without an intermediate copy to trim
+        while (!body.empty() && std::isspace(static_cast<unsigned char>(body.front())))
+            body.remove_prefix(1);
+        while (!body.empty() && std::isspace(static_cast<unsigned char>(body.back())))
+            body.remove_suffix(1);
 
-            content_data = (*it).trimmed();
+        content_data = QByteArray{body.data(), static_cast<int>(body.size())}; // the single copy, sized exactly
+    }
+}
+
+void mp::LocalSocketReply::decode_chunked_body(std::string_view body)
+{
+    constexpr auto npos = std::string_view::npos;
+
+    content_data.clear();
+    content_data.reserve(static_cast<int>(body.size())); // slight overestimate (chunk framing), but one allocation
 
-            break;
+    while (!body.empty())
+    {
+        // Chunks open with their size in hex; decode it in place, there being no null terminator for strtol
+        std::size_t chunk_size = 0;
+        std::size_t i = 0;
+        for (; i < body.size(); ++i)
+        {
+            const auto c = body[i];
+            if (c >= '0' && c <= '9')
+                chunk_size = chunk_size * 16 + (c - '0');
+            else if (c >= 'a' && c <= 'f')
+                chunk_size = chunk_size * 16 + (c - 'a' + 10);
+            else if (c >= 'A' && c <= 'F')
+                chunk_size = chunk_size * 16 + (c - 'A' + 10);
+            else
+                break;
         }
+
+        const auto data_start = body.find('\n', i);
+        if (chunk_size == 0 || data_start == npos || data_start + 1 + chunk_size > body.size())
+            break; // the terminating chunk, or a truncated reply
+
+        content_data.append(body.data() + data_start + 1, static_cast<int>(chunk_size));
+        body.remove_prefix(data_start + 1 + chunk_size);
+
+        if (!body.empty() && body.front() == '\r')
+            body.remove_prefix(1);
+        if (!body.empty() && body.front() == '\n')
+            body.remove_prefix(1);
     }
 }
 
 void mp::LocalSocketReply::parse_status(const QByteArray& status)
 {
-    QRegularExpression http_status_regex{"^HTTP/\\d\\.\\d (?P<status>\\d{3})\\ (?P<message>.*)$"};
+    static const QRegularExpression http_status_regex{"^HTTP/\\d\\.\\d (?P<status>\\d{3})\\ (?P<message>.*)$"};
     QRegularExpressionMatch http_status_match = http_status_regex.match(QString::fromLatin1(status));
 
     if (!http_status_match.hasMatch())
@@ -25,6 +25,7 @@
 #include <QString>
 
 #include <memory>
+#include <string_view>
 
 namespace multipass
 {
@@ -52,9 +53,11 @@ private:
     void send_request(const QNetworkRequest& request, QIODevice* outgoingData);
     void parse_reply();
     void parse_status(const QByteArray& status);
+    void decode_chunked_body(std::string_view body);
 
     LocalSocketUPtr local_socket;
     QByteArray reply_data;
+    qint64 bytes_received{0};
     qint64 offset{0};
     bool chunked_transfer_encoding{false};
 };
@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2020 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <multipass/token_bucket.h>
+
+#include <algorithm>
+
+namespace mp = multipass;
+
+namespace
+{
+qint64 burst_for(qint64 bytes_per_second)
+{ // a quarter second of data, but keep reads a reasonable size even under tight limits
+    return std::max<qint64>(bytes_per_second / 4, 65536);
+}
+} // namespace
+
+void mp::TokenBucket::set_rate(qint64 bytes_per_second)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    this->bytes_per_second = bytes_per_second;
+    tokens = burst_for(bytes_per_second); // start full, so short transfers are not delayed at all
+    last_refill = std::chrono::steady_clock::now();
+}
+
+qint64 mp::TokenBucket::rate() const
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    return bytes_per_second;
+}
+
+qint64 mp::TokenBucket::burst() const
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    return burst_for(bytes_per_second);
+}
+
+std::chrono::milliseconds mp::TokenBucket::consume(qint64 bytes)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    if (bytes_per_second == 0 || bytes <= 0)
+        return {};
+
+    const auto cap = burst_for(bytes_per_second);
+    const auto now = std::chrono::steady_clock::now();
+    tokens = std::min<double>(cap, tokens + std::chrono::duration<double>(now - last_refill).count() * bytes_per_second);
+    last_refill = now;
+
+    const auto wanted = std::min(bytes, cap); // a request larger than a full bucket could never be satisfied
+    if (tokens < wanted)
+        return std::chrono::milliseconds{static_cast<qint64>((wanted - tokens) * 1000 / bytes_per_second) + 1};
+
+    tokens -= wanted;
+    return {};
+}
@@ -17,9 +17,13 @@
 
 #include <multipass/url_downloader.h>
 
+#include <multipass/data_sink.h>
 #include <multipass/exceptions/aborted_download_exception.h>
 #include <multipass/exceptions/download_exception.h>
 #include <multipass/logging/log.h>
+#include <multipass/page_cache.h>
+#include <multipass/performance_counters.h>
+#include <multipass/sha256.h>
 
 #include <multipass/format.h>
 
@@ -32,6 +36,7 @@
 #include <QTimer>
 #include <QUrl>
 
+#include <chrono>
 #include <memory>
 
 namespace mp = multipass;
@@ -41,6 +46,11 @@ namespace
 {
 constexpr auto category = "url downloader";
 
+constexpr qint64 min_write_chunk = 256 * 1024; // file writes are coalesced to between these two sizes,
+constexpr qint64 max_write_chunk = 16 * 1024 * 1024; // adapting to how fast the disk absorbs them
+constexpr qint64 read_buffer_cap = 32 * 1024 * 1024; /* when the disk (or a throttled sink) cannot keep up, the
+    reply buffer fills to this cap and TCP backpressure slows the sender, instead of the download ballooning RSS */
+
 auto make_network_manager(const mp::Path& cache_dir_path)
 {
     auto manager = std::make_unique<QNetworkAccessManager>();
@@ -65,27 +75,79 @@ auto get_network_cache_data(QAbstractNetworkCache* network_cache, const QUrl& ur
     return data;
 }
 
-template <typename ProgressAction, typename DownloadAction, typename ErrorAction, typename Time>
-QByteArray download(QNetworkAccessManager* manager, const Time& timeout, QUrl const& url, ProgressAction&& on_progress,
-                    DownloadAction&& on_download, ErrorAction&& on_error, const std::atomic_bool& abort_download)
+QByteArray read_resume_validator(const QString& resume_info_name)
 {
-    QEventLoop event_loop;
-    QTimer download_timeout;
-    download_timeout.setInterval(timeout);
+    QFile resume_info_file{resume_info_name};
+    if (!resume_info_file.open(QIODevice::ReadOnly))
+        return {};
+
+    return resume_info_file.readAll().trimmed();
+}
 
+void write_resume_validator(const QString& resume_info_name, const QByteArray& validator)
+{
+    QFile resume_info_file{resume_info_name};
+    if (resume_info_file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        resume_info_file.write(validator);
+}
+
+QNetworkRequest make_request(const QUrl& url)
+{
     QNetworkRequest request{url};
     request.setRawHeader("Connection", "Keep-Alive");
     request.setAttribute(QNetworkRequest::HttpPipeliningAllowedAttribute, true);
     request.setAttribute(QNetworkRequest::FollowRedirectsAttribute, true);
-    request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::AlwaysNetwork);
+    /* PreferNetwork lets the disk cache attach its validators, so an unchanged manifest comes back as a
+       bare 304 instead of the whole body; cacheless transfers (download_to disables storing) still go
+       straight to the network */
+    request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::PreferNetwork);
+    return request;
+}
+
+template <typename ProgressAction, typename DownloadAction, typename ErrorAction, typename Time>
+QByteArray download(QNetworkAccessManager* manager, const Time& timeout, const QNetworkRequest& request,
+                    ProgressAction&& on_progress, DownloadAction&& on_download, ErrorAction&& on_error,
+                    const std::atomic_bool& abort_download, mp::TokenBucket& throttle)
+{
+    QEventLoop event_loop;
+    QTimer download_timeout;
+    download_timeout.setInterval(timeout);
+
+    const auto begin = std::chrono::steady_clock::now();
+    qint64 total_received{0};
 
     auto reply = manager->get(request);
 
+    if (throttle.rate() > 0)
+    { /* with reads paced below, the bounded buffer fills up while we wait and TCP backpressure slows
+         the sender down to the configured rate */
+        reply->setReadBufferSize(throttle.burst());
+    }
+    else
+    {
+        reply->setReadBufferSize(read_buffer_cap);
+    }
+
+    QTimer throttle_resume;
+    throttle_resume.setSingleShot(true);
+
+    auto paced_download = [&]() {
+        const auto wait = throttle.consume(reply->bytesAvailable());
+        if (wait.count() > 0)
+        { // over budget; leave the data queued and come back for it once the bucket has refilled
+            throttle_resume.start(static_cast<int>(wait.count()));
+            return;
+        }
+        on_download(reply, download_timeout);
+    };
+
     QObject::connect(reply, &QNetworkReply::finished, &event_loop, &QEventLoop::quit);
     QObject::connect(reply, &QNetworkReply::downloadProgress, [&](qint64 bytes_received, qint64 bytes_total) {
+        total_received = bytes_received;
         on_progress(reply, bytes_received, bytes_total);
     });
-    QObject::connect(reply, &QNetworkReply::readyRead, [&]() { on_download(reply, download_timeout); });
+    QObject::connect(reply, &QNetworkReply::readyRead, paced_download);
+    QObject::connect(&throttle_resume, &QTimer::timeout, paced_download);
     QObject::connect(&download_timeout, &QTimer::timeout, [&]() {
         download_timeout.stop();
         reply->abort();
@@ -95,7 +157,7 @@ QByteArray download(QNetworkAccessManager* manager, const Time& timeout, QUrl co
     event_loop.exec();
     if (reply->error() != QNetworkReply::NoError)
     {
-        on_error();
+        on_error(reply);
 
         const auto msg = reply->errorString().toStdString();
 
@@ -105,8 +167,14 @@ QByteArray download(QNetworkAccessManager* manager, const Time& timeout, QUrl co
         if (abort_download)
             throw mp::AbortedDownloadException{msg};
         else
-            throw mp::DownloadException{url.toString().toStdString(), download_timeout.isActive() ? msg : "Network timeout"};
+            throw mp::DownloadException{request.url().toString().toStdString(),
+                                        download_timeout.isActive() ? msg : "Network timeout"};
     }
+
+    mp::perf::PerformanceCounters::instance().increment("download_bytes", total_received);
+    mp::perf::PerformanceCounters::instance().record_duration(
+        "download", std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin));
+
     return reply->readAll();
 }
 } // namespace
@@ -122,28 +190,128 @@ mp::URLDownloader::URLDownloader(const mp::Path& cache_dir, std::chrono::millise
 
 void mp::URLDownloader::download_to(const QUrl& url, const QString& file_name, int64_t size, const int download_type,
                                     const mp::ProgressMonitor& monitor)
+{
+    download_to(url, file_name, size, download_type, monitor, nullptr);
+}
+
+void mp::URLDownloader::download_to(const QUrl& url, const QString& file_name, int64_t size, const int download_type,
+                                    const mp::ProgressMonitor& monitor, DataSink* sink)
 {
     auto manager{make_network_manager(cache_dir_path)};
 
-    QFile file{file_name};
-    file.open(QIODevice::ReadWrite | QIODevice::Truncate);
+    /* Transfers land in a sidecar file, along with the server's validator, so that an interrupted download can
+       be picked up again with a ranged request instead of starting over from byte zero */
+    const QString partial_name = file_name + ".partial";
+    const QString resume_info_name = partial_name + ".info";
+
+    auto validator = read_resume_validator(resume_info_name);
+
+    QFile file{partial_name};
+    file.open(QIODevice::ReadWrite);
+
+    // Hash the stream as it is written out, so that verification does not need another pass over the file
+    mp::Sha256 sha256;
+
+    qint64 offset = 0;
+    if (!validator.isEmpty() && file.size() > 0)
+    {
+        try
+        {
+            while (!file.atEnd())
+            {
+                auto chunk = file.read(65536);
+                sha256.add_data(chunk);
+                if (sink != nullptr)
+                    sink->write(chunk);
+            }
+            offset = file.size();
+            mp::utils::drop_io_cache(file.handle(), offset); // the re-read partial data is done with, too
+        }
+        catch (const std::exception& e)
+        { // the sink choked on the partial data (e.g. a truncated xz block); start over instead of failing
+            mpl::log(mpl::Level::warning, category,
+                     fmt::format("Discarding partial download of {}: {}", url.toString(), e.what()));
+            file.resize(0);
+            file.seek(0);
+            sha256.reset();
+            if (sink != nullptr)
+                sink->restart();
+            offset = 0;
+        }
+    }
+    else
+    {
+        file.resize(0);
+    }
+
+    auto request = make_request(url);
+    /* The body goes straight to the file below; letting the disk cache spool a copy alongside would double
+       the write I/O of a multi-GB image for nothing — images are content-addressed and verified against
+       their SHA in the vault, so there is no revalidation the cache could ever answer. Manifests (which do
+       profit from cache validation) go through download() and keep being stored */
+    request.setAttribute(QNetworkRequest::CacheSaveControlAttribute, false);
+    if (offset > 0)
+    {
+        mpl::log(mpl::Level::info, category,
+                 fmt::format("Resuming download of {} from byte {}", url.toString(), offset));
+        request.setRawHeader("Range", QString("bytes=%1-").arg(offset).toLatin1());
+        request.setRawHeader("If-Range", validator);
+    }
 
-    auto progress_monitor = [&monitor, download_type, size](QNetworkReply* reply, qint64 bytes_received,
-                                                            qint64 bytes_total) {
+    auto progress_monitor = [&monitor, &offset, download_type, size](QNetworkReply* reply, qint64 bytes_received,
+                                                                     qint64 bytes_total) {
         if (bytes_received == 0)
             return;
 
         if (bytes_total == -1 && size > 0)
-            bytes_total = size;
+            bytes_total = size - offset;
 
-        auto progress = (size < 0) ? size : (100 * bytes_received + bytes_total / 2) / bytes_total;
+        auto progress =
+            (size < 0) ? size : (100 * (offset + bytes_received) + bytes_total / 2) / (offset + bytes_total);
         if (!monitor(download_type, progress))
         {
             reply->abort();
         }
     };
 
-    auto on_download = [this, &file](QNetworkReply* reply, QTimer& download_timeout) {
+    auto status_checked = false;
+    std::exception_ptr sink_error;
+    qint64 bytes_since_drop = 0;
+
+    /* Qt signals readyRead for whatever trickled in, which on a fast link means a stream of tiny writes. Batch
+       the data up to a target size instead, growing the target while the disk keeps pace and shrinking it when
+       writes stall, so the syscall rate stays low without memory piling up in front of a slow disk */
+    QByteArray pending;
+    qint64 write_target = min_write_chunk;
+    auto flush_pending = [&file, &pending, &write_target, &bytes_since_drop]() {
+        if (pending.isEmpty())
+            return true;
+
+        const auto before = std::chrono::steady_clock::now();
+        if (file.write(pending) < 0)
+        {
+            mpl::log(mpl::Level::error, category, fmt::format("error writing image: {}", file.errorString()));
+            return false;
+        }
+        const auto took = std::chrono::steady_clock::now() - before;
+
+        if (took < std::chrono::milliseconds{20} && write_target < max_write_chunk)
+            write_target *= 2;
+        else if (took > std::chrono::milliseconds{100} && write_target > min_write_chunk)
+            write_target /= 2;
+
+        if ((bytes_since_drop += pending.size()) >= mp::utils::drop_behind_window)
+        { // keep the multi-GB body from crowding out the page cache that running guests rely on
+            mp::utils::drop_io_cache(file.handle(), file.pos());
+            bytes_since_drop = 0;
+        }
+
+        pending.clear();
+        return true;
+    };
+
+    auto on_download = [this, &sha256, &status_checked, &file, &offset, sink, &sink_error, &pending, &write_target,
+                        &flush_pending](QNetworkReply* reply, QTimer& download_timeout) {
         if (abort_download)
         {
             reply->abort();
@@ -155,17 +323,87 @@ void mp::URLDownloader::download_to(const QUrl& url, const QString& file_name, i
         else
             return;
 
-        if (file.write(reply->readAll()) < 0)
+        if (!status_checked)
+        { // the server replies with the full body instead of the requested range when the image changed
+            if (offset > 0 &&
+                reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() != 206 /* Partial Content */)
+            {
+                file.resize(0);
+                file.seek(0);
+                sha256.reset();
+                if (sink != nullptr)
+                    sink->restart();
+                offset = 0;
+            }
+            status_checked = true;
+        }
+
+        auto data = reply->readAll();
+        sha256.add_data(data);
+
+        pending.append(data);
+        if (pending.size() >= write_target && !flush_pending())
         {
-            mpl::log(mpl::Level::error, category, fmt::format("error writing image: {}", file.errorString()));
             reply->abort();
+            return;
+        }
+
+        if (sink != nullptr)
+        {
+            try
+            {
+                sink->write(data);
+            }
+            catch (...)
+            { // exceptions must not unwind through the event loop; stash the error and rethrow it below
+                sink_error = std::current_exception();
+                reply->abort();
+                return;
+            }
         }
         download_timeout.start();
     };
 
-    auto on_error = [&file]() { file.remove(); };
+    auto on_error = [&file, &resume_info_name](QNetworkReply* reply) {
+        const auto last_modified = reply->rawHeader("Last-Modified"); // verbatim, to be given back in If-Range
+        if (file.size() > 0 && !last_modified.isEmpty())
+        { // keep the partial data and remember what it was downloaded from
+            write_resume_validator(resume_info_name, last_modified);
+        }
+        else
+        {
+            file.remove();
+            QFile::remove(resume_info_name);
+        }
+    };
+
+    try
+    {
+        ::download(manager.get(), timeout, request, progress_monitor, on_download, on_error, abort_download, throttle);
+    }
+    catch (const std::exception&)
+    {
+        if (sink_error)
+            std::rethrow_exception(sink_error); // the sink failure is the root cause of the aborted transfer
+        throw;
+    }
 
-    ::download(manager.get(), timeout, url, progress_monitor, on_download, on_error, abort_download);
+    if (!flush_pending()) // whatever the last readyRead left below the target size
+        throw mp::DownloadException{url.toString().toStdString(), file.errorString().toStdString()};
+
+    file.close();
+    QFile::remove(resume_info_name);
+    QFile::remove(file_name);
+    file.rename(file_name);
+
+    std::lock_guard<decltype(checksum_mutex)> lock{checksum_mutex};
+    checksums[file_name] = sha256.result();
+}
+
+std::string mp::URLDownloader::sha256_checksum(const QString& file_name)
+{
+    std::lock_guard<decltype(checksum_mutex)> lock{checksum_mutex};
+    return checksums.take(file_name).toStdString();
 }
 
 QByteArray mp::URLDownloader::download(const QUrl& url)
@@ -175,23 +413,11 @@ QByteArray mp::URLDownloader::download(const QUrl& url)
     auto network_cache = manager->cache();
     auto metadata = network_cache->metaData(url);
 
-    if (metadata.isValid())
-    {
-        try
-        {
-            if (last_modified(url) == metadata.lastModified())
-            {
-                return get_network_cache_data(network_cache, url);
-            }
-        }
-        catch (const std::exception& e)
-        {
-            mpl::log(
-                mpl::Level::info, category,
-                fmt::format("Cannot get last modified date for {}: {}. Using cached data.", url.toString(), e.what()));
-            return get_network_cache_data(network_cache, url);
-        }
-    }
+    /* A validated GET costs a single header round-trip when the content did not change: Qt derives
+       If-Modified-Since/If-None-Match from the disk cache entry and serves the body from cache on a
+       304 Not Modified, so there is no need for a separate HEAD probe or an unconditional re-download */
+    auto request = make_request(url);
+    request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::PreferNetwork);
 
     // This will connect to the QNetworkReply::readReady signal and when emitted,
     // reset the timer.
@@ -207,8 +433,8 @@ QByteArray mp::URLDownloader::download(const QUrl& url)
 
     try
     {
-        return ::download(manager.get(), timeout, url, [](QNetworkReply*, qint64, qint64) {}, on_download, [] {},
-                          abort_download);
+        return ::download(manager.get(), timeout, request, [](QNetworkReply*, qint64, qint64) {}, on_download,
+                          [](QNetworkReply*) {}, abort_download, throttle);
     }
     catch (const std::exception& e)
     {
@@ -263,3 +489,8 @@ void mp::URLDownloader::abort_all_downloads()
 {
     abort_download = true;
 }
+
+void mp::URLDownloader::set_bandwidth_limit(qint64 bytes_per_second)
+{
+    throttle.set_rate(bytes_per_second);
+}
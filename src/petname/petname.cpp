@@ -63,9 +63,9 @@ mp::Petname::Petname(NumWords num_words, std::string separator)
 
 std::string mp::Petname::make_name()
 {
-    std::string name = multipass::petname::names[name_dist(engine)];
-    std::string adjective = multipass::petname::adjectives[adjective_dist(engine)];
-    std::string adverb = multipass::petname::adverbs[adverb_dist(engine)];
+    std::string name{multipass::petname::names[name_dist(engine)]};
+    std::string adjective{multipass::petname::adjectives[adjective_dist(engine)]};
+    std::string adverb{multipass::petname::adverbs[adverb_dist(engine)]};
 
     switch(num_words)
     {
@@ -79,3 +79,25 @@ std::string mp::Petname::make_name()
         throw std::invalid_argument("Invalid number of words chosen");
     }
 }
+
+std::string mp::Petname::make_name(const std::function<bool(const std::string&)>& is_free)
+{
+    constexpr auto num_random_attempts = 10;
+
+    std::string candidate;
+    for (auto i = 0; i < num_random_attempts; ++i)
+    {
+        candidate = make_name();
+        if (is_free(candidate))
+            return candidate;
+    }
+
+    // A densely populated registry (think bulk creation of hundreds of instances) makes random compositions
+    // collide over and over; suffixing a monotonic counter instead gets each further name in ~one check
+    while (true)
+    {
+        auto sharded = candidate + separator + std::to_string(fallback_counter++);
+        if (is_free(sharded))
+            return sharded;
+    }
+}
@@ -49,10 +49,12 @@ public:
     explicit Petname(std::string separator);
 
     std::string make_name() override;
+    std::string make_name(const std::function<bool(const std::string&)>& is_free) override;
 
 private:
     std::string separator;
     NumWords num_words;
+    std::size_t fallback_counter{2};
     std::mt19937 engine;
     std::uniform_int_distribution<std::size_t> name_dist;
     std::uniform_int_distribution<std::size_t> adjective_dist;
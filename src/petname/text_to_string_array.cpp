@@ -51,7 +51,9 @@ public:
 
     void print_to(std::ostream& out)
     {
-        out << "const char* " << var_name << "[] =\n{\n";
+        // constexpr string_views keep the words in the binary's read-only data, with no per-word heap
+        // allocation when the arrays are first used
+        out << "inline constexpr std::string_view " << var_name << "[] =\n{\n";
         for (auto const& w: words)
         {
             out << "    \"" << w << "\",\n";
@@ -80,6 +82,7 @@ try
     std::ofstream out(argv[4]);
 
     out << "//Auto Generated, any edits will be lost\n\n";
+    out << "#include <string_view>\n\n";
     out << "namespace multipass\n{\n";
     out << "namespace petname\n{\n";
 
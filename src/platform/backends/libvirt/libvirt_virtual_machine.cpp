@@ -270,12 +270,9 @@ mp::LibVirtVirtualMachine::~LibVirtVirtualMachine()
 void mp::LibVirtVirtualMachine::start()
 {
     auto connection = open_libvirt_connection(libvirt_wrapper);
-    DomainUPtr domain{nullptr, nullptr};
 
-    if (state == VirtualMachine::State::unknown)
-        domain = initialize_domain_info(connection.get());
-    else
-        domain = domain_by_name_for(vm_name, connection.get(), libvirt_wrapper);
+    if (state == VirtualMachine::State::unknown || !domain)
+        initialize_domain_info(connection.get());
 
     state = refresh_instance_state_for_domain(domain.get(), state, libvirt_wrapper);
     if (state == State::running)
@@ -320,11 +317,11 @@ void mp::LibVirtVirtualMachine::stop()
 void mp::LibVirtVirtualMachine::shutdown()
 {
     std::unique_lock<decltype(state_mutex)> lock{state_mutex};
-    auto domain = domain_by_name_for(vm_name, open_libvirt_connection(libvirt_wrapper).get(), libvirt_wrapper);
-    state = refresh_instance_state_for_domain(domain.get(), state, libvirt_wrapper);
+    auto domain = domain_for(open_libvirt_connection(libvirt_wrapper).get());
+    state = refresh_instance_state_for_domain(domain, state, libvirt_wrapper);
     if (state == State::running || state == State::delayed_shutdown || state == State::unknown)
     {
-        if (!domain || libvirt_wrapper->virDomainShutdown(domain.get()) == -1)
+        if (!domain || libvirt_wrapper->virDomainShutdown(domain) == -1)
         {
             auto warning_string{
                 fmt::format("Cannot shutdown '{}': {}", vm_name, libvirt_wrapper->virGetLastErrorMessage())};
@@ -337,7 +334,7 @@ void mp::LibVirtVirtualMachine::shutdown()
     }
     else if (state == State::starting)
     {
-        libvirt_wrapper->virDomainDestroy(domain.get());
+        libvirt_wrapper->virDomainDestroy(domain);
         state_wait.wait(lock, [this] { return state == State::off; });
         update_state();
     }
@@ -352,11 +349,11 @@ void mp::LibVirtVirtualMachine::shutdown()
 
 void mp::LibVirtVirtualMachine::suspend()
 {
-    auto domain = domain_by_name_for(vm_name, open_libvirt_connection(libvirt_wrapper).get(), libvirt_wrapper);
-    state = refresh_instance_state_for_domain(domain.get(), state, libvirt_wrapper);
+    auto domain = domain_for(open_libvirt_connection(libvirt_wrapper).get());
+    state = refresh_instance_state_for_domain(domain, state, libvirt_wrapper);
     if (state == State::running || state == State::delayed_shutdown)
     {
-        if (!domain || libvirt_wrapper->virDomainManagedSave(domain.get(), 0) < 0)
+        if (!domain || libvirt_wrapper->virDomainManagedSave(domain, 0) < 0)
         {
             auto warning_string{
                 fmt::format("Cannot suspend '{}': {}", vm_name, libvirt_wrapper->virGetLastErrorMessage())};
@@ -383,8 +380,7 @@ mp::VirtualMachine::State mp::LibVirtVirtualMachine::current_state()
     try
     {
         auto connection = open_libvirt_connection(libvirt_wrapper);
-        auto domain = domain_by_name_for(vm_name, connection.get(), libvirt_wrapper);
-        if (!domain)
+        if (!domain_for(connection.get()))
             initialize_domain_info(connection.get());
 
         state = refresh_instance_state_for_domain(domain.get(), state, libvirt_wrapper);
@@ -405,8 +401,8 @@ int mp::LibVirtVirtualMachine::ssh_port()
 void mp::LibVirtVirtualMachine::ensure_vm_is_running()
 {
     std::lock_guard<decltype(state_mutex)> lock{state_mutex};
-    auto domain = domain_by_name_for(vm_name, open_libvirt_connection(libvirt_wrapper).get(), libvirt_wrapper);
-    if (!domain_is_running(domain.get(), libvirt_wrapper))
+    auto domain = domain_for(open_libvirt_connection(libvirt_wrapper).get());
+    if (!domain_is_running(domain, libvirt_wrapper))
     {
         // Have to set 'off' here so there is an actual state change to compare to for
         // the cond var's predicate
@@ -472,11 +468,9 @@ void mp::LibVirtVirtualMachine::update_state()
     monitor->persist_state_for(vm_name, state);
 }
 
-mp::LibVirtVirtualMachine::DomainUPtr mp::LibVirtVirtualMachine::initialize_domain_info(virConnectPtr connection)
+void mp::LibVirtVirtualMachine::initialize_domain_info(virConnectPtr connection)
 {
-    auto domain = domain_by_name_for(vm_name, connection, libvirt_wrapper);
-
-    if (!domain)
+    if (!domain_for(connection))
     {
         domain = domain_by_definition_for(desc, bridge_name, connection, libvirt_wrapper);
     }
@@ -486,8 +480,14 @@ mp::LibVirtVirtualMachine::DomainUPtr mp::LibVirtVirtualMachine::initialize_doma
 
     ipv4(); // To set ip
     state = refresh_instance_state_for_domain(domain.get(), state, libvirt_wrapper);
+}
 
-    return domain;
+virDomainPtr mp::LibVirtVirtualMachine::domain_for(virConnectPtr connection)
+{
+    if (!domain)
+        domain = domain_by_name_for(vm_name, connection, libvirt_wrapper);
+
+    return domain.get();
 }
 
 mp::LibVirtVirtualMachine::ConnectionUPtr
@@ -57,8 +57,12 @@ public:
     static ConnectionUPtr open_libvirt_connection(const LibvirtWrapper::UPtr& libvirt_wrapper);
 
 private:
-    DomainUPtr initialize_domain_info(virConnectPtr connection);
+    void initialize_domain_info(virConnectPtr connection);
+    virDomainPtr domain_for(virConnectPtr connection);
 
+    // Domain handles are reference counted by libvirt independently of the connection
+    // they were obtained on, so one lookup can serve all subsequent operations
+    DomainUPtr domain{nullptr, nullptr};
     std::string mac_addr;
     const std::string username;
     const VirtualMachineDescription desc;
@@ -160,6 +160,18 @@ void mp::LibVirtVirtualMachineFactory::prepare_instance_image(const VMImage& ins
     mp::backend::resize_instance_image(desc.disk_space, instance_image.image_path);
 }
 
+void mp::LibVirtVirtualMachineFactory::snapshot_instance_image(const VMImage& instance_image,
+                                                               const std::string& snapshot_name)
+{
+    mp::backend::snapshot_instance_image(snapshot_name, instance_image.image_path);
+}
+
+void mp::LibVirtVirtualMachineFactory::restore_instance_image(const VMImage& instance_image,
+                                                              const std::string& snapshot_name)
+{
+    mp::backend::restore_instance_image(snapshot_name, instance_image.image_path);
+}
+
 void mp::LibVirtVirtualMachineFactory::hypervisor_health_check()
 {
     mp::backend::check_for_kvm_support();
@@ -32,14 +32,11 @@
 #include <multipass/vm_status_monitor.h>
 
 #include <chrono>
-#include <thread>
 
 namespace mp = multipass;
 namespace mpl = multipass::logging;
 namespace mpu = multipass::utils;
 
-using namespace std::literals::chrono_literals;
-
 namespace
 {
 auto instance_state_for(const QString& name, mp::NetworkAccessManager* manager, const QUrl& url)
@@ -139,12 +136,20 @@ mp::LXDVirtualMachine::LXDVirtualMachine(const VirtualMachineDescription& desc,
         if (!desc.user_data_config.IsNull())
             config["user.user-data"] = QString::fromStdString(mpu::emit_cloud_config(desc.user_data_config));
 
-        QJsonObject devices{
-            {"config", QJsonObject{{"source", "cloud-init:config"}, {"type", "disk"}}},
-            {"root", QJsonObject{{"path", "/"},
-                                 {"pool", "default"},
-                                 {"size", QString::number(get_minimum_disk_size(desc.disk_space).in_bytes())},
-                                 {"type", "disk"}}}};
+        QJsonObject root_device{{"path", "/"},
+                                {"pool", "default"},
+                                {"size", QString::number(get_minimum_disk_size(desc.disk_space).in_bytes())},
+                                {"type", "disk"}};
+
+        // LXD takes a single I/O cap per device, either a byte rate or an IOPS rate — when both are
+        // requested, the byte rate wins, as it is the better proxy for the disk time being contended
+        if (desc.io_limits.bytes_per_second > 0)
+            root_device["limits.max"] = QString("%1B").arg(desc.io_limits.bytes_per_second);
+        else if (desc.io_limits.iops > 0)
+            root_device["limits.max"] = QString("%1iops").arg(desc.io_limits.iops);
+
+        QJsonObject devices{{"config", QJsonObject{{"source", "cloud-init:config"}, {"type", "disk"}}},
+                            {"root", root_device}};
 
         QJsonObject virtual_machine{
             {"name", name},
@@ -164,37 +169,19 @@ mp::LXDVirtualMachine::LXDVirtualMachine(const VirtualMachineDescription& desc,
         if (json_reply["metadata"].toObject()["class"] == QStringLiteral("task") &&
             json_reply["status_code"].toInt(-1) == 100)
         {
-            QUrl task_url(QString("%1/operations/%2")
+            QUrl task_url(QString("%1/operations/%2/wait")
                               .arg(base_url.toString())
                               .arg(json_reply["metadata"].toObject()["id"].toString()));
 
-            // Instead of polling, need to use websockets to get events
-            while (true)
+            // The wait endpoint blocks until the operation completes, so there are no
+            // sleep-polling round trips against the socket
+            try
+            {
+                lxd_request(manager, "GET", task_url, nullopt, 300000);
+            }
+            catch (const LXDNotFoundException&)
             {
-                try
-                {
-                    auto task_reply = lxd_request(manager, "GET", task_url);
-
-                    if (task_reply["error_code"].toInt(-1) != 0)
-                    {
-                        break;
-                    }
-
-                    auto status_code = task_reply["metadata"].toObject()["status_code"].toInt(-1);
-                    if (status_code == 200)
-                    {
-                        break;
-                    }
-                    else
-                    {
-                        std::this_thread::sleep_for(1s);
-                    }
-                }
                 // Implies the task is finished
-                catch (const LXDNotFoundException& e)
-                {
-                    break;
-                }
             }
         }
 
@@ -76,7 +76,8 @@ mp::LXDVMImageVault::LXDVMImageVault(std::vector<VMImageHost*> image_hosts, Netw
 mp::VMImage mp::LXDVMImageVault::fetch_image(const FetchType& fetch_type, const Query& query,
                                              const PrepareAction& prepare, const ProgressMonitor& monitor)
 {
-    // Look for an already existing instance and get its image info
+    // Look for an already existing instance and get its image info; the image is necessarily in LXD's store
+    // already, so answering from here skips the alias resolution and images queries below entirely
     try
     {
         auto instance_info = lxd_request(
@@ -102,6 +103,8 @@ mp::VMImage mp::LXDVMImageVault::fetch_image(const FetchType& fetch_type, const
                 {
                     source_image.aliases.push_back(alias.toStdString());
                 }
+
+                return source_image;
             }
             catch (const std::exception&)
             {
@@ -197,6 +200,19 @@ mp::VMImage mp::LXDVMImageVault::fetch_image(const FetchType& fetch_type, const
     return source_image;
 }
 
+mp::VMImage mp::LXDVMImageVault::clone_image(const std::string& /* source_name */,
+                                             const std::string& /* destination_name */)
+{
+    // Instance disks live inside LXD's storage pool here, out of the vault's reach
+    throw std::runtime_error("cloning instances is not supported on the LXD backend");
+}
+
+mp::VMImage mp::LXDVMImageVault::rename_image(const std::string& /* source_name */,
+                                              const std::string& /* destination_name */)
+{
+    throw std::runtime_error("renaming instance images is not supported on the LXD backend");
+}
+
 void mp::LXDVMImageVault::remove(const std::string& name)
 {
     try
@@ -233,6 +249,11 @@ void mp::LXDVMImageVault::update_images(const FetchType& fetch_type, const Prepa
 {
 }
 
+void mp::LXDVMImageVault::prefetch_images(const std::vector<Query>& tracked_queries, const FetchType& fetch_type,
+                                          const PrepareAction& prepare, const ProgressMonitor& monitor)
+{
+}
+
 mp::VMImageInfo mp::LXDVMImageVault::info_for(const mp::Query& query)
 {
     if (!query.remote_name.empty())
@@ -37,11 +37,15 @@ public:
 
     VMImage fetch_image(const FetchType& fetch_type, const Query& query, const PrepareAction& prepare,
                         const ProgressMonitor& monitor) override;
+    VMImage clone_image(const std::string& source_name, const std::string& destination_name) override;
+    VMImage rename_image(const std::string& source_name, const std::string& destination_name) override;
     void remove(const std::string& name) override;
     bool has_record_for(const std::string& name) override;
     void prune_expired_images() override;
     void update_images(const FetchType& fetch_type, const PrepareAction& prepare,
                        const ProgressMonitor& monitor) override;
+    void prefetch_images(const std::vector<Query>& tracked_queries, const FetchType& fetch_type,
+                         const PrepareAction& prepare, const ProgressMonitor& monitor) override;
 
 private:
     VMImageInfo info_for(const Query& query);
@@ -41,9 +41,9 @@ QString mp::DNSMasqProcessSpec::program() const
 
 QStringList mp::DNSMasqProcessSpec::arguments() const
 {
-    const auto bridge_addr = mp::IPAddress{fmt::format("{}.1", subnet)};
-    const auto start_ip = mp::IPAddress{fmt::format("{}.2", subnet)};
-    const auto end_ip = mp::IPAddress{fmt::format("{}.254", subnet)};
+    const auto bridge_addr = mp::IPAddress{fmt::format("{}.1", subnet)}; // the subnet's first assignable address
+    const auto start_ip = bridge_addr + 1;
+    const auto end_ip = bridge_addr.last_in_subnet(24);
 
     return QStringList() << "--strict-order"
                          << "--bind-interfaces" << QString("--pid-file=%1").arg(pid_file_path) << "--domain=multipass"
@@ -18,6 +18,7 @@
 #include "dnsmasq_server.h"
 
 #include "dnsmasq_process_spec.h"
+#include <multipass/file_watcher.h>
 #include <multipass/logging/log.h>
 #include <multipass/process.h>
 #include <multipass/utils.h>
@@ -26,8 +27,11 @@
 #include <multipass/format.h>
 
 #include <QDir>
+#include <QFileInfo>
 
 #include <fstream>
+#include <functional>
+#include <unordered_set>
 
 #include <signal.h>
 #include <sys/types.h>
@@ -61,12 +65,22 @@ mp::DNSMasqServer::DNSMasqServer(const Path& data_dir, const QString& bridge_nam
     : data_dir{data_dir},
       bridge_name{bridge_name},
       pid_file_path{QDir(data_dir).filePath("dnsmasq.pid")},
+      hosts_file_path{QDir(data_dir).filePath("dnsmasq.hosts")},
+      leases_file_path{QDir(data_dir).filePath("dnsmasq.leases")},
       subnet{subnet},
       conf_file{QDir(data_dir).absoluteFilePath("dnsmasq-XXXXXX.conf")}
 {
     conf_file.open();
     conf_file.close();
 
+    load_host_reservations();
+
+    lease_cache->watched = FileWatcher::instance().watch(
+        leases_file_path, [cache = lease_cache.get()] { // the indirection keeps the pointer stable across moves
+            std::lock_guard<std::mutex> lock{cache->mutex};
+            cache->stale = true;
+        });
+
     try
     {
         check_dnsmasq_running();
@@ -79,6 +93,9 @@ mp::DNSMasqServer::DNSMasqServer(const Path& data_dir, const QString& bridge_nam
 
 mp::DNSMasqServer::~DNSMasqServer()
 {
+    if (lease_cache && lease_cache->watched) // the cache pointer is gone on moved-from servers
+        FileWatcher::instance().unwatch(leases_file_path);
+
     try
     {
         auto dnsmasq_pid = get_dnsmasq_pid(pid_file_path);
@@ -92,25 +109,118 @@ mp::DNSMasqServer::~DNSMasqServer()
 
 mp::optional<mp::IPAddress> mp::DNSMasqServer::get_ip_for(const std::string& hw_addr)
 {
+    {
+        std::lock_guard<std::mutex> lock{reservations->mutex};
+        auto entry = reservations->entries.find(hw_addr);
+        if (entry != reservations->entries.end())
+            return mp::optional<mp::IPAddress>{entry->second};
+    }
+
+    return ip_from_lease(hw_addr);
+}
+
+mp::IPAddress mp::DNSMasqServer::reserve_ip_for(const std::string& hw_addr)
+{
+    const auto leased = ip_from_lease(hw_addr); // an instance predating reservations keeps the address it holds
+
+    std::lock_guard<std::mutex> lock{reservations->mutex};
+
+    auto entry = reservations->entries.find(hw_addr);
+    if (entry != reservations->entries.end())
+        return entry->second;
+
+    std::unordered_set<uint32_t> taken;
+    for (const auto& reservation : reservations->entries)
+        taken.insert(reservation.second.as_uint32());
+
+    // dnsmasq hands out <subnet>.2 through <subnet>.254; derive a slot from the MAC so the mapping is stable
+    // across daemon restarts, and probe linearly past any collision
+    const auto range_begin = IPAddress{subnet + ".2"}.as_uint32();
+    constexpr uint32_t range_size = 253;
+
+    auto candidate = leased ? leased->as_uint32()
+                            : range_begin + static_cast<uint32_t>(std::hash<std::string>{}(hw_addr)) % range_size;
+    for (uint32_t probe = 0; probe < range_size; ++probe)
+    {
+        if (taken.find(candidate) == taken.end())
+        {
+            const auto ip = IPAddress{candidate};
+            reservations->entries.emplace(hw_addr, ip);
+            write_hosts_file();
+            signal_dnsmasq(); // dnsmasq re-reads the hosts file on SIGHUP, no restart needed
+            return ip;
+        }
+        candidate = range_begin + (candidate - range_begin + 1) % range_size;
+    }
+
+    throw std::runtime_error(
+        fmt::format("no addresses left in {}.2-{}.254 to reserve for {}", subnet, subnet, hw_addr));
+}
+
+mp::optional<mp::IPAddress> mp::DNSMasqServer::ip_from_lease(const std::string& hw_addr)
+{
+    std::lock_guard<std::mutex> lock{lease_cache->mutex};
+
+    // with a watch in place lookups cost no syscalls at all until an event flags the cache stale; without
+    // one (no event loop), staleness falls back on comparing the file's mtime on every lookup
+    if (!lease_cache->watched || lease_cache->stale)
+        reload_lease_cache();
+
+    auto entry = lease_cache->entries.find(hw_addr);
+    if (entry == lease_cache->entries.end() && lease_cache->watched)
+    {
+        // a miss may just mean the event is still queued behind a busy main loop; the mtime check is the
+        // backstop that keeps IP discovery from stalling behind it
+        reload_lease_cache();
+        entry = lease_cache->entries.find(hw_addr);
+    }
+
+    if (entry != lease_cache->entries.end())
+        return mp::optional<mp::IPAddress>{entry->second};
+    return mp::nullopt;
+}
+
+void mp::DNSMasqServer::reload_lease_cache()
+{
+    // dnsmasq rewrites the whole file on every change, so its mtime tells us whether the cached table
+    // actually needs rebuilding
+    const auto last_modified = QFileInfo{leases_file_path}.lastModified();
+    if (last_modified.isValid() && last_modified == lease_cache->last_modified)
+    {
+        lease_cache->stale = false;
+        return;
+    }
+
     // DNSMasq leases entries consist of:
     // <lease expiration> <mac addr> <ipv4> <name> * * *
-    const auto path = QDir(data_dir).filePath("dnsmasq.leases").toStdString();
     const std::string delimiter{" "};
     const int hw_addr_idx{1};
     const int ipv4_idx{2};
-    std::ifstream leases_file{path};
+
+    lease_cache->entries.clear();
+    std::ifstream leases_file{leases_file_path.toStdString()};
     std::string line;
     while (getline(leases_file, line))
     {
         const auto fields = mp::utils::split(line, delimiter);
-        if (fields.size() > 2 && fields[hw_addr_idx] == hw_addr)
-            return mp::optional<mp::IPAddress>{fields[ipv4_idx]};
+        if (fields.size() > 2)
+            lease_cache->entries.emplace(fields[hw_addr_idx], IPAddress{fields[ipv4_idx]});
     }
-    return mp::nullopt;
+    lease_cache->last_modified = last_modified;
+    lease_cache->stale = false;
 }
 
 void mp::DNSMasqServer::release_mac(const std::string& hw_addr)
 {
+    {
+        std::lock_guard<std::mutex> lock{reservations->mutex};
+        if (reservations->entries.erase(hw_addr) > 0)
+        {
+            write_hosts_file();
+            signal_dnsmasq();
+        }
+    }
+
     auto ip = get_ip_for(hw_addr);
     if (!ip)
     {
@@ -142,6 +252,39 @@ void mp::DNSMasqServer::release_mac(const std::string& hw_addr)
     dhcp_release.waitForFinished();
 }
 
+void mp::DNSMasqServer::load_host_reservations()
+{
+    // reservations are persisted in dnsmasq's own dhcp-host format: <mac>,<ip> per line
+    std::ifstream hosts_file{hosts_file_path.toStdString()};
+    std::string line;
+    while (getline(hosts_file, line))
+    {
+        const auto fields = mp::utils::split(line, ",");
+        if (fields.size() == 2)
+            reservations->entries.emplace(fields[0], IPAddress{fields[1]});
+    }
+}
+
+void mp::DNSMasqServer::write_hosts_file()
+{
+    std::ofstream hosts_file{hosts_file_path.toStdString(), std::ios::trunc};
+    for (const auto& reservation : reservations->entries)
+        hosts_file << reservation.first << "," << reservation.second.as_string() << "\n";
+}
+
+void mp::DNSMasqServer::signal_dnsmasq()
+{
+    try
+    {
+        auto dnsmasq_pid = get_dnsmasq_pid(pid_file_path);
+        kill(dnsmasq_pid, SIGHUP);
+    }
+    catch (const std::exception&)
+    {
+        // not running yet - it will read the hosts file on startup
+    }
+}
+
 void mp::DNSMasqServer::check_dnsmasq_running()
 {
     try
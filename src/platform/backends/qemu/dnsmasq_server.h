@@ -22,10 +22,13 @@
 #include <multipass/optional.h>
 #include <multipass/path.h>
 
+#include <QDateTime>
 #include <QTemporaryFile>
 
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 
 namespace multipass
 {
@@ -39,18 +42,43 @@ public:
     ~DNSMasqServer();
 
     optional<IPAddress> get_ip_for(const std::string& hw_addr);
+    IPAddress reserve_ip_for(const std::string& hw_addr);
     void release_mac(const std::string& hw_addr);
     void check_dnsmasq_running();
 
 private:
+    struct LeaseCache
+    {
+        std::mutex mutex;
+        QDateTime last_modified;
+        bool stale{true};    // set by the FileWatcher callback; cleared on reload
+        bool watched{false}; // without a watch, staleness is checked against the file's mtime per lookup
+        std::unordered_map<std::string, IPAddress> entries;
+    };
+
+    struct HostReservations
+    {
+        std::mutex mutex;
+        std::unordered_map<std::string, IPAddress> entries;
+    };
+
     void start_dnsmasq();
+    optional<IPAddress> ip_from_lease(const std::string& hw_addr);
+    void reload_lease_cache(); // lease_cache->mutex must be held
+    void load_host_reservations();
+    void write_hosts_file(); // reservations->mutex must be held
+    void signal_dnsmasq();
 
     const QString data_dir;
     const QString bridge_name;
     const QString pid_file_path;
+    const QString hosts_file_path;
+    const QString leases_file_path;
     const std::string subnet;
     std::unique_ptr<Process> dnsmasq_cmd;
     QTemporaryFile conf_file;
+    std::unique_ptr<LeaseCache> lease_cache{std::make_unique<LeaseCache>()}; // indirection keeps the server movable
+    std::unique_ptr<HostReservations> reservations{std::make_unique<HostReservations>()};
 };
 } // namespace multipass
 #endif // MULTIPASS_DNSMASQ_SERVER_H
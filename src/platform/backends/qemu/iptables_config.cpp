@@ -20,8 +20,13 @@
 #include <multipass/format.h>
 #include <multipass/logging/log.h>
 #include <multipass/process.h>
+#include <multipass/tracing/trace_recorder.h>
 #include <shared/linux/process_factory.h>
 
+#include <QCryptographicHash>
+
+#include <utility>
+
 namespace mp = multipass;
 namespace mpl = multipass::logging;
 
@@ -29,6 +34,7 @@ namespace
 {
 // QString constants for all of the different iptables calls
 const QString iptables{QStringLiteral("iptables")};
+const QString iptables_restore{QStringLiteral("iptables-restore")};
 const QString negate{QStringLiteral("!")};
 
 //   Different tables to use
@@ -39,12 +45,16 @@ const QString mangle{QStringLiteral("mangle")};
 //   Chain constants
 const QString INPUT{QStringLiteral("INPUT")};
 const QString OUTPUT{QStringLiteral("OUTPUT")};
+const QString PREROUTING{QStringLiteral("PREROUTING")};
 const QString POSTROUTING{QStringLiteral("POSTROUTING")};
 const QString FORWARD{QStringLiteral("FORWARD")};
+const QString portfwd_chain{QStringLiteral("MULTIPASS-PORTFWD")};
 
 //   option constants
 const QString destination{QStringLiteral("--destination")};
+const QString delete_chain{QStringLiteral("--delete-chain")};
 const QString delete_rule{QStringLiteral("--delete")};
+const QString flush_chain{QStringLiteral("--flush")};
 const QString in_interface{QStringLiteral("--in-interface")};
 const QString append_rule{QStringLiteral("--append")};
 const QString insert_rule{QStringLiteral("--insert")};
@@ -56,6 +66,7 @@ const QString source{QStringLiteral("--source")};
 const QString list_rules{QStringLiteral("--list-rules")};
 const QString dash_t{QStringLiteral("-t")}; // Use short option for specifying table to avoid var conflicts
 const QString wait{QStringLiteral("--wait")};
+const QString noflush{QStringLiteral("--noflush")};
 
 //   protocol constants
 const QString udp{QStringLiteral("udp")};
@@ -64,6 +75,7 @@ const QString tcp{QStringLiteral("tcp")};
 //   port options and constants
 const QString dport{QStringLiteral("--dport")};
 const QString sport{QStringLiteral("--sport")};
+const QString to_destination{QStringLiteral("--to-destination")};
 const QString to_ports{QStringLiteral("--to-ports")};
 const QString port_53{QStringLiteral("53")};
 const QString port_67{QStringLiteral("67")};
@@ -72,6 +84,7 @@ const QString port_range{QStringLiteral("1024-65535")};
 
 //   rule target constants
 const QString ACCEPT{QStringLiteral("ACCEPT")};
+const QString DNAT{QStringLiteral("DNAT")};
 const QString MASQUERADE{QStringLiteral("MASQUERADE")};
 const QString REJECT{QStringLiteral("REJECT")};
 const QString RETURN{QStringLiteral("RETURN")};
@@ -85,16 +98,29 @@ auto multipass_iptables_comment(const QString& bridge_name)
     return QString("generated for Multipass network %1").arg(bridge_name);
 }
 
-void add_iptables_rule(const QString& table, const QString& chain, const QStringList& rule, bool append = false)
+// Collects a rule as a line in iptables-restore format; like the individual iptables calls these
+// replace, inserts go to the head of the chain and appends to the tail, in the order given
+void add_iptables_rule(QStringList& table_rules, const QString& chain, const QStringList& rule, bool append = false)
 {
-    auto process = mp::ProcessFactory::instance().create_process(
-        iptables, QStringList() << wait << dash_t << table << (append ? append_rule : insert_rule) << chain << rule);
+    table_rules << QString("%1 %2 %3").arg(append ? append_rule : insert_rule, chain, rule.join(' '));
+}
 
-    auto exit_state = process->execute();
+void apply_iptables_rules(const QString& payload)
+{
+    auto process = mp::ProcessFactory::instance().create_process(iptables_restore, QStringList() << wait << noflush);
+
+    process->start();
+    if (!process->wait_for_started())
+        throw std::runtime_error("Failed to start iptables-restore");
 
+    process->write(payload.toUtf8());
+    process->close_write_channel();
+    process->wait_for_finished();
+
+    auto exit_state = process->process_state();
     if (!exit_state.completed_successfully())
         throw std::runtime_error(
-            fmt::format("Failed to set iptables rule for table {}: {}", table, process->read_all_standard_error()));
+            fmt::format("Failed to set iptables rules: {}", process->read_all_standard_error()));
 }
 
 void delete_iptables_rule(const QString& table, const QStringList& chain_and_rule)
@@ -125,88 +151,119 @@ auto get_iptables_rules(const QString& table)
     return process->read_all_standard_output();
 }
 
-void set_iptables_rules(const QString& bridge_name, const QString& cidr, const QString& comment)
+// Builds the whole ruleset in iptables-restore format, one atomic transaction per table
+QString build_iptables_payload(const QString& bridge_name, const QString& cidr, const QString& comment)
 {
-    const QStringList comment_option{match, QStringLiteral("comment"), QStringLiteral("--comment"), comment};
+    // the comment contains spaces, so it needs quoting to survive the iptables-restore line parser
+    const QStringList comment_option{match, QStringLiteral("comment"), QStringLiteral("--comment"),
+                                     QString("\"%1\"").arg(comment)};
+
+    QStringList filter_rules, nat_rules, mangle_rules;
+
+    // The port-forwarding table lives in its own chain, declared here and (re)filled atomically by
+    // set_port_forwards; PREROUTING covers remote clients, OUTPUT the host's own loopback traffic
+    nat_rules << QString(":%1 - [0:0]").arg(portfwd_chain);
+    add_iptables_rule(nat_rules, PREROUTING, QStringList() << jump << portfwd_chain << comment_option);
+    add_iptables_rule(nat_rules, OUTPUT, QStringList() << jump << portfwd_chain << comment_option);
 
     // Setup basic iptables overrides for DHCP/DNS
-    add_iptables_rule(filter, INPUT,
+    add_iptables_rule(filter_rules, INPUT,
                       QStringList() << in_interface << bridge_name << protocol << udp << dport << port_67 << jump
                                     << ACCEPT << comment_option);
 
-    add_iptables_rule(filter, INPUT,
+    add_iptables_rule(filter_rules, INPUT,
                       QStringList() << in_interface << bridge_name << protocol << udp << dport << port_53 << jump
                                     << ACCEPT << comment_option);
 
-    add_iptables_rule(filter, INPUT,
+    add_iptables_rule(filter_rules, INPUT,
                       QStringList() << in_interface << bridge_name << protocol << tcp << dport << port_53 << jump
                                     << ACCEPT << comment_option);
 
-    add_iptables_rule(filter, OUTPUT,
+    add_iptables_rule(filter_rules, OUTPUT,
                       QStringList() << out_interface << bridge_name << protocol << udp << sport << port_67 << jump
                                     << ACCEPT << comment_option);
 
-    add_iptables_rule(filter, OUTPUT,
+    add_iptables_rule(filter_rules, OUTPUT,
                       QStringList() << out_interface << bridge_name << protocol << udp << sport << port_53 << jump
                                     << ACCEPT << comment_option);
 
-    add_iptables_rule(filter, OUTPUT,
+    add_iptables_rule(filter_rules, OUTPUT,
                       QStringList() << out_interface << bridge_name << protocol << tcp << sport << port_53 << jump
                                     << ACCEPT << comment_option);
 
-    add_iptables_rule(mangle, POSTROUTING,
+    add_iptables_rule(mangle_rules, POSTROUTING,
                       QStringList() << out_interface << bridge_name << protocol << udp << dport << port_68 << jump
                                     << QStringLiteral("CHECKSUM") << QStringLiteral("--checksum-fill")
                                     << comment_option);
 
     // Do not masquerade to these reserved address blocks.
-    add_iptables_rule(nat, POSTROUTING,
+    add_iptables_rule(nat_rules, POSTROUTING,
                       QStringList() << source << cidr << destination << QStringLiteral("224.0.0.0/24") << jump << RETURN
                                     << comment_option);
 
-    add_iptables_rule(nat, POSTROUTING,
+    add_iptables_rule(nat_rules, POSTROUTING,
                       QStringList() << source << cidr << destination << QStringLiteral("255.255.255.255/32") << jump
                                     << RETURN << comment_option);
 
     // Masquerade all packets going from VMs to the LAN/Internet
-    add_iptables_rule(nat, POSTROUTING,
+    add_iptables_rule(nat_rules, POSTROUTING,
                       QStringList() << source << cidr << negate << destination << cidr << protocol << tcp << jump
                                     << MASQUERADE << to_ports << port_range << comment_option);
 
-    add_iptables_rule(nat, POSTROUTING,
+    add_iptables_rule(nat_rules, POSTROUTING,
                       QStringList() << source << cidr << negate << destination << cidr << protocol << udp << jump
                                     << MASQUERADE << to_ports << port_range << comment_option);
 
-    add_iptables_rule(nat, POSTROUTING,
+    add_iptables_rule(nat_rules, POSTROUTING,
                       QStringList() << source << cidr << negate << destination << cidr << jump << MASQUERADE
                                     << comment_option);
 
     // Allow established traffic to the private subnet
-    add_iptables_rule(filter, FORWARD,
+    add_iptables_rule(filter_rules, FORWARD,
                       QStringList() << destination << cidr << out_interface << bridge_name << match
                                     << QStringLiteral("conntrack") << QStringLiteral("--ctstate")
                                     << QStringLiteral("RELATED,ESTABLISHED") << jump << ACCEPT << comment_option);
 
     // Allow outbound traffic from the private subnet
-    add_iptables_rule(filter, FORWARD,
+    add_iptables_rule(filter_rules, FORWARD,
                       QStringList() << source << cidr << in_interface << bridge_name << jump << ACCEPT
                                     << comment_option);
 
     // Allow traffic between virtual machines
-    add_iptables_rule(filter, FORWARD,
+    add_iptables_rule(filter_rules, FORWARD,
                       QStringList() << in_interface << bridge_name << out_interface << bridge_name << jump << ACCEPT
                                     << comment_option);
 
     // Reject everything else
-    add_iptables_rule(filter, FORWARD,
+    add_iptables_rule(filter_rules, FORWARD,
                       QStringList() << in_interface << bridge_name << jump << REJECT << reject_with
                                     << icmp_port_unreachable << comment_option,
                       /*append=*/true);
 
-    add_iptables_rule(filter, FORWARD,
+    add_iptables_rule(filter_rules, FORWARD,
                       QStringList() << out_interface << bridge_name << jump << REJECT << reject_with
                                     << icmp_port_unreachable << comment_option,
                       /*append=*/true);
+
+    QString payload;
+    for (const auto& table : {std::make_pair(filter, filter_rules), std::make_pair(nat, nat_rules),
+                              std::make_pair(mangle, mangle_rules)})
+    {
+        payload += QString("*%1\n%2\nCOMMIT\n").arg(table.first, table.second.join('\n'));
+    }
+
+    return payload;
+}
+
+// Counts the live rules carrying the given comment across our tables; matching the number we would
+// program means the previous run's ruleset is still in place, verbatim
+int count_live_rules_with(const QString& comment)
+{
+    auto count = 0;
+    for (const auto& table : {filter, nat, mangle})
+        count += QString::fromUtf8(get_iptables_rules(table)).count(comment);
+
+    return count;
 }
 
 void clear_iptables_rules_for(const QString& table, const QString& bridge_name, const QString& cidr,
@@ -233,10 +290,29 @@ mp::IPTablesConfig::IPTablesConfig(const QString& bridge_name, const std::string
       cidr{QString("%1.0/24").arg(QString::fromStdString(subnet))},
       comment{multipass_iptables_comment(bridge_name)}
 {
+    MP_TRACE_SPAN("IPTablesConfig::IPTablesConfig");
     try
     {
-        clear_all_iptables_rules();
-        set_iptables_rules(bridge_name, cidr, comment);
+        /* The comment on every rule is tagged with a stamp of the ruleset's content, so a restart can
+           tell at a glance whether the rules left by the previous run are exactly the ones it would
+           program. On the common path (same bridge, subnet and rule shape) startup then costs three
+           list-rules reads instead of the whole teardown-and-reprogram dance; any mismatch — a changed
+           subnet, an older version's rules, a partial set — falls through to the full rebuild. */
+        const auto probe = build_iptables_payload(bridge_name, cidr, comment);
+        const auto stamp = QCryptographicHash::hash(probe.toUtf8(), QCryptographicHash::Sha1).toHex().left(8);
+        const auto stamped_comment = QString("%1 [%2]").arg(comment, QString::fromUtf8(stamp));
+        const auto payload = build_iptables_payload(bridge_name, cidr, stamped_comment);
+
+        if (count_live_rules_with(stamped_comment) == payload.count(stamped_comment))
+        {
+            mpl::log(mpl::Level::debug, "iptables",
+                     "ruleset from the previous run is still in place; leaving it as is");
+        }
+        else
+        {
+            clear_all_iptables_rules(); // matches on the untagged comment, catching old-format rules too
+            apply_iptables_rules(payload);
+        }
     }
     catch (const std::exception& e)
     {
@@ -266,9 +342,45 @@ void mp::IPTablesConfig::verify_iptables_rules()
     }
 }
 
+void mp::IPTablesConfig::set_port_forwards(const std::vector<PortForward>& forwards)
+{
+    verify_iptables_rules();
+
+    const QStringList comment_option{match, QStringLiteral("comment"), QStringLiteral("--comment"),
+                                     QString("\"%1\"").arg(comment)};
+
+    // Replacing just our chain in one transaction: --noflush leaves the rest of the ruleset alone while
+    // the explicit flush below swaps the whole forwarding table in, instead of an iptables fork per rule
+    // tearing it down and back up
+    QStringList lines{QString("%1 %2").arg(flush_chain, portfwd_chain)};
+    for (const auto& forward : forwards)
+    {
+        lines << QString("%1 %2 %3")
+                     .arg(append_rule, portfwd_chain,
+                          (QStringList() << protocol << forward.protocol << dport
+                                         << QString::number(forward.host_port) << jump << DNAT << to_destination
+                                         << QString("%1:%2")
+                                                .arg(QString::fromStdString(forward.instance_ip.as_string()))
+                                                .arg(forward.instance_port)
+                                         << comment_option)
+                              .join(' '));
+    }
+
+    apply_iptables_rules(QString("*%1\n%2\nCOMMIT\n").arg(nat, lines.join('\n')));
+}
+
 void mp::IPTablesConfig::clear_all_iptables_rules()
 {
     clear_iptables_rules_for(filter, bridge_name, cidr, comment);
     clear_iptables_rules_for(nat, bridge_name, cidr, comment);
     clear_iptables_rules_for(mangle, bridge_name, cidr, comment);
+
+    // best effort: the forwarding chain lingers empty once its rules are cleared above; it may also not
+    // exist at all, e.g. on rules left behind by older versions
+    auto process = mp::ProcessFactory::instance().create_process(
+        iptables, QStringList() << wait << dash_t << nat << flush_chain << portfwd_chain);
+    process->execute();
+    process = mp::ProcessFactory::instance().create_process(
+        iptables, QStringList() << wait << dash_t << nat << delete_chain << portfwd_chain);
+    process->execute();
 }
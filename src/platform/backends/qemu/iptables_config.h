@@ -18,12 +18,23 @@
 #ifndef MULTIPASS_IPTABLES_CONFIG_H
 #define MULTIPASS_IPTABLES_CONFIG_H
 
+#include <multipass/ip_address.h>
+
 #include <string>
+#include <vector>
 
 #include <QString>
 
 namespace multipass
 {
+struct PortForward
+{
+    QString protocol; // tcp or udp
+    int host_port;
+    IPAddress instance_ip;
+    int instance_port;
+};
+
 class IPTablesConfig
 {
 public:
@@ -32,6 +43,10 @@ public:
 
     void verify_iptables_rules();
 
+    // Replaces the whole forwarding table (host port -> instance address) in one atomic transaction;
+    // the rules live in a dedicated chain, so updates leave the base NAT/filter rules undisturbed
+    void set_port_forwards(const std::vector<PortForward>& forwards);
+
 private:
     void clear_all_iptables_rules();
 
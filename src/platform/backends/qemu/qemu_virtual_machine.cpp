@@ -27,25 +27,38 @@
 #include <multipass/logging/log.h>
 #include <multipass/process.h>
 #include <multipass/ssh/ssh_session.h>
+#include <multipass/tracing/trace_recorder.h>
 #include <multipass/utils.h>
 #include <multipass/vm_status_monitor.h>
 
 #include <multipass/format.h>
 
 #include <QCoreApplication>
+#include <QDir>
 #include <QFile>
+#include <QFileInfo>
 #include <QHash>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QLocalSocket>
 #include <QProcess>
 #include <QString>
 #include <QStringList>
 #include <QSysInfo>
 #include <QTemporaryFile>
+#include <QtEndian>
 
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
 #include <thread>
 
+#include <sched.h>
+#include <unistd.h>
+
 namespace mp = multipass;
 namespace mpl = multipass::logging;
 
@@ -84,8 +97,45 @@ QStringList get_arguments(const QJsonObject& metadata)
     return args;
 }
 
+auto cpu_set_from_list(const QString& cpulist)
+{
+    // the kernel's cpu list format: comma-separated decimals and inclusive ranges, e.g. "0-7,16-23"
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    for (const auto& part : cpulist.split(','))
+    {
+        const auto range = part.split('-');
+        const auto first = range.first().toInt();
+        const auto last = range.last().toInt();
+        for (auto cpu = first; cpu <= last; ++cpu)
+            CPU_SET(cpu, &cpus);
+    }
+
+    return cpus;
+}
+
+// Affinity is per thread and qemu spawns its vcpu threads during machine init, so pin every thread the
+// process has by now — anything created later inherits the mask from the thread that spawns it. Pinning
+// is best effort: a failure costs locality, not the instance.
+void pin_to_cpus(qint64 pid, const QString& cpulist, const std::string& vm_name)
+{
+    const auto cpus = cpu_set_from_list(cpulist);
+    const auto tids = QDir{QString("/proc/%1/task").arg(pid)}.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const auto& tid : tids)
+    {
+        if (sched_setaffinity(tid.toInt(), sizeof(cpus), &cpus) != 0)
+        {
+            mpl::log(mpl::Level::warning, vm_name,
+                     fmt::format("Could not pin to host cpus {}: {}", cpulist, strerror(errno)));
+            return;
+        }
+    }
+
+    mpl::log(mpl::Level::info, vm_name, fmt::format("pinned to host cpus {}", cpulist));
+}
+
 auto make_qemu_process(const mp::VirtualMachineDescription& desc, const mp::optional<QJsonObject>& resume_metadata,
-                       const std::string& tap_device_name)
+                       const std::string& tap_device_name, const mp::optional<mp::backend::NumaNode>& numa_node)
 {
     if (!QFile::exists(desc.image.image_path) || !QFile::exists(desc.cloud_init_iso))
     {
@@ -100,8 +150,8 @@ auto make_qemu_process(const mp::VirtualMachineDescription& desc, const mp::opti
                                                         get_arguments(data)};
     }
 
-    auto process_spec =
-        std::make_unique<mp::QemuVMProcessSpec>(desc, QString::fromStdString(tap_device_name), resume_data);
+    auto process_spec = std::make_unique<mp::QemuVMProcessSpec>(desc, QString::fromStdString(tap_device_name),
+                                                                resume_data, numa_node);
     auto process = mp::ProcessFactory::instance().create_process(std::move(process_spec));
 
     mpl::log(mpl::Level::debug, desc.vm_name, fmt::format("process working dir '{}'", process->working_directory()));
@@ -125,6 +175,61 @@ auto qmp_execute_json(const QString& cmd)
     return QJsonDocument(qmp).toJson();
 }
 
+constexpr auto qga_short_timeout = 250;   // ms; the agent answers locally, so keep the SSH fallback quick
+constexpr auto qga_exec_timeout = 2000;   // ms; cap on a whole guest command, from dispatch to collected output
+constexpr auto qga_freeze_timeout = 1000; // ms; fsfreeze flushes the guest's dirty data, give it a moment
+constexpr auto snapshot_wait_timeout = 5000; // ms; cap on waiting for a live snapshot to land in the image
+
+auto qga_command(const QString& name, const QJsonObject& arguments = QJsonObject{})
+{
+    QJsonObject command{{"execute", name}};
+    if (!arguments.isEmpty())
+        command.insert("arguments", arguments);
+    return QJsonDocument{command}.toJson(QJsonDocument::Compact);
+}
+
+// Sends one guest-agent command and waits for its reply, skipping any events or stale replies in between.
+// The agent speaks newline-delimited JSON over the virtio-serial channel.
+mp::optional<QJsonObject> qga_transact(QLocalSocket& sock, const QByteArray& command, int timeout_ms)
+{
+    sock.write(command + '\n');
+    if (!sock.waitForBytesWritten(timeout_ms))
+        return mp::nullopt;
+
+    QByteArray buffer;
+    while (sock.waitForReadyRead(timeout_ms))
+    {
+        buffer += sock.readAll();
+
+        int newline;
+        while ((newline = buffer.indexOf('\n')) >= 0)
+        {
+            const auto reply = QJsonDocument::fromJson(buffer.left(newline)).object();
+            buffer.remove(0, newline + 1);
+            if (reply.contains("error"))
+                return mp::nullopt;
+            if (reply.contains("return"))
+                return mp::optional<QJsonObject>{reply};
+        }
+    }
+
+    return mp::nullopt;
+}
+
+// Connects to the instance's guest-agent channel and runs a guest-sync, which both flushes any partial
+// reply a previous client left in the channel and detects an absent or stuck agent up front
+bool qga_connect_and_sync(QLocalSocket& sock, const QString& socket_path)
+{
+    sock.connectToServer(socket_path);
+    if (!sock.waitForConnected(qga_short_timeout))
+        return false; // machines resumed from pre-channel suspends have no agent port
+
+    static std::atomic<int> sync_ids{0};
+    const auto sync_id = ++sync_ids;
+    const auto sync = qga_transact(sock, qga_command("guest-sync", QJsonObject{{"id", sync_id}}), qga_short_timeout);
+    return sync && sync->value("return").toInt() == sync_id;
+}
+
 auto hmc_to_qmp_json(const QString& command_line)
 {
     auto qmp = QJsonDocument::fromJson(qmp_execute_json("human-monitor-command")).object();
@@ -137,8 +242,63 @@ auto hmc_to_qmp_json(const QString& command_line)
     return QJsonDocument(qmp).toJson();
 }
 
+/* Walks the qcow2 snapshot table in-process, looking for an entry with the given name. The layout is
+   fixed (see docs/interop/qcow2.txt in qemu): the header holds the snapshot count (u32 at offset 56,
+   big-endian like everything else) and the table offset (u64 at 64); each table entry is a 40-byte
+   fixed part followed by extra data, id string and name, padded to 8 bytes. Returns nullopt when
+   anything looks off, so the caller can fall back on qemu-img rather than guess. */
+mp::optional<bool> snapshot_table_contains(const mp::Path& image_path, const QByteArray& name)
+{
+    QFile image_file{image_path};
+    if (!image_file.open(QIODevice::ReadOnly))
+        return mp::nullopt;
+
+    const auto header = image_file.read(72);
+    if (header.size() < 72 || !header.startsWith(QByteArrayLiteral("QFI\xfb")))
+        return mp::nullopt;
+
+    const auto nb_snapshots = qFromBigEndian<quint32>(header.constData() + 56);
+    if (nb_snapshots == 0)
+        return false;
+
+    auto offset = qFromBigEndian<quint64>(header.constData() + 64);
+    for (quint32 i = 0; i < nb_snapshots; ++i)
+    {
+        if (!image_file.seek(offset))
+            return mp::nullopt;
+
+        const auto entry = image_file.read(40);
+        if (entry.size() < 40)
+            return mp::nullopt;
+
+        const auto id_str_size = qFromBigEndian<quint16>(entry.constData() + 12);
+        const auto name_size = qFromBigEndian<quint16>(entry.constData() + 14);
+        const auto extra_data_size = qFromBigEndian<quint32>(entry.constData() + 36);
+
+        if (!image_file.seek(offset + 40 + extra_data_size + id_str_size))
+            return mp::nullopt;
+
+        const auto entry_name = image_file.read(name_size);
+        if (entry_name.size() < name_size)
+            return mp::nullopt;
+
+        if (entry_name == name)
+            return true;
+
+        const quint64 entry_size = 40u + extra_data_size + id_str_size + name_size;
+        offset += (entry_size + 7) & ~quint64{7};
+    }
+
+    return false;
+}
+
 bool instance_image_has_snapshot(const mp::Path& image_path)
 {
+    // Answer from the image header directly when possible; each qemu-img run is a fork/exec plus a
+    // full image open, and this check sits on every start/resume decision
+    if (const auto found = snapshot_table_contains(image_path, QByteArray{suspend_tag}))
+        return *found;
+
     auto process = mp::ProcessFactory::instance().create_process("qemu-img", QStringList{"snapshot", "-l", image_path});
     auto process_state = process->execute();
     if (!process_state.completed_successfully())
@@ -160,7 +320,7 @@ bool instance_image_has_snapshot(const mp::Path& image_path)
     return false;
 }
 
-auto get_qemu_machine_type()
+QString probe_qemu_machine_type()
 {
     QTemporaryFile dump_file;
     if (!dump_file.open())
@@ -185,6 +345,14 @@ auto get_qemu_machine_type()
     return machine_type;
 }
 
+auto get_qemu_machine_type()
+{
+    // invariant for a given qemu build, and discovering it costs a whole qemu-system spawn — so one
+    // probe per daemon run serves every instance (a failed probe is retried on the next call)
+    static const auto machine_type = probe_qemu_machine_type();
+    return machine_type;
+}
+
 auto generate_metadata(const QStringList& args)
 {
     QJsonObject metadata;
@@ -211,6 +379,10 @@ mp::QemuVirtualMachine::QemuVirtualMachine(const VirtualMachineDescription& desc
                          delete_memory_snapshot = false;
                      },
                      Qt::QueuedConnection);
+
+    // reserve the instance's address up front - the IP is then known before the first boot, instead of
+    // being discovered from the lease file once the guest's DHCP exchange completes
+    ip.emplace(dnsmasq_server.reserve_ip_for(mac_addr));
 }
 
 mp::QemuVirtualMachine::~QemuVirtualMachine()
@@ -219,8 +391,9 @@ mp::QemuVirtualMachine::~QemuVirtualMachine()
     {
         update_shutdown_status = false;
 
-        if (state == State::running)
-        {
+        if (state == State::running || state == State::delayed_shutdown)
+        { // snapshot the memory so the workload survives the daemon going away; the spec DB still says
+          // running, so the next daemon start resumes the instance right where it left off
             suspend();
         }
         else
@@ -228,7 +401,7 @@ mp::QemuVirtualMachine::~QemuVirtualMachine()
             shutdown();
         }
 
-        vm_process->wait_for_finished();
+        vm_process->wait_for_finished(-1); // a suspend in progress may still be writing the snapshot
     }
 
     remove_tap_device(QString::fromStdString(tap_device_name));
@@ -242,6 +415,8 @@ void mp::QemuVirtualMachine::start()
     if (state == State::suspending)
         throw std::runtime_error("cannot start the instance while suspending");
 
+    MP_TRACE_SPAN("QemuVirtualMachine::start");
+
     initialize_vm_process();
 
     if (state == State::suspended)
@@ -253,7 +428,14 @@ void mp::QemuVirtualMachine::start()
     }
     else
     {
-        monitor->update_metadata_for(vm_name, generate_metadata(vm_process->arguments()));
+        auto metadata = generate_metadata(vm_process->arguments());
+        if (monitor->retrieve_metadata_for(vm_name) != metadata) // same arguments as last boot: skip the DB write
+            monitor->update_metadata_for(vm_name, metadata);
+
+        // warm the page cache with the blocks the last boot needed, and snapshot the new boot's set
+        // once SSH is up (see wait_until_ssh_up) — boot storms then read ahead instead of faulting
+        mp::backend::prefetch_boot_regions(desc.image.image_path);
+        capture_boot_regions = true;
     }
 
     vm_process->start();
@@ -276,6 +458,9 @@ void mp::QemuVirtualMachine::start()
         }
     }
 
+    if (numa_node)
+        pin_to_cpus(vm_process->process_id(), numa_node->cpulist, vm_name);
+
     vm_process->write(qmp_execute_json("qmp_capabilities"));
 }
 
@@ -313,6 +498,22 @@ void mp::QemuVirtualMachine::suspend()
 {
     if ((state == State::running || state == State::delayed_shutdown) && vm_process->running())
     {
+        /* savevm rides the migration machinery, so the compress capability applies to it: guest RAM is
+           deflated on its way into the qcow2, shrinking both the state written on suspend and the bytes
+           read back on resume (decompression needs no setup there). Level 1 favors speed over ratio —
+           untouched guest pages compress to nearly nothing at any level. */
+        auto capabilities = QJsonDocument::fromJson(qmp_execute_json("migrate-set-capabilities")).object();
+        capabilities.insert(
+            "arguments",
+            QJsonObject{{"capabilities",
+                         QJsonArray{QJsonObject{{"capability", QStringLiteral("compress")}, {"state", true}}}}});
+        vm_process->write(QJsonDocument(capabilities).toJson());
+
+        auto parameters = QJsonDocument::fromJson(qmp_execute_json("migrate-set-parameters")).object();
+        parameters.insert("arguments", QJsonObject{{"compress-level", 1},
+                                                   {"compress-threads", std::min(desc.num_cores, 4)}});
+        vm_process->write(QJsonDocument(parameters).toJson());
+
         vm_process->write(hmc_to_qmp_json("savevm " + QString::fromStdString(suspend_tag)));
 
         if (update_shutdown_status)
@@ -321,7 +522,9 @@ void mp::QemuVirtualMachine::suspend()
             update_state();
 
             update_shutdown_status = false;
-            vm_process->wait_for_finished();
+            // savevm of a large-memory instance can take minutes; the default 30s wait would abandon
+            // the process mid-snapshot and leave a corrupt suspend image behind
+            vm_process->wait_for_finished(-1);
             vm_process.reset(nullptr);
         }
     }
@@ -347,6 +550,205 @@ void mp::QemuVirtualMachine::update_state()
     monitor->persist_state_for(vm_name, state);
 }
 
+void mp::QemuVirtualMachine::update_resources(int num_cores, const MemorySize& mem_size)
+{
+    /* The qemu arguments are rebuilt from desc on every cold boot, so storing the new values is all it takes
+       for them to apply then. Hot-plugging instead would require the machine to have been started with
+       maxmem/slots headroom, which these instances are not. */
+    desc.num_cores = num_cores;
+    desc.mem_size = mem_size;
+}
+
+void mp::QemuVirtualMachine::update_io_limits(long long iops, long long bytes_per_second)
+{
+    desc.io_limits = {iops, bytes_per_second}; // cold boots rebuild the throttles from desc
+
+    if (vm_process && (state == State::running || state == State::delayed_shutdown))
+    {
+        // Unlike cores and memory, throttles can change on a live machine: qemu retunes the block device's
+        // throttle state on the fly. The drive id only exists on machines booted with the current argument
+        // set; on one resumed from legacy arguments qemu just reports an error, leaving the limits as they were.
+        QJsonObject arguments;
+        arguments.insert("device", "hda");
+        arguments.insert("iops", iops);
+        arguments.insert("iops_rd", 0);
+        arguments.insert("iops_wr", 0);
+        arguments.insert("bps", bytes_per_second);
+        arguments.insert("bps_rd", 0);
+        arguments.insert("bps_wr", 0);
+
+        auto qmp = QJsonDocument::fromJson(qmp_execute_json("block_set_io_throttle")).object();
+        qmp.insert("arguments", arguments);
+        vm_process->write(QJsonDocument(qmp).toJson());
+    }
+}
+
+mp::optional<std::string> mp::QemuVirtualMachine::run_in_guest(const std::string& cmd)
+{
+    if (!vm_process || (state != State::running && state != State::delayed_shutdown))
+        return mp::nullopt;
+
+    QLocalSocket sock;
+    if (!qga_connect_and_sync(sock, QemuVMProcessSpec::guest_agent_socket_path(desc)))
+        return mp::nullopt;
+
+    const QJsonObject exec_arguments{{"path", QStringLiteral("/bin/sh")},
+                                     {"arg", QJsonArray{QStringLiteral("-c"), QString::fromStdString(cmd)}},
+                                     {"capture-output", true}};
+    const auto exec = qga_transact(sock, qga_command("guest-exec", exec_arguments), qga_short_timeout);
+    if (!exec)
+        return mp::nullopt;
+
+    const auto pid = exec->value("return").toObject().value("pid").toInt();
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds{qga_exec_timeout};
+    while (std::chrono::steady_clock::now() < deadline)
+    {
+        const auto status =
+            qga_transact(sock, qga_command("guest-exec-status", QJsonObject{{"pid", pid}}), qga_short_timeout);
+        if (!status)
+            return mp::nullopt;
+
+        const auto ret = status->value("return").toObject();
+        if (ret.value("exited").toBool())
+        {
+            if (ret.value("exitcode").toInt() != 0)
+                return mp::nullopt; // let the caller's fallback report the failure
+
+            return mp::optional<std::string>{
+                QByteArray::fromBase64(ret.value("out-data").toString().toLatin1()).toStdString()};
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    }
+
+    return mp::nullopt;
+}
+
+bool mp::QemuVirtualMachine::take_live_snapshot(const std::string& snapshot_name)
+{
+    if (!vm_process || (state != State::running && state != State::delayed_shutdown))
+        return false;
+
+    /* Quiesce the guest's filesystems around the snapshot when the agent channel answers; without it the
+       snapshot is merely crash-consistent, which still beats a stop/snapshot/start cycle, so proceed
+       either way. The freeze window is bounded below: it lasts only until the snapshot's entry shows up
+       in the image, typically milliseconds for a metadata-only internal snapshot. */
+    QLocalSocket sock;
+    const auto frozen = qga_connect_and_sync(sock, QemuVMProcessSpec::guest_agent_socket_path(desc)) &&
+                        qga_transact(sock, qga_command("guest-fsfreeze-freeze"), qga_freeze_timeout).has_value();
+    if (!frozen)
+        mpl::log(mpl::Level::warning, vm_name,
+                 "no guest agent answered; taking a crash-consistent snapshot without quiescing");
+
+    vm_process->write(
+        hmc_to_qmp_json(QString("snapshot_blkdev_internal hda %1").arg(QString::fromStdString(snapshot_name))));
+
+    // The monitor's reply arrives asynchronously on the event stream, but the snapshot's entry in the
+    // image's own table is the authoritative sign of completion — poll for it so the freeze ends as soon
+    // as the metadata lands rather than after a fixed wait
+    auto done = false;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds{snapshot_wait_timeout};
+    while (!done && std::chrono::steady_clock::now() < deadline)
+    {
+        done = snapshot_table_contains(desc.image.image_path, QByteArray::fromStdString(snapshot_name)) ==
+               mp::optional<bool>{true};
+        if (!done)
+            std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    }
+
+    if (frozen)
+        qga_transact(sock, qga_command("guest-fsfreeze-thaw"), qga_freeze_timeout);
+
+    return done;
+}
+
+auto mp::QemuVirtualMachine::host_resource_usage() -> optional<HostResourceUsage>
+{
+    if (!vm_process || !vm_process->running())
+        return mp::nullopt;
+
+    const auto pid = vm_process->process_id();
+    if (pid <= 0)
+        return mp::nullopt;
+
+    QFile stat_file{QString{"/proc/%1/stat"}.arg(pid)};
+    if (!stat_file.open(QIODevice::ReadOnly))
+        return mp::nullopt;
+
+    // utime/stime (fields 14/15) and rss (24) come after the parenthesized comm, which may contain spaces
+    const auto stat = stat_file.readAll();
+    const auto after_comm = stat.lastIndexOf(')');
+    if (after_comm < 0)
+        return mp::nullopt;
+
+    const auto fields = stat.mid(after_comm + 2).split(' '); // fields[0] is field 3, the state
+    if (fields.size() < 22)
+        return mp::nullopt;
+
+    auto ticks_per_second = ::sysconf(_SC_CLK_TCK);
+    if (ticks_per_second <= 0)
+        ticks_per_second = 100;
+
+    HostResourceUsage usage{};
+    usage.cpu_seconds = static_cast<double>(fields[11].toLongLong() + fields[12].toLongLong()) / ticks_per_second;
+    usage.rss_bytes = fields[21].toLongLong() * ::sysconf(_SC_PAGESIZE);
+
+    QFile io_file{QString{"/proc/%1/io"}.arg(pid)};
+    if (io_file.open(QIODevice::ReadOnly))
+    { // reading another process's io needs matching ownership; the -1 defaults stand when it is off limits
+        for (const auto& line : io_file.readAll().split('\n'))
+        {
+            if (line.startsWith("read_bytes:"))
+                usage.io_read_bytes = line.mid(sizeof("read_bytes:") - 1).trimmed().toLongLong();
+            else if (line.startsWith("write_bytes:"))
+                usage.io_write_bytes = line.mid(sizeof("write_bytes:") - 1).trimmed().toLongLong();
+        }
+    }
+
+    // the tap statistics are world-readable, so these are available even when /proc/<pid>/io is not
+    auto read_tap_counter = [this](const char* counter) -> long long {
+        QFile file{QString{"/sys/class/net/%1/statistics/%2"}.arg(QString::fromStdString(tap_device_name), counter)};
+        if (!file.open(QIODevice::ReadOnly))
+            return -1;
+        return file.readAll().trimmed().toLongLong();
+    };
+    usage.net_rx_bytes = read_tap_counter("rx_bytes");
+    usage.net_tx_bytes = read_tap_counter("tx_bytes");
+
+    return usage;
+}
+
+bool mp::QemuVirtualMachine::prepare_disk_compaction()
+{
+    if (state != State::off && state != State::stopped)
+        return false;
+
+    return mp::backend::create_compacted_image(desc.image.image_path, desc.image.image_path + ".compact");
+}
+
+long long mp::QemuVirtualMachine::commit_disk_compaction()
+{
+    const auto compacted_path = desc.image.image_path + ".compact";
+    if (!QFile::exists(compacted_path))
+        return 0;
+
+    if (state != State::off && state != State::stopped)
+    { // the instance came up since the copy was made, so the copy is stale
+        QFile::remove(compacted_path);
+        return 0;
+    }
+
+    const auto size_before = QFileInfo{desc.image.image_path}.size();
+    // rename(2) replaces the image atomically; on failure the original remains untouched
+    if (std::rename(compacted_path.toStdString().c_str(), desc.image.image_path.toStdString().c_str()) != 0)
+    {
+        QFile::remove(compacted_path);
+        return 0;
+    }
+
+    return size_before - QFileInfo{desc.image.image_path}.size();
+}
+
 void mp::QemuVirtualMachine::on_started()
 {
     state = State::starting;
@@ -463,17 +865,64 @@ void mp::QemuVirtualMachine::wait_until_ssh_up(std::chrono::milliseconds timeout
 {
     mp::utils::wait_until_ssh_up(this, timeout, std::bind(&QemuVirtualMachine::ensure_vm_is_running, this));
 
+    if (capture_boot_regions)
+    { // runs on the waiting thread, so the mincore scan stays off the daemon thread
+        mp::backend::record_boot_regions(desc.image.image_path);
+        capture_boot_regions = false;
+    }
+
     if (delete_memory_snapshot)
     {
         emit on_delete_memory_snapshot();
     }
 }
 
+void mp::QemuVirtualMachine::handle_qmp_line(const QByteArray& qmp_line)
+{
+    auto qmp_object = QJsonDocument::fromJson(qmp_line).object();
+    auto event = qmp_object["event"];
+
+    if (event.isNull())
+        return;
+
+    if (event.toString() == "RESET" && state != State::restarting)
+    {
+        mpl::log(mpl::Level::info, vm_name, "VM restarting");
+        on_restart();
+    }
+    else if (event.toString() == "POWERDOWN")
+    {
+        mpl::log(mpl::Level::info, vm_name, "VM powering down");
+    }
+    else if (event.toString() == "SHUTDOWN")
+    {
+        mpl::log(mpl::Level::info, vm_name, "VM shut down");
+    }
+    else if (event.toString() == "STOP")
+    {
+        mpl::log(mpl::Level::info, vm_name, "VM suspending");
+    }
+    else if (event.toString() == "RESUME")
+    {
+        mpl::log(mpl::Level::info, vm_name, "VM suspended");
+        if (state == State::suspending || state == State::running)
+        {
+            vm_process->kill();
+            on_suspend();
+        }
+    }
+}
+
 void mp::QemuVirtualMachine::initialize_vm_process()
 {
+    // Placement is decided afresh on every boot, so a restart naturally rebalances an instance onto
+    // whichever node has room now. Resumes keep the arguments the suspended machine was started with, and
+    // pinning vcpus against a possibly different memory binding would defeat the point — so skip those.
+    numa_node = (state == State::suspended) ? mp::nullopt : mp::backend::preferred_numa_node();
+
     vm_process = make_qemu_process(
         desc, ((state == State::suspended) ? mp::make_optional(monitor->retrieve_metadata_for(vm_name)) : mp::nullopt),
-        tap_device_name);
+        tap_device_name, numa_node);
 
     QObject::connect(vm_process.get(), &Process::started, [this]() {
         mpl::log(mpl::Level::info, vm_name, "process started");
@@ -481,39 +930,22 @@ void mp::QemuVirtualMachine::initialize_vm_process()
     });
 
     QObject::connect(vm_process.get(), &Process::ready_read_standard_output, [this]() {
-        auto qmp_output = vm_process->read_all_standard_output();
-        mpl::log(mpl::Level::debug, vm_name, fmt::format("QMP: {}", qmp_output));
-        auto qmp_object = QJsonDocument::fromJson(qmp_output.split('\n').first()).object();
-        auto event = qmp_object["event"];
+        // QMP messages are newline delimited, but a single read can carry several of them and end
+        // mid-message, so buffer and handle every complete line — dropping an event here means a
+        // state transition only gets noticed much later, if at all
+        qmp_buffer.append(vm_process->read_all_standard_output());
 
-        if (!event.isNull())
+        int newline_pos;
+        while ((newline_pos = qmp_buffer.indexOf('\n')) != -1)
         {
-            if (event.toString() == "RESET" && state != State::restarting)
-            {
-                mpl::log(mpl::Level::info, vm_name, "VM restarting");
-                on_restart();
-            }
-            else if (event.toString() == "POWERDOWN")
-            {
-                mpl::log(mpl::Level::info, vm_name, "VM powering down");
-            }
-            else if (event.toString() == "SHUTDOWN")
-            {
-                mpl::log(mpl::Level::info, vm_name, "VM shut down");
-            }
-            else if (event.toString() == "STOP")
-            {
-                mpl::log(mpl::Level::info, vm_name, "VM suspending");
-            }
-            else if (event.toString() == "RESUME")
-            {
-                mpl::log(mpl::Level::info, vm_name, "VM suspended");
-                if (state == State::suspending || state == State::running)
-                {
-                    vm_process->kill();
-                    on_suspend();
-                }
-            }
+            auto qmp_line = qmp_buffer.left(newline_pos);
+            qmp_buffer.remove(0, newline_pos + 1);
+
+            if (qmp_line.trimmed().isEmpty())
+                continue;
+
+            mpl::log(mpl::Level::debug, vm_name, fmt::format("QMP: {}", qmp_line));
+            handle_qmp_line(qmp_line);
         }
     });
 
@@ -18,12 +18,15 @@
 #ifndef MULTIPASS_QEMU_VIRTUAL_MACHINE_H
 #define MULTIPASS_QEMU_VIRTUAL_MACHINE_H
 
+#include <shared/linux/backend_utils.h>
+
 #include <multipass/ip_address.h>
 #include <multipass/optional.h>
 #include <multipass/process.h>
 #include <multipass/virtual_machine.h>
 #include <multipass/virtual_machine_description.h>
 
+#include <QByteArray>
 #include <QObject>
 #include <QStringList>
 
@@ -53,6 +56,13 @@ public:
     void ensure_vm_is_running() override;
     void wait_until_ssh_up(std::chrono::milliseconds timeout) override;
     void update_state() override;
+    void update_resources(int num_cores, const MemorySize& mem_size) override;
+    void update_io_limits(long long iops, long long bytes_per_second) override;
+    optional<std::string> run_in_guest(const std::string& cmd) override;
+    bool take_live_snapshot(const std::string& snapshot_name) override;
+    optional<HostResourceUsage> host_resource_usage() override;
+    bool prepare_disk_compaction() override;
+    long long commit_disk_compaction() override;
 
 signals:
     void on_delete_memory_snapshot();
@@ -63,19 +73,23 @@ private:
     void on_shutdown();
     void on_suspend();
     void on_restart();
+    void handle_qmp_line(const QByteArray& qmp_line);
     void initialize_vm_process();
 
     const std::string tap_device_name;
-    const VirtualMachineDescription desc;
+    VirtualMachineDescription desc; // num_cores/mem_size may be updated while stopped, for the next boot
     std::unique_ptr<Process> vm_process{nullptr};
+    multipass::optional<backend::NumaNode> numa_node; // where the current boot was placed, on multi-node hosts
     multipass::optional<IPAddress> ip;
     const std::string mac_addr;
     const std::string username;
     DNSMasqServer* dnsmasq_server;
     VMStatusMonitor* monitor;
+    QByteArray qmp_buffer;
     std::string saved_error_msg;
     bool update_shutdown_status{true};
     bool delete_memory_snapshot{false};
+    bool capture_boot_regions{false}; // snapshot the boot's page-cache footprint once SSH comes up
 };
 } // namespace multipass
 
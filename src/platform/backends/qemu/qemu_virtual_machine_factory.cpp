@@ -20,6 +20,7 @@
 
 #include <multipass/logging/log.h>
 #include <multipass/optional.h>
+#include <multipass/tracing/trace_recorder.h>
 #include <multipass/utils.h>
 #include <multipass/virtual_machine_description.h>
 
@@ -29,6 +30,7 @@
 #include <multipass/format.h>
 #include <yaml-cpp/yaml.h>
 
+#include <QProcess>
 #include <QRegularExpression>
 #include <QTcpSocket>
 
@@ -50,6 +52,26 @@ auto generate_tap_device_name(const std::string& vm_name)
     return tap_name;
 }
 
+/* `ip -batch` reads commands from stdin, so a whole device setup costs one spawn instead of one per command
+   (the same trick iptables rules get from iptables-restore); -force carries on past a failed command, as
+   the individual-status calls this replaces did */
+bool run_ip_batch(const std::vector<std::string>& commands)
+{
+    QProcess proc;
+    proc.setProgram("ip");
+    proc.setArguments({"-force", "-batch", "-"});
+    proc.setStandardOutputFile(QProcess::nullDevice());
+    proc.setStandardErrorFile(QProcess::nullDevice());
+
+    proc.start();
+    for (const auto& command : commands)
+        proc.write(fmt::format("{}\n", command).c_str());
+    proc.closeWriteChannel();
+    proc.waitForFinished();
+
+    return proc.exitStatus() == QProcess::NormalExit && proc.exitCode() == 0;
+}
+
 void create_virtual_switch(const std::string& subnet, const QString& bridge_name)
 {
     const QString dummy_name{bridge_name + "-dummy"};
@@ -60,13 +82,11 @@ void create_virtual_switch(const std::string& subnet, const QString& bridge_name
         const auto cidr = fmt::format("{}.1/24", subnet);
         const auto broadcast = fmt::format("{}.255", subnet);
 
-        mp::utils::run_cmd_for_status("ip",
-                                      {"link", "add", dummy_name, "address", mac_address.c_str(), "type", "dummy"});
-        mp::utils::run_cmd_for_status("ip", {"link", "add", bridge_name, "type", "bridge"});
-        mp::utils::run_cmd_for_status("ip", {"link", "set", dummy_name, "master", bridge_name});
-        mp::utils::run_cmd_for_status(
-            "ip", {"address", "add", cidr.c_str(), "dev", bridge_name, "broadcast", broadcast.c_str()});
-        mp::utils::run_cmd_for_status("ip", {"link", "set", bridge_name, "up"});
+        run_ip_batch({fmt::format("link add {} address {} type dummy", dummy_name, mac_address),
+                      fmt::format("link add {} type bridge", bridge_name),
+                      fmt::format("link set {} master {}", dummy_name, bridge_name),
+                      fmt::format("address add {} dev {} broadcast {}", cidr, bridge_name, broadcast),
+                      fmt::format("link set {} up", bridge_name)});
     }
 }
 
@@ -76,8 +96,7 @@ void delete_virtual_switch(const QString& bridge_name)
 
     if (mp::utils::run_cmd_for_status("ip", {"addr", "show", bridge_name}))
     {
-        mp::utils::run_cmd_for_status("ip", {"link", "delete", bridge_name});
-        mp::utils::run_cmd_for_status("ip", {"link", "delete", dummy_name});
+        run_ip_batch({fmt::format("link delete {}", bridge_name), fmt::format("link delete {}", dummy_name)});
     }
 }
 
@@ -85,9 +104,10 @@ void create_tap_device(const QString& tap_name, const QString& bridge_name)
 {
     if (!mp::utils::run_cmd_for_status("ip", {"addr", "show", tap_name}))
     {
-        mp::utils::run_cmd_for_status("ip", {"tuntap", "add", tap_name, "mode", "tap"});
-        mp::utils::run_cmd_for_status("ip", {"link", "set", tap_name, "master", bridge_name});
-        mp::utils::run_cmd_for_status("ip", {"link", "set", tap_name, "up"});
+        // multi_queue lets qemu open one queue pair per vcpu later on; harmless for single-core guests
+        run_ip_batch({fmt::format("tuntap add {} mode tap multi_queue", tap_name),
+                      fmt::format("link set {} master {}", tap_name, bridge_name),
+                      fmt::format("link set {} up", tap_name)});
     }
 }
 
@@ -112,6 +132,7 @@ void set_ip_forward()
 mp::DNSMasqServer create_dnsmasq_server(const mp::Path& network_dir, const QString& bridge_name,
                                         const std::string& subnet)
 {
+    MP_TRACE_SPAN("create_dnsmasq_server");
     create_virtual_switch(subnet, bridge_name);
     set_ip_forward();
 
@@ -167,6 +188,18 @@ void mp::QemuVirtualMachineFactory::prepare_instance_image(const mp::VMImage& in
     mp::backend::resize_instance_image(desc.disk_space, instance_image.image_path);
 }
 
+void mp::QemuVirtualMachineFactory::snapshot_instance_image(const mp::VMImage& instance_image,
+                                                            const std::string& snapshot_name)
+{
+    mp::backend::snapshot_instance_image(snapshot_name, instance_image.image_path);
+}
+
+void mp::QemuVirtualMachineFactory::restore_instance_image(const mp::VMImage& instance_image,
+                                                           const std::string& snapshot_name)
+{
+    mp::backend::restore_instance_image(snapshot_name, instance_image.image_path);
+}
+
 void mp::QemuVirtualMachineFactory::hypervisor_health_check()
 {
     mp::backend::check_for_kvm_support();
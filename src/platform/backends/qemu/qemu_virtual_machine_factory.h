@@ -41,6 +41,8 @@ public:
     void remove_resources_for(const std::string& name) override;
     VMImage prepare_source_image(const VMImage& source_image) override;
     void prepare_instance_image(const VMImage& instance_image, const VirtualMachineDescription& desc) override;
+    void snapshot_instance_image(const VMImage& instance_image, const std::string& snapshot_name) override;
+    void restore_instance_image(const VMImage& instance_image, const std::string& snapshot_name) override;
     void hypervisor_health_check() override;
     QString get_backend_version_string() override;
 
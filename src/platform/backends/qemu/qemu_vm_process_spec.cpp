@@ -22,12 +22,44 @@
 #include <multipass/snap_utils.h>
 #include <shared/linux/backend_utils.h>
 
+#include <QFile>
+#include <QFileInfo>
+
 namespace mp = multipass;
 namespace mpl = multipass::logging;
 namespace mu = multipass::utils;
 
 namespace
 {
+struct NetdevOffloads
+{
+    bool vhost_net = false;
+    int queues = 1;
+};
+
+// vhost-net moves packet processing for the tap into the kernel, and a multi-queue tap lets a
+// multi-core guest spread its traffic over one queue pair per vcpu. Both depend on the host, and
+// taps created before we started requesting multi_queue are single-queue forever, so probe the
+// actual device rather than assume.
+NetdevOffloads probe_netdev_offloads(const QString& tap_device_name, int num_cores)
+{
+    NetdevOffloads offloads;
+
+    QFile tun_flags_file{QString("/sys/class/net/%1/tun_flags").arg(tap_device_name)};
+    if (!tun_flags_file.open(QIODevice::ReadOnly) || !QFile::exists("/dev/vhost-net"))
+        return offloads;
+
+    offloads.vhost_net = true;
+
+    bool parsed{false};
+    const auto tun_flags = QString{tun_flags_file.readAll()}.trimmed().toInt(&parsed, 16);
+    constexpr auto iff_multi_queue = 0x0100; // IFF_MULTI_QUEUE, from linux/if_tun.h
+    if (parsed && (tun_flags & iff_multi_queue) && num_cores > 1)
+        offloads.queues = num_cores;
+
+    return offloads;
+}
+
 // This returns the initial two Qemu command line options we used in Multipass. Only of use to resume old suspended
 // images.
 //  === Do not change this! ===
@@ -71,9 +103,15 @@ QStringList initial_qemu_arguments(const mp::VirtualMachineDescription& desc, co
 }
 } // namespace
 
+QString mp::QemuVMProcessSpec::guest_agent_socket_path(const mp::VirtualMachineDescription& desc)
+{
+    return QFileInfo{desc.image.image_path}.path() + "/qga.sock";
+}
+
 mp::QemuVMProcessSpec::QemuVMProcessSpec(const mp::VirtualMachineDescription& desc, const QString& tap_device_name,
-                                         const multipass::optional<ResumeData>& resume_data)
-    : desc(desc), tap_device_name(tap_device_name), resume_data{resume_data}
+                                         const multipass::optional<ResumeData>& resume_data,
+                                         const multipass::optional<mp::backend::NumaNode>& numa_node)
+    : desc(desc), tap_device_name(tap_device_name), resume_data{resume_data}, numa_node{numa_node}
 {
 }
 
@@ -114,22 +152,49 @@ QStringList mp::QemuVMProcessSpec::arguments() const
     `man qemu-system`, under `-m` option; including suffix to avoid relying on default unit */
 
         args << "--enable-kvm";
-        // The VM image itself
-        args << "-device"
-             << "virtio-scsi-pci,id=scsi0"
-             << "-drive" << QString("file=%1,if=none,format=qcow2,discard=unmap,id=hda").arg(desc.image.image_path)
+        // The VM image itself; one request queue per vcpu, so multi-core guests don't serialize
+        // their I/O behind a single queue
+        auto drive = QString("file=%1,if=none,format=qcow2,discard=unmap,id=hda").arg(desc.image.image_path);
+        // Hypervisor-enforced I/O limits, so this instance cannot starve its neighbours of disk time
+        if (desc.io_limits.iops > 0)
+            drive += QString(",throttling.iops-total=%1").arg(desc.io_limits.iops);
+        if (desc.io_limits.bytes_per_second > 0)
+            drive += QString(",throttling.bps-total=%1").arg(desc.io_limits.bytes_per_second);
+        args << "-device" << QString("virtio-scsi-pci,id=scsi0,num_queues=%1").arg(desc.num_cores)
+             << "-drive" << drive
              << "-device"
              << "scsi-hd,drive=hda,bus=scsi0.0";
         // Number of cpu cores
         args << "-smp" << QString::number(desc.num_cores);
         // Memory to use for VM
         args << "-m" << mem_size;
-        // Create a virtual NIC in the VM
-        args << "-device"
-             << QString("virtio-net-pci,netdev=hostnet0,id=net0,mac=%1").arg(QString::fromStdString(desc.mac_addr));
+        if (numa_node)
+        {
+            // Bind guest RAM to the node the vcpus are pinned on (see QemuVirtualMachine::start), so no
+            // guest memory access has to cross a socket
+            args << "-object"
+                 << QString("memory-backend-ram,id=mem0,size=%1,host-nodes=%2,policy=bind")
+                        .arg(mem_size)
+                        .arg(numa_node->id)
+                 << "-numa"
+                 << "node,memdev=mem0";
+        }
+        // Create a virtual NIC in the VM, with whatever offloads the host's tap supports
+        const auto offloads = probe_netdev_offloads(tap_device_name, desc.num_cores);
+        auto net_device =
+            QString("virtio-net-pci,netdev=hostnet0,id=net0,mac=%1").arg(QString::fromStdString(desc.mac_addr));
+        auto net_backend = QString("tap,id=hostnet0,ifname=%1,script=no,downscript=no").arg(tap_device_name);
+        if (offloads.vhost_net)
+            net_backend += ",vhost=on";
+        if (offloads.queues > 1)
+        {
+            net_backend += QString(",queues=%1").arg(offloads.queues);
+            // a TX and an RX vector per queue, plus one each for config and control
+            net_device += QString(",mq=on,vectors=%1").arg(2 * offloads.queues + 2);
+        }
+        args << "-device" << net_device;
         // Create tap device to connect to virtual bridge
-        args << "-netdev";
-        args << QString("tap,id=hostnet0,ifname=%1,script=no,downscript=no").arg(tap_device_name);
+        args << "-netdev" << net_backend;
         // Control interface
         args << "-qmp"
              << "stdio";
@@ -144,6 +209,14 @@ QStringList mp::QemuVMProcessSpec::arguments() const
              << "chardev:char0"
              // TODO Add a debugging mode with access to console
              << "-nographic";
+        // Guest-agent channel: a virtio-serial port the guest's qemu-guest-agent attaches to, letting the
+        // daemon query guest facts without SSH (see QemuVirtualMachine::run_in_guest)
+        args << "-chardev"
+             << QString("socket,id=qga0,path=%1,server,nowait").arg(guest_agent_socket_path(desc))
+             << "-device"
+             << "virtio-serial"
+             << "-device"
+             << "virtserialport,chardev=qga0,name=org.qemu.guest_agent.0";
         // Cloud-init disk
         args << "-cdrom" << desc.cloud_init_iso;
     }
@@ -177,6 +250,7 @@ profile %1 flags=(attach_disconnected) {
   signal (receive) peer=%2,
 
   /dev/net/tun rw,
+  /dev/vhost-net rw,
   /dev/kvm rw,
   /dev/ptmx rw,
   /dev/kqemu rw,
@@ -210,6 +284,8 @@ profile %1 flags=(attach_disconnected) {
   /sys/devices/system/cpu/ r,
   /sys/devices/system/node/ r,
   /sys/devices/system/node/node[0-9]*/meminfo r,
+  /sys/devices/system/node/node[0-9]*/cpulist r,
+  /sys/devices/system/node/node[0-9]*/cpumap r,
   /sys/module/vhost/parameters/max_mem_regions r,
 
   # binary and its libs
@@ -222,6 +298,9 @@ profile %1 flags=(attach_disconnected) {
   # Disk images
   %6 rwk,  # QCow2 filesystem image
   %7 rk,   # cloud-init ISO
+
+  # guest-agent channel socket
+  %8 rw,
 }
     )END");
 
@@ -243,7 +322,7 @@ profile %1 flags=(attach_disconnected) {
     }
 
     return profile_template.arg(apparmor_profile_name(), signal_peer, firmware, root_dir, program(),
-                                desc.image.image_path, desc.cloud_init_iso);
+                                desc.image.image_path, desc.cloud_init_iso, guest_agent_socket_path(desc));
 }
 
 QString mp::QemuVMProcessSpec::identifier() const
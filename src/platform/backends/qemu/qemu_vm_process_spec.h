@@ -20,6 +20,8 @@
 
 #include "qemu_base_process_spec.h"
 
+#include <shared/linux/backend_utils.h>
+
 #include <multipass/optional.h>
 #include <multipass/virtual_machine_description.h>
 
@@ -38,9 +40,11 @@ public:
     };
 
     static QString default_machine_type();
+    static QString guest_agent_socket_path(const VirtualMachineDescription& desc);
 
     explicit QemuVMProcessSpec(const VirtualMachineDescription& desc, const QString& tap_device_name,
-                               const multipass::optional<ResumeData>& resume_data);
+                               const multipass::optional<ResumeData>& resume_data,
+                               const multipass::optional<backend::NumaNode>& numa_node = multipass::nullopt);
 
     QStringList arguments() const override;
 
@@ -51,6 +55,7 @@ private:
     const VirtualMachineDescription desc;
     const QString tap_device_name;
     const multipass::optional<ResumeData> resume_data;
+    const multipass::optional<backend::NumaNode> numa_node;
 };
 
 } // namespace multipass
@@ -43,6 +43,16 @@ public:
         log(logging::Level::trace, log_category, fmt::format("No driver configuration for \"{}\"", name));
     };
 
+    void snapshot_instance_image(const VMImage& /*instance_image*/, const std::string& /*snapshot_name*/) override
+    {
+        throw std::runtime_error("disk snapshots are not supported on this backend");
+    };
+
+    void restore_instance_image(const VMImage& /*instance_image*/, const std::string& /*snapshot_name*/) override
+    {
+        throw std::runtime_error("disk snapshots are not supported on this backend");
+    };
+
     QString get_backend_directory_name() override
     {
         return {};
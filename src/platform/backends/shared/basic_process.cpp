@@ -154,6 +154,11 @@ bool mp::BasicProcess::running() const
     return process.state() == QProcess::Running;
 }
 
+qint64 mp::BasicProcess::process_id() const
+{
+    return process.processId();
+}
+
 QByteArray mp::BasicProcess::read_all_standard_output()
 {
     return process.readAllStandardOutput();
@@ -18,6 +18,7 @@
 #include "backend_utils.h"
 #include "process_factory.h"
 #include "qemuimg_process_spec.h"
+#include <multipass/ip_address.h>
 #include <multipass/logging/log.h>
 #include <multipass/memory_size.h>
 #include <multipass/process.h>
@@ -32,15 +33,19 @@
 #include <QRegularExpression>
 #include <QString>
 #include <QSysInfo>
+#include <QtEndian>
 
 #include <chrono>
 #include <exception>
 #include <random>
+#include <vector>
 
 #include <errno.h>
 #include <fcntl.h>
 #include <linux/kvm.h>
 #include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
 
@@ -52,11 +57,10 @@ namespace
 std::default_random_engine gen;
 std::uniform_int_distribution<int> dist{0, 255};
 
-bool subnet_used_locally(const std::string& subnet)
+QString local_route_table()
 {
-    // CLI equivalent: ip -4 route show | grep -q ${SUBNET}
-    const auto output = QString::fromStdString(mp::utils::run_cmd_for_output("ip", {"-4", "route", "show"}));
-    return output.contains(QString::fromStdString(subnet));
+    // CLI equivalent: ip -4 route show
+    return QString::fromStdString(mp::utils::run_cmd_for_output("ip", {"-4", "route", "show"}));
 }
 
 bool can_reach_gateway(const std::string& ip)
@@ -88,7 +92,22 @@ auto virtual_switch_subnet(const QString& bridge_name)
     return subnet.toStdString();
 }
 
-void check_min_img_size(const mp::MemorySize& requested_size, const mp::Path& image_path)
+qint64 qcow2_virtual_size(const mp::Path& image_path)
+{
+    // The virtual size sits in the qcow2 header, as a big-endian u64 at offset 24, right after the magic,
+    // version, backing-file offset and backing-file size fields — reading it spares a qemu-img spawn
+    QFile image_file{image_path};
+    if (!image_file.open(QIODevice::ReadOnly))
+        return -1;
+
+    const auto header = image_file.read(32);
+    if (header.size() < 32 || !header.startsWith(QByteArrayLiteral("QFI\xfb")))
+        return -1;
+
+    return static_cast<qint64>(qFromBigEndian<quint64>(header.constData() + 24));
+}
+
+qint64 virtual_size_from_qemuimg(const mp::Path& image_path)
 {
     auto qemuimg_process = mp::ProcessFactory::instance().create_process(
         std::make_unique<mp::QemuImgProcessSpec>(QStringList{"info", image_path}));
@@ -104,14 +123,22 @@ void check_min_img_size(const mp::MemorySize& requested_size, const mp::Path& im
     const auto re = QRegularExpression{pattern, QRegularExpression::MultilineOption};
 
     if (const auto match = re.match(img_info); match.hasMatch())
-    {
-        const auto min_size = match.captured("size").toStdString();
-        if (requested_size < mp::MemorySize{min_size})
-            throw std::runtime_error(fmt::format("Requested disk ({} bytes) below minimum for this image ({} bytes)",
-                                                 requested_size.in_bytes(), min_size)); // TODO use human-readable sizes
-    }
-    else
-        throw std::runtime_error{fmt::format("Could not obtain image's virtual size")};
+        return match.captured("size").toLongLong();
+
+    throw std::runtime_error{fmt::format("Could not obtain image's virtual size")};
+}
+
+qint64 check_min_img_size(const mp::MemorySize& requested_size, const mp::Path& image_path)
+{ // returns the image's current virtual size, in bytes
+    auto min_size = qcow2_virtual_size(image_path);
+    if (min_size < 0)
+        min_size = virtual_size_from_qemuimg(image_path);
+
+    if (requested_size < mp::MemorySize{std::to_string(min_size)})
+        throw std::runtime_error(fmt::format("Requested disk ({} bytes) below minimum for this image ({} bytes)",
+                                             requested_size.in_bytes(), min_size)); // TODO use human-readable sizes
+
+    return min_size;
 }
 
 } // namespace
@@ -119,16 +146,22 @@ void check_min_img_size(const mp::MemorySize& requested_size, const mp::Path& im
 std::string mp::backend::generate_random_subnet()
 {
     gen.seed(std::chrono::system_clock::now().time_since_epoch().count());
+
+    // One route-table fetch covers all the candidates (grepping it per candidate would spawn `ip` each
+    // time); a subnet that comes into use mid-scan is still caught by the gateway pings below
+    const auto route_table = local_route_table();
     for (auto i = 0; i < 100; ++i)
     {
-        auto subnet = fmt::format("10.{}.{}", dist(gen), dist(gen));
-        if (subnet_used_locally(subnet))
+        const std::array<uint8_t, 4> quad{{10, static_cast<uint8_t>(dist(gen)), static_cast<uint8_t>(dist(gen)), 0}};
+        const auto candidate = mp::IPAddress{quad};
+        auto subnet = fmt::format("{}.{}.{}", quad[0], quad[1], quad[2]);
+        if (route_table.contains(QString::fromStdString(subnet)))
             continue;
 
-        if (can_reach_gateway(fmt::format("{}.1", subnet)))
+        if (can_reach_gateway(candidate.first_in_subnet(24).as_string()))
             continue;
 
-        if (can_reach_gateway(fmt::format("{}.254", subnet)))
+        if (can_reach_gateway(candidate.last_in_subnet(24).as_string()))
             continue;
 
         return subnet;
@@ -155,7 +188,11 @@ std::string mp::backend::get_subnet(const mp::Path& network_dir, const QString&
 
 void mp::backend::resize_instance_image(const MemorySize& disk_space, const mp::Path& image_path)
 {
-    check_min_img_size(disk_space, image_path);
+    const auto virtual_size = check_min_img_size(disk_space, image_path);
+
+    // Nothing to resize if the image already has the requested geometry
+    if (virtual_size == static_cast<qint64>(disk_space.in_bytes()))
+        return;
 
     auto disk_size = QString::number(disk_space.in_bytes()); // format documented in `man qemu-img` (look for "size")
     auto qemuimg_spec = std::make_unique<mp::QemuImgProcessSpec>(QStringList{"resize", image_path, disk_size});
@@ -170,6 +207,72 @@ void mp::backend::resize_instance_image(const MemorySize& disk_space, const mp::
     }
 }
 
+bool mp::backend::create_compacted_image(const mp::Path& image_path, const mp::Path& output_path)
+{
+    /* Only a standalone, snapshot-free qcow2 image is eligible: convert collapses backing layers into the
+       copy (ballooning an overlay by its whole base) and silently drops internal snapshots. The backing
+       file offset sits at header offset 8, the snapshot count at 56, both big-endian. */
+    QFile image_file{image_path};
+    if (!image_file.open(QIODevice::ReadOnly))
+        return false;
+
+    const auto header = image_file.read(60);
+    image_file.close();
+    if (header.size() < 60 || !header.startsWith(QByteArrayLiteral("QFI\xfb")))
+        return false;
+
+    if (qFromBigEndian<quint64>(header.constData() + 8) != 0 || // backing file present
+        qFromBigEndian<quint32>(header.constData() + 56) != 0)  // internal snapshots present
+        return false;
+
+    auto qemuimg_spec = std::make_unique<mp::QemuImgProcessSpec>(
+        QStringList{"convert", "-O", "qcow2", image_path, output_path});
+    auto qemuimg_process = mp::ProcessFactory::instance().create_process(std::move(qemuimg_spec));
+
+    auto process_state = qemuimg_process->execute(-1);
+    if (!process_state.completed_successfully())
+    {
+        QFile::remove(output_path);
+        throw std::runtime_error(fmt::format("Cannot compact instance image: qemu-img failed ({}) with output:\n{}",
+                                             process_state.failure_message(),
+                                             qemuimg_process->read_all_standard_error()));
+    }
+
+    return true;
+}
+
+void mp::backend::snapshot_instance_image(const std::string& snapshot_name, const mp::Path& image_path)
+{
+    auto qemuimg_spec = std::make_unique<mp::QemuImgProcessSpec>(
+        QStringList{"snapshot", "-c", QString::fromStdString(snapshot_name), image_path});
+    auto qemuimg_process = mp::ProcessFactory::instance().create_process(std::move(qemuimg_spec));
+
+    auto process_state = qemuimg_process->execute(mp::backend::image_resize_timeout);
+    if (!process_state.completed_successfully())
+    {
+        throw std::runtime_error(fmt::format("Cannot snapshot instance image: qemu-img failed ({}) with output:\n{}",
+                                             process_state.failure_message(),
+                                             qemuimg_process->read_all_standard_error()));
+    }
+}
+
+void mp::backend::restore_instance_image(const std::string& snapshot_name, const mp::Path& image_path)
+{
+    // Applying a snapshot only rewrites the image's L1 table to the snapshot's copy, so
+    // this is metadata-bound no matter how much the disk diverged since
+    auto qemuimg_spec = std::make_unique<mp::QemuImgProcessSpec>(
+        QStringList{"snapshot", "-a", QString::fromStdString(snapshot_name), image_path});
+    auto qemuimg_process = mp::ProcessFactory::instance().create_process(std::move(qemuimg_spec));
+
+    auto process_state = qemuimg_process->execute(mp::backend::image_resize_timeout);
+    if (!process_state.completed_successfully())
+    {
+        throw std::runtime_error(fmt::format("Cannot restore instance image: qemu-img failed ({}) with output:\n{}",
+                                             process_state.failure_message(),
+                                             qemuimg_process->read_all_standard_error()));
+    }
+}
+
 mp::Path mp::backend::convert_to_qcow_if_necessary(const mp::Path& image_path)
 {
     // Check if raw image file, and if so, convert to qcow2 format.
@@ -220,6 +323,111 @@ QString mp::backend::cpu_arch()
     return cpu_to_arch.value(QSysInfo::currentCpuArchitecture());
 }
 
+mp::optional<mp::backend::NumaNode> mp::backend::preferred_numa_node()
+{
+    QDir nodes_dir{"/sys/devices/system/node"};
+    const auto nodes = nodes_dir.entryList({"node[0-9]*"}, QDir::Dirs);
+    if (nodes.size() < 2)
+        return mp::nullopt; // a single node holds everything; binding to it would only constrain the scheduler
+
+    // On multi-node hosts, the node with the most free memory wins — the guest's whole allocation has to
+    // fit there, and spilling past the node is exactly the cross-socket traffic placement is meant to avoid
+    mp::optional<NumaNode> preferred;
+    long long most_free = -1;
+    for (const auto& node : nodes)
+    {
+        QFile meminfo_file{nodes_dir.filePath(node + "/meminfo")};
+        if (!meminfo_file.open(QIODevice::ReadOnly))
+            continue;
+
+        const QRegularExpression free_pattern{"MemFree:\\s+(\\d+) kB"};
+        const auto match = free_pattern.match(QString{meminfo_file.readAll()});
+        if (!match.hasMatch())
+            continue;
+
+        const auto free_kb = match.captured(1).toLongLong();
+        if (free_kb <= most_free)
+            continue;
+
+        QFile cpulist_file{nodes_dir.filePath(node + "/cpulist")};
+        if (!cpulist_file.open(QIODevice::ReadOnly))
+            continue;
+
+        most_free = free_kb;
+        preferred = NumaNode{node.mid(4).toInt(), QString{cpulist_file.readAll()}.trimmed()};
+    }
+
+    return preferred;
+}
+
+void mp::backend::record_boot_regions(const mp::Path& image_path)
+{
+    const auto fd = ::open(QFile::encodeName(image_path).constData(), O_RDONLY);
+    if (fd < 0)
+        return;
+
+    struct stat image_stat;
+    if (::fstat(fd, &image_stat) < 0 || image_stat.st_size == 0)
+    {
+        ::close(fd);
+        return;
+    }
+
+    const auto map = ::mmap(nullptr, image_stat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED)
+    {
+        ::close(fd);
+        return;
+    }
+
+    const auto page_size = ::sysconf(_SC_PAGESIZE);
+    const auto pages = (image_stat.st_size + page_size - 1) / page_size;
+    std::vector<unsigned char> residency(pages);
+    if (::mincore(map, image_stat.st_size, residency.data()) == 0)
+    {
+        QFile regions_file{(image_path + ".bootmap")};
+        if (regions_file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+        { // resident pages coalesce into "<offset> <length>" lines, one per contiguous run
+            long long run_start{-1};
+            for (long long page = 0; page <= pages; ++page)
+            {
+                const auto resident = page < pages && (residency[page] & 1);
+                if (resident && run_start < 0)
+                    run_start = page;
+                else if (!resident && run_start >= 0)
+                {
+                    regions_file.write(QByteArray::number(run_start * page_size) + ' ' +
+                                       QByteArray::number((page - run_start) * page_size) + '\n');
+                    run_start = -1;
+                }
+            }
+        }
+    }
+
+    ::munmap(map, image_stat.st_size);
+    ::close(fd);
+}
+
+void mp::backend::prefetch_boot_regions(const mp::Path& image_path)
+{
+    QFile regions_file{(image_path + ".bootmap")};
+    if (!regions_file.open(QIODevice::ReadOnly | QIODevice::Text))
+        return; // nothing recorded yet - the first boot runs cold and leaves a map behind
+
+    const auto fd = ::open(QFile::encodeName(image_path).constData(), O_RDONLY);
+    if (fd < 0)
+        return;
+
+    while (!regions_file.atEnd())
+    {
+        const auto fields = regions_file.readLine().trimmed().split(' ');
+        if (fields.size() == 2) // WILLNEED just queues asynchronous readahead, so this returns promptly
+            ::posix_fadvise(fd, fields[0].toLongLong(), fields[1].toLongLong(), POSIX_FADV_WILLNEED);
+    }
+
+    ::close(fd);
+}
+
 void mp::backend::check_for_kvm_support()
 {
     QProcess check_kvm;
@@ -18,6 +18,7 @@
 #ifndef MULTIPASS_BACKEND_UTILS_H
 #define MULTIPASS_BACKEND_UTILS_H
 
+#include <multipass/optional.h>
 #include <multipass/path.h>
 
 #include <chrono>
@@ -37,8 +38,26 @@ constexpr auto image_resize_timeout = std::chrono::duration_cast<std::chrono::mi
 std::string generate_random_subnet();
 std::string get_subnet(const Path& network_dir, const QString& bridge_name);
 void resize_instance_image(const MemorySize& disk_space, const multipass::Path& image_path);
+bool create_compacted_image(const multipass::Path& image_path, const multipass::Path& output_path);
+void snapshot_instance_image(const std::string& snapshot_name, const multipass::Path& image_path);
+void restore_instance_image(const std::string& snapshot_name, const multipass::Path& image_path);
 Path convert_to_qcow_if_necessary(const Path& image_path);
 QString cpu_arch();
+
+// A NUMA node an instance can be placed on, as the kernel describes it under /sys/devices/system/node
+struct NumaNode
+{
+    int id;
+    QString cpulist; // kernel cpu list format, e.g. "0-7,16-23"
+};
+optional<NumaNode> preferred_numa_node(); // nullopt on single-node hosts, where placement is moot
+
+/* Page-cache prewarming for boot storms: record_boot_regions snapshots which pages of the image a boot
+   left resident (mincore) into a map file next to it; prefetch_boot_regions replays that map through
+   posix_fadvise(WILLNEED) before the next cold boot, so many instances starting at once read their
+   boot blocks sequentially ahead of qemu's random faults. Both are best effort and quiet on failure. */
+void record_boot_regions(const Path& image_path);
+void prefetch_boot_regions(const Path& image_path);
 void check_for_kvm_support();
 void check_if_kvm_is_in_use();
 } // namespace backend
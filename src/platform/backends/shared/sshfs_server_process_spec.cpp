@@ -68,6 +68,8 @@ QProcessEnvironment mp::SSHFSServerProcessSpec::environment() const
 {
     QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
     env.insert("KEY", QString::fromStdString(config.private_key));
+    if (!config.sshfs_exec_line.empty())
+        env.insert("SSHFS_EXEC_LINE", QString::fromStdString(config.sshfs_exec_line));
     return env;
 }
 
@@ -24,6 +24,8 @@
 #include <sys/ioctl.h>
 #include <unistd.h>
 
+#include <cstdlib>
+
 namespace mp = multipass;
 
 namespace
@@ -67,8 +69,15 @@ mp::UnixConsole::UnixConsole(ssh_channel channel, UnixTerminal* term) : term{ter
     {
         setup_console();
 
-        ssh_channel_request_pty(channel);
-        change_ssh_pty_size(channel, term->cout_fd());
+        /* Request the pty with the host's terminal type and actual geometry up front: the libssh default
+           ("xterm", 80x24) has full-screen guest applications address a terminal the user may not have, and
+           the immediate resize that used to follow made them redraw the whole screen twice on entry */
+        struct winsize win = {0, 0, 0, 0};
+        ioctl(term->cout_fd(), TIOCGWINSZ, &win);
+
+        const auto* term_type = ::getenv("TERM");
+        ssh_channel_request_pty_size(channel, term_type && *term_type ? term_type : "xterm", win.ws_col, win.ws_row);
+        last_geometry = {win.ws_row, win.ws_col};
     }
 }
 
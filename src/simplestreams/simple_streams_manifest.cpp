@@ -26,26 +26,23 @@
 #include <multipass/exceptions/manifest_exceptions.h>
 #include <multipass/utils.h>
 
+#include <algorithm>
+
 namespace mp = multipass;
 
 namespace
 {
+const mp::VMImageInfo* find_in(const std::vector<mp::SimpleStreamsManifest::IndexEntry>& index, const QString& key)
+{
+    auto it = std::lower_bound(index.cbegin(), index.cend(), key,
+                               [](const auto& entry, const QString& k) { return entry.first < k; });
+    return it != index.cend() && it->first == key ? it->second : nullptr;
+}
+
 const QHash<QString, QString> arch_to_manifest{{"x86_64", "amd64"}, {"arm", "armhf"},     {"arm64", "arm64"},
                                                {"i386", "i386"},    {"power", "powerpc"}, {"power64", "ppc64el"},
                                                {"s390x", "s390x"}};
 
-QJsonObject parse_manifest(const QByteArray& json)
-{
-    QJsonParseError parse_error;
-    const auto doc = QJsonDocument::fromJson(json, &parse_error);
-    if (doc.isNull())
-        throw mp::GenericManifestException(parse_error.errorString().toStdString());
-
-    if (!doc.isObject())
-        throw mp::GenericManifestException("invalid manifest object");
-    return doc.object();
-}
-
 QString latest_version_in(const QJsonObject& versions)
 {
     QString max_version;
@@ -74,10 +71,34 @@ QString derive_unpacked_file_path_prefix_from(const QString& image_location)
 }
 }
 
+const mp::VMImageInfo* mp::SimpleStreamsManifest::find_image_record(const QString& key) const
+{
+    return find_in(image_records, key);
+}
+
+const mp::VMImageInfo* mp::SimpleStreamsManifest::find_product(const QString& id) const
+{
+    return find_in(products_by_id, id);
+}
+
 std::unique_ptr<mp::SimpleStreamsManifest> mp::SimpleStreamsManifest::fromJson(const QByteArray& json,
                                                                                const QString& host_url)
 {
-    const auto manifest = parse_manifest(json);
+    QJsonParseError parse_error;
+    const auto doc = QJsonDocument::fromJson(json, &parse_error);
+    if (doc.isNull())
+        throw mp::GenericManifestException(parse_error.errorString().toStdString());
+
+    return fromJson(doc, host_url);
+}
+
+std::unique_ptr<mp::SimpleStreamsManifest> mp::SimpleStreamsManifest::fromJson(const QJsonDocument& doc,
+                                                                               const QString& host_url)
+{
+    if (!doc.isObject())
+        throw mp::GenericManifestException("invalid manifest object");
+
+    const auto manifest = doc.object();
     const auto updated = manifest["updated"].toString();
 
     const auto manifest_products = manifest["products"].toObject();
@@ -158,17 +179,29 @@ std::unique_ptr<mp::SimpleStreamsManifest> mp::SimpleStreamsManifest::fromJson(c
     if (products.empty())
         throw mp::EmptyManifestException("No supported products found.");
 
-    QMap<QString, const VMImageInfo*> map;
-
+    /* The pointers survive the move below: moving a vector hands over its buffer. Insertion order decides
+       between duplicate keys (last wins, as with the maps these indexes replace), hence the stable sort and
+       the backwards dedupe */
+    std::vector<SimpleStreamsManifest::IndexEntry> records;
+    std::vector<SimpleStreamsManifest::IndexEntry> by_id;
+    by_id.reserve(products.size());
     for (const auto& product : products)
     {
-        map[product.id] = &product;
+        records.emplace_back(product.id, &product);
+        by_id.emplace_back(product.id, &product);
         for (const auto& alias : product.aliases)
-        {
-            map[alias] = &product;
-        }
+            records.emplace_back(alias, &product);
+    }
+
+    for (auto index : {&records, &by_id})
+    {
+        std::stable_sort(index->begin(), index->end(),
+                         [](const auto& a, const auto& b) { return a.first < b.first; });
+        index->erase(index->begin(), std::unique(index->rbegin(), index->rend(), [](const auto& a, const auto& b) {
+                                         return a.first == b.first;
+                                     }).base());
     }
 
     return std::unique_ptr<SimpleStreamsManifest>(
-        new SimpleStreamsManifest{updated, std::move(products), std::move(map)});
+        new SimpleStreamsManifest{updated, std::move(products), std::move(records), std::move(by_id)});
 }
@@ -29,10 +29,26 @@ namespace mp = multipass;
 namespace
 {
 
+// Ed25519 is the default: its signatures are a fraction of the cost of RSA's, which shows in every
+// session handshake. An RSA key from an earlier install keeps being used, since its public half is
+// what existing instances were launched with.
+QString priv_key_path_for(const QDir& key_dir)
+{
+    auto ed25519_path = key_dir.filePath("id_ed25519");
+    if (QFile::exists(ed25519_path))
+        return ed25519_path;
+
+    auto rsa_path = key_dir.filePath("id_rsa");
+    if (QFile::exists(rsa_path))
+        return rsa_path;
+
+    return ed25519_path;
+}
+
 mp::OpenSSHKeyProvider::KeyUPtr create_priv_key(const QString& priv_key_path)
 {
     ssh_key priv_key;
-    auto ret = ssh_pki_generate(SSH_KEYTYPE_RSA, 2048, &priv_key);
+    auto ret = ssh_pki_generate(SSH_KEYTYPE_ED25519, 0, &priv_key);
     if (ret != SSH_OK)
         throw std::runtime_error("unable to generate ssh key");
 
@@ -45,9 +61,8 @@ mp::OpenSSHKeyProvider::KeyUPtr create_priv_key(const QString& priv_key_path)
     return key;
 }
 
-mp::OpenSSHKeyProvider::KeyUPtr get_priv_key(const QDir& key_dir)
+mp::OpenSSHKeyProvider::KeyUPtr get_priv_key(const QString& priv_key_path)
 {
-    auto priv_key_path = key_dir.filePath("id_rsa");
     if (QFile::exists(priv_key_path))
     {
         ssh_key priv_key;
@@ -59,21 +74,22 @@ mp::OpenSSHKeyProvider::KeyUPtr get_priv_key(const QDir& key_dir)
     }
     return create_priv_key(priv_key_path);
 }
-} // namespace
 
-void mp::OpenSSHKeyProvider::KeyDeleter::operator()(ssh_key key)
+std::string export_pubkey_base64(const mp::OpenSSHKeyProvider::KeyUPtr& priv_key)
 {
-    ssh_key_free(key);
-}
+    char* base64{nullptr};
+    auto ret = ssh_pki_export_pubkey_base64(priv_key.get(), &base64);
+    std::unique_ptr<char, decltype(std::free)*> base64_output{base64, std::free};
 
-mp::OpenSSHKeyProvider::OpenSSHKeyProvider(const mp::Path& cache_dir)
-    : ssh_key_dir{mp::utils::make_dir(cache_dir, "ssh-keys")}, priv_key{get_priv_key(ssh_key_dir)}
-{
+    if (ret != SSH_OK)
+        throw std::runtime_error("unable to export public key as base64");
+
+    return {base64};
 }
 
-std::string mp::OpenSSHKeyProvider::private_key_as_base64() const
+std::string read_priv_key_file(const QString& priv_key_path)
 {
-    QFile key_file{ssh_key_dir.filePath("id_rsa")};
+    QFile key_file{priv_key_path};
     auto opened = key_file.open(QIODevice::ReadOnly);
     if (!opened)
         throw std::runtime_error(fmt::format("Unable to open private key file '{}'", key_file.fileName()));
@@ -82,17 +98,30 @@ std::string mp::OpenSSHKeyProvider::private_key_as_base64() const
     auto data_size = static_cast<size_t>(data.length());
     return {data.constData(), data_size};
 }
+} // namespace
 
-std::string mp::OpenSSHKeyProvider::public_key_as_base64() const
+void mp::OpenSSHKeyProvider::KeyDeleter::operator()(ssh_key key)
 {
-    char* base64{nullptr};
-    auto ret = ssh_pki_export_pubkey_base64(priv_key.get(), &base64);
-    std::unique_ptr<char, decltype(std::free)*> base64_output{base64, std::free};
+    ssh_key_free(key);
+}
 
-    if (ret != SSH_OK)
-        throw std::runtime_error("unable to export public key as base64");
+mp::OpenSSHKeyProvider::OpenSSHKeyProvider(const mp::Path& cache_dir)
+    : ssh_key_dir{mp::utils::make_dir(cache_dir, "ssh-keys")},
+      priv_key_path{priv_key_path_for(ssh_key_dir)},
+      priv_key{get_priv_key(priv_key_path)},
+      priv_key_contents{read_priv_key_file(priv_key_path)},
+      pub_key_base64{export_pubkey_base64(priv_key)}
+{
+}
 
-    return {base64};
+std::string mp::OpenSSHKeyProvider::private_key_as_base64() const
+{
+    return priv_key_contents;
+}
+
+std::string mp::OpenSSHKeyProvider::public_key_as_base64() const
+{
+    return pub_key_base64;
 }
 
 ssh_key mp::OpenSSHKeyProvider::private_key() const
@@ -23,7 +23,10 @@
 
 #include <multipass/format.h>
 
+#include <algorithm>
 #include <array>
+#include <cstring>
+#include <deque>
 #include <fcntl.h>
 
 #include <QFile>
@@ -34,10 +37,14 @@ namespace
 {
 // TODO: For push/pull, use actual file permissions
 constexpr int file_mode = 0664;
-constexpr auto max_transfer = 65536u;
+constexpr auto max_read_transfer = 32768u;   // what stock sftp clients request per packet; served whole everywhere
+constexpr auto max_write_transfer = 131072u; // a write is one packet and one ack; bigger blocks mean fewer of both
+constexpr auto max_in_flight_reads = 32;     // ~1MiB outstanding keeps the link busy across the round-trip time
+constexpr auto resume_tail_check = 65536u;   // bytes re-read to confirm a partial file matches before resuming
 const std::string stream_file_name{"stream_output.dat"};
 
 using SFTPFileUPtr = std::unique_ptr<sftp_file_struct, int (*)(sftp_file)>;
+using SFTPAttributesUPtr = std::unique_ptr<sftp_attributes_struct, void (*)(sftp_attributes)>;
 
 mp::SFTPSessionUPtr make_sftp_session(ssh_session session)
 {
@@ -62,6 +69,77 @@ std::string full_destination(const std::string& destination_path, const std::str
 
     return destination_path;
 }
+
+// Compares the tail of the shorter, partially-transferred side against the same byte range of the remote
+// file — evidence that the partial file really is a prefix of the same content and not a size coincidence
+bool tails_match(const mp::SFTPSessionUPtr& sftp, const std::string& remote_path, QFile& local_file,
+                 sftp_off_t partial_size)
+{
+    const auto length = std::min<sftp_off_t>(partial_size, resume_tail_check);
+
+    SFTPFileUPtr remote{sftp_open(sftp.get(), remote_path.c_str(), O_RDONLY, file_mode), sftp_close};
+    if (remote == nullptr || sftp_seek64(remote.get(), partial_size - length) < 0)
+        return false;
+
+    if (!local_file.seek(partial_size - length))
+        return false;
+
+    std::array<char, max_read_transfer> remote_data;
+    std::array<char, max_read_transfer> local_data;
+    sftp_off_t compared = 0;
+    while (compared < length)
+    {
+        const auto r = sftp_read(remote.get(), remote_data.data(),
+                                 std::min<sftp_off_t>(length - compared, remote_data.size()));
+        if (r <= 0 || local_file.read(local_data.data(), r) != r ||
+            std::memcmp(remote_data.data(), local_data.data(), r) != 0)
+            return false;
+
+        compared += r;
+    }
+
+    return true;
+}
+
+// Keeps a window of read requests in flight, so the transfer is not limited to one block per round trip
+template <typename SinkAction>
+void pipelined_read(const mp::SFTPSessionUPtr& sftp, ssh_session session, sftp_file file, const char* error_msg,
+                    SinkAction&& sink)
+{
+    std::deque<int> pending;
+    auto begin_read = [&] {
+        auto id = sftp_async_read_begin(file, max_read_transfer);
+        if (id < 0)
+            mp::SSH::throw_on_error(sftp, session, error_msg, sftp_get_error);
+        pending.push_back(id);
+    };
+
+    for (auto i = 0; i < max_in_flight_reads; ++i)
+        begin_read();
+
+    std::array<char, max_read_transfer> data;
+    auto eof = false;
+    while (!pending.empty())
+    {
+        auto id = pending.front();
+        pending.pop_front();
+
+        auto r = sftp_async_read(file, data.data(), data.size(), id);
+        if (r < 0)
+            mp::SSH::throw_on_error(sftp, session, error_msg, sftp_get_error);
+
+        if (r == 0)
+        {
+            eof = true; // requests queued beyond this one are past the end; just drain them
+            continue;
+        }
+
+        sink(data.data(), r);
+
+        if (!eof)
+            begin_read();
+    }
+}
 } // namespace
 
 mp::SFTPClient::SFTPClient(const std::string& host, int port, const std::string& username,
@@ -79,15 +157,48 @@ mp::SFTPClient::SFTPClient(SSHSessionUPtr ssh_session)
 void mp::SFTPClient::push_file(const std::string& source_path, const std::string& destination_path)
 {
     auto full_destination_path = full_destination(destination_path, mp::utils::filename_for(source_path));
-    SFTPFileUPtr file_handle{
-        sftp_open(sftp.get(), full_destination_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, file_mode), sftp_close};
-    SSH::throw_on_error(sftp, *ssh_session, "[sftp push] open failed", sftp_get_error);
 
     QFile source(QString::fromStdString(source_path));
     if (!source.open(QIODevice::ReadOnly))
         throw std::runtime_error(fmt::format("[sftp push] error opening file for reading: {}", source.errorString()));
 
-    std::array<char, max_transfer> data;
+    // A shorter remote leftover from an interrupted push is itself the checkpoint: when its tail matches
+    // the same range of the source, the transfer picks up after it instead of starting from zero
+    sftp_off_t resume_offset = 0;
+    SFTPAttributesUPtr attrs{sftp_stat(sftp.get(), full_destination_path.c_str()), sftp_attributes_free};
+    if (attrs && attrs->size > 0 && attrs->size < static_cast<uint64_t>(source.size()) &&
+        tails_match(sftp, full_destination_path, source, attrs->size))
+        resume_offset = attrs->size;
+
+    SFTPFileUPtr file_handle{sftp_open(sftp.get(), full_destination_path.c_str(),
+                                       O_WRONLY | O_CREAT | (resume_offset ? 0 : O_TRUNC), file_mode),
+                             sftp_close};
+    if (file_handle == nullptr) // a failed stat above leaves a stale error behind, so only check on failure
+        SSH::throw_on_error(sftp, *ssh_session, "[sftp push] open failed", sftp_get_error);
+
+    if (resume_offset && sftp_seek64(file_handle.get(), resume_offset) < 0)
+        SSH::throw_on_error(sftp, *ssh_session, "[sftp push] seek failed", sftp_get_error);
+
+    // Hand sftp_write slices of a mapping of the source instead of staging each block in a buffer — for
+    // multi-GB artifacts that is one copy less per byte (the mapping dies with `source` at scope exit)
+    const auto remaining = source.size() - static_cast<qint64>(resume_offset);
+    if (auto mapped = remaining > 0 ? source.map(resume_offset, remaining) : nullptr; mapped != nullptr)
+    {
+        qint64 written = 0;
+        while (written < remaining)
+        {
+            const auto len = std::min<qint64>(remaining - written, max_write_transfer);
+            sftp_write(file_handle.get(), reinterpret_cast<const char*>(mapped) + written, len);
+            SSH::throw_on_error(sftp, *ssh_session, "[sftp push] remote write failed", sftp_get_error);
+            written += len;
+        }
+
+        return;
+    }
+
+    // empty source, or a filesystem that cannot map; fall back to the buffered loop
+    source.seek(resume_offset); // the tail probe moved the read position
+    std::array<char, max_write_transfer> data;
     while (true)
     {
         auto r = source.read(data.data(), data.size());
@@ -106,28 +217,37 @@ void mp::SFTPClient::push_file(const std::string& source_path, const std::string
 void mp::SFTPClient::pull_file(const std::string& source_path, const std::string& destination_path)
 {
     auto full_destination_path = full_destination(destination_path, mp::utils::filename_for(source_path));
+
+    // A shorter local leftover from an interrupted pull resumes the same way pushes do: tail probe
+    // first, then append from where it stopped
+    sftp_off_t resume_offset = 0;
+    {
+        SFTPAttributesUPtr attrs{sftp_stat(sftp.get(), source_path.c_str()), sftp_attributes_free};
+        QFile existing(QString::fromStdString(full_destination_path));
+        if (attrs && existing.open(QIODevice::ReadOnly) && existing.size() > 0 &&
+            static_cast<uint64_t>(existing.size()) < attrs->size &&
+            tails_match(sftp, source_path, existing, existing.size()))
+            resume_offset = existing.size();
+    }
+
     QFile destination(QString::fromStdString(full_destination_path));
-    if (!destination.open(QIODevice::WriteOnly))
+    if (!destination.open(resume_offset ? QIODevice::WriteOnly | QIODevice::Append : QIODevice::WriteOnly))
         throw std::runtime_error(
             fmt::format("[sftp pull] error opening file for writing: {}", destination.errorString()));
 
     SFTPFileUPtr file_handle{sftp_open(sftp.get(), source_path.c_str(), O_RDONLY, file_mode), sftp_close};
-    SSH::throw_on_error(sftp, *ssh_session, "[sftp pull] open failed", sftp_get_error);
-
-    std::array<char, max_transfer> data;
-    while (true)
-    {
-        auto r = sftp_read(file_handle.get(), data.data(), data.size());
-
-        if (r == 0)
-            break;
-
-        if (r < 0)
-            SSH::throw_on_error(sftp, *ssh_session, "[sftp pull] read failed", sftp_get_error);
-
-        if (destination.write(data.data(), r) == -1)
-            throw std::runtime_error(fmt::format("[sftp pull] error writing to file: {}", destination.errorString()));
-    }
+    if (file_handle == nullptr) // a failed stat above leaves a stale error behind, so only check on failure
+        SSH::throw_on_error(sftp, *ssh_session, "[sftp pull] open failed", sftp_get_error);
+
+    if (resume_offset && sftp_seek64(file_handle.get(), resume_offset) < 0)
+        SSH::throw_on_error(sftp, *ssh_session, "[sftp pull] seek failed", sftp_get_error);
+
+    pipelined_read(sftp, *ssh_session, file_handle.get(), "[sftp pull] read failed",
+                   [&destination](const char* data, std::streamsize size) {
+                       if (destination.write(data, size) == -1)
+                           throw std::runtime_error(
+                               fmt::format("[sftp pull] error writing to file: {}", destination.errorString()));
+                   });
 }
 
 void mp::SFTPClient::stream_file(const std::string& destination_path, std::istream& cin)
@@ -137,7 +257,7 @@ void mp::SFTPClient::stream_file(const std::string& destination_path, std::istre
         sftp_open(sftp.get(), full_destination_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, file_mode), sftp_close};
     SSH::throw_on_error(sftp, *ssh_session, "[sftp stream] open failed", sftp_get_error);
 
-    std::array<char, max_transfer> data;
+    std::array<char, max_write_transfer> data;
     while (!cin.eof())
     {
         cin.read(data.data(), data.size());
@@ -151,17 +271,6 @@ void mp::SFTPClient::stream_file(const std::string& source_path, std::ostream& c
     SFTPFileUPtr file_handle{sftp_open(sftp.get(), source_path.c_str(), O_RDONLY, file_mode), sftp_close};
     SSH::throw_on_error(sftp, *ssh_session, "[sftp pull] open failed", sftp_get_error);
 
-    std::array<char, max_transfer> data;
-    while (true)
-    {
-        auto r = sftp_read(file_handle.get(), data.data(), data.size());
-
-        if (r == 0)
-            break;
-
-        if (r < 0)
-            SSH::throw_on_error(sftp, *ssh_session, "[sftp pull] read failed", sftp_get_error);
-
-        cout << data.data();
-    }
+    pipelined_read(sftp, *ssh_session, file_handle.get(), "[sftp pull] read failed",
+                   [&cout](const char* data, std::streamsize size) { cout.write(data, size); });
 }
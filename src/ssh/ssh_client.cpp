@@ -67,6 +67,8 @@ int mp::SSHClient::exec(const std::vector<std::string>& args)
     return ssh_channel_get_exit_status(channel.get());
 }
 
+// The terminal pump is libssh connectors on an event loop: data moves fd<->channel inside libssh,
+// driven by readiness of the local fds and the ssh socket, with no copy loop on our side.
 void mp::SSHClient::handle_ssh_events()
 {
     using ConnectorUPtr = std::unique_ptr<ssh_connector_struct, void (*)(ssh_connector)>;
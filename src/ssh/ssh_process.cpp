@@ -27,7 +27,6 @@
 #include <libssh/callbacks.h>
 
 #include <array>
-#include <sstream>
 
 #include <cerrno>
 #include <cstring>
@@ -114,7 +113,33 @@ std::string mp::SSHProcess::read_std_error()
     return read_stream(StreamType::err);
 }
 
+void mp::SSHProcess::consume_std_output(const ChunkConsumer& consumer)
+{
+    consume_stream(StreamType::out, consumer);
+}
+
+void mp::SSHProcess::consume_std_error(const ChunkConsumer& consumer)
+{
+    consume_stream(StreamType::err, consumer);
+}
+
 std::string mp::SSHProcess::read_stream(StreamType type, int timeout)
+{
+    std::string output;
+
+    // whatever libssh has buffered already arrives in a single growth step rather than doublings
+    const auto buffered = ssh_channel_poll(channel.get(), type == StreamType::err);
+    if (buffered > 0)
+        output.reserve(buffered);
+
+    consume_stream(type, [&output](const char* data, std::size_t size) { output.append(data, size); }, timeout);
+
+    mpl::log(mpl::Level::debug, category,
+             fmt::format("{}:{} {}(): read {} bytes", __FILE__, __LINE__, __FUNCTION__, output.size()));
+    return output;
+}
+
+void mp::SSHProcess::consume_stream(StreamType type, const ChunkConsumer& consumer, int timeout)
 {
     mpl::log(mpl::Level::debug, category,
              fmt::format("{}:{} {}(type = {}, timeout = {}): ", __FILE__, __LINE__, __FUNCTION__,
@@ -124,18 +149,15 @@ std::string mp::SSHProcess::read_stream(StreamType type, int timeout)
     {
         mpl::log(mpl::Level::debug, category,
                  fmt::format("{}:{} {}(): channel closed", __FILE__, __LINE__, __FUNCTION__));
-        return std::string();
+        return;
     }
 
-    std::stringstream output;
-    std::array<char, 256> buffer;
+    std::array<char, 65536> buffer; // big reads spare syscalls and channel-window churn on chatty streams
     int num_bytes{0};
     const bool is_std_err = type == StreamType::err;
     do
     {
         num_bytes = ssh_channel_read_timeout(channel.get(), buffer.data(), buffer.size(), is_std_err, timeout);
-        mpl::log(mpl::Level::debug, category,
-                 fmt::format("{}:{} {}(): num_bytes = {}", __FILE__, __LINE__, __FUNCTION__, num_bytes));
         if (num_bytes < 0)
         {
             // Latest libssh now returns an error if the channel has been closed instead of returning 0 bytes
@@ -143,17 +165,16 @@ std::string mp::SSHProcess::read_stream(StreamType type, int timeout)
             {
                 mpl::log(mpl::Level::debug, category,
                          fmt::format("{}:{} {}(): channel closed", __FILE__, __LINE__, __FUNCTION__));
-                return output.str();
+                return;
             }
 
             throw std::runtime_error(fmt::format("error while reading ssh channel for remote process '{}'"
                                                  " - error: {}",
                                                  cmd, num_bytes));
         }
-        output.write(buffer.data(), num_bytes);
+        if (num_bytes > 0)
+            consumer(buffer.data(), num_bytes);
     } while (num_bytes > 0);
-
-    return output.str();
 }
 
 ssh_channel mp::SSHProcess::release_channel()
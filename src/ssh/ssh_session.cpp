@@ -15,11 +15,14 @@
  *
  */
 
+#include <multipass/performance_counters.h>
 #include <multipass/ssh/ssh_key_provider.h>
 #include <multipass/ssh/ssh_session.h>
 #include <multipass/ssh/throw_on_error.h>
 #include <multipass/standard_paths.h>
 
+#include "ssh_client_key_provider.h"
+
 #include <libssh/callbacks.h>
 #include <libssh/socket.h>
 
@@ -31,8 +34,26 @@
 #include <stdexcept>
 #include <string>
 
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
 namespace mp = multipass;
 
+namespace
+{
+void set_tcp_keepalive(socket_t sock)
+{
+    /* Without probes, a dead peer on a long-haul link goes unnoticed until the next write times out — which
+       for an idle mount session can be never — and stateful middleboxes expire the idle mapping under it */
+    const int enable{1}, idle{30}, interval{10}, probes{3};
+    setsockopt(sock, SOL_SOCKET, SO_KEEPALIVE, &enable, sizeof(enable));
+    setsockopt(sock, IPPROTO_TCP, TCP_KEEPIDLE, &idle, sizeof(idle));
+    setsockopt(sock, IPPROTO_TCP, TCP_KEEPINTVL, &interval, sizeof(interval));
+    setsockopt(sock, IPPROTO_TCP, TCP_KEEPCNT, &probes, sizeof(probes));
+}
+} // namespace
+
 mp::SSHSession::SSHSession(const std::string& host, int port, const std::string& username,
                            const SSHKeyProvider* key_provider, const std::chrono::milliseconds timeout)
     : session{ssh_new(), ssh_free}
@@ -53,14 +74,25 @@ mp::SSHSession::SSHSession(const std::string& host, int port, const std::string&
     set_option(SSH_OPTIONS_NODELAY, &nodelay);
     set_option(SSH_OPTIONS_CIPHERS_C_S, "chacha20-poly1305@openssh.com,aes256-ctr");
     set_option(SSH_OPTIONS_CIPHERS_S_C, "chacha20-poly1305@openssh.com,aes256-ctr");
+    /* The peers are always our own guests, so the negotiation outcome is known up front; offering only
+       the algorithms they will pick keeps the handshake to its minimum — this runs again on every retry
+       of the boot-time wait-for-ssh loop, so the round trips add up */
+    set_option(SSH_OPTIONS_KEY_EXCHANGE, "curve25519-sha256,curve25519-sha256@libssh.org");
+    set_option(SSH_OPTIONS_HOSTKEYS, "ssh-ed25519,rsa-sha2-512,rsa-sha2-256,ssh-rsa");
     set_option(SSH_OPTIONS_SSH_DIR, ssh_dir.c_str());
 
+    const auto begin = std::chrono::steady_clock::now();
     SSH::throw_on_error(session, "ssh connection failed", ssh_connect);
+    set_tcp_keepalive(ssh_get_fd(session.get()));
     if (key_provider)
     {
         SSH::throw_on_error(session, "ssh failed to authenticate", ssh_userauth_publickey, nullptr,
                             key_provider->private_key());
     }
+
+    perf::PerformanceCounters::instance().record_duration(
+        "ssh_session_establish",
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin));
 }
 
 mp::SSHSession::SSHSession(const std::string& host, int port, const std::string& username,
@@ -74,11 +106,22 @@ mp::SSHSession::SSHSession(const std::string& host, int port, const std::chrono:
 {
 }
 
+mp::SSHSession::SSHSession(const std::string& host, int port, const std::string& username,
+                           const std::string& priv_key_blob)
+    : SSHSession(host, port, username, SSHClientKeyProvider{priv_key_blob})
+{
+}
+
 mp::SSHProcess mp::SSHSession::exec(const std::string& cmd)
 {
     return {session.get(), cmd};
 }
 
+bool mp::SSHSession::is_connected() const
+{
+    return ssh_is_connected(session.get());
+}
+
 void mp::SSHSession::force_shutdown()
 {
     auto socket = ssh_get_fd(session.get());
@@ -112,6 +155,10 @@ const char* name_for(ssh_options_e type)
         return "client to server ciphers";
     case SSH_OPTIONS_CIPHERS_S_C:
         return "server to client ciphers";
+    case SSH_OPTIONS_KEY_EXCHANGE:
+        return "key exchange algorithms";
+    case SSH_OPTIONS_HOSTKEYS:
+        return "host key algorithms";
     case SSH_OPTIONS_SSH_DIR:
         return "ssh config directory";
     default:
@@ -128,6 +175,8 @@ std::string as_string(ssh_options_e type, const void* value)
     case SSH_OPTIONS_USER:
     case SSH_OPTIONS_CIPHERS_C_S:
     case SSH_OPTIONS_CIPHERS_S_C:
+    case SSH_OPTIONS_KEY_EXCHANGE:
+    case SSH_OPTIONS_HOSTKEYS:
     case SSH_OPTIONS_SSH_DIR:
         return std::string(reinterpret_cast<const char*>(value));
     case SSH_OPTIONS_PORT:
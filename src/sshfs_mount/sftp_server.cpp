@@ -20,6 +20,7 @@
 #include <multipass/cli/client_platform.h>
 #include <multipass/exceptions/exitless_sshprocess_exception.h>
 #include <multipass/logging/log.h>
+#include <multipass/performance_counters.h>
 #include <multipass/platform.h>
 #include <multipass/ssh/ssh_session.h>
 #include <multipass/ssh/throw_on_error.h>
@@ -31,28 +32,21 @@
 #include <QDir>
 #include <QFile>
 
+#include <ctime>
+
 namespace mp = multipass;
 namespace mpl = multipass::logging;
 
 namespace
 {
 constexpr auto category = "sftp server";
+constexpr qint64 read_ahead_size = 262144;  // fetched in one go when a handle is read sequentially
+constexpr qint64 max_write_buffer = 262144; // adjacent writes are coalesced up to this much before hitting the file
+constexpr auto attribute_cache_ttl = std::chrono::seconds(1);
+constexpr auto max_attribute_cache_entries = 65536u;
 using SftpHandleUPtr = std::unique_ptr<ssh_string_struct, void (*)(ssh_string)>;
 using namespace std::literals::chrono_literals;
 
-enum Permissions
-{
-    read_user = 0400,
-    write_user = 0200,
-    exec_user = 0100,
-    read_group = 040,
-    write_group = 020,
-    exec_group = 010,
-    read_other = 04,
-    write_other = 02,
-    exec_other = 01
-};
-
 auto make_sftp_session(ssh_session session, ssh_channel channel)
 {
     mp::SftpServer::SftpSessionUptr sftp_server_session{sftp_server_new(session, channel), sftp_free};
@@ -91,124 +85,53 @@ fmt::memory_buffer& operator<<(fmt::memory_buffer& buf, const char* v)
     return buf;
 }
 
-auto longname_from(const QFileInfo& file_info, const std::string& filename)
+fmt::memory_buffer& longname_from(const QFileInfo& file_info, const std::string& filename, fmt::memory_buffer& out)
 {
-    fmt::memory_buffer out;
-    auto mode = file_info.permissions();
+    // triads indexed by each class's r=4/w=2/x=1 bits — three table lookups instead of nine branches
+    static constexpr const char* triads[] = {"---", "--x", "-w-", "-wx", "r--", "r-x", "rw-", "rwx"};
+    static constexpr const char* months[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+                                             "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+
+    out.clear();
 
     if (file_info.isSymLink())
-        out << "l";
+        out.push_back('l');
     else if (file_info.isDir())
-        out << "d";
-    else
-        out << "-";
-
-    /* user */
-    if (mode & QFileDevice::ReadOwner)
-        out << "r";
-    else
-        out << "-";
-
-    if (mode & QFileDevice::WriteOwner)
-        out << "w";
-    else
-        out << "-";
-
-    if (mode & QFileDevice::ExeOwner)
-        out << "x";
+        out.push_back('d');
     else
-        out << "-";
+        out.push_back('-');
 
-    /*group*/
-    if (mode & QFileDevice::ReadGroup)
-        out << "r";
-    else
-        out << "-";
-
-    if (mode & QFileDevice::WriteGroup)
-        out << "w";
-    else
-        out << "-";
-
-    if (mode & QFileDevice::ExeGroup)
-        out << "x";
-    else
-        out << "-";
-
-    /* other */
-    if (mode & QFileDevice::ReadOther)
-        out << "r";
-    else
-        out << "-";
-
-    if (mode & QFileDevice::WriteOther)
-        out << "w";
-    else
-        out << "-";
-
-    if (mode & QFileDevice::ExeOther)
-        out << "x";
-    else
-        out << "-";
+    const auto qt_perms = static_cast<int>(file_info.permissions()); // Owner flags sit in the top nibble
+    fmt::format_to(out, "{}{}{}", triads[(qt_perms >> 12) & 07], triads[(qt_perms >> 4) & 07], triads[qt_perms & 07]);
 
     fmt::format_to(out, " 1 {} {} {}", file_info.ownerId(), file_info.groupId(), file_info.size());
 
-    const auto timestamp = file_info.lastModified().toString("MMM d hh:mm:ss yyyy").toStdString();
-    fmt::format_to(out, " {} {}", timestamp, filename);
+    // the ls-style date is assembled by hand: QDateTime::toString drags the locale machinery in per entry
+    const auto mtime = static_cast<std::time_t>(file_info.lastModified().toSecsSinceEpoch());
+    struct tm broken_down
+    {
+    };
+    localtime_r(&mtime, &broken_down);
+    fmt::format_to(out, " {} {} {:02}:{:02}:{:02} {} {}", months[broken_down.tm_mon], broken_down.tm_mday,
+                   broken_down.tm_hour, broken_down.tm_min, broken_down.tm_sec, broken_down.tm_year + 1900, filename);
+
+    out.push_back('\0'); // the C API reads up to a NUL, and a reused buffer may hold stale bytes past the end
 
     return out;
 }
 
+// Both permission representations keep the same r=4/w=2/x=1 order inside each class triad, with Qt
+// using one nibble per class (0x400/0x40/0x4 for user/group/other reads). The conversions below are
+// therefore plain bit relocations — this sits in the per-message attribute path, so no branching
 auto to_qt_permissions(uint32_t perms)
 {
-    QFile::Permissions out;
-
-    if (perms & Permissions::read_user)
-        out |= QFileDevice::ReadUser;
-    if (perms & Permissions::write_user)
-        out |= QFileDevice::WriteUser;
-    if (perms & Permissions::exec_user)
-        out |= QFileDevice::ExeUser;
-    if (perms & Permissions::read_group)
-        out |= QFileDevice::ReadGroup;
-    if (perms & Permissions::write_group)
-        out |= QFileDevice::WriteGroup;
-    if (perms & Permissions::exec_group)
-        out |= QFileDevice::ExeGroup;
-    if (perms & Permissions::read_other)
-        out |= QFileDevice::ReadOther;
-    if (perms & Permissions::write_other)
-        out |= QFileDevice::WriteOther;
-    if (perms & Permissions::exec_other)
-        out |= QFileDevice::ExeOther;
-
-    return out;
+    return QFile::Permissions(QFlag(((perms & 0700) << 2) | ((perms & 070) << 1) | (perms & 07)));
 }
 
 auto to_unix_permissions(QFile::Permissions perms)
 {
-    int out = 0;
-
-    if (perms & QFileDevice::ReadOwner)
-        out |= Permissions::read_user;
-    if (perms & QFileDevice::WriteOwner)
-        out |= Permissions::write_user;
-    if (perms & QFileDevice::ExeOwner)
-        out |= Permissions::exec_user;
-    if (perms & QFileDevice::ReadGroup)
-        out |= Permissions::read_group;
-    if (perms & QFileDevice::WriteGroup)
-        out |= Permissions::write_group;
-    if (perms & QFileDevice::ExeGroup)
-        out |= Permissions::exec_group;
-    if (perms & QFileDevice::ReadOther)
-        out |= Permissions::read_other;
-    if (perms & QFileDevice::WriteOther)
-        out |= Permissions::write_other;
-    if (perms & QFileDevice::ExeOther)
-        out |= Permissions::exec_other;
-
-    return out;
+    const auto qt_perms = static_cast<int>(perms); // the Owner flags, not the user ones, map to unix
+    return ((qt_perms & 0x7000) >> 6) | ((qt_perms & 0x70) >> 1) | (qt_perms & 0x7);
 }
 
 auto validate_path(const std::string& source_path, const std::string& current_path)
@@ -334,10 +257,75 @@ int mp::SftpServer::mapped_gid_for(const int gid)
     return gid;
 }
 
+bool mp::SftpServer::flush_writes(QFile* file, HandleIo& io)
+{
+    if (io.write_buffer.isEmpty())
+        return true;
+
+    auto ok = file->seek(io.write_buffer_offset);
+    auto data_ptr = io.write_buffer.constData();
+    qint64 remaining = io.write_buffer.size();
+    while (ok && remaining > 0)
+    {
+        auto r = file->write(data_ptr, remaining);
+        if (r < 0)
+        {
+            ok = false;
+            break;
+        }
+
+        data_ptr += r;
+        remaining -= r;
+    }
+
+    if (ok)
+        file->flush();
+
+    io.write_buffer.resize(0); // unlike clear(), this keeps the capacity for the next run of writes
+    io.write_buffer_offset = -1;
+
+    if (!ok)
+    {
+        io.write_error = true;
+        mpl::log(mpl::Level::error, category,
+                 fmt::format("error writing to file '{}': {}", file->fileName(), file->errorString()));
+    }
+
+    invalidate_attributes(file->fileName().toStdString()); // size and mtime just changed
+    return ok;
+}
+
+void mp::SftpServer::flush_all_writes()
+{
+    for (auto& entry : handle_io)
+        flush_writes(entry.first, entry.second);
+}
+
+void mp::SftpServer::cache_attributes(const std::string& path, const sftp_attributes_struct& attr, const bool follow)
+{
+    if (attribute_cache.size() >= max_attribute_cache_entries)
+        attribute_cache.clear(); // crude, but keeps the cache bounded without bookkeeping on the hot path
+
+    attribute_cache[path] = {attr, follow, std::chrono::steady_clock::now() + attribute_cache_ttl};
+}
+
+void mp::SftpServer::invalidate_attributes(const std::string& path)
+{
+    attribute_cache.erase(path);
+}
+
 void mp::SftpServer::process_message(sftp_client_message msg)
 {
     int ret = 0;
     const auto type = sftp_client_message_get_type(msg);
+
+    MPL_TRACE_LOG(category, "processing message type {}", static_cast<int>(type));
+
+    // Coalesced writes (see handle_write) sit in memory; anything other than more I/O on open
+    // handles has to observe them, so they go to the filesystem first
+    if (type != SFTP_WRITE && type != SFTP_READ)
+        flush_all_writes();
+
     switch (type)
     {
     case SFTP_REALPATH:
@@ -394,11 +382,11 @@ void mp::SftpServer::process_message(sftp_client_message msg)
         ret = handle_extended(msg);
         break;
     default:
-        mpl::log(mpl::Level::warning, category, fmt::format("Unknown message: {}", static_cast<int>(type)));
+        mpl::log(mpl::Level::warning, category, "Unknown message: {}", static_cast<int>(type));
         ret = reply_unsupported(msg);
     }
     if (ret != 0)
-        mpl::log(mpl::Level::error, category, fmt::format("error occurred when replying to client: {}", ret));
+        mpl::log(mpl::Level::error, category, "error occurred when replying to client: {}", ret);
 }
 
 void mp::SftpServer::run()
@@ -411,6 +399,8 @@ void mp::SftpServer::run()
         auto msg = client_msg.get();
         if (msg == nullptr)
         {
+            flush_all_writes(); // the message stream is over, one way or another
+
             if (stop_invoked)
                 break;
 
@@ -462,13 +452,27 @@ int mp::SftpServer::handle_close(sftp_client_message msg)
 {
     const auto id = sftp_handle(sftp_server_session.get(), msg->handle);
 
+    auto failed_writes = false;
+    auto file_it = open_file_handles.find(id);
+    if (file_it != open_file_handles.end())
+    {
+        auto io_it = handle_io.find(file_it->second.get());
+        if (io_it != handle_io.end())
+        {
+            // close is the last chance to report writes that were deferred and then failed
+            flush_writes(file_it->second.get(), io_it->second);
+            failed_writes = io_it->second.write_error;
+            handle_io.erase(io_it);
+        }
+    }
+
     auto erased = open_file_handles.erase(id);
     erased += open_dir_handles.erase(id);
     if (erased == 0)
         return reply_bad_handle(msg, "close");
 
     sftp_handle_remove(sftp_server_session.get(), id);
-    return reply_ok(msg);
+    return failed_writes ? reply_failure(msg) : reply_ok(msg);
 }
 
 int mp::SftpServer::handle_fstat(sftp_client_message msg)
@@ -583,6 +587,7 @@ int mp::SftpServer::handle_open(sftp_client_message msg)
     SftpHandleUPtr sftp_handle{sftp_handle_alloc(sftp_server_session.get(), file.get()), ssh_string_free};
     open_file_handles.emplace(file.get(), std::move(file));
 
+    invalidate_attributes(filename); // opening may have created or truncated the file
     return sftp_reply_handle(msg, sftp_handle.get());
 }
 
@@ -616,18 +621,89 @@ int mp::SftpServer::handle_read(sftp_client_message msg)
 
     const auto max_packet_size = 65536u;
     const auto len = std::min(msg->len, max_packet_size);
+    const qint64 offset = msg->offset;
 
-    std::vector<char> data;
-    data.reserve(len);
+    auto& io = handle_io[file];
+    if (!flush_writes(file, io)) // reads have to observe writes still sitting in the buffer
+        return reply_failure(msg);
+
+    // Serve from the read-ahead block if the requested range starts inside it
+    const auto buffer_end = io.read_buffer_offset + io.read_buffer.size();
+    if (!io.read_buffer.isEmpty() && offset >= io.read_buffer_offset && offset < buffer_end)
+    {
+        const auto n = std::min<qint64>(len, buffer_end - offset);
+        io.next_sequential_read = offset + n;
+        mp::perf::PerformanceCounters::instance().increment("sftp_read_bytes", n);
+        return sftp_reply_data(msg, io.read_buffer.data() + (offset - io.read_buffer_offset), n);
+    }
+
+    if (offset == io.next_sequential_read)
+    {
+        // A sequential scan; the block for this offset may already be on its way from the prefetch below
+        if (io.read_ahead_future.valid() && io.read_ahead_future_offset == offset)
+        {
+            io.read_buffer = io.read_ahead_future.get();
+            io.read_buffer_offset = offset;
+        }
+        io.read_ahead_future_offset = -1;
+
+        if (io.read_buffer.isEmpty() || io.read_buffer_offset != offset)
+        {
+            // Nothing prefetched (or the prefetch failed); fetch a larger block here and now
+            io.read_buffer.resize(read_ahead_size);
+            auto r = file->seek(offset) ? file->read(io.read_buffer.data(), read_ahead_size) : -1;
+            if (r <= 0)
+            {
+                io.read_buffer.clear();
+                if (r < 0)
+                    return sftp_reply_status(msg, SSH_FX_FAILURE, file->errorString().toStdString().c_str());
+                return sftp_reply_status(msg, SSH_FX_EOF, "End of file");
+            }
+
+            io.read_buffer.truncate(r);
+            io.read_buffer_offset = offset;
+        }
 
-    file->seek(msg->offset);
-    auto r = file->read(data.data(), len);
+        if (io.read_buffer.size() == read_ahead_size)
+        {
+            // Not at the end yet, so fetch the following block in the background, on an independent
+            // descriptor; the disk works while this one drains over the channel
+            const auto next_offset = offset + read_ahead_size;
+            io.read_ahead_future = std::async(std::launch::async, [path = file->fileName(), next_offset] {
+                QFile reader{path};
+                QByteArray block;
+                if (!reader.open(QIODevice::ReadOnly) || !reader.seek(next_offset))
+                    return block;
+
+                block.resize(read_ahead_size);
+                auto r = reader.read(block.data(), read_ahead_size);
+                block.truncate(r < 0 ? 0 : r);
+                return block;
+            });
+            io.read_ahead_future_offset = next_offset;
+        }
+
+        const auto n = std::min<qint64>(len, io.read_buffer.size());
+        io.next_sequential_read = offset + n;
+        mp::perf::PerformanceCounters::instance().increment("sftp_read_bytes", n);
+        return sftp_reply_data(msg, io.read_buffer.data(), n);
+    }
+
+    // sftp_reply_data copies into the outgoing packet before returning, so one grow-only scratch
+    // buffer serves every non-sequential read instead of a fresh allocation per message
+    if (random_read_buffer.size() < static_cast<int>(len))
+        random_read_buffer.resize(len);
+
+    file->seek(offset);
+    auto r = file->read(random_read_buffer.data(), len);
     if (r < 0)
         return sftp_reply_status(msg, SSH_FX_FAILURE, file->errorString().toStdString().c_str());
     else if (r == 0)
         return sftp_reply_status(msg, SSH_FX_EOF, "End of file");
 
-    return sftp_reply_data(msg, data.data(), r);
+    io.next_sequential_read = offset + r; // a run may turn sequential from here
+    mp::perf::PerformanceCounters::instance().increment("sftp_read_bytes", r);
+    return sftp_reply_data(msg, random_read_buffer.data(), r);
 }
 
 int mp::SftpServer::handle_readdir(sftp_client_message msg)
@@ -639,10 +715,16 @@ int mp::SftpServer::handle_readdir(sftp_client_message msg)
     if (dir_entries->empty())
         return sftp_reply_status(msg, SSH_FX_EOF, nullptr);
 
-    const auto max_num_entries_per_packet = 50;
-    const auto num_entries = std::min(dir_entries->size(), max_num_entries_per_packet);
+    // Pack as many entries as fit in one SFTP packet; names and longnames dominate the per-entry
+    // footprint, the attributes are a fixed few dozen bytes on top
+    const auto max_reply_bytes = 32000;
+    const auto max_num_entries_per_packet = 200;
+    auto reply_bytes = 0;
+    auto num_entries = 0;
+
+    fmt::memory_buffer longname; // reused across entries; a large directory would otherwise allocate one per file
 
-    for (int i = 0; i < num_entries; i++)
+    while (!dir_entries->isEmpty() && num_entries < max_num_entries_per_packet && reply_bytes < max_reply_bytes)
     {
         const QFileInfo entry = dir_entries->takeFirst();
         const auto filename = entry.fileName().toStdString();
@@ -657,8 +739,15 @@ int mp::SftpServer::handle_readdir(sftp_client_message msg)
         {
             attr = attr_from(entry);
         }
-        const auto longname = longname_from(entry, filename);
+
+        // the lstats that typically follow a directory listing can then be answered from memory
+        cache_attributes(entry.absoluteFilePath().toStdString(), attr, false);
+
+        longname_from(entry, filename, longname);
         sftp_reply_names_add(msg, filename.c_str(), longname.data(), &attr);
+
+        reply_bytes += static_cast<int>(filename.size() + longname.size() - 1) + 64;
+        ++num_entries;
     }
 
     return sftp_reply_names(msg);
@@ -697,6 +786,8 @@ int mp::SftpServer::handle_remove(sftp_client_message msg)
 
     if (!QFile::remove(filename))
         return reply_failure(msg);
+
+    invalidate_attributes(filename);
     return reply_ok(msg);
 }
 
@@ -722,6 +813,8 @@ int mp::SftpServer::handle_rename(sftp_client_message msg)
     if (!QFile::rename(source, target))
         return reply_failure(msg);
 
+    invalidate_attributes(source);
+    invalidate_attributes(target);
     return reply_ok(msg);
 }
 
@@ -770,6 +863,7 @@ int mp::SftpServer::handle_setstat(sftp_client_message msg)
             return reply_failure(msg);
     }
 
+    invalidate_attributes(filename.toStdString());
     return reply_ok(msg);
 }
 
@@ -779,6 +873,12 @@ int mp::SftpServer::handle_stat(sftp_client_message msg, const bool follow)
     if (!validate_path(source_path, filename))
         return reply_perm_denied(msg);
 
+    const std::string path{filename};
+    auto cached = attribute_cache.find(path);
+    if (cached != attribute_cache.end() && cached->second.follow == follow &&
+        std::chrono::steady_clock::now() < cached->second.expiry)
+        return sftp_reply_attr(msg, &cached->second.attr);
+
     QFileInfo file_info(filename);
     if (!file_info.isSymLink() && !file_info.exists())
         return sftp_reply_status(msg, SSH_FX_NO_SUCH_FILE, "no such file");
@@ -799,6 +899,7 @@ int mp::SftpServer::handle_stat(sftp_client_message msg, const bool follow)
         attr = attr_from(file_info);
     }
 
+    cache_attributes(path, attr, follow);
     return sftp_reply_attr(msg, &attr);
 }
 
@@ -835,20 +936,41 @@ int mp::SftpServer::handle_write(sftp_client_message msg)
 
     auto len = ssh_string_len(msg->data);
     auto data_ptr = ssh_string_get_char(msg->data);
-    if (!file->seek(msg->offset))
+    const qint64 offset = msg->offset;
+
+    auto& io = handle_io[file];
+    io.read_buffer.clear();             // keep subsequent reads coherent with this write
+    io.read_ahead_future_offset = -1;   // and drop any prefetched block, it may be stale now
+
+    if (io.write_error)
+    {
+        // a deferred write failed since it was acknowledged; surface that rather than dropping it
+        io.write_error = false;
         return reply_failure(msg);
+    }
 
-    do
+    // Adjacent writes are coalesced into one buffer, turning the 32K blocks sshfs sends for a bulk
+    // write into a fraction of the seek/write/flush cycles; anything non-contiguous flushes first
+    if (io.write_buffer_offset >= 0 && offset != io.write_buffer_offset + io.write_buffer.size())
     {
-        auto r = file->write(data_ptr, len);
-        if (r < 0)
+        if (!flush_writes(file, io))
+        {
+            io.write_error = false;
             return reply_failure(msg);
+        }
+    }
 
-        file->flush();
+    if (io.write_buffer_offset < 0)
+        io.write_buffer_offset = offset;
 
-        data_ptr += r;
-        len -= r;
-    } while (len > 0);
+    io.write_buffer.append(data_ptr, len);
+    mp::perf::PerformanceCounters::instance().increment("sftp_write_bytes", len);
+
+    if (io.write_buffer.size() >= max_write_buffer && !flush_writes(file, io))
+    {
+        io.write_error = false;
+        return reply_failure(msg);
+    }
 
     return reply_ok(msg);
 }
@@ -56,41 +56,45 @@ auto run_cmd(mp::SSHSession& session, std::string&& cmd)
 auto get_sshfs_exec_and_options(mp::SSHSession& session)
 {
     std::string sshfs_exec;
+    std::string detection_output;
 
+    // One round trip covering both locations; the Snap package version remains preferred
     try
     {
-        // Prefer to use Snap package version first
-        auto sshfs_env{run_cmd(session, "snap run multipass-sshfs.env")};
+        detection_output = run_cmd(session, "snap run multipass-sshfs.env 2>/dev/null || sudo which sshfs");
+    }
+    catch (const std::exception& e)
+    {
+        mpl::log(mpl::Level::warning, category,
+                 fmt::format("Unable to determine if 'sshfs' is installed: {}", e.what()));
+        throw mp::SSHFSMissingError();
+    }
 
-        auto ld_library_path = mp::utils::match_line_for(sshfs_env, ld_library_path_key);
-        auto snap_path = mp::utils::match_line_for(sshfs_env, snap_path_key);
+    auto snap_path = mp::utils::match_line_for(detection_output, snap_path_key);
+    if (!snap_path.empty())
+    {
+        auto ld_library_path = mp::utils::match_line_for(detection_output, ld_library_path_key);
         snap_path = snap_path.substr(snap_path_key.length());
 
         sshfs_exec = fmt::format("env {} {}/bin/sshfs", ld_library_path, snap_path);
     }
-    catch (const std::exception& e)
+    else
     {
         mpl::log(mpl::Level::debug, category,
-                 fmt::format("'multipass-sshfs' snap package is not installed: {}", e.what()));
-
-        // Fallback to looking for distro version if snap is not found
-        try
-        {
-            sshfs_exec = run_cmd(session, "sudo which sshfs");
-        }
-        catch (const std::exception& e)
-        {
-            mpl::log(mpl::Level::warning, category,
-                     fmt::format("Unable to determine if 'sshfs' is installed: {}", e.what()));
-            throw mp::SSHFSMissingError();
-        }
+                 "'multipass-sshfs' snap package is not installed, using the distro sshfs");
+        sshfs_exec = detection_output;
     }
 
     sshfs_exec = mp::utils::trim_end(sshfs_exec);
 
     auto version_info{run_cmd(session, fmt::format("sudo {} -V", sshfs_exec))};
 
-    sshfs_exec += " -o slave -o transform_symlinks -o allow_other";
+    /* Besides the mount plumbing (slave, symlinks, permissions): auto_cache keeps file pages cached in the
+       guest between opens, dropping them when the attributes change, and the kernel-side attribute/entry
+       timeouts let a build re-stat the same tree from memory instead of each lookup taking an
+       sshfs->SftpServer round trip — sshfs's own stat cache is far looser (20s) than these 3s anyway */
+    sshfs_exec += " -o slave -o transform_symlinks -o allow_other -o auto_cache"
+                  " -o attr_timeout=3 -o entry_timeout=3 -o negative_timeout=3";
 
     auto fuse_version_line = mp::utils::match_line_for(version_info, fuse_version_string);
     if (!fuse_version_line.empty())
@@ -110,7 +114,8 @@ auto get_sshfs_exec_and_options(mp::SSHSession& session)
         // The option was made the default in libfuse 3.0
         else if (version::Semver200_version(fuse_version) < version::Semver200_version("3.0.0"))
         {
-            sshfs_exec += " -o nonempty";
+            // both defaults as of libfuse 3.0: mounting over non-empty dirs, and 128KiB writes instead of 4KiB
+            sshfs_exec += " -o nonempty -o big_writes";
         }
     }
     else
@@ -167,25 +172,32 @@ void set_owner_for(mp::SSHSession& session, const std::string& root, const std::
 }
 
 auto make_sftp_server(mp::SSHSession&& session, const std::string& source, const std::string& target,
-                      const std::unordered_map<int, int>& gid_map, const std::unordered_map<int, int>& uid_map)
+                      const std::unordered_map<int, int>& gid_map, const std::unordered_map<int, int>& uid_map,
+                      std::string& sshfs_exec_line)
 {
     mpl::log(mpl::Level::debug, category,
              fmt::format("{}:{} {}(source = {}, target = {}, …): ", __FILE__, __LINE__, __FUNCTION__, source, target));
 
-    auto sshfs_exec_line = get_sshfs_exec_and_options(session);
+    if (sshfs_exec_line.empty())
+        sshfs_exec_line = get_sshfs_exec_and_options(session);
+    else // further mounts in the same instance reuse the first one's probe, skipping two guest execs each
+        mpl::log(mpl::Level::debug, category,
+                 fmt::format("using cached sshfs invocation \"{}\", skipping probes", sshfs_exec_line));
+
+    // Magic prefix parsed by the daemon, which caches the invocation for the instance's next mount
+    std::cout << "sshfs exec: " << sshfs_exec_line << std::endl;
 
     // Split the path in existing and missing parts.
     const auto& [leading, missing] = get_path_split(session, target);
 
-    auto output = run_cmd(session, "id -u");
-    mpl::log(mpl::Level::debug, category,
-             fmt::format("{}:{} {}(): `id -u` = {}", __FILE__, __LINE__, __FUNCTION__, output));
-    auto default_uid = std::stoi(output);
-
-    output = run_cmd(session, "id -g");
+    auto output = run_cmd(session, "id -u; id -g");
     mpl::log(mpl::Level::debug, category,
-             fmt::format("{}:{} {}(): `id -g` = {}", __FILE__, __LINE__, __FUNCTION__, output));
-    auto default_gid = std::stoi(output);
+             fmt::format("{}:{} {}(): `id -u; id -g` = {}", __FILE__, __LINE__, __FUNCTION__, output));
+    auto ids = mp::utils::split(output, "\n");
+    if (ids.size() < 2)
+        throw std::runtime_error(fmt::format("unexpected output from `id`: {}", output));
+    auto default_uid = std::stoi(ids[0]);
+    auto default_gid = std::stoi(ids[1]);
 
     // We need to create the part of the path which does not still exist,
     // and set then the correct ownership.
@@ -202,8 +214,10 @@ auto make_sftp_server(mp::SSHSession&& session, const std::string& source, const
 } // namespace
 
 mp::SshfsMount::SshfsMount(SSHSession&& session, const std::string& source, const std::string& target,
-                           const std::unordered_map<int, int>& gid_map, const std::unordered_map<int, int>& uid_map)
-    : sftp_server{make_sftp_server(std::move(session), source, target, gid_map, uid_map)}, sftp_thread{[this] {
+                           const std::unordered_map<int, int>& gid_map, const std::unordered_map<int, int>& uid_map,
+                           std::string sshfs_exec_line)
+    : sftp_server{make_sftp_server(std::move(session), source, target, gid_map, uid_map, sshfs_exec_line)},
+      sftp_thread{[this] {
           std::cout << "Connected" << std::endl;
           sftp_server->run();
           std::cout << "Stopped" << std::endl;
@@ -33,6 +33,7 @@ namespace mpl = multipass::logging;
 namespace
 {
 constexpr auto category = "sshfs-mounts";
+constexpr auto max_mount_restarts = 3; // per mount, between successful connections
 
 template <typename Signal>
 void start_and_block_until(mp::Process* process, Signal signal, std::function<bool(mp::Process* process)> ready_decider)
@@ -65,6 +66,17 @@ mp::SSHFSMounts::SSHFSMounts(const SSHKeyProvider& key_provider) : key(key_provi
 void mp::SSHFSMounts::start_mount(VirtualMachine* vm, const std::string& source_path, const std::string& target_path,
                                   const std::unordered_map<int, int>& gid_map,
                                   const std::unordered_map<int, int>& uid_map)
+{
+    start_mount_process(vm, source_path, target_path, gid_map, uid_map);
+
+    // Only a mount that came up once is worth supervising; failures to establish keep throwing to the caller
+    mount_details[vm->vm_name][target_path] = MountDetails{vm, source_path, gid_map, uid_map};
+}
+
+void mp::SSHFSMounts::start_mount_process(VirtualMachine* vm, const std::string& source_path,
+                                          const std::string& target_path,
+                                          const std::unordered_map<int, int>& gid_map,
+                                          const std::unordered_map<int, int>& uid_map)
 {
     mp::SSHFSServerConfig config;
     config.host = vm->ssh_hostname();
@@ -77,6 +89,10 @@ void mp::SSHFSMounts::start_mount(VirtualMachine* vm, const std::string& source_
     config.gid_map = gid_map;
     config.private_key = key;
 
+    auto cached_exec = sshfs_exec_cache.find(vm->vm_name);
+    if (cached_exec != sshfs_exec_cache.end())
+        config.sshfs_exec_line = cached_exec->second;
+
     auto sshfs_server_process_t = mp::platform::make_sshfs_server_process(config);
     // FIXME: ProcessFactory really should return qt_delete_later_unique_ptr<Process> as Process emits signals
     // and the respective slots may be called on the event loop, but unique_ptr can delete the Process before
@@ -86,20 +102,56 @@ void mp::SSHFSMounts::start_mount(VirtualMachine* vm, const std::string& source_
     QObject::connect(
         sshfs_server_process.get(), &mp::Process::finished, this,
         [this, instance = vm->vm_name, target_path](mp::ProcessState exit_state) {
+            mount_processes[instance].erase(target_path);
+
             if (exit_state.completed_successfully())
             {
                 mpl::log(mpl::Level::info, category,
                          fmt::format("Mount '{}' in instance \"{}\" has stopped", target_path, instance));
+                return;
             }
-            else
+
+            mpl::log(mpl::Level::warning, // not error as it failing can indicate we need to install sshfs in the VM
+                     category,
+                     fmt::format("Mount '{}' in instance \"{}\" has stopped unexpectedly: {}", target_path, instance,
+                                 exit_state.failure_message()));
+
+            // A mount that was up and died (e.g. over a network blip) is brought back without waiting
+            // for a manual umount/mount cycle; details are gone if the mount was stopped on purpose
+            auto instance_details = mount_details.find(instance);
+            if (instance_details == mount_details.end())
+                return;
+
+            auto details_it = instance_details->second.find(target_path);
+            if (details_it == instance_details->second.end())
+                return;
+
+            auto& details = details_it->second;
+            if (++details.restart_attempts > max_mount_restarts)
             {
-                mpl::log(mpl::Level::warning, // not error as it failing can indicate we need to install sshfs in the VM
-                         category,
-                         fmt::format("Mount '{}' in instance \"{}\" has stopped unexpectedly: {}", target_path,
-                                     instance, exit_state.failure_message()));
+                mpl::log(mpl::Level::error, category,
+                         fmt::format("Giving up on mount '{}' in instance \"{}\" after {} failed attempts to restart",
+                                     target_path, instance, max_mount_restarts));
+                instance_details->second.erase(details_it);
+                return;
             }
 
-            mount_processes[instance].erase(target_path);
+            mpl::log(mpl::Level::info, category,
+                     fmt::format("Restarting mount '{}' in instance \"{}\" (attempt {} of {})", target_path, instance,
+                                 details.restart_attempts, max_mount_restarts));
+            try
+            {
+                start_mount_process(details.vm, details.source_path, target_path, details.gid_map, details.uid_map);
+                details.restart_attempts = 0;
+                mpl::log(mpl::Level::info, category,
+                         fmt::format("Mount '{}' in instance \"{}\" re-established", target_path, instance));
+            }
+            catch (const std::exception& e)
+            {
+                mpl::log(mpl::Level::error, category,
+                         fmt::format("Failed to restart mount '{}' in instance \"{}\": {}", target_path, instance,
+                                     e.what()));
+            }
         });
 
     QObject::connect(
@@ -117,9 +169,11 @@ void mp::SSHFSMounts::start_mount(VirtualMachine* vm, const std::string& source_
     mpl::log(mpl::Level::info, category,
              fmt::format("process arguments '{}'", sshfs_server_process->arguments().join(", ").toStdString()));
 
+    QByteArray server_output;
     start_and_block_until(
-        sshfs_server_process.get(), &mp::Process::ready_read_standard_output, [](mp::Process* process) {
-            return process->read_all_standard_output().contains("Connected"); // Magic string printed by sshfs_server
+        sshfs_server_process.get(), &mp::Process::ready_read_standard_output, [&server_output](mp::Process* process) {
+            server_output += process->read_all_standard_output();
+            return server_output.contains("Connected"); // Magic string printed by sshfs_server
         });
 
     // Check in case sshfs_server stopped, usually due to an error
@@ -134,11 +188,27 @@ void mp::SSHFSMounts::start_mount(VirtualMachine* vm, const std::string& source_
             fmt::format("{}: {}", process_state.failure_message(), sshfs_server_process->read_all_standard_error()));
     }
 
+    // The server announces the sshfs invocation it settled on; remembering it lets the instance's further
+    // mounts skip the probe execs, which dominate mount setup time
+    const auto exec_announcement = QByteArray{"sshfs exec: "}; // Magic prefix printed by sshfs_server
+    auto exec_index = server_output.indexOf(exec_announcement);
+    if (exec_index >= 0)
+    {
+        exec_index += exec_announcement.size();
+        const auto exec_end = server_output.indexOf('\n', exec_index);
+        sshfs_exec_cache[vm->vm_name] =
+            server_output.mid(exec_index, exec_end < 0 ? -1 : exec_end - exec_index).trimmed().toStdString();
+    }
+
     mount_processes[vm->vm_name][target_path] = std::move(sshfs_server_process);
 }
 
 bool mp::SSHFSMounts::stop_mount(const std::string& instance, const std::string& path)
 {
+    auto details_it = mount_details.find(instance);
+    if (details_it != mount_details.end())
+        details_it->second.erase(path); // forgetting the details keeps the finished handler from restarting it
+
     auto sshfs_mount_it = mount_processes.find(instance);
     if (sshfs_mount_it == mount_processes.end())
     {
@@ -160,6 +230,9 @@ bool mp::SSHFSMounts::stop_mount(const std::string& instance, const std::string&
 
 void mp::SSHFSMounts::stop_all_mounts_for_instance(const std::string& instance)
 {
+    mount_details.erase(instance);
+    sshfs_exec_cache.erase(instance); // all mounts gone means the instance (and its image) may change next
+
     auto mounts_it = mount_processes.find(instance);
     if (mounts_it == mount_processes.end() || mounts_it->second.empty())
     {
@@ -85,6 +85,7 @@ int main(int argc, char* argv[])
     const auto target_path = string(argv[5]);
     const unordered_map<int, int> uid_map = deserialise_id_map(argv[6]);
     const unordered_map<int, int> gid_map = deserialise_id_map(argv[7]);
+    const auto sshfs_exec_line = string(qgetenv("SSHFS_EXEC_LINE")); // empty means probe the guest for it
 
     auto logger = std::make_shared<mpl::StandardLogger>(mpl::Level::error); // QUESTION - how to pass verbosity level?
     mpl::set_logger(logger);
@@ -94,7 +95,7 @@ int main(int argc, char* argv[])
         auto watchdog = mpp::make_quit_watchdog(); // called while there is only one thread
 
         mp::SSHSession session{host, port, username, mp::SSHClientKeyProvider{priv_key_blob}};
-        mp::SshfsMount sshfs_mount(move(session), source_path, target_path, gid_map, uid_map);
+        mp::SshfsMount sshfs_mount(move(session), source_path, target_path, gid_map, uid_map, sshfs_exec_line);
 
         // ssh lives on its own thread, use this thread to listen for quit signal
         if (int sig = watchdog())
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2020 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <multipass/tracing/trace_recorder.h>
+
+#include <multipass/format.h>
+
+#include <functional>
+#include <thread>
+
+namespace mp = multipass;
+
+mp::tracing::TraceRecorder& mp::tracing::TraceRecorder::instance()
+{
+    static TraceRecorder recorder;
+    return recorder;
+}
+
+mp::tracing::TraceRecorder::TraceRecorder() : epoch{std::chrono::steady_clock::now()}
+{
+}
+
+void mp::tracing::TraceRecorder::record(const char* name, std::chrono::steady_clock::time_point begin,
+                                        std::chrono::steady_clock::time_point end)
+{
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+
+    SpanEvent event{name, std::hash<std::thread::id>{}(std::this_thread::get_id()),
+                    duration_cast<microseconds>(begin - epoch), duration_cast<microseconds>(end - begin)};
+
+    std::lock_guard<decltype(mutex)> lock{mutex};
+    if (events.size() < max_events)
+    {
+        events.push_back(event);
+    }
+    else
+    {
+        events[next_slot] = event;
+        next_slot = (next_slot + 1) % max_events;
+    }
+}
+
+std::string mp::tracing::TraceRecorder::chrome_trace_json() const
+{
+    fmt::memory_buffer buffer;
+    fmt::format_to(buffer, "{{\"traceEvents\": [");
+
+    std::lock_guard<decltype(mutex)> lock{mutex};
+    auto first = true;
+    for (const auto& event : events)
+    {
+        // "X" (complete) events carry their duration, so begin/end need not pair up in the viewer
+        fmt::format_to(buffer,
+                       "{}{{\"name\": \"{}\", \"cat\": \"multipass\", \"ph\": \"X\", \"ts\": {}, \"dur\": {}, "
+                       "\"pid\": 1, \"tid\": {}}}",
+                       first ? "" : ", ", event.name, event.timestamp.count(), event.duration.count(),
+                       event.thread_id);
+        first = false;
+    }
+
+    fmt::format_to(buffer, "]}}");
+    return fmt::to_string(buffer);
+}
+
+void mp::tracing::TraceRecorder::clear()
+{
+    std::lock_guard<decltype(mutex)> lock{mutex};
+    events.clear();
+    next_slot = 0;
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2020 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <multipass/file_watcher.h>
+
+#include <QCoreApplication>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QThread>
+
+namespace mp = multipass;
+
+mp::FileWatcher::FileWatcher(const Singleton<FileWatcher>::PrivatePass& pass) : Singleton<FileWatcher>{pass}
+{
+}
+
+mp::FileWatcher::~FileWatcher() = default;
+
+bool mp::FileWatcher::watch(const QString& path, std::function<void()> callback)
+{
+    auto app = QCoreApplication::instance();
+    if (!app || QThread::currentThread() != app->thread())
+        return false; // QFileSystemWatcher needs the main thread's event loop to deliver its signals
+
+    if (!watcher)
+    {
+        watcher = std::make_unique<QFileSystemWatcher>();
+        QObject::connect(watcher.get(), &QFileSystemWatcher::fileChanged, [this](const QString& changed) {
+            watcher->addPath(changed); // editors and atomic writers replace the file, dropping the watch
+            notify(changed);
+        });
+        QObject::connect(watcher.get(), &QFileSystemWatcher::directoryChanged, [this](const QString& dir) {
+            for (const auto& subscription : subscriptions)
+            { // a subscribed file may have just (re)appeared in the directory, not yet watched itself
+                if (QFileInfo{subscription.first}.absolutePath() == dir)
+                {
+                    watcher->addPath(subscription.first);
+                    notify(subscription.first);
+                }
+            }
+        });
+    }
+
+    const auto abs_path = QFileInfo{path}.absoluteFilePath();
+    subscriptions[abs_path].push_back(std::move(callback));
+    watcher->addPath(QFileInfo{abs_path}.absolutePath()); // the dir watch catches the file appearing at all
+    watcher->addPath(abs_path);                           // fails quietly while the file does not exist yet
+
+    return true;
+}
+
+void mp::FileWatcher::unwatch(const QString& path)
+{
+    const auto abs_path = QFileInfo{path}.absoluteFilePath();
+    if (subscriptions.erase(abs_path) && watcher)
+        watcher->removePath(abs_path); // the directory watch stays, it may serve other subscriptions
+}
+
+void mp::FileWatcher::notify(const QString& path)
+{
+    auto subscription = subscriptions.find(path);
+    if (subscription != subscriptions.end())
+        for (const auto& callback : subscription->second)
+            callback();
+}
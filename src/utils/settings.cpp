@@ -16,6 +16,9 @@
  */
 
 #include <multipass/constants.h>
+#include <multipass/file_watcher.h>
+#include <multipass/logging/level.h>
+#include <multipass/memory_size.h>
 #include <multipass/platform.h>
 #include <multipass/settings.h>
 #include <multipass/standard_paths.h>
@@ -23,6 +26,7 @@
 
 #include <QDir>
 #include <QSettings>
+#include <QUrl>
 
 #include <algorithm>
 #include <array>
@@ -46,7 +50,12 @@ std::map<QString, QString> make_defaults()
 { // clang-format off
     auto ret = std::map<QString, QString>{{mp::petenv_key, petenv_name},
                                           {mp::driver_key, mp::platform::default_driver()},
-                                          {mp::autostart_key, autostart_default}};
+                                          {mp::autostart_key, autostart_default},
+                                          {mp::bandwidth_key, QString()},
+                                          {mp::vault_size_key, QString()},
+                                          {mp::idle_suspend_key, QString()},
+                                          {mp::mirror_key, QString()},
+                                          {mp::log_level_key, QString()}};
 
     for(const auto& [k, v] : mp::platform::extra_settings_defaults())
         ret.insert_or_assign(k, v);
@@ -157,8 +166,48 @@ std::set<QString> multipass::Settings::keys() const
 QString mp::Settings::get(const QString& key) const
 {
     const auto& default_ret = get_default(key); // make sure the key is valid before reading from disk
+
+    if (const auto snapshot = std::atomic_load(&cache)) // just a pointer read when the cache is warm; no locking
+    {
+        const auto it = snapshot->find(key);
+        if (it != snapshot->cend())
+            return it->second;
+    }
+
     auto settings = persistent_settings(key);
-    return checked_get(settings, key, default_ret, mutex);
+    auto ret = checked_get(settings, key, default_ret, mutex);
+    cache_value(key, ret);
+    return ret;
+}
+
+void mp::Settings::cache_value(const QString& key, const QString& val) const
+{
+    std::lock_guard<std::mutex> lock{mutex};
+
+    if (!ensure_watching(file_for(key)))
+        return; // a cache we can't invalidate would serve stale values; keep reading from disk instead
+
+    const auto current = std::atomic_load(&cache);
+    auto updated = current ? std::make_shared<Cache>(*current) : std::make_shared<Cache>();
+    (*updated)[key] = val;
+    std::atomic_store(&cache, std::shared_ptr<const Cache>{std::move(updated)});
+}
+
+void mp::Settings::invalidate_cache() const
+{
+    std::atomic_store(&cache, std::shared_ptr<const Cache>{});
+}
+
+bool mp::Settings::ensure_watching(const QString& file) const
+{
+    if (watching.find(file) != watching.end())
+        return true;
+
+    if (!FileWatcher::instance().watch(file, [this] { invalidate_cache(); }))
+        return false; // no event loop to deliver changes on this thread; keep reading from disk instead
+
+    watching.insert(file);
+    return true;
 }
 
 void mp::Settings::set(const QString& key, const QString& val)
@@ -200,7 +249,45 @@ void multipass::Settings::set_aux(const QString& key, QString val) // work with
         throw InvalidSettingsException(key, val, "Invalid flag, try \"true\" or \"false\"");
     else if (key == winterm_key)
         val = mp::platform::interpret_setting(winterm_key, val);
+    else if ((key == bandwidth_key || key == vault_size_key) && !val.isEmpty())
+    {
+        try
+        {
+            MemorySize{val.toStdString()}; // size suffixes double as rate suffixes (bytes per second)
+        }
+        catch (const InvalidMemorySizeException&)
+        {
+            throw InvalidSettingsException(key, val, "Invalid size, try something like \"5M\" or empty for no limit");
+        }
+    }
+    else if (key == idle_suspend_key && !val.isEmpty())
+    {
+        bool ok = false;
+        if (val.toInt(&ok) <= 0 || !ok)
+            throw InvalidSettingsException(key, val,
+                                           "Invalid timeout, try a positive number of minutes or empty to disable");
+    }
+    else if (key == mirror_key && !val.isEmpty())
+    {
+        const QUrl url{val};
+        if (!url.isValid() || (url.scheme() != "http" && url.scheme() != "https"))
+            throw InvalidSettingsException(key, val, "Invalid mirror, try an http(s) URL or empty for the upstream");
+        if (!val.endsWith('/'))
+            val.append('/'); // paths are resolved by concatenation downstream
+    }
+    else if (key == log_level_key && !val.isEmpty())
+    {
+        for (const auto& token : val.split(',')) // e.g. "debug" or "warning,sftp server=trace"
+        {
+            const auto parts = token.split('=');
+            if (parts.size() > 2 || !multipass::logging::level_from_name(parts.last().trimmed().toStdString()))
+                throw InvalidSettingsException(key, val,
+                                               "Invalid level, try e.g. \"debug\" or \"warning,daemon=debug\", or "
+                                               "empty for the startup verbosity");
+        }
+    }
 
     auto settings = persistent_settings(key);
     checked_set(settings, key, val, mutex);
+    invalidate_cache(); // don't wait on the watcher for read-after-write consistency in this process
 }
@@ -24,12 +24,14 @@
 #include <multipass/settings.h>
 #include <multipass/ssh/ssh_session.h>
 #include <multipass/standard_paths.h>
+#include <multipass/tracing/trace_recorder.h>
 #include <multipass/utils.h>
 
 #include <QDateTime>
 #include <QDir>
 #include <QFileInfo>
 #include <QProcess>
+#include <QTcpSocket>
 #include <QUuid>
 #include <QtGlobal>
 
@@ -117,6 +119,10 @@ bool mp::utils::run_cmd_for_status(const QString& cmd, const QStringList& args,
     proc.setProgram(cmd);
     proc.setArguments(args);
 
+    // only the exit status is wanted, so spare the pipe pair, read loop, and buffering per channel
+    proc.setStandardOutputFile(QProcess::nullDevice());
+    proc.setStandardErrorFile(QProcess::nullDevice());
+
     proc.start();
     proc.waitForFinished(timeout);
 
@@ -128,6 +134,7 @@ std::string mp::utils::run_cmd_for_output(const QString& cmd, const QStringList&
     QProcess proc;
     proc.setProgram(cmd);
     proc.setArguments(args);
+    proc.setStandardErrorFile(QProcess::nullDevice()); // stderr goes unread below
 
     proc.start();
     proc.waitForFinished(timeout);
@@ -190,16 +197,76 @@ std::string mp::utils::generate_mac_address()
     return fmt::format("52:54:00:{:02x}:{:02x}:{:02x}", octets[0], octets[1], octets[2]);
 }
 
+namespace
+{
+bool tcp_port_open(const std::string& host, int port, std::chrono::milliseconds attempt_timeout)
+{
+    QTcpSocket socket;
+    socket.connectToHost(QString::fromStdString(host), port);
+    if (!socket.waitForConnected(attempt_timeout.count()))
+        return false;
+
+    socket.abort(); // no bytes exchanged; the banner is left for the real handshake
+    return true;
+}
+} // namespace
+
 void mp::utils::wait_until_ssh_up(VirtualMachine* virtual_machine, std::chrono::milliseconds timeout,
                                   std::function<void()> const& ensure_vm_is_running)
 {
+    using namespace std::literals::chrono_literals;
+
+    MP_TRACE_SPAN("wait_until_ssh_up");
+
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    auto remaining = [deadline] {
+        return std::max(std::chrono::duration_cast<std::chrono::milliseconds>(deadline -
+                                                                              std::chrono::steady_clock::now()),
+                        std::chrono::milliseconds{1});
+    };
+    auto on_timeout = [virtual_machine] {
+        std::lock_guard<decltype(virtual_machine->state_mutex)> lock{virtual_machine->state_mutex};
+        virtual_machine->state = VirtualMachine::State::unknown;
+        virtual_machine->update_state();
+        throw std::runtime_error(fmt::format("{}: timed out waiting for response", virtual_machine->vm_name));
+    };
+
+    /* Readiness arrives in stages — address (for qemu, the DHCP lease the hostname query below waits on),
+       TCP port accepting, SSH handshake succeeding. Probing the cheapest signal for each stage means no
+       full ssh_connect timeout is ever burnt just to learn the guest has no address yet, and the separate
+       trace spans let boot latency be attributed to the stage that actually ate it */
+    std::string hostname;
+    {
+        MP_TRACE_SPAN("wait_for_address");
+        try
+        {
+            hostname = virtual_machine->ssh_hostname();
+        }
+        catch (const std::exception&)
+        {
+            on_timeout();
+        }
+    }
+
     mpl::log(mpl::Level::debug, virtual_machine->vm_name,
-             fmt::format("Trying SSH on {}:{}", virtual_machine->ssh_hostname(), virtual_machine->ssh_port()));
-    auto action = [virtual_machine, &ensure_vm_is_running] {
+             fmt::format("Trying SSH on {}:{}", hostname, virtual_machine->ssh_port()));
+
+    {
+        MP_TRACE_SPAN("wait_for_ssh_port");
+        auto port_action = [virtual_machine, &ensure_vm_is_running, &hostname] {
+            ensure_vm_is_running();
+            return tcp_port_open(hostname, virtual_machine->ssh_port(), 250ms) ? mp::utils::TimeoutAction::done
+                                                                               : mp::utils::TimeoutAction::retry;
+        };
+        mp::utils::try_action_for(on_timeout, remaining(), port_action);
+    }
+
+    MP_TRACE_SPAN("wait_for_ssh_handshake");
+    auto action = [virtual_machine, &ensure_vm_is_running, &hostname] {
         ensure_vm_is_running();
         try
         {
-            mp::SSHSession session{virtual_machine->ssh_hostname(), virtual_machine->ssh_port()};
+            mp::SSHSession session{hostname, virtual_machine->ssh_port()};
 
             std::lock_guard<decltype(virtual_machine->state_mutex)> lock{virtual_machine->state_mutex};
             virtual_machine->state = VirtualMachine::State::running;
@@ -211,29 +278,35 @@ void mp::utils::wait_until_ssh_up(VirtualMachine* virtual_machine, std::chrono::
             return mp::utils::TimeoutAction::retry;
         }
     };
-    auto on_timeout = [virtual_machine] {
-        std::lock_guard<decltype(virtual_machine->state_mutex)> lock{virtual_machine->state_mutex};
-        virtual_machine->state = VirtualMachine::State::unknown;
-        virtual_machine->update_state();
-        throw std::runtime_error(fmt::format("{}: timed out waiting for response", virtual_machine->vm_name));
-    };
 
-    mp::utils::try_action_for(on_timeout, timeout, action);
+    mp::utils::try_action_for(on_timeout, remaining(), action);
 }
 
 void mp::utils::wait_for_cloud_init(mp::VirtualMachine* virtual_machine, std::chrono::milliseconds timeout,
                                     const mp::SSHKeyProvider& key_provider)
 {
-    auto action = [virtual_machine, &key_provider] {
+    MP_TRACE_SPAN("wait_for_cloud_init");
+
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    auto action = [virtual_machine, &key_provider, deadline] {
         virtual_machine->ensure_vm_is_running();
         try
         {
             mp::SSHSession session{virtual_machine->ssh_hostname(), virtual_machine->ssh_port(),
                                    virtual_machine->ssh_username(), key_provider};
 
-            std::lock_guard<decltype(virtual_machine->state_mutex)> lock{virtual_machine->state_mutex};
-            auto ssh_process = session.exec({"[ -e /var/lib/cloud/instance/boot-finished ]"});
-            return ssh_process.exit_code() == 0 ? mp::utils::TimeoutAction::done : mp::utils::TimeoutAction::retry;
+            const auto remaining =
+                std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+            if (remaining <= std::chrono::milliseconds::zero())
+                return mp::utils::TimeoutAction::retry; // let the outer loop time out
+
+            /* One blocking wait inside the guest replaces a session per poll: cloud-init reports completion
+               the moment it happens rather than on our next probe. The file check afterwards keeps the old
+               semantics as the fallback for images without the status command or when the wait is cut short */
+            auto ssh_process = session.exec({"command -v cloud-init > /dev/null && cloud-init status --wait > "
+                                             "/dev/null; [ -e /var/lib/cloud/instance/boot-finished ]"});
+            return ssh_process.exit_code(remaining) == 0 ? mp::utils::TimeoutAction::done
+                                                         : mp::utils::TimeoutAction::retry;
         }
         catch (const std::exception& e)
         {
@@ -347,7 +420,7 @@ QString mp::utils::get_driver_str()
                  fmt::format("{} is now ignored, please use `multipass set {}` instead.", mp::driver_env_var,
                              mp::driver_key));
     }
-    return mp::Settings::instance().get(mp::driver_key);
+    return mp::Settings::instance().get(mp::settings::driver);
 }
 
 QString mp::utils::make_uuid()
@@ -370,6 +443,24 @@ std::string mp::utils::contents_of(const multipass::Path& file_path)
     return stream.str();
 }
 
+QJsonDocument mp::utils::load_json_document(QFile& file, QJsonParseError* parse_error)
+{
+    /* Mapping lets the parser read straight from the page cache instead of copying the whole file onto the heap
+       first — a difference that shows on multi-MB DBs parsed at startup. fromRawData does not copy and the parsed
+       document does not refer back to the input, so the mapping can go away with the file object. */
+    if (const auto size = file.size())
+        if (const auto mapped = file.map(0, size))
+            return QJsonDocument::fromJson(
+                QByteArray::fromRawData(reinterpret_cast<const char*>(mapped), static_cast<int>(size)), parse_error);
+
+    return QJsonDocument::fromJson(file.readAll(), parse_error); // some filesystems cannot map; fall back to copying
+}
+
+bool mp::utils::is_local_socket_address(const std::string& address)
+{
+    return address.rfind("unix:", 0) == 0;
+}
+
 bool mp::utils::has_only_digits(const std::string& value)
 {
     return std::all_of(value.begin(), value.end(), [](char c) { return std::isdigit(c); });
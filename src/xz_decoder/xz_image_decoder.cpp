@@ -17,16 +17,86 @@
 
 #include <multipass/xz_image_decoder.h>
 
+#include <multipass/aligned_allocator.h>
+#include <multipass/page_cache.h>
 #include <multipass/rpc/multipass.grpc.pb.h>
+#include <multipass/tracing/trace_recorder.h>
 
 #include <multipass/format.h>
 
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 namespace mp = multipass;
 
 namespace
 {
+// 64KB chunks left the decoder stalling on I/O; a chunk of one aligned slab keeps it fed and makes every
+// buffer hugepage-backed
+constexpr auto chunk_size = mp::utils::large_buffer_alignment;
+
+// A small bounded hand-off between the I/O threads and the decoding loop, so that disk reads and writes
+// overlap with the (CPU-bound) decode instead of serializing with it
+class ChunkPipe
+{
+public:
+    using Chunk = mp::utils::IOBuffer; // 2MiB-aligned, so reads and writes hit the disk in aligned units
+
+    bool push(Chunk&& chunk)
+    {
+        std::unique_lock<std::mutex> lock{mutex};
+        space_available.wait(lock, [this] { return chunks.size() < max_chunks || broken; });
+        if (broken)
+            return false;
+
+        chunks.push_back(std::move(chunk));
+        data_available.notify_one();
+        return true;
+    }
+
+    bool pop(Chunk& chunk)
+    {
+        std::unique_lock<std::mutex> lock{mutex};
+        data_available.wait(lock, [this] { return !chunks.empty() || closed || broken; });
+        if (chunks.empty())
+            return false;
+
+        chunk = std::move(chunks.front());
+        chunks.pop_front();
+        space_available.notify_one();
+        return true;
+    }
+
+    void close() // no more data will be pushed
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        closed = true;
+        data_available.notify_all();
+    }
+
+    void break_off() // the other end is gone; unblock any pending push or pop
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        broken = true;
+        space_available.notify_all();
+        data_available.notify_all();
+    }
+
+private:
+    static constexpr std::size_t max_chunks = 2;
+
+    std::mutex mutex;
+    std::condition_variable data_available;
+    std::condition_variable space_available;
+    std::deque<Chunk> chunks;
+    bool closed{false};
+    bool broken{false};
+};
+
 bool verify_decode(const xz_ret& ret)
 {
     switch (ret)
@@ -63,6 +133,8 @@ mp::XzImageDecoder::XzImageDecoder(const Path& xz_file_path)
 
 void mp::XzImageDecoder::decode_to(const Path& decoded_image_path, const ProgressMonitor& monitor)
 {
+    MP_TRACE_SPAN("XzImageDecoder::decode_to");
+
     if (!xz_file.open(QIODevice::ReadOnly))
         throw std::runtime_error(fmt::format("failed to open {} for reading", xz_file.fileName()));
 
@@ -70,46 +142,215 @@ void mp::XzImageDecoder::decode_to(const Path& decoded_image_path, const Progres
     if (!decoded_file.open(QIODevice::WriteOnly))
         throw std::runtime_error(fmt::format("failed to open {} for writing", decoded_file.fileName()));
 
+    ChunkPipe read_pipe, write_pipe;
+    std::exception_ptr reader_error, writer_error;
+
+    std::thread reader{[this, &read_pipe, &reader_error] {
+        try
+        {
+            qint64 bytes_since_drop = 0;
+            while (true)
+            {
+                ChunkPipe::Chunk chunk(chunk_size);
+                auto bytes_read = xz_file.read(reinterpret_cast<char*>(chunk.data()), chunk_size);
+                if (bytes_read < 0)
+                    throw std::runtime_error(
+                        fmt::format("failed to read {}: {}", xz_file.fileName(), xz_file.errorString()));
+                if (bytes_read == 0)
+                    break;
+
+                if ((bytes_since_drop += bytes_read) >= utils::drop_behind_window)
+                { // the compressed image is read once; no point keeping it cached behind us
+                    utils::drop_io_cache(xz_file.handle(), xz_file.pos());
+                    bytes_since_drop = 0;
+                }
+
+                chunk.resize(bytes_read);
+                if (!read_pipe.push(std::move(chunk)))
+                    return;
+            }
+        }
+        catch (...)
+        {
+            reader_error = std::current_exception();
+        }
+        read_pipe.close();
+    }};
+
+    std::thread writer{[&decoded_file, &write_pipe, &writer_error] {
+        try
+        {
+            qint64 bytes_since_drop = 0;
+            ChunkPipe::Chunk chunk;
+            while (write_pipe.pop(chunk))
+            {
+                if (decoded_file.write(reinterpret_cast<const char*>(chunk.data()), chunk.size()) < 0)
+                    throw std::runtime_error(
+                        fmt::format("failed to write {}: {}", decoded_file.fileName(), decoded_file.errorString()));
+
+                if ((bytes_since_drop += chunk.size()) >= utils::drop_behind_window)
+                { // the decoded image is verified and booted through qemu, not re-read by us
+                    utils::drop_io_cache(decoded_file.handle(), decoded_file.pos());
+                    bytes_since_drop = 0;
+                }
+            }
+        }
+        catch (...)
+        {
+            writer_error = std::current_exception();
+            write_pipe.break_off();
+        }
+    }};
+
+    auto join_pipeline = [&] {
+        read_pipe.break_off();
+        write_pipe.close();
+        reader.join();
+        writer.join();
+    };
+
     struct xz_buf decode_buf
     {
     };
-    const auto max_size = 65536u;
-
-    std::vector<char> read_data, write_data;
-    read_data.reserve(max_size);
-    write_data.reserve(max_size);
+    ChunkPipe::Chunk in_chunk;
+    ChunkPipe::Chunk out_chunk(chunk_size);
 
-    decode_buf.in = reinterpret_cast<unsigned char*>(read_data.data());
+    decode_buf.in = nullptr;
     decode_buf.in_pos = 0;
     decode_buf.in_size = 0;
-    decode_buf.out = reinterpret_cast<unsigned char*>(write_data.data());
+    decode_buf.out = out_chunk.data();
     decode_buf.out_pos = 0;
-    decode_buf.out_size = max_size;
+    decode_buf.out_size = chunk_size;
 
     const auto file_size = xz_file.size();
     qint64 total_bytes_extracted{0};
 
-    while (true)
+    try
     {
-        if (decode_buf.in_pos == decode_buf.in_size)
+        while (true)
         {
-            decode_buf.in_size = xz_file.read(read_data.data(), max_size);
-            decode_buf.in_pos = 0;
-            total_bytes_extracted += decode_buf.in_size;
-            auto progress = (total_bytes_extracted / (float)file_size) * 100;
-            monitor(LaunchProgress::EXTRACT, progress);
+            if (decode_buf.in_pos == decode_buf.in_size)
+            {
+                if (read_pipe.pop(in_chunk))
+                {
+                    decode_buf.in = in_chunk.data();
+                    decode_buf.in_size = in_chunk.size();
+                }
+                else
+                { // premature end of input; the decoder reports the truncation below
+                    decode_buf.in = nullptr;
+                    decode_buf.in_size = 0;
+                }
+                decode_buf.in_pos = 0;
+                total_bytes_extracted += decode_buf.in_size;
+                auto progress = (total_bytes_extracted / (float)file_size) * 100;
+                monitor(LaunchProgress::EXTRACT, progress);
+            }
+
+            if (!verify_decode(xz_dec_run(xz_decoder.get(), &decode_buf)))
+            {
+                out_chunk.resize(decode_buf.out_pos);
+                if (!write_pipe.push(std::move(out_chunk)))
+                    throw std::runtime_error("failed to write decoded image");
+                break;
+            }
+
+            if (decode_buf.out_pos == chunk_size)
+            {
+                if (!write_pipe.push(std::move(out_chunk)))
+                    throw std::runtime_error("failed to write decoded image");
+
+                out_chunk = ChunkPipe::Chunk(chunk_size);
+                decode_buf.out = out_chunk.data();
+                decode_buf.out_pos = 0;
+            }
         }
+    }
+    catch (...)
+    {
+        join_pipeline();
+
+        // a decode failure may just be the downstream symptom of an I/O error; report the cause instead
+        if (reader_error)
+            std::rethrow_exception(reader_error);
+        if (writer_error)
+            std::rethrow_exception(writer_error);
+        throw;
+    }
+
+    join_pipeline();
+
+    if (writer_error) // the final flush may still have failed
+        std::rethrow_exception(writer_error);
+}
+
+mp::XzStreamDecoder::XzStreamDecoder(const Path& decoded_file_path)
+    : decoded_file{decoded_file_path}, xz_decoder{xz_dec_init(XZ_DYNALLOC, 1u << 26), xz_dec_end},
+      out_buf(chunk_size)
+{
+    xz_crc32_init();
+    xz_crc64_init();
+
+    if (!decoded_file.open(QIODevice::WriteOnly))
+        throw std::runtime_error(fmt::format("failed to open {} for writing", decoded_file.fileName()));
+}
+
+void mp::XzStreamDecoder::write(const QByteArray& data)
+{
+    if (data.isEmpty() || stream_ended) // bytes trailing the stream footer are not ours to interpret
+        return;
 
-        if (!verify_decode(xz_dec_run(xz_decoder.get(), &decode_buf)))
+    struct xz_buf decode_buf
+    {
+    };
+    decode_buf.in = reinterpret_cast<const unsigned char*>(data.constData());
+    decode_buf.in_pos = 0;
+    decode_buf.in_size = data.size();
+
+    do
+    {
+        decode_buf.out = out_buf.data();
+        decode_buf.out_pos = 0;
+        decode_buf.out_size = out_buf.size();
+
+        auto more = verify_decode(xz_dec_run(xz_decoder.get(), &decode_buf));
+
+        if (decode_buf.out_pos > 0 &&
+            decoded_file.write(reinterpret_cast<const char*>(out_buf.data()), decode_buf.out_pos) < 0)
+            throw std::runtime_error(
+                fmt::format("failed to write {}: {}", decoded_file.fileName(), decoded_file.errorString()));
+
+        if ((bytes_since_drop += decode_buf.out_pos) >= utils::drop_behind_window)
         {
-            decoded_file.write(write_data.data(), decode_buf.out_pos);
-            return;
+            utils::drop_io_cache(decoded_file.handle(), decoded_file.pos());
+            bytes_since_drop = 0;
         }
 
-        if (decode_buf.out_pos == max_size)
+        if (!more)
         {
-            decoded_file.write(write_data.data(), decode_buf.out_pos);
-            decode_buf.out_pos = 0;
+            stream_ended = true;
+            return;
         }
-    }
+    } while (decode_buf.in_pos < decode_buf.in_size);
+}
+
+void mp::XzStreamDecoder::restart()
+{
+    xz_dec_reset(xz_decoder.get());
+    decoded_file.resize(0);
+    decoded_file.seek(0);
+    stream_ended = false;
+    bytes_since_drop = 0;
+}
+
+void mp::XzStreamDecoder::finish()
+{
+    if (!stream_ended)
+        throw std::runtime_error("xz file is corrupt");
+
+    if (!decoded_file.flush())
+        throw std::runtime_error(
+            fmt::format("failed to write {}: {}", decoded_file.fileName(), decoded_file.errorString()));
+
+    decoded_file.close();
 }
@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2020 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <multipass/cloud_init_iso.h>
+
+#include <benchmark/benchmark.h>
+
+#include <QTemporaryDir>
+
+#include <string>
+
+namespace mp = multipass;
+
+namespace
+{
+void BM_cloud_init_iso_write_to(benchmark::State& state)
+{
+    mp::CloudInitIso iso;
+    iso.add_file("meta-data", "instance-id: vm1\nlocal-hostname: vm1\n");
+    iso.add_file("user-data", "#cloud-config\n");
+    iso.add_file("vendor-data", std::string(state.range(0), '#')); // ssh keys, mounts, etc. grow this one
+
+    QTemporaryDir scratch_dir;
+    const auto iso_path = scratch_dir.filePath("cloud-init-config.iso");
+
+    for (auto _ : state)
+        iso.write_to(iso_path);
+}
+} // namespace
+
+BENCHMARK(BM_cloud_init_iso_write_to)->Arg(1 << 10)->Arg(1 << 14);
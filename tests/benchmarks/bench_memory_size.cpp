@@ -0,0 +1,39 @@
+/*
+ * Copyright (C) 2020 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <multipass/memory_size.h>
+
+#include <benchmark/benchmark.h>
+
+namespace mp = multipass;
+
+namespace
+{
+void BM_memory_size_parse(benchmark::State& state, const char* spec)
+{
+    for (auto _ : state)
+    {
+        mp::MemorySize size{spec};
+        benchmark::DoNotOptimize(size);
+    }
+}
+} // namespace
+
+BENCHMARK_CAPTURE(BM_memory_size_parse, gigabytes, "4G");
+BENCHMARK_CAPTURE(BM_memory_size_parse, megabytes, "2048M");
+BENCHMARK_CAPTURE(BM_memory_size_parse, kilobytes, "16384K");
+BENCHMARK_CAPTURE(BM_memory_size_parse, bytes, "1073741824");
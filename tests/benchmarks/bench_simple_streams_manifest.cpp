@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2020 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <multipass/simple_streams_manifest.h>
+
+#include <benchmark/benchmark.h>
+
+#include <QFile>
+
+#include <stdexcept>
+
+namespace mp = multipass;
+
+namespace
+{
+QByteArray load_test_data(const char* file_name)
+{
+    QFile file{QStringLiteral(MULTIPASS_BENCHMARK_DATA_DIR "/") + file_name};
+    if (!file.open(QIODevice::ReadOnly))
+        throw std::runtime_error("failed to open benchmark data file");
+    return file.readAll();
+}
+
+void BM_manifest_from_json(benchmark::State& state, const char* file_name)
+{
+    const auto json = load_test_data(file_name);
+    for (auto _ : state)
+    {
+        auto manifest = mp::SimpleStreamsManifest::fromJson(json, "http://stream/url");
+        benchmark::DoNotOptimize(manifest);
+    }
+}
+} // namespace
+
+BENCHMARK_CAPTURE(BM_manifest_from_json, releases, "good_manifest.json");
+BENCHMARK_CAPTURE(BM_manifest_from_json, daily, "daily/daily_manifest.json");
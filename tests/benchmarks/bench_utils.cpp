@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2020 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <multipass/utils.h>
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+namespace mp = multipass;
+
+namespace
+{
+const std::vector<std::string> sshfs_like_args{
+    "sudo", "sshfs", "-o", "slave", "-o", "transform_symlinks", "-o", "allow_other",
+    ":\"/home/user/dir with spaces\"", "\"/target/it's here\""};
+
+void BM_to_cmd_quote_every_arg(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        auto cmd = mp::utils::to_cmd(sshfs_like_args, mp::utils::QuoteType::quote_every_arg);
+        benchmark::DoNotOptimize(cmd);
+    }
+}
+
+void BM_to_cmd_no_quotes(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        auto cmd = mp::utils::to_cmd(sshfs_like_args, mp::utils::QuoteType::no_quotes);
+        benchmark::DoNotOptimize(cmd);
+    }
+}
+} // namespace
+
+BENCHMARK(BM_to_cmd_quote_every_arg);
+BENCHMARK(BM_to_cmd_no_quotes);
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2020 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+struct Budget
+{
+    std::string benchmark; // matches any benchmark whose name starts with this (arguments form a suffix)
+    double budget_us;
+    double noise_margin; // fraction above budget tolerated before failing, absorbing run-to-run noise
+};
+
+std::vector<Budget> load_budgets(const QString& manifest_path)
+{
+    QFile manifest{manifest_path};
+    if (!manifest.open(QIODevice::ReadOnly))
+        return {}; // no manifest, no enforcement; the benchmarks still run and report
+
+    std::vector<Budget> budgets;
+    const auto entries = QJsonDocument::fromJson(manifest.readAll()).object()["budgets"].toArray();
+    for (const auto& entry : entries)
+    {
+        const auto object = entry.toObject();
+        budgets.push_back(Budget{object["benchmark"].toString().toStdString(), object["budget_us"].toDouble(),
+                                 object.contains("noise_margin") ? object["noise_margin"].toDouble() : 0.25});
+    }
+
+    return budgets;
+}
+
+// The usual console output, plus a check of every run against the manifest's latency budgets;
+// violations accumulate and fail the process at the end, making budgets a tested property of the code
+// rather than tribal knowledge
+class BudgetReporter : public benchmark::ConsoleReporter
+{
+public:
+    explicit BudgetReporter(std::vector<Budget> budgets) : budgets{std::move(budgets)}
+    {
+    }
+
+    void ReportRuns(const std::vector<Run>& runs) override
+    {
+        benchmark::ConsoleReporter::ReportRuns(runs);
+
+        for (const auto& run : runs)
+        {
+            if (run.error_occurred || run.iterations == 0)
+                continue;
+
+            // with repetitions in play, judge the median; stddev and friends are not latencies
+            if (run.run_type == Run::RT_Aggregate && run.aggregate_name != "median")
+                continue;
+
+            const auto time_us = run.real_accumulated_time / run.iterations * 1e6;
+            for (const auto& budget : budgets)
+            {
+                if (run.benchmark_name().rfind(budget.benchmark, 0) == 0 &&
+                    time_us > budget.budget_us * (1 + budget.noise_margin))
+                    violations.push_back(run.benchmark_name() + ": " + std::to_string(time_us) +
+                                         "us over budget of " + std::to_string(budget.budget_us) + "us (+" +
+                                         std::to_string(budget.noise_margin * 100) + "% noise margin)");
+            }
+        }
+    }
+
+    const std::vector<std::string>& budget_violations() const
+    {
+        return violations;
+    }
+
+private:
+    std::vector<Budget> budgets;
+    std::vector<std::string> violations;
+};
+} // namespace
+
+int main(int argc, char** argv)
+{
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+
+    BudgetReporter reporter{load_budgets(MULTIPASS_PERF_BUDGETS)};
+    benchmark::RunSpecifiedBenchmarks(&reporter);
+
+    for (const auto& violation : reporter.budget_violations())
+        std::cerr << "budget exceeded: " << violation << "\n";
+
+    return reporter.budget_violations().empty() ? 0 : 1;
+}
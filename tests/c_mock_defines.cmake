@@ -66,6 +66,11 @@ add_c_mocks(
   sftp_open
   sftp_write
   sftp_read
+  sftp_async_read_begin
+  sftp_async_read
+  sftp_stat
+  sftp_seek64
+  sftp_attributes_free
   sftp_free
   sftp_get_error
   sftp_close
@@ -22,6 +22,10 @@
 
 #include "tests/extra_assertions.h"
 #include "tests/mock_process_factory.h"
+#include "tests/temp_dir.h"
+
+#include <QFile>
+#include <QtEndian>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
@@ -41,6 +45,20 @@ const auto null_string_matcher = static_cast<mp::optional<decltype(_)>>(mp::null
 using ImageConversionParamType =
     std::tuple<const char*, const char*, mp::ProcessState, bool, mp::ProcessState, mp::optional<Matcher<std::string>>>;
 
+QString fake_qcow2_img(const mpt::TempDir& dir, const mp::MemorySize& virtual_size)
+{
+    QByteArray header(104, '\0');
+    header.replace(0, 4, QByteArrayLiteral("QFI\xfb"));
+    qToBigEndian<quint32>(3u, header.data() + 4);                                         // version
+    qToBigEndian<quint64>(static_cast<quint64>(virtual_size.in_bytes()), header.data() + 24); // virtual size
+
+    const auto img = dir.path() + "/fake.qcow2";
+    QFile img_file{img};
+    EXPECT_TRUE(img_file.open(QIODevice::WriteOnly));
+    EXPECT_EQ(img_file.write(header), header.size());
+    return img;
+}
+
 QByteArray fake_img_info(const mp::MemorySize& size)
 {
     return QByteArray::fromStdString(
@@ -222,21 +240,65 @@ TEST(BackendUtils, image_resizing_checks_minimum_size_and_proceeds_when_larger)
                         qemuimg_resize_result, throw_msg_matcher);
 }
 
-TEST(BackendUtils, image_resizing_checks_minimum_size_and_proceeds_when_equal)
+TEST(BackendUtils, image_resizing_skipped_when_already_requested_size)
 {
     const auto img = "/fake/img/path";
     const auto min_size = mp::MemorySize{"1234554321"};
     const auto request_size = min_size;
     const auto qemuimg_info_output = "";
     const auto qemuimg_info_result = success;
-    const auto attempt_resize = true;
-    const auto qemuimg_resize_result = success;
+    const auto attempt_resize = false;
+    const auto qemuimg_resize_result = mp::ProcessState{};
     const auto throw_msg_matcher = null_string_matcher;
 
     test_image_resizing(img, min_size, request_size, qemuimg_info_output, qemuimg_info_result, attempt_resize,
                         qemuimg_resize_result, throw_msg_matcher);
 }
 
+TEST(BackendUtils, image_resizing_reads_qcow2_header_instead_of_spawning_qemuimg_info)
+{
+    mpt::TempDir dir;
+    const auto img = fake_qcow2_img(dir, mp::MemorySize{"1G"});
+    const auto request_size = mp::MemorySize{"3G"};
+
+    auto process_count = 0;
+    auto mock_factory_scope = mpt::MockProcessFactory::Inject();
+    mock_factory_scope->register_callback([&](mpt::MockProcess* process) {
+        ASSERT_EQ(++process_count, 1); // no qemu-img info spawn, only the resize itself
+        simulate_qemuimg_resize(process, img, request_size, success);
+    });
+
+    mp::backend::resize_instance_image(request_size, img);
+    EXPECT_EQ(process_count, 1);
+}
+
+TEST(BackendUtils, image_resizing_skipped_when_qcow2_header_matches_request)
+{
+    mpt::TempDir dir;
+    const auto request_size = mp::MemorySize{"3G"};
+    const auto img = fake_qcow2_img(dir, request_size);
+
+    auto process_count = 0;
+    auto mock_factory_scope = mpt::MockProcessFactory::Inject();
+    mock_factory_scope->register_callback([&](mpt::MockProcess*) { ++process_count; });
+
+    mp::backend::resize_instance_image(request_size, img);
+    EXPECT_EQ(process_count, 0);
+}
+
+TEST(BackendUtils, image_resizing_rejects_request_below_qcow2_header_size)
+{
+    mpt::TempDir dir;
+    const auto img = fake_qcow2_img(dir, mp::MemorySize{"3G"});
+    const auto request_size = mp::MemorySize{"2G"};
+
+    auto mock_factory_scope = mpt::MockProcessFactory::Inject();
+    mock_factory_scope->register_callback([](mpt::MockProcess*) { FAIL() << "no process should be spawned"; });
+
+    MP_EXPECT_THROW_THAT(mp::backend::resize_instance_image(request_size, img), std::runtime_error,
+                         Property(&std::runtime_error::what, HasSubstr("below minimum")));
+}
+
 TEST(BackendUtils, image_resizing_not_attempted_when_below_minimum)
 {
     const auto img = "SomeImg";
@@ -150,6 +150,31 @@ TEST_F(LocalNetworkAccessManager, reads_expected_data_chunked)
     EXPECT_EQ(data, reply_data);
 }
 
+TEST_F(LocalNetworkAccessManager, reads_expected_data_multiple_chunks)
+{
+    QByteArray http_response;
+    http_response += "HTTP/1.1 200 OK\r\n";
+    http_response += "Transfer-Encoding: chunked\r\n";
+    http_response += "\r\n";
+    http_response += "6\r\n";
+    http_response += "What's\r\n";
+    http_response += "4\r\n";
+    http_response += " up?\r\n";
+    http_response += "0\r\n";
+    http_response += "\r\n";
+
+    auto server_response = [&http_response](auto...) { return http_response; };
+    test_server.local_socket_server_handler(server_response);
+
+    auto reply = handle_request(base_url, "GET");
+
+    ASSERT_EQ(reply->error(), QNetworkReply::NoError);
+
+    auto data = reply->readAll();
+
+    EXPECT_EQ(data, QByteArray{"What's up?"});
+}
+
 TEST_F(LocalNetworkAccessManager, client_posts_correct_data)
 {
     QByteArray expected_data;
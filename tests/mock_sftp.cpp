@@ -24,6 +24,11 @@ extern "C"
     IMPL_MOCK_DEFAULT(4, sftp_open);
     IMPL_MOCK_DEFAULT(3, sftp_write);
     IMPL_MOCK_DEFAULT(3, sftp_read);
+    IMPL_MOCK_DEFAULT(2, sftp_async_read_begin);
+    IMPL_MOCK_DEFAULT(4, sftp_async_read);
+    IMPL_MOCK_DEFAULT(2, sftp_stat);
+    IMPL_MOCK_DEFAULT(2, sftp_seek64);
+    IMPL_MOCK_DEFAULT(1, sftp_attributes_free);
     IMPL_MOCK_DEFAULT(1, sftp_get_error);
     IMPL_MOCK_DEFAULT(1, sftp_close);
 }
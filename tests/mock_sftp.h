@@ -28,6 +28,11 @@ DECL_MOCK(sftp_init);
 DECL_MOCK(sftp_open);
 DECL_MOCK(sftp_write);
 DECL_MOCK(sftp_read);
+DECL_MOCK(sftp_async_read_begin);
+DECL_MOCK(sftp_async_read);
+DECL_MOCK(sftp_stat);
+DECL_MOCK(sftp_seek64);
+DECL_MOCK(sftp_attributes_free);
 DECL_MOCK(sftp_get_error);
 DECL_MOCK(sftp_close);
 
@@ -36,6 +36,8 @@ struct MockVirtualMachineFactory : public VirtualMachineFactory
     MOCK_METHOD0(fetch_type, FetchType());
     MOCK_METHOD1(prepare_source_image, VMImage(const VMImage&));
     MOCK_METHOD2(prepare_instance_image, void(const VMImage&, const VirtualMachineDescription&));
+    MOCK_METHOD2(snapshot_instance_image, void(const VMImage&, const std::string&));
+    MOCK_METHOD2(restore_instance_image, void(const VMImage&, const std::string&));
     MOCK_METHOD3(configure, void(const std::string&, YAML::Node&, YAML::Node&));
     MOCK_METHOD0(hypervisor_health_check, void());
     MOCK_METHOD0(get_backend_directory_name, QString());
@@ -155,6 +155,37 @@ TEST_F(DNSMasqServer, dnsmasq_fails_and_throws)
     EXPECT_THROW(dns.check_dnsmasq_running(), std::runtime_error);
 }
 
+TEST_F(DNSMasqServer, reserved_ip_is_known_without_a_lease)
+{
+    mp::DNSMasqServer dns{data_dir.path(), bridge_name, subnet};
+
+    const auto reserved = dns.reserve_ip_for(hw_addr);
+
+    auto ip = dns.get_ip_for(hw_addr);
+    ASSERT_TRUE(ip);
+    EXPECT_THAT(ip.value(), Eq(reserved));
+}
+
+TEST_F(DNSMasqServer, reservations_persist_in_hosts_file)
+{
+    const auto reserved = [this] {
+        mp::DNSMasqServer dns{data_dir.path(), bridge_name, subnet};
+        return dns.reserve_ip_for(hw_addr);
+    }();
+
+    mp::DNSMasqServer dns{data_dir.path(), bridge_name, subnet};
+
+    EXPECT_THAT(dns.reserve_ip_for(hw_addr), Eq(reserved));
+}
+
+TEST_F(DNSMasqServer, reservation_pins_an_existing_lease)
+{
+    mp::DNSMasqServer dns{data_dir.path(), bridge_name, subnet};
+    make_lease_entry();
+
+    EXPECT_THAT(dns.reserve_ip_for(hw_addr), Eq(mp::IPAddress(expected_ip)));
+}
+
 TEST_F(DNSMasqServer, dnsmasq_creates_conf_file)
 {
     mp::DNSMasqServer dns{data_dir.path(), bridge_name, subnet};
@@ -38,31 +38,28 @@ struct IPTablesConfig : public Test
     const QString evilbr0{QStringLiteral("evilbr0")};
     const std::string subnet{"192.168.2"};
 
-    mpt::MockProcessFactory::Callback iptables_callback = [this](mpt::MockProcess* process) {
-        if (process->program() == "iptables")
-        {
-            if (process->arguments().contains(goodbr0))
+    // the rules themselves travel over stdin, so success/failure is keyed on the restore process
+    mpt::MockProcessFactory::Callback make_iptables_callback(int restore_exit_code)
+    {
+        return [restore_exit_code](mpt::MockProcess* process) {
+            if (process->program() == "iptables-restore")
             {
                 mp::ProcessState exit_state;
-                exit_state.exit_code = 0;
-                EXPECT_CALL(*process, execute(_)).WillOnce(Return(exit_state));
+                exit_state.exit_code = restore_exit_code;
+                EXPECT_CALL(*process, start());
+                EXPECT_CALL(*process, process_state()).WillOnce(Return(exit_state));
+                if (restore_exit_code != 0)
+                    ON_CALL(*process, read_all_standard_error()).WillByDefault(Return("Evil bridge detected!\n"));
             }
-            else if (process->arguments().contains(evilbr0))
-            {
-                mp::ProcessState exit_state;
-                exit_state.exit_code = 1;
-                EXPECT_CALL(*process, execute(_)).WillOnce(Return(exit_state));
-                ON_CALL(*process, read_all_standard_error()).WillByDefault(Return("Evil bridge detected!\n"));
-            }
-        }
-    };
+        };
+    }
 };
 } // namespace
 
 TEST_F(IPTablesConfig, iptables_no_error_no_throw)
 {
     auto factory = mpt::MockProcessFactory::Inject();
-    factory->register_callback(iptables_callback);
+    factory->register_callback(make_iptables_callback(0));
 
     mp::IPTablesConfig iptables_config{goodbr0, subnet};
 
@@ -72,7 +69,7 @@ TEST_F(IPTablesConfig, iptables_no_error_no_throw)
 TEST_F(IPTablesConfig, iptables_error_throws)
 {
     auto factory = mpt::MockProcessFactory::Inject();
-    factory->register_callback(iptables_callback);
+    factory->register_callback(make_iptables_callback(1));
 
     mp::IPTablesConfig iptables_config{evilbr0, subnet};
 
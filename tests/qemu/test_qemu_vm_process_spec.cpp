@@ -48,7 +48,7 @@ TEST_F(TestQemuVMProcessSpec, default_arguments_correct)
 
     EXPECT_EQ(spec.arguments(), QStringList({"--enable-kvm",
                                              "-device",
-                                             "virtio-scsi-pci,id=scsi0",
+                                             "virtio-scsi-pci,id=scsi0,num_queues=2",
                                              "-drive",
                                              "file=/path/to/image,if=none,format=qcow2,discard=unmap,id=hda",
                                              "-device",
@@ -70,10 +70,45 @@ TEST_F(TestQemuVMProcessSpec, default_arguments_correct)
                                              "-serial",
                                              "chardev:char0",
                                              "-nographic",
+                                             "-chardev",
+                                             "socket,id=qga0,path=/path/to/qga.sock,server,nowait",
+                                             "-device",
+                                             "virtio-serial",
+                                             "-device",
+                                             "virtserialport,chardev=qga0,name=org.qemu.guest_agent.0",
                                              "-cdrom",
                                              "/path/to/cloud_init.iso"}));
 }
 
+TEST_F(TestQemuVMProcessSpec, guest_agent_channel_allowed_by_apparmor)
+{
+    mp::QemuVMProcessSpec spec(desc, tap_device_name, mp::nullopt);
+
+    EXPECT_TRUE(spec.apparmor_profile().contains("/path/to/qga.sock rw,"));
+}
+
+TEST_F(TestQemuVMProcessSpec, io_limits_throttle_the_drive)
+{
+    auto limited_desc = desc;
+    limited_desc.io_limits = mp::IoLimits{500, 104857600};
+
+    mp::QemuVMProcessSpec spec(limited_desc, tap_device_name, mp::nullopt);
+
+    EXPECT_TRUE(spec.arguments().contains("file=/path/to/image,if=none,format=qcow2,discard=unmap,id=hda,"
+                                          "throttling.iops-total=500,throttling.bps-total=104857600"));
+}
+
+TEST_F(TestQemuVMProcessSpec, numa_placement_binds_guest_memory)
+{
+    mp::QemuVMProcessSpec spec(desc, tap_device_name, mp::nullopt, mp::backend::NumaNode{1, "8-15,24-31"});
+
+    const auto args = spec.arguments();
+    const auto object_index = args.indexOf("-object");
+    ASSERT_NE(object_index, -1);
+    EXPECT_EQ(args[object_index + 1], "memory-backend-ram,id=mem0,size=3072M,host-nodes=1,policy=bind");
+    EXPECT_EQ(args[args.indexOf("-numa") + 1], "node,memdev=mem0");
+}
+
 TEST_F(TestQemuVMProcessSpec, legacy_resume_arguments_correct)
 {
     const mp::QemuVMProcessSpec::ResumeData resume_data{"suspend_tag", "machine_type", false, {}};
@@ -54,6 +54,14 @@ struct StubVirtualMachineFactory : public multipass::VirtualMachineFactory
     {
     }
 
+    void snapshot_instance_image(const multipass::VMImage&, const std::string&) override
+    {
+    }
+
+    void restore_instance_image(const multipass::VMImage&, const std::string&) override
+    {
+    }
+
     void configure(const std::string&, YAML::Node&, YAML::Node&) override
     {
     }
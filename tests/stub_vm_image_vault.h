@@ -35,6 +35,16 @@ struct StubVMImageVault final : public multipass::VMImageVault
         return prepare({dummy_image.name(), dummy_image.name(), dummy_image.name(), {}, {}, {}, {}, {}, {}});
     };
 
+    multipass::VMImage clone_image(const std::string&, const std::string&) override
+    {
+        return {dummy_image.name(), dummy_image.name(), dummy_image.name(), {}, {}, {}, {}, {}, {}};
+    };
+
+    multipass::VMImage rename_image(const std::string&, const std::string&) override
+    {
+        return {dummy_image.name(), dummy_image.name(), dummy_image.name(), {}, {}, {}, {}, {}, {}};
+    };
+
     void remove(const std::string&) override{};
     bool has_record_for(const std::string&) override
     {
@@ -44,6 +54,8 @@ struct StubVMImageVault final : public multipass::VMImageVault
     void prune_expired_images() override{};
     void update_images(const FetchType& fetch_type, const PrepareAction& prepare,
                        const ProgressMonitor& monitor) override{};
+    void prefetch_images(const std::vector<Query>& tracked_queries, const FetchType& fetch_type,
+                         const PrepareAction& prepare, const ProgressMonitor& monitor) override{};
 
     TempFile dummy_image;
 };
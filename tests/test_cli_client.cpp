@@ -30,6 +30,7 @@
 #include <src/client/cli/client.h>
 #include <src/daemon/daemon_rpc.h>
 
+#include <QCoreApplication>
 #include <QEventLoop>
 #include <QStringList>
 #include <QTemporaryFile>
@@ -82,12 +83,22 @@ struct MockDaemonRpc : public mp::DaemonRpc
                                        grpc::ServerWriter<mp::SuspendReply>* response));
     MOCK_METHOD3(restart, grpc::Status(grpc::ServerContext* context, const mp::RestartRequest* request,
                                        grpc::ServerWriter<mp::RestartReply>* response));
+    MOCK_METHOD3(snapshot, grpc::Status(grpc::ServerContext* context, const mp::SnapshotRequest* request,
+                                        grpc::ServerWriter<mp::SnapshotReply>* response));
+    MOCK_METHOD3(restore, grpc::Status(grpc::ServerContext* context, const mp::RestoreRequest* request,
+                                       grpc::ServerWriter<mp::RestoreReply>* response));
+    MOCK_METHOD3(modify, grpc::Status(grpc::ServerContext* context, const mp::ModifyRequest* request,
+                                      grpc::ServerWriter<mp::ModifyReply>* response));
     MOCK_METHOD3(delet, grpc::Status(grpc::ServerContext* context, const mp::DeleteRequest* request,
                                      grpc::ServerWriter<mp::DeleteReply>* response));
     MOCK_METHOD3(umount, grpc::Status(grpc::ServerContext* context, const mp::UmountRequest* request,
                                       grpc::ServerWriter<mp::UmountReply>* response));
     MOCK_METHOD3(version, grpc::Status(grpc::ServerContext* context, const mp::VersionRequest* request,
                                        grpc::ServerWriter<mp::VersionReply>* response));
+    MOCK_METHOD3(trace, grpc::Status(grpc::ServerContext* context, const mp::TraceRequest* request,
+                                     grpc::ServerWriter<mp::TraceReply>* response));
+    MOCK_METHOD3(get_metrics, grpc::Status(grpc::ServerContext* context, const mp::MetricsRequest* request,
+                                           grpc::ServerWriter<mp::MetricsReply>* response));
     MOCK_METHOD3(ping,
                  grpc::Status(grpc::ServerContext* context, const mp::PingRequest* request, mp::PingReply* response));
 };
@@ -235,10 +246,12 @@ struct Client : public Test
         return QVariant::fromValue(!flag).toString().toStdString();
     }
 
+    // per-process endpoints, so parallel test shards don't bind the same one or talk across each other
 #ifdef WIN32
-    std::string server_address{"localhost:50051"};
+    std::string server_address{"localhost:" + std::to_string(50051 + QCoreApplication::applicationPid() % 10000)};
 #else
-    std::string server_address{"unix:/tmp/test-multipassd.socket"};
+    std::string server_address{"unix:/tmp/test-multipassd." + std::to_string(QCoreApplication::applicationPid()) +
+                               ".socket"};
 #endif
     mpt::StubCertProvider cert_provider;
     mpt::StubCertStore cert_store;
@@ -669,6 +682,12 @@ TEST_F(Client, exec_cmd_double_dash_ok_cmd_arg)
     EXPECT_THAT(send_command({"exec", "foo", "--", "cmd"}), Eq(mp::ReturnCode::Ok));
 }
 
+TEST_F(Client, exec_cmd_double_dash_ok_multiple_instances)
+{
+    EXPECT_CALL(mock_daemon, ssh_info(_, _, _));
+    EXPECT_THAT(send_command({"exec", "foo,bar", "--", "cmd"}), Eq(mp::ReturnCode::Ok));
+}
+
 TEST_F(Client, exec_cmd_double_dash_ok_cmd_arg_with_opts)
 {
     EXPECT_CALL(mock_daemon, ssh_info(_, _, _));
@@ -774,6 +793,24 @@ TEST_F(Client, list_cmd_help_ok)
     EXPECT_THAT(send_command({"list", "-h"}), Eq(mp::ReturnCode::Ok));
 }
 
+TEST_F(Client, list_cmd_accepts_watch)
+{
+    EXPECT_CALL(mock_daemon, list(_, _, _));
+    EXPECT_THAT(send_command({"list", "--watch"}), Eq(mp::ReturnCode::Ok));
+}
+
+// metrics cli tests
+TEST_F(Client, metrics_cmd_ok_no_args)
+{
+    EXPECT_CALL(mock_daemon, get_metrics(_, _, _));
+    EXPECT_THAT(send_command({"metrics"}), Eq(mp::ReturnCode::Ok));
+}
+
+TEST_F(Client, metrics_cmd_fails_with_args)
+{
+    EXPECT_THAT(send_command({"metrics", "foo"}), Eq(mp::ReturnCode::CommandLineError));
+}
+
 // mount cli tests
 // Note: mpt::test_data_path() returns an absolute path
 TEST_F(Client, mount_cmd_good_absolute_source_path)
@@ -1439,6 +1476,91 @@ TEST_F(Client, restart_cmd_fails_with_unknown_options)
     EXPECT_THAT(send_command({"restart", "--cancel", "foo"}), Eq(mp::ReturnCode::CommandLineError));
 }
 
+// snapshot cli tests
+TEST_F(Client, snapshot_cmd_good_arguments)
+{
+    EXPECT_CALL(mock_daemon, snapshot(_, _, _));
+    EXPECT_THAT(send_command({"snapshot", "foo", "clean-slate"}), Eq(mp::ReturnCode::Ok));
+}
+
+TEST_F(Client, snapshot_cmd_help_ok)
+{
+    EXPECT_THAT(send_command({"snapshot", "-h"}), Eq(mp::ReturnCode::Ok));
+}
+
+TEST_F(Client, snapshot_cmd_fails_without_snapshot_name)
+{
+    EXPECT_THAT(send_command({"snapshot", "foo"}), Eq(mp::ReturnCode::CommandLineError));
+}
+
+// restore cli tests
+TEST_F(Client, restore_cmd_good_arguments)
+{
+    EXPECT_CALL(mock_daemon, restore(_, _, _));
+    EXPECT_THAT(send_command({"restore", "foo", "clean-slate"}), Eq(mp::ReturnCode::Ok));
+}
+
+TEST_F(Client, restore_cmd_help_ok)
+{
+    EXPECT_THAT(send_command({"restore", "-h"}), Eq(mp::ReturnCode::Ok));
+}
+
+TEST_F(Client, restore_cmd_fails_without_snapshot_name)
+{
+    EXPECT_THAT(send_command({"restore", "foo"}), Eq(mp::ReturnCode::CommandLineError));
+}
+
+// modify cli tests
+TEST_F(Client, modify_cmd_good_arguments)
+{
+    EXPECT_CALL(mock_daemon, modify(_, _, _));
+    EXPECT_THAT(send_command({"modify", "foo", "--cpus", "2", "--mem", "2G"}), Eq(mp::ReturnCode::Ok));
+}
+
+TEST_F(Client, modify_cmd_single_option_ok)
+{
+    EXPECT_CALL(mock_daemon, modify(_, _, _));
+    EXPECT_THAT(send_command({"modify", "foo", "--mem", "2G"}), Eq(mp::ReturnCode::Ok));
+}
+
+TEST_F(Client, modify_cmd_help_ok)
+{
+    EXPECT_THAT(send_command({"modify", "-h"}), Eq(mp::ReturnCode::Ok));
+}
+
+TEST_F(Client, modify_cmd_fails_without_options)
+{
+    EXPECT_THAT(send_command({"modify", "foo"}), Eq(mp::ReturnCode::CommandLineError));
+}
+
+TEST_F(Client, modify_cmd_fails_with_invalid_cpus)
+{
+    EXPECT_THAT(send_command({"modify", "foo", "--cpus", "none"}), Eq(mp::ReturnCode::CommandLineError));
+}
+
+TEST_F(Client, modify_cmd_fails_without_instance_name)
+{
+    EXPECT_THAT(send_command({"modify", "--cpus", "2"}), Eq(mp::ReturnCode::CommandLineError));
+}
+
+// trace cli tests
+TEST_F(Client, trace_cmd_ok_no_args)
+{
+    EXPECT_CALL(mock_daemon, trace(_, _, _));
+    EXPECT_THAT(send_command({"trace"}), Eq(mp::ReturnCode::Ok));
+}
+
+TEST_F(Client, trace_cmd_ok_with_clear)
+{
+    EXPECT_CALL(mock_daemon, trace(_, _, _));
+    EXPECT_THAT(send_command({"trace", "--clear"}), Eq(mp::ReturnCode::Ok));
+}
+
+TEST_F(Client, trace_cmd_fails_with_args)
+{
+    EXPECT_THAT(send_command({"trace", "foo"}), Eq(mp::ReturnCode::CommandLineError));
+}
+
 // delete cli tests
 TEST_F(Client, delete_cmd_fails_no_args)
 {
@@ -95,3 +95,23 @@ TEST_F(ClientCertStore, add_cert_stores_certificate)
     const auto content = cert_store.PEM_cert_chain();
     EXPECT_THAT(content, StrEq(cert_data));
 }
+
+TEST_F(ClientCertStore, add_cert_skips_certificate_already_stored)
+{
+    constexpr auto cert_data = "-----BEGIN CERTIFICATE-----\n"
+                               "MIIBUjCB+AIBKjAKBggqhkjOPQQDAjA1MQswCQYDVQQGEwJDQTESMBAGA1UECgwJ\n"
+                               "Q2Fub25pY2FsMRIwEAYDVQQDDAlsb2NhbGhvc3QwHhcNMTgwNjIxMTM0MjI5WhcN\n"
+                               "MTkwNjIxMTM0MjI5WjA1MQswCQYDVQQGEwJDQTESMBAGA1UECgwJQ2Fub25pY2Fs\n"
+                               "MRIwEAYDVQQDDAlsb2NhbGhvc3QwWTATBgcqhkjOPQIBBggqhkjOPQMBBwNCAAQA\n"
+                               "FGNAqq7c5IMDeQ/cV4+EmogmkfpbTLSPfXgXVLHRsvL04xUAkqGpL+eyGFVE6dqa\n"
+                               "J7sAPJJwlVj1xD0r5DX5MAoGCCqGSM49BAMCA0kAMEYCIQCvI0PYv9f201fbe4LP\n"
+                               "BowTeYWSqMQtLNjvZgd++AAGhgIhALNPW+NRSKCXwadiIFgpbjPInLPqXPskLWSc\n"
+                               "aXByaQyt\n"
+                               "-----END CERTIFICATE-----\n";
+
+    mp::ClientCertStore cert_store{cert_dir};
+    cert_store.add_cert(cert_data);
+    cert_store.add_cert(cert_data);
+
+    EXPECT_THAT(cert_store.PEM_cert_chain(), StrEq(cert_data));
+}
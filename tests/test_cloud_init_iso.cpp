@@ -45,3 +45,42 @@ TEST_F(CloudInitIso, creates_iso_file)
     EXPECT_TRUE(file.exists());
     EXPECT_THAT(file.size(), Ge(0));
 }
+
+TEST_F(CloudInitIso, updates_file_in_place)
+{
+    mp::CloudInitIso iso;
+    iso.add_file("meta-data", "original meta data");
+    iso.add_file("user-data", "original user data");
+    iso.write_to(iso_path);
+
+    QFile file{iso_path};
+    const auto size_before = file.size();
+
+    EXPECT_TRUE(mp::CloudInitIso::update_file_in(iso_path, "user-data", "updated user data"));
+    EXPECT_EQ(file.size(), size_before);
+
+    ASSERT_TRUE(file.open(QIODevice::ReadOnly));
+    const auto contents = file.readAll();
+    EXPECT_TRUE(contents.contains("updated user data"));
+    EXPECT_FALSE(contents.contains("original user data"));
+    EXPECT_TRUE(contents.contains("original meta data"));
+}
+
+TEST_F(CloudInitIso, update_fails_for_unknown_entry)
+{
+    mp::CloudInitIso iso;
+    iso.add_file("meta-data", "meta data");
+    iso.write_to(iso_path);
+
+    EXPECT_FALSE(mp::CloudInitIso::update_file_in(iso_path, "no-such-entry", "some data"));
+}
+
+TEST_F(CloudInitIso, update_fails_when_contents_outgrow_extent)
+{
+    mp::CloudInitIso iso;
+    iso.add_file("user-data", "small");
+    iso.write_to(iso_path);
+
+    const std::string oversized(1024 * 1024, 'x');
+    EXPECT_FALSE(mp::CloudInitIso::update_file_in(iso_path, "user-data", oversized));
+}
@@ -53,11 +53,13 @@
 
 #include <scope_guard.hpp>
 
+#include <atomic>
 #include <memory>
 #include <ostream>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 namespace mp = multipass;
 namespace mpt = multipass::test;
@@ -211,7 +213,7 @@ class TestClient : public mp::Client
 public:
     explicit TestClient(mp::ClientConfig& context) : mp::Client{context}
     {
-        add_command<TestCreate>();
+        add_command<TestCreate>("test_create", "");
         sort_commands();
     }
 };
@@ -298,7 +300,8 @@ struct Daemon : public Test
         loop.exec();
     }
 
-    std::string server_address{"unix:/tmp/test-multipassd.socket"};
+    std::string server_address{"unix:/tmp/test-multipassd." + std::to_string(QCoreApplication::applicationPid()) +
+                               ".socket"}; // per-process, so parallel test shards don't bind the same endpoint
     QEventLoop loop; // needed as signal/slots used internally by mp::Daemon
     mpt::TempDir cache_dir;
     mpt::TempDir data_dir;
@@ -693,6 +696,72 @@ TEST_P(MinSpaceViolatedSuite, refuses_launch_with_memory_below_threshold)
     EXPECT_THAT(stream.str(), AllOf(HasSubstr("fail"), AnyOf(HasSubstr("memory"), HasSubstr("disk"))));
 }
 
+struct DaemonConcurrentRequests : public Daemon
+{
+    /* Drives every command from its own client thread, so the daemon sees genuinely simultaneous RPCs.
+       Run under the tsan build type, this gives the instance registry and the worker pools race coverage */
+    void send_commands_concurrently(const std::vector<std::vector<std::string>>& commands)
+    {
+        std::atomic<int> remaining{static_cast<int>(commands.size())};
+        std::vector<std::unique_ptr<mp::AutoJoinThread>> client_threads;
+        client_threads.reserve(commands.size());
+
+        for (const auto& command : commands)
+            client_threads.push_back(std::make_unique<mp::AutoJoinThread>([this, &command, &remaining] {
+                std::stringstream cin, cout, cerr; // per-thread streams, the shared trash_stream would race
+                mpt::StubTerminal term(cout, cerr, cin);
+                mp::ClientConfig client_config{server_address, mp::RpcConnectionType::insecure,
+                                               std::make_unique<mpt::StubCertProvider>(), &term};
+                TestClient client{client_config};
+
+                QStringList args = QStringList() << "multipass_test";
+                for (const auto& arg : command)
+                    args << QString::fromStdString(arg);
+                client.run(args);
+
+                if (--remaining == 0)
+                    loop.quit();
+            }));
+
+        loop.exec();
+    }
+};
+
+TEST_F(DaemonConcurrentRequests, survives_a_storm_of_simultaneous_queries)
+{
+    mp::Daemon daemon{config_builder.build()};
+
+    std::vector<std::vector<std::string>> commands;
+    for (auto i = 0; i < 50; ++i)
+    {
+        commands.push_back({"list"});
+        commands.push_back({"version"});
+        commands.push_back({"info", "unknown-" + std::to_string(i)}); // error paths touch the registry too
+    }
+
+    send_commands_concurrently(commands);
+}
+
+TEST_F(DaemonConcurrentRequests, concurrent_creates_land_every_instance_in_the_registry)
+{
+    mp::Daemon daemon{config_builder.build()};
+
+    constexpr auto count = 20;
+    std::vector<std::vector<std::string>> commands;
+    for (auto i = 0; i < count; ++i)
+    {
+        commands.push_back({"test_create", "foo" + std::to_string(i)});
+        commands.push_back({"list"}); // interleaved readers, racing the writers for the registry
+    }
+
+    send_commands_concurrently(commands);
+
+    std::stringstream stream;
+    send_command({"list"}, stream);
+    for (auto i = 0; i < count; ++i)
+        EXPECT_THAT(stream.str(), HasSubstr("foo" + std::to_string(i)));
+}
+
 INSTANTIATE_TEST_SUITE_P(Daemon, DaemonCreateLaunchTestSuite, Values("launch", "test_create"));
 INSTANTIATE_TEST_SUITE_P(Daemon, MinSpaceRespectedSuite,
                          Combine(Values("test_create", "launch"), Values("--mem", "--disk"),
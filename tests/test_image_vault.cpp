@@ -335,6 +335,38 @@ TEST_F(ImageVault, remembers_prepared_images)
     EXPECT_THAT(vm_image1.id, Eq(vm_image2.id));
 }
 
+TEST_F(ImageVault, rename_moves_record_and_files)
+{
+    mp::DefaultVMImageVault vault{hosts, &url_downloader, cache_dir.path(), data_dir.path(), mp::days{0}};
+    auto vm_image = vault.fetch_image(mp::FetchType::ImageOnly, default_query, stub_prepare, stub_monitor);
+
+    auto renamed_image = vault.rename_image(instance_name, "aviato");
+
+    EXPECT_TRUE(renamed_image.image_path.contains("aviato"));
+    EXPECT_TRUE(QFileInfo::exists(renamed_image.image_path));
+    EXPECT_FALSE(vault.has_record_for(instance_name));
+    EXPECT_TRUE(vault.has_record_for("aviato"));
+}
+
+TEST_F(ImageVault, rename_throws_on_missing_source)
+{
+    mp::DefaultVMImageVault vault{hosts, &url_downloader, cache_dir.path(), data_dir.path(), mp::days{0}};
+
+    EXPECT_THROW(vault.rename_image("nonexistent", "aviato"), std::runtime_error);
+}
+
+TEST_F(ImageVault, rename_throws_on_existing_destination)
+{
+    mp::DefaultVMImageVault vault{hosts, &url_downloader, cache_dir.path(), data_dir.path(), mp::days{0}};
+    auto vm_image = vault.fetch_image(mp::FetchType::ImageOnly, default_query, stub_prepare, stub_monitor);
+
+    auto another_query = default_query;
+    another_query.name = "valley-pied-piper-chat";
+    vault.fetch_image(mp::FetchType::ImageOnly, another_query, stub_prepare, stub_monitor);
+
+    EXPECT_THROW(vault.rename_image(instance_name, "valley-pied-piper-chat"), std::runtime_error);
+}
+
 TEST_F(ImageVault, uses_image_from_prepare)
 {
     constexpr auto expected_data = "12345-pied-piper-rats";
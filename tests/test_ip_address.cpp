@@ -26,10 +26,10 @@ TEST(IPAddress, can_initialize_from_string)
 {
     mp::IPAddress ip{"192.168.1.3"};
 
-    EXPECT_THAT(ip.octets[0], Eq(192));
-    EXPECT_THAT(ip.octets[1], Eq(168));
-    EXPECT_THAT(ip.octets[2], Eq(1));
-    EXPECT_THAT(ip.octets[3], Eq(3));
+    EXPECT_THAT(ip.octets()[0], Eq(192));
+    EXPECT_THAT(ip.octets()[1], Eq(168));
+    EXPECT_THAT(ip.octets()[2], Eq(1));
+    EXPECT_THAT(ip.octets()[3], Eq(3));
 }
 
 TEST(IPAddress, can_convert_to_string)
@@ -75,3 +75,23 @@ TEST(IPAddress, supports_addition_operator)
     auto result_ip = an_ip + 4;
     EXPECT_THAT(result_ip, Eq(expected_ip));
 }
+
+TEST(IPAddress, works_at_compile_time)
+{
+    constexpr mp::IPAddress ip{0xC0A80103};
+    static_assert(ip.as_uint32() == 0xC0A80103, "the packed value should round-trip");
+    static_assert(ip.octets()[0] == 0xC0, "octets should be derivable at compile time");
+    static_assert(ip + 2 > ip, "arithmetic and comparisons should be constexpr");
+
+    EXPECT_THAT(ip.as_string(), StrEq("192.168.1.3"));
+}
+
+TEST(IPAddress, computes_assignable_subnet_bounds)
+{
+    mp::IPAddress ip{"10.120.5.37"};
+
+    EXPECT_THAT(ip.first_in_subnet(24).as_string(), StrEq("10.120.5.1"));
+    EXPECT_THAT(ip.last_in_subnet(24).as_string(), StrEq("10.120.5.254"));
+    EXPECT_THAT(ip.first_in_subnet(16).as_string(), StrEq("10.120.0.1"));
+    EXPECT_THAT(ip.last_in_subnet(16).as_string(), StrEq("10.120.255.254"));
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2020 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <src/daemon/json_writer.h>
+
+#include "temp_dir.h"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+
+#include <gmock/gmock.h>
+
+namespace mp = multipass;
+namespace mpt = multipass::test;
+using namespace testing;
+
+namespace
+{
+QJsonObject read_back(const QString& path)
+{
+    QFile file{path};
+    EXPECT_TRUE(file.open(QIODevice::ReadOnly));
+
+    QJsonParseError parse_error;
+    const auto doc = QJsonDocument::fromJson(file.readAll(), &parse_error);
+    EXPECT_EQ(parse_error.error, QJsonParseError::NoError);
+
+    return doc.object();
+}
+} // namespace
+
+TEST(JsonWriter, written_json_round_trips)
+{
+    mpt::TempDir dir;
+    const auto path = dir.path() + "/db.json";
+
+    QJsonObject root;
+    root.insert("name", "relishing-lemur");
+    root.insert("num_cores", 2);
+    root.insert("deleted", false);
+    root.insert("metadata", QJsonObject{{"machine_type", "pc-i440fx"}});
+    root.insert("mounts", QJsonArray{QJsonObject{{"source_path", "/home/someone"}}});
+    root.insert("nothing", QJsonValue{});
+
+    mp::write_json(root, path);
+
+    EXPECT_EQ(read_back(path), root);
+}
+
+TEST(JsonWriter, escapes_problem_characters)
+{
+    mpt::TempDir dir;
+    const auto path = dir.path() + "/db.json";
+
+    QJsonObject root;
+    root.insert("tricky", "a \"quoted\\path\"\nwith\tcontrols\x01 and non-ascii — ¿sí?");
+
+    mp::write_json(root, path);
+
+    EXPECT_EQ(read_back(path), root);
+}
+
+TEST(JsonWriter, replaces_existing_content)
+{
+    mpt::TempDir dir;
+    const auto path = dir.path() + "/db.json";
+
+    mp::write_json(QJsonObject{{"first", QJsonObject{{"state", 4}}}}, path);
+    mp::write_json(QJsonObject{{"second", true}}, path);
+
+    EXPECT_EQ(read_back(path), (QJsonObject{{"second", true}}));
+}
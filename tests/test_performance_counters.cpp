@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2020 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <multipass/performance_counters.h>
+
+#include <gmock/gmock.h>
+
+namespace mp = multipass;
+using namespace testing;
+
+// The registry is a process-wide singleton, so these tests use names of their own and
+// only ever check for their presence
+TEST(PerformanceCounters, renders_counters_in_prometheus_format)
+{
+    auto& counters = mp::perf::PerformanceCounters::instance();
+    counters.increment("test_widgets", 3);
+    counters.increment("test_widgets", 2);
+
+    auto text = counters.prometheus_text();
+    EXPECT_THAT(text, HasSubstr("# TYPE multipass_test_widgets_total counter"));
+    EXPECT_THAT(text, HasSubstr("multipass_test_widgets_total 5"));
+}
+
+TEST(PerformanceCounters, renders_duration_histograms_with_cumulative_buckets)
+{
+    auto& counters = mp::perf::PerformanceCounters::instance();
+    counters.record_duration("test_op", std::chrono::microseconds{1500});   // 2ms bucket
+    counters.record_duration("test_op", std::chrono::microseconds{500000}); // 512ms bucket
+
+    auto text = counters.prometheus_text();
+    EXPECT_THAT(text, HasSubstr("# TYPE multipass_test_op_seconds histogram"));
+    EXPECT_THAT(text, HasSubstr("multipass_test_op_seconds_count 2"));
+    EXPECT_THAT(text, HasSubstr("multipass_test_op_seconds_sum 0.5015"));
+    EXPECT_THAT(text, HasSubstr("le=\"+Inf\"} 2"));
+}
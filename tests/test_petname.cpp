@@ -21,6 +21,7 @@
 
 #include <gmock/gmock.h>
 
+#include <cctype>
 #include <regex>
 #include <string>
 #include <unordered_set>
@@ -96,3 +97,30 @@ TEST(Petname, can_generate_at_least_hundred_unique_names)
 
     EXPECT_THAT(name_set.size(), Ge(expected_num_unique_names));
 }
+
+TEST(Petname, reserving_make_name_returns_a_name_passing_the_predicate)
+{
+    mp::Petname name_generator{"-"};
+    std::unordered_set<std::string> taken;
+
+    for (auto i = 0; i < 100; ++i)
+    {
+        auto name = name_generator.make_name([&taken](const std::string& name) { return taken.count(name) == 0; });
+        EXPECT_THAT(taken.count(name), Eq(0u));
+        taken.insert(name);
+    }
+}
+
+TEST(Petname, reserving_make_name_falls_back_to_counter_when_everything_collides)
+{
+    mp::Petname name_generator{"-"};
+
+    // reject anything without a trailing counter, as if all random compositions were taken
+    auto only_sharded = [](const std::string& name) { return std::isdigit(name.back()); };
+
+    auto first = name_generator.make_name(only_sharded);
+    auto second = name_generator.make_name(only_sharded);
+    EXPECT_TRUE(std::isdigit(first.back()));
+    EXPECT_TRUE(std::isdigit(second.back()));
+    EXPECT_NE(first, second);
+}
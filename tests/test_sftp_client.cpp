@@ -26,6 +26,8 @@
 
 #include <gmock/gmock.h>
 
+#include <cstring>
+
 namespace mp = multipass;
 namespace mpt = multipass::test;
 
@@ -45,7 +47,9 @@ struct SFTPClient : public testing::Test
                            static_cast<sftp_session_struct*>(std::calloc(1, sizeof(struct sftp_session_struct)));
                        return sftp;
                    }},
-          free_sftp{mock_sftp_free, [](sftp_session sftp) { std::free(sftp); }}
+          free_sftp{mock_sftp_free, [](sftp_session sftp) { std::free(sftp); }},
+          stat_sftp{mock_sftp_stat, // no pre-existing remote/local leftovers, so transfers take the non-resume path
+                    [](sftp_session sftp, const char* path) -> sftp_attributes { return nullptr; }}
     {
         connect.returnValue(SSH_OK);
         is_connected.returnValue(true);
@@ -64,6 +68,7 @@ struct SFTPClient : public testing::Test
     decltype(MOCK(sftp_close)) close{MOCK(sftp_close)};
     MockScope<decltype(mock_sftp_new)> sftp_new;
     MockScope<decltype(mock_sftp_free)> free_sftp;
+    MockScope<decltype(mock_sftp_stat)> stat_sftp;
 
     std::stringstream test_stream{"testing stream :-)"};
 };
@@ -132,6 +137,44 @@ TEST_F(SFTPClient, push_throws_on_sftp_write_error)
     EXPECT_THROW(sftp.push_file(file_name.toStdString(), "bar"), std::runtime_error);
 }
 
+TEST_F(SFTPClient, push_resumes_after_matching_remote_leftover)
+{
+    mpt::TempDir temp_dir;
+    auto file_name = temp_dir.path() + "/test-file";
+    const std::string content{"this is a test file"};
+    const uint64_t partial_size = 10; // "this is a "
+    mpt::make_file_with_content(file_name, content);
+
+    REPLACE(sftp_init, [](auto...) { return SSH_OK; });
+    REPLACE(sftp_stat, [partial_size](auto...) {
+        auto attrs = static_cast<sftp_attributes_struct*>(calloc(1, sizeof(struct sftp_attributes_struct)));
+        attrs->size = partial_size;
+        return attrs;
+    });
+    REPLACE(sftp_attributes_free, [](sftp_attributes attrs) { std::free(attrs); });
+    REPLACE(sftp_open, [](sftp_session session, auto...) {
+        auto file = get_dummy_sftp_file();
+        file->sftp = session;
+        return file;
+    });
+    REPLACE(sftp_seek64, [](auto...) { return 0; });
+    REPLACE(sftp_read, [&content, partial_size](sftp_file file, void* buf, size_t count) {
+        std::memcpy(buf, content.data(), partial_size); // the tail probe reads back what made it across
+        return static_cast<ssize_t>(partial_size);
+    });
+
+    std::string written;
+    REPLACE(sftp_write, [&written](sftp_file file, const void* buf, size_t count) {
+        written.append(static_cast<const char*>(buf), count);
+        return static_cast<ssize_t>(count);
+    });
+
+    auto sftp = make_sftp_client();
+    sftp.push_file(file_name.toStdString(), "bar");
+
+    EXPECT_EQ(written, content.substr(partial_size));
+}
+
 TEST_F(SFTPClient, pull_throws_on_sftp_open_failed)
 {
     const std::string source_path{"foo"};
@@ -157,7 +200,8 @@ TEST_F(SFTPClient, pull_throws_on_sftp_read_failed)
         file->sftp = session;
         return file;
     });
-    REPLACE(sftp_read, [](sftp_file file, auto...) {
+    REPLACE(sftp_async_read_begin, [](auto...) { return 0; });
+    REPLACE(sftp_async_read, [](sftp_file file, auto...) {
         file->sftp->errnum = SSH_ERROR;
         return -1;
     });
@@ -228,7 +272,8 @@ TEST_F(SFTPClient, out_stream_throws_on_sftp_read_failed)
         file->sftp = session;
         return file;
     });
-    REPLACE(sftp_read, [](sftp_file file, auto...) {
+    REPLACE(sftp_async_read_begin, [](auto...) { return 0; });
+    REPLACE(sftp_async_read, [](sftp_file file, auto...) {
         file->sftp->errnum = SSH_ERROR;
         return -1;
     });
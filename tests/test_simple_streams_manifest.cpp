@@ -37,7 +37,7 @@ TEST(SimpleStreamsManifest, can_parse_image_info)
     EXPECT_THAT(manifest->updated_at, Eq("Wed, 20 May 2020 16:47:50 +0000"));
     EXPECT_THAT(manifest->products.size(), Eq(2u));
 
-    const auto info = manifest->image_records["default"];
+    const auto info = manifest->find_image_record("default");
     ASSERT_THAT(info, NotNull());
     EXPECT_FALSE(info->image_location.isEmpty());
 }
@@ -52,7 +52,7 @@ TEST(SimpleStreamsManifest, can_find_info_by_alias)
     const QString expected_location{
         "server/releases/xenial/release-20170516/ubuntu-16.04-server-cloudimg-amd64-disk1.img"};
 
-    const auto info = manifest->image_records[expected_id];
+    const auto info = manifest->find_image_record(expected_id);
     ASSERT_THAT(info, NotNull());
     EXPECT_THAT(info->image_location, Eq(expected_location));
     EXPECT_THAT(info->id, Eq(expected_id));
@@ -94,7 +94,7 @@ TEST(SimpleStreamsManifest, chooses_newest_version)
     const QString expected_id{"8842e7a8adb01c7a30cc702b01a5330a1951b12042816e87efd24b61c5e2239f"};
     const QString expected_location{"newest_image.img"};
 
-    const auto info = manifest->image_records["default"];
+    const auto info = manifest->find_image_record("default");
     ASSERT_THAT(info, NotNull());
     EXPECT_THAT(info->image_location, Eq(expected_location));
     EXPECT_THAT(info->id, Eq(expected_id));
@@ -113,7 +113,7 @@ TEST(SimpleStreamsManifest, can_query_all_versions)
 
     for (const auto& hash : all_known_hashes)
     {
-        const auto info = manifest->image_records[hash];
+        const auto info = manifest->find_image_record(hash);
         EXPECT_THAT(info, NotNull());
     }
 }
@@ -123,7 +123,7 @@ TEST(SimpleStreamsManifest, info_has_kernel_and_initrd_paths)
     auto json = mpt::load_test_file("good_manifest.json");
     auto manifest = mp::SimpleStreamsManifest::fromJson(json, "");
 
-    const auto info = manifest->image_records["default"];
+    const auto info = manifest->find_image_record("default");
     ASSERT_THAT(info, NotNull());
 
     EXPECT_FALSE(info->kernel_location.isEmpty());
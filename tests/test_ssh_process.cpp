@@ -154,3 +154,28 @@ TEST_F(SSHProcess, can_read_output)
 
     EXPECT_THAT(output, StrEq(expected_output));
 }
+
+TEST_F(SSHProcess, streams_output_chunks_to_consumer)
+{
+    std::string expected_output{"some content here"};
+    auto remaining = expected_output.size();
+    auto channel_read = [&expected_output, &remaining](ssh_channel, void* dest, uint32_t count, int is_stderr, int) {
+        const auto num_to_copy = std::min({count, static_cast<uint32_t>(remaining), 4u}); // drip-feed small chunks
+        const auto begin = expected_output.begin() + expected_output.size() - remaining;
+        std::copy_n(begin, num_to_copy, reinterpret_cast<char*>(dest));
+        remaining -= num_to_copy;
+        return num_to_copy;
+    };
+    REPLACE(ssh_channel_read_timeout, channel_read);
+
+    auto proc = session.exec("something");
+    std::string output;
+    int chunks{0};
+    proc.consume_std_output([&output, &chunks](const char* data, std::size_t size) {
+        output.append(data, size);
+        ++chunks;
+    });
+
+    EXPECT_THAT(output, StrEq(expected_output));
+    EXPECT_THAT(chunks, Gt(1)); // handed over incrementally, not accumulated into one blob
+}
@@ -67,3 +67,14 @@ TEST_F(TestSSHFSServerProcessSpec, environment_correct)
     ASSERT_TRUE(spec.environment().contains("KEY"));
     EXPECT_EQ(spec.environment().value("KEY"), "private_key");
 }
+
+TEST_F(TestSSHFSServerProcessSpec, exec_line_in_environment_only_when_cached)
+{
+    mp::SSHFSServerProcessSpec spec(config);
+    EXPECT_FALSE(spec.environment().contains("SSHFS_EXEC_LINE"));
+
+    config.sshfs_exec_line = "sshfs -o slave";
+    mp::SSHFSServerProcessSpec cached_spec(config);
+    ASSERT_TRUE(cached_spec.environment().contains("SSHFS_EXEC_LINE"));
+    EXPECT_EQ(cached_spec.environment().value("SSHFS_EXEC_LINE"), "sshfs -o slave");
+}
@@ -196,13 +196,12 @@ struct SshfsMount : public mp::test::SftpServerTest
     std::shared_ptr<NiceMock<mpt::MockLogger>> logger = std::make_shared<NiceMock<mpt::MockLogger>>();
 
     const std::unordered_map<std::string, std::string> default_cmds{
-        {"snap run multipass-sshfs.env", "LD_LIBRARY_PATH=/foo/bar\nSNAP=/baz\n"},
+        {"snap run multipass-sshfs.env 2>/dev/null || sudo which sshfs", "LD_LIBRARY_PATH=/foo/bar\nSNAP=/baz\n"},
         {"sudo env LD_LIBRARY_PATH=/foo/bar /baz/bin/sshfs -V", "FUSE library version: 3.0.0\n"},
         {"echo $PWD/target", "/home/ubuntu/target\n"},
         {"sudo /bin/bash -c 'P=\"/home/ubuntu/target\"; while [ ! -d \"$P/\" ]; do P=\"${P%/*}\"; done; echo $P/'",
          "/home/ubuntu/\n"},
-        {"id -u", "1000\n"},
-        {"id -g", "1000\n"},
+        {"id -u; id -g", "1000\n1000\n"},
         {"sudo env LD_LIBRARY_PATH=/foo/bar /baz/bin/sshfs -o slave -o transform_symlinks -o allow_other :\"source\" "
          "\"target\"",
          "don't care\n"}};
@@ -366,8 +365,8 @@ INSTANTIATE_TEST_SUITE_P(SshfsMountSuccessAndAvoidCommands, SshfsMountExecuteAnd
                                          std::make_tuple("target", execute_no_mkdir_cmds, "chown")));
 
 // Check that some commands throw some exceptions.
-CommandVector non_int_uid_cmds = {{"id -u", "ubuntu\n"}};
-CommandVector non_int_gid_cmds = {{"id -g", "ubuntu\n"}};
+CommandVector non_int_uid_cmds = {{"id -u; id -g", "ubuntu\n1000\n"}};
+CommandVector non_int_gid_cmds = {{"id -u; id -g", "1000\nubuntu\n"}};
 CommandVector invalid_fuse_ver_cmds = {
     {"sudo env LD_LIBRARY_PATH=/foo/bar /baz/bin/sshfs -V", "FUSE library version: fu.man.chu\n"}};
 
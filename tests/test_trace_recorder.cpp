@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2020 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <multipass/tracing/trace_recorder.h>
+
+#include <gmock/gmock.h>
+
+namespace mp = multipass;
+using namespace testing;
+
+namespace
+{
+struct TraceRecorder : public Test
+{
+    TraceRecorder() : recorder{mp::tracing::TraceRecorder::instance()}
+    {
+        recorder.clear(); // the recorder is a process-wide singleton, so start each test from scratch
+    }
+
+    ~TraceRecorder()
+    {
+        recorder.clear();
+    }
+
+    mp::tracing::TraceRecorder& recorder;
+};
+} // namespace
+
+TEST_F(TraceRecorder, records_spans_and_renders_chrome_trace)
+{
+    auto begin = std::chrono::steady_clock::now();
+    recorder.record("some stage", begin, begin + std::chrono::microseconds{42});
+
+    auto json = recorder.chrome_trace_json();
+    EXPECT_THAT(json, HasSubstr("\"traceEvents\""));
+    EXPECT_THAT(json, HasSubstr("\"name\": \"some stage\""));
+    EXPECT_THAT(json, HasSubstr("\"dur\": 42"));
+}
+
+TEST_F(TraceRecorder, clear_empties_the_buffer)
+{
+    auto begin = std::chrono::steady_clock::now();
+    recorder.record("other stage", begin, begin);
+    recorder.clear();
+
+    EXPECT_THAT(recorder.chrome_trace_json(), Not(HasSubstr("other stage")));
+}
+
+TEST_F(TraceRecorder, scoped_span_records_on_destruction)
+{
+    {
+        mp::tracing::ScopedSpan span{"scoped stage"};
+        EXPECT_THAT(recorder.chrome_trace_json(), Not(HasSubstr("scoped stage")));
+    }
+
+    EXPECT_THAT(recorder.chrome_trace_json(), HasSubstr("scoped stage"));
+}
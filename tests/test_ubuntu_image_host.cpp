@@ -81,6 +81,18 @@ TEST_F(UbuntuImageHost, uses_default_on_unspecified_release)
     EXPECT_THAT(info->id, Eq(expected_id));
 }
 
+TEST_F(UbuntuImageHost, falls_back_to_registered_url_when_primary_unreachable)
+{
+    const QString bogus_url{QUrl::fromLocalFile(mpt::test_data_path() + "nowhere").toString() + "/"};
+    mp::UbuntuVMImageHost host{{{"release", bogus_url.toStdString()}}, &url_downloader, default_ttl};
+    host.set_fallback_url("release", host_url.toStdString());
+
+    auto info = host.info_for(make_query("xenial", "release"));
+
+    ASSERT_TRUE(info);
+    EXPECT_THAT(info->image_location, Eq(expected_location)); // locations resolve against the fallback
+}
+
 TEST_F(UbuntuImageHost, iterates_over_all_entries)
 {
     mp::UbuntuVMImageHost host{{release_remote_spec}, &url_downloader, default_ttl};
@@ -0,0 +1,154 @@
+#!/usr/bin/env python3
+"""Benchmark end-to-end instance lifecycle latency against a running daemon.
+
+Runs launch/exec/mount/transfer/delete cycles and reports P50/P95 for each
+stage, both as observed from the client and, where available, from the
+daemon's own trace buffer (`multipass trace`), which breaks a launch down
+into image fetch, decode, cloud-init ISO write, QEMU start and the
+SSH/cloud-init waits.
+
+Point --image at a local image server (e.g. `python3 -m http.server` over a
+mirror of the simplestreams tree) for runs that don't depend on the network.
+Results can be written as JSON with --output so CI can diff them between
+commits.
+"""
+
+import argparse
+import json
+import logging
+import pathlib
+import statistics
+import subprocess
+import sys
+import tempfile
+import time
+
+logger = logging.getLogger("multipass.perf_benchmark")
+logger.addHandler(logging.StreamHandler())
+logger.setLevel(logging.INFO)
+
+TRANSFER_FILE_SIZE = 4 * 1024 * 1024
+
+
+def run_multipass(binary, *args, timeout=1800):
+    cmd = [binary] + list(args)
+    logger.debug("Running %s", " ".join(cmd))
+    return subprocess.run(cmd, check=True, capture_output=True, text=True, timeout=timeout)
+
+
+def timed(samples, stage, func):
+    begin = time.monotonic()
+    func()
+    samples.setdefault(stage, []).append(time.monotonic() - begin)
+
+
+def daemon_trace_durations(binary):
+    """Collect per-span durations (in seconds) from the daemon's trace buffer, clearing it."""
+    durations = {}
+    try:
+        output = run_multipass(binary, "trace", "--clear").stdout
+        for event in json.loads(output).get("traceEvents", []):
+            durations.setdefault(event["name"], []).append(event["dur"] / 1e6)
+    except (subprocess.CalledProcessError, json.JSONDecodeError) as e:
+        logger.warning("Could not collect the daemon trace: %s", e)
+    return durations
+
+
+def run_cycle(args, samples, trace_samples, cycle):
+    name = "{}-{}".format(args.instance_prefix, cycle)
+
+    with tempfile.TemporaryDirectory() as scratch:
+        scratch = pathlib.Path(scratch)
+        transfer_file = scratch / "payload"
+        transfer_file.write_bytes(b"\0" * TRANSFER_FILE_SIZE)
+
+        daemon_trace_durations(args.multipass)  # start the cycle with a clean trace buffer
+
+        timed(samples, "launch",
+              lambda: run_multipass(args.multipass, "launch", args.image, "--name", name))
+        timed(samples, "exec",
+              lambda: run_multipass(args.multipass, "exec", name, "--", "true"))
+        timed(samples, "mount",
+              lambda: run_multipass(args.multipass, "mount", str(scratch), "{}:/mnt/bench".format(name)))
+        timed(samples, "umount",
+              lambda: run_multipass(args.multipass, "umount", name))
+        timed(samples, "transfer",
+              lambda: run_multipass(args.multipass, "transfer", str(transfer_file),
+                                    "{}:/tmp/payload".format(name)))
+        timed(samples, "delete",
+              lambda: run_multipass(args.multipass, "delete", "--purge", name))
+
+        for span, durations in daemon_trace_durations(args.multipass).items():
+            trace_samples.setdefault(span, []).extend(durations)
+
+
+def percentile(values, fraction):
+    ordered = sorted(values)
+    index = min(len(ordered) - 1, round(fraction * (len(ordered) - 1)))
+    return ordered[index]
+
+
+def summarize(samples):
+    return {
+        stage: {
+            "samples": len(values),
+            "p50": statistics.median(values),
+            "p95": percentile(values, 0.95),
+            "max": max(values),
+        }
+        for stage, values in samples.items()
+    }
+
+
+def report(title, summary):
+    logger.info("")
+    logger.info("%s", title)
+    logger.info("%-40s %8s %10s %10s %10s", "stage", "samples", "p50 (s)", "p95 (s)", "max (s)")
+    for stage, stats in sorted(summary.items()):
+        logger.info("%-40s %8d %10.3f %10.3f %10.3f", stage, stats["samples"], stats["p50"],
+                    stats["p95"], stats["max"])
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--multipass", default="multipass", help="the multipass client to drive")
+    parser.add_argument("--image", default="release:default", help="the image to launch")
+    parser.add_argument("--runs", type=int, default=5, help="how many lifecycle cycles to run")
+    parser.add_argument("--instance-prefix", default="perf-bench",
+                        help="prefix for the benchmark instance names")
+    parser.add_argument("--output", type=pathlib.Path,
+                        help="write the summary as JSON to this file, for diffing in CI")
+    parser.add_argument("--debug", action="store_true", help="print every command being run")
+    args = parser.parse_args()
+
+    if args.debug:
+        logger.setLevel(logging.DEBUG)
+
+    samples = {}
+    trace_samples = {}
+    for cycle in range(args.runs):
+        logger.info("Cycle %d/%d...", cycle + 1, args.runs)
+        try:
+            run_cycle(args, samples, trace_samples, cycle)
+        except subprocess.CalledProcessError as e:
+            logger.error("Command %s failed:\n%s", e.cmd, e.stderr)
+            run_multipass(args.multipass, "delete", "--all", "--purge")
+            return 1
+
+    client_summary = summarize(samples)
+    daemon_summary = summarize(trace_samples)
+    report("Client-observed latency", client_summary)
+    if daemon_summary:
+        report("Daemon stage breakdown (trace spans)", daemon_summary)
+
+    if args.output:
+        args.output.write_text(json.dumps({"client": client_summary, "daemon": daemon_summary},
+                                          indent=2, sort_keys=True) + "\n")
+        logger.info("Summary written to %s", args.output)
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())